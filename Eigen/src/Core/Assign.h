@@ -549,18 +549,21 @@ template<typename Derived>
 template<typename OtherDerived>
 EIGEN_STRONG_INLINE Derived& DenseBase<Derived>::operator=(const DenseBase<OtherDerived>& other)
 {
+  EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
   return internal::assign_selector<Derived,OtherDerived>::run(derived(), other.derived());
 }
 
 template<typename Derived>
 EIGEN_STRONG_INLINE Derived& DenseBase<Derived>::operator=(const DenseBase& other)
 {
+  EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
   return internal::assign_selector<Derived,Derived>::run(derived(), other.derived());
 }
 
 template<typename Derived>
 EIGEN_STRONG_INLINE Derived& MatrixBase<Derived>::operator=(const MatrixBase& other)
 {
+  EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
   return internal::assign_selector<Derived,Derived>::run(derived(), other.derived());
 }
 
@@ -568,6 +571,7 @@ template<typename Derived>
 template <typename OtherDerived>
 EIGEN_STRONG_INLINE Derived& MatrixBase<Derived>::operator=(const DenseBase<OtherDerived>& other)
 {
+  EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
   return internal::assign_selector<Derived,OtherDerived>::run(derived(), other.derived());
 }
 
@@ -575,6 +579,7 @@ template<typename Derived>
 template <typename OtherDerived>
 EIGEN_STRONG_INLINE Derived& MatrixBase<Derived>::operator=(const EigenBase<OtherDerived>& other)
 {
+  EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
   return internal::assign_selector<Derived,OtherDerived,false>::evalTo(derived(), other.derived());
 }
 
@@ -582,6 +587,7 @@ template<typename Derived>
 template<typename OtherDerived>
 EIGEN_STRONG_INLINE Derived& MatrixBase<Derived>::operator=(const ReturnByValue<OtherDerived>& other)
 {
+  EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
   return internal::assign_selector<Derived,OtherDerived,false>::evalTo(derived(), other.derived());
 }
 
@@ -66,9 +66,211 @@ struct any_unroller<Derived, Dynamic>
   static inline bool run(const Derived &) { return false; }
 };
 
+/** \internal
+  * \brief Evaluates a boolean expression as packets of masks
+  *
+  * This is only possible for comparisons of vectorizable expressions, and for their combinations with
+  * operator&& and operator||. The other boolean expressions are reduced coefficient by coefficient.
+  */
+template<typename Derived>
+struct packet_mask
+{
+  typedef void Packet;
+  enum { Vectorize = 0 };
+};
+
+template<typename Scalar, ComparisonName Cmp, typename Lhs, typename Rhs>
+struct packet_mask<CwiseBinaryOp<scalar_cmp_op<Scalar,Cmp>, Lhs, Rhs> >
+{
+  typedef CwiseBinaryOp<scalar_cmp_op<Scalar,Cmp>, Lhs, Rhs> Expr;
+  typedef typename Expr::_LhsNested _Lhs;
+  typedef typename Expr::_RhsNested _Rhs;
+  typedef typename Expr::Index Index;
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum {
+    Vectorize = packet_traits<Scalar>::Vectorizable && packet_traits<Scalar>::HasCmp
+             && (int(Expr::Flags) & LinearAccessBit)
+             && (int(_Lhs::Flags) & int(_Rhs::Flags) & ActualPacketAccessBit)
+             && (int(_Lhs::Flags) & int(_Rhs::Flags) & LinearAccessBit),
+    LhsAlignment = (int(_Lhs::Flags) & AlignedBit) ? Aligned : Unaligned,
+    RhsAlignment = (int(_Rhs::Flags) & AlignedBit) ? Aligned : Unaligned
+  };
+
+  // index must be a multiple of the packet size
+  static EIGEN_STRONG_INLINE Packet run(const Expr& expr, Index index)
+  {
+    return expr.functor().packetOp(expr.lhs().template packet<LhsAlignment>(index),
+                                   expr.rhs().template packet<RhsAlignment>(index));
+  }
+};
+
+template<typename Scalar, typename Lhs, typename Rhs>
+struct packet_mask<CwiseBinaryOp<std::equal_to<Scalar>, Lhs, Rhs> >
+  : packet_mask<CwiseBinaryOp<scalar_cmp_op<Scalar,cmp_EQ>, Lhs, Rhs> >
+{
+  typedef CwiseBinaryOp<std::equal_to<Scalar>, Lhs, Rhs> Expr;
+  typedef packet_mask<CwiseBinaryOp<scalar_cmp_op<Scalar,cmp_EQ>, Lhs, Rhs> > Base;
+  typedef typename Base::Packet Packet;
+  static EIGEN_STRONG_INLINE Packet run(const Expr& expr, typename Base::Index index)
+  {
+    return scalar_cmp_op<Scalar,cmp_EQ>().packetOp(expr.lhs().template packet<Base::LhsAlignment>(index),
+                                                   expr.rhs().template packet<Base::RhsAlignment>(index));
+  }
+};
+
+template<typename Scalar, typename Lhs, typename Rhs>
+struct packet_mask<CwiseBinaryOp<std::not_equal_to<Scalar>, Lhs, Rhs> >
+  : packet_mask<CwiseBinaryOp<scalar_cmp_op<Scalar,cmp_NEQ>, Lhs, Rhs> >
+{
+  typedef CwiseBinaryOp<std::not_equal_to<Scalar>, Lhs, Rhs> Expr;
+  typedef packet_mask<CwiseBinaryOp<scalar_cmp_op<Scalar,cmp_NEQ>, Lhs, Rhs> > Base;
+  typedef typename Base::Packet Packet;
+  static EIGEN_STRONG_INLINE Packet run(const Expr& expr, typename Base::Index index)
+  {
+    return scalar_cmp_op<Scalar,cmp_NEQ>().packetOp(expr.lhs().template packet<Base::LhsAlignment>(index),
+                                                    expr.rhs().template packet<Base::RhsAlignment>(index));
+  }
+};
+
+template<typename BooleanOp, typename Lhs, typename Rhs>
+struct packet_mask_boolean_op
+{
+  typedef CwiseBinaryOp<BooleanOp, Lhs, Rhs> Expr;
+  typedef typename Expr::Index Index;
+  typedef packet_mask<typename Expr::_LhsNested> LhsMask;
+  typedef packet_mask<typename Expr::_RhsNested> RhsMask;
+  typedef typename LhsMask::Packet Packet;
+  enum {
+    Vectorize = LhsMask::Vectorize && RhsMask::Vectorize
+             && is_same<typename LhsMask::Packet, typename RhsMask::Packet>::value
+             && (int(Expr::Flags) & LinearAccessBit)
+  };
+};
+
+template<typename Lhs, typename Rhs>
+struct packet_mask<CwiseBinaryOp<scalar_boolean_and_op, Lhs, Rhs> >
+  : packet_mask_boolean_op<scalar_boolean_and_op, Lhs, Rhs>
+{
+  typedef packet_mask_boolean_op<scalar_boolean_and_op, Lhs, Rhs> Base;
+  typedef typename Base::Packet Packet;
+  static EIGEN_STRONG_INLINE Packet run(const typename Base::Expr& expr, typename Base::Index index)
+  {
+    return pand(Base::LhsMask::run(expr.lhs(), index), Base::RhsMask::run(expr.rhs(), index));
+  }
+};
+
+template<typename Lhs, typename Rhs>
+struct packet_mask<CwiseBinaryOp<scalar_boolean_or_op, Lhs, Rhs> >
+  : packet_mask_boolean_op<scalar_boolean_or_op, Lhs, Rhs>
+{
+  typedef packet_mask_boolean_op<scalar_boolean_or_op, Lhs, Rhs> Base;
+  typedef typename Base::Packet Packet;
+  static EIGEN_STRONG_INLINE Packet run(const typename Base::Expr& expr, typename Base::Index index)
+  {
+    return por(Base::LhsMask::run(expr.lhs(), index), Base::RhsMask::run(expr.rhs(), index));
+  }
+};
+
+template<typename Derived, bool Vectorize = packet_mask<Derived>::Vectorize>
+struct boolean_redux_impl
+{
+  typedef typename Derived::Index Index;
+
+  static inline bool all(const Derived& mat)
+  {
+    for(Index j = 0; j < mat.cols(); ++j)
+      for(Index i = 0; i < mat.rows(); ++i)
+        if (!mat.coeff(i, j)) return false;
+    return true;
+  }
+
+  static inline bool any(const Derived& mat)
+  {
+    for(Index j = 0; j < mat.cols(); ++j)
+      for(Index i = 0; i < mat.rows(); ++i)
+        if (mat.coeff(i, j)) return true;
+    return false;
+  }
+
+  static inline Index count(const Derived& mat)
+  {
+    return mat.template cast<bool>().template cast<Index>().sum();
+  }
+};
+
+// The masks are reduced to integers with pmovemask. all() and any() test two packets at once,
+// hence leave the loop at most one packet after the answer is known.
+template<typename Derived>
+struct boolean_redux_impl<Derived, true>
+{
+  typedef typename Derived::Index Index;
+  typedef packet_mask<Derived> Mask;
+  typedef typename Mask::Packet Packet;
+  enum {
+    PacketSize = unpacket_traits<Packet>::size,
+    FullMask = (1 << PacketSize) - 1
+  };
+
+  static EIGEN_STRONG_INLINE int popcount(int bits)
+  {
+    static const unsigned char table[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+    if(PacketSize <= 4)
+      return table[bits];
+    int res = 0;
+    for(; bits; bits >>= 4)
+      res += table[bits & 15];
+    return res;
+  }
+
+  static inline bool all(const Derived& mat)
+  {
+    const Index size = mat.size();
+    const Index alignedEnd2 = (size/(2*PacketSize))*(2*PacketSize);
+    const Index alignedEnd = (size/PacketSize)*PacketSize;
+    for(Index index = 0; index < alignedEnd2; index += 2*PacketSize)
+      if(pmovemask(pand(Mask::run(mat, index), Mask::run(mat, index+PacketSize))) != FullMask)
+        return false;
+    if(alignedEnd > alignedEnd2 && pmovemask(Mask::run(mat, alignedEnd2)) != FullMask)
+      return false;
+    for(Index index = alignedEnd; index < size; ++index)
+      if(!mat.coeff(index)) return false;
+    return true;
+  }
+
+  static inline bool any(const Derived& mat)
+  {
+    const Index size = mat.size();
+    const Index alignedEnd2 = (size/(2*PacketSize))*(2*PacketSize);
+    const Index alignedEnd = (size/PacketSize)*PacketSize;
+    for(Index index = 0; index < alignedEnd2; index += 2*PacketSize)
+      if(pmovemask(por(Mask::run(mat, index), Mask::run(mat, index+PacketSize))) != 0)
+        return true;
+    if(alignedEnd > alignedEnd2 && pmovemask(Mask::run(mat, alignedEnd2)) != 0)
+      return true;
+    for(Index index = alignedEnd; index < size; ++index)
+      if(mat.coeff(index)) return true;
+    return false;
+  }
+
+  static inline Index count(const Derived& mat)
+  {
+    const Index size = mat.size();
+    const Index alignedEnd = (size/PacketSize)*PacketSize;
+    Index res = 0;
+    for(Index index = 0; index < alignedEnd; index += PacketSize)
+      res += popcount(pmovemask(Mask::run(mat, index)));
+    for(Index index = alignedEnd; index < size; ++index)
+      if(mat.coeff(index)) ++res;
+    return res;
+  }
+};
+
 } // end namespace internal
 
 /** \returns true if all coefficients are true
+  *
+  * Comparisons of vectorizable expressions, possibly combined with operator&& and operator||,
+  * are evaluated a packet at a time.
   *
   * Example: \include MatrixBase_all.cpp
   * Output: \verbinclude MatrixBase_all.out
@@ -87,12 +289,7 @@ inline bool DenseBase<Derived>::all() const
   if(unroll)
     return internal::all_unroller<Derived, unroll ? int(SizeAtCompileTime) : Dynamic>::run(derived());
   else
-  {
-    for(Index j = 0; j < cols(); ++j)
-      for(Index i = 0; i < rows(); ++i)
-        if (!coeff(i, j)) return false;
-    return true;
-  }
+    return internal::boolean_redux_impl<Derived>::all(derived());
 }
 
 /** \returns true if at least one coefficient is true
@@ -111,12 +308,7 @@ inline bool DenseBase<Derived>::any() const
   if(unroll)
     return internal::any_unroller<Derived, unroll ? int(SizeAtCompileTime) : Dynamic>::run(derived());
   else
-  {
-    for(Index j = 0; j < cols(); ++j)
-      for(Index i = 0; i < rows(); ++i)
-        if (coeff(i, j)) return true;
-    return false;
-  }
+    return internal::boolean_redux_impl<Derived>::any(derived());
 }
 
 /** \returns the number of coefficients which evaluate to true
@@ -126,7 +318,7 @@ inline bool DenseBase<Derived>::any() const
 template<typename Derived>
 inline typename DenseBase<Derived>::Index DenseBase<Derived>::count() const
 {
-  return derived().template cast<bool>().template cast<Index>().sum();
+  return internal::boolean_redux_impl<Derived>::count(derived());
 }
 
 /** \returns true is \c *this contains at least one Not A Number (NaN).
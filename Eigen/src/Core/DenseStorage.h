@@ -12,10 +12,16 @@
 #ifndef EIGEN_MATRIXSTORAGE_H
 #define EIGEN_MATRIXSTORAGE_H
 
+#ifdef EIGEN_DEBUG_TEMPORARIES
+  #define EIGEN_INTERNAL_DENSE_STORAGE_COUNT_TEMPORARY internal::on_temporary_allocation(size);
+#else
+  #define EIGEN_INTERNAL_DENSE_STORAGE_COUNT_TEMPORARY
+#endif
+
 #ifdef EIGEN_DENSE_STORAGE_CTOR_PLUGIN
-  #define EIGEN_INTERNAL_DENSE_STORAGE_CTOR_PLUGIN EIGEN_DENSE_STORAGE_CTOR_PLUGIN;
+  #define EIGEN_INTERNAL_DENSE_STORAGE_CTOR_PLUGIN EIGEN_INTERNAL_DENSE_STORAGE_COUNT_TEMPORARY EIGEN_DENSE_STORAGE_CTOR_PLUGIN;
 #else
-  #define EIGEN_INTERNAL_DENSE_STORAGE_CTOR_PLUGIN
+  #define EIGEN_INTERNAL_DENSE_STORAGE_CTOR_PLUGIN EIGEN_INTERNAL_DENSE_STORAGE_COUNT_TEMPORARY
 #endif
 
 namespace Eigen {
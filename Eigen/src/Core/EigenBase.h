@@ -106,6 +106,7 @@ template<typename Derived>
 template<typename OtherDerived>
 Derived& DenseBase<Derived>::operator=(const EigenBase<OtherDerived> &other)
 {
+  EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
   other.derived().evalTo(derived());
   return derived();
 }
@@ -114,6 +115,7 @@ template<typename Derived>
 template<typename OtherDerived>
 Derived& DenseBase<Derived>::operator+=(const EigenBase<OtherDerived> &other)
 {
+  EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
   other.derived().addTo(derived());
   return derived();
 }
@@ -122,6 +124,7 @@ template<typename Derived>
 template<typename OtherDerived>
 Derived& DenseBase<Derived>::operator-=(const EigenBase<OtherDerived> &other)
 {
+  EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
   other.derived().subTo(derived());
   return derived();
 }
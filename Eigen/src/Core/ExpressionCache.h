@@ -0,0 +1,163 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_EXPRESSIONCACHE_H
+#define EIGEN_EXPRESSIONCACHE_H
+
+namespace Eigen {
+
+namespace internal {
+
+template<typename T> void destruct_cached_elements(void* ptr, std::size_t size)
+{
+  destruct_elements_of_array(static_cast<T*>(ptr), size);
+}
+
+} // end namespace internal
+
+/** \class ExpressionCache
+  * \ingroup Core_Module
+  *
+  * \brief Evaluates subexpressions once into buffers which are reused
+  *
+  * An expression used several times in a statement, or nested in an expression which reads its
+  * coefficients several times, is evaluated again for each use, or into a hidden temporary:
+  * \code
+  * y = (A*B).array().exp() / (A*B).array().exp().sum();   // two products, and two temporaries
+  * \endcode
+  * eval() evaluates an expression once into a buffer owned by the cache, and returns a Map of this
+  * buffer, which can then be used as many times as needed without any further evaluation:
+  * \code
+  * ExpressionCache cache;
+  * for(int i=0; i<n; ++i)
+  * {
+  *   Map<const ArrayXXd,Aligned> e = cache.eval((A*B).array().exp());
+  *   y = e / e.sum();
+  *   cache.clear();
+  * }
+  * \endcode
+  * The evaluation goes directly into the buffer, as with noalias(), since it cannot alias the operands.
+  * The maps remain valid until clear() is called or the cache is destroyed. clear() keeps the buffers,
+  * such that the same sequence of evaluations in the next iteration of a loop reuses them without any
+  * allocation.
+  *
+  * \sa DenseBase::eval()
+  */
+class ExpressionCache
+{
+  public:
+
+    ExpressionCache() : m_first(0), m_last(0), m_used(0) {}
+
+    ~ExpressionCache()
+    {
+      clear();
+      while(m_first)
+      {
+        Buffer* next = m_first->next;
+        internal::aligned_free(m_first->data);
+        delete m_first;
+        m_first = next;
+      }
+    }
+
+    /** Evaluates \a xpr into a buffer of the cache.
+      *
+      * \returns a Map of the evaluated expression, which remains valid until the next call to clear() */
+    template<typename Derived>
+    Map<const typename Derived::PlainObject, Aligned> eval(const DenseBase<Derived>& xpr)
+    {
+      EIGEN_INTERNAL_TEMPORARIES_NESTED_SCOPE
+      typedef typename Derived::PlainObject PlainObject;
+      typedef typename PlainObject::Scalar Scalar;
+      const std::size_t size = std::size_t(xpr.rows()) * std::size_t(xpr.cols());
+      Buffer& buffer = nextBuffer(size * sizeof(Scalar));
+      Scalar* data = internal::construct_elements_of_array(static_cast<Scalar*>(buffer.data), size);
+      buffer.size = size;
+      buffer.destruct = &internal::destruct_cached_elements<Scalar>;
+
+      Map<PlainObject, Aligned> dst(data, xpr.rows(), xpr.cols());
+      dst.lazyAssign(xpr.derived());
+      return Map<const PlainObject, Aligned>(data, xpr.rows(), xpr.cols());
+    }
+
+    /** Releases the evaluated expressions, keeping their buffers for the next evaluations. */
+    void clear()
+    {
+      Buffer* buffer = m_first;
+      for(std::size_t i=0; i<m_used; ++i, buffer=buffer->next)
+      {
+        buffer->destruct(buffer->data, buffer->size);
+        buffer->size = 0;
+      }
+      m_last = 0;
+      m_used = 0;
+    }
+
+    /** \returns the number of expressions evaluated since the last call to clear() */
+    std::size_t size() const { return m_used; }
+
+    /** \returns the number of bytes of the buffers */
+    std::size_t capacity() const
+    {
+      std::size_t bytes = 0;
+      for(Buffer* buffer=m_first; buffer; buffer=buffer->next)
+        bytes += buffer->bytes;
+      return bytes;
+    }
+
+  protected:
+
+    struct Buffer
+    {
+      void* data;
+      std::size_t bytes;
+      std::size_t size;
+      void (*destruct)(void*, std::size_t);
+      Buffer* next;
+    };
+
+    // takes the buffer following the last used one, enlarging it if needed
+    Buffer& nextBuffer(std::size_t bytes)
+    {
+      Buffer* buffer = m_last ? m_last->next : m_first;
+      if(buffer==0)
+      {
+        buffer = new Buffer;
+        buffer->data = 0;
+        buffer->bytes = 0;
+        buffer->size = 0;
+        buffer->destruct = 0;
+        buffer->next = 0;
+        if(m_last) m_last->next = buffer;
+        else       m_first = buffer;
+      }
+      if(buffer->bytes<bytes)
+      {
+        internal::aligned_free(buffer->data);
+        buffer->data = 0;
+        buffer->bytes = 0;
+        buffer->data = internal::aligned_malloc(bytes);
+        buffer->bytes = bytes;
+      }
+      m_last = buffer;
+      ++m_used;
+      return *buffer;
+    }
+
+    Buffer* m_first;
+    Buffer* m_last;
+    std::size_t m_used;
+
+  private:
+    ExpressionCache(const ExpressionCache&);
+    ExpressionCache& operator=(const ExpressionCache&);
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_EXPRESSIONCACHE_H
@@ -261,7 +261,10 @@ template<> struct functor_traits<scalar_boolean_or_op> {
 
 /** \internal
   * \brief Template functors for comparison of two scalars
-  * \todo Implement packet-comparisons
+  *
+  * When packet_traits<Scalar>::HasCmp is true, packetOp() returns the comparison as a mask of packets of Scalar.
+  * PacketAccess remains false because a comparison expression has bool coefficients: these masks are only
+  * consumed by the boolean reductions all(), any() and count().
   */
 template<typename Scalar, ComparisonName cmp> struct scalar_cmp_op;
 
@@ -282,22 +285,43 @@ struct result_of<scalar_cmp_op<Scalar, Cmp>(Scalar,Scalar)> {
 template<typename Scalar> struct scalar_cmp_op<Scalar, cmp_EQ> {
   EIGEN_EMPTY_STRUCT_CTOR(scalar_cmp_op)
   EIGEN_STRONG_INLINE bool operator()(const Scalar& a, const Scalar& b) const {return a==b;}
+  template<typename Packet>
+  EIGEN_STRONG_INLINE const Packet packetOp(const Packet& a, const Packet& b) const
+  { return internal::pcmp_eq(a,b); }
 };
 template<typename Scalar> struct scalar_cmp_op<Scalar, cmp_LT> {
   EIGEN_EMPTY_STRUCT_CTOR(scalar_cmp_op)
   EIGEN_STRONG_INLINE bool operator()(const Scalar& a, const Scalar& b) const {return a<b;}
+  template<typename Packet>
+  EIGEN_STRONG_INLINE const Packet packetOp(const Packet& a, const Packet& b) const
+  { return internal::pcmp_lt(a,b); }
 };
 template<typename Scalar> struct scalar_cmp_op<Scalar, cmp_LE> {
   EIGEN_EMPTY_STRUCT_CTOR(scalar_cmp_op)
   EIGEN_STRONG_INLINE bool operator()(const Scalar& a, const Scalar& b) const {return a<=b;}
+  template<typename Packet>
+  EIGEN_STRONG_INLINE const Packet packetOp(const Packet& a, const Packet& b) const
+  { return internal::pcmp_le(a,b); }
 };
 template<typename Scalar> struct scalar_cmp_op<Scalar, cmp_UNORD> {
   EIGEN_EMPTY_STRUCT_CTOR(scalar_cmp_op)
   EIGEN_STRONG_INLINE bool operator()(const Scalar& a, const Scalar& b) const {return !(a<=b || b<=a);}
+  template<typename Packet>
+  EIGEN_STRONG_INLINE const Packet packetOp(const Packet& a, const Packet& b) const
+  {
+    const Packet zero = internal::pset1<Packet>(Scalar(0));
+    return internal::pxor(internal::por(internal::pcmp_le(a,b), internal::pcmp_le(b,a)), internal::pcmp_eq(zero,zero));
+  }
 };
 template<typename Scalar> struct scalar_cmp_op<Scalar, cmp_NEQ> {
   EIGEN_EMPTY_STRUCT_CTOR(scalar_cmp_op)
   EIGEN_STRONG_INLINE bool operator()(const Scalar& a, const Scalar& b) const {return a!=b;}
+  template<typename Packet>
+  EIGEN_STRONG_INLINE const Packet packetOp(const Packet& a, const Packet& b) const
+  {
+    const Packet zero = internal::pset1<Packet>(Scalar(0));
+    return internal::pxor(internal::pcmp_eq(a,b), internal::pcmp_eq(zero,zero));
+  }
 };
 
 // unary functors:
@@ -390,10 +414,15 @@ struct scalar_cast_op {
   EIGEN_EMPTY_STRUCT_CTOR(scalar_cast_op)
   typedef NewType result_type;
   EIGEN_STRONG_INLINE const NewType operator() (const Scalar& a) const { return cast<Scalar, NewType>(a); }
+  template<typename Packet>
+  EIGEN_STRONG_INLINE typename packet_traits<NewType>::type packetOp(const Packet& a) const
+  { return pcast<Packet, typename packet_traits<NewType>::type>(a); }
 };
 template<typename Scalar, typename NewType>
 struct functor_traits<scalar_cast_op<Scalar,NewType> >
-{ enum { Cost = is_same<Scalar, NewType>::value ? 0 : NumTraits<NewType>::AddCost, PacketAccess = false }; };
+{ enum { Cost = is_same<Scalar, NewType>::value ? 0 : NumTraits<NewType>::AddCost,
+         PacketAccess = type_casting_traits<Scalar,NewType>::VectorizedCast
+                     && int(packet_traits<Scalar>::size) == int(packet_traits<NewType>::size) }; };
 
 /** \internal
   * \brief Template functor to extract the real part of a complex
@@ -833,21 +862,146 @@ struct functor_traits<scalar_asin_op<Scalar> >
   };
 };
 
+/** \internal
+  * \brief Template functor to compute the arc tangent of a scalar
+  * \sa class CwiseUnaryOp, ArrayBase::atan()
+  */
+template<typename Scalar> struct scalar_atan_op {
+  EIGEN_EMPTY_STRUCT_CTOR(scalar_atan_op)
+  inline const Scalar operator() (const Scalar& a) const { using std::atan; return atan(a); }
+  typedef typename packet_traits<Scalar>::type Packet;
+  inline Packet packetOp(const Packet& a) const { return internal::patan(a); }
+};
+template<typename Scalar>
+struct functor_traits<scalar_atan_op<Scalar> >
+{
+  enum {
+    Cost = 5 * NumTraits<Scalar>::MulCost,
+    PacketAccess = packet_traits<Scalar>::HasATan
+  };
+};
+
+/** \internal
+  * \brief Template functor to compute the hyperbolic tangent of a scalar
+  * \sa class CwiseUnaryOp, ArrayBase::tanh()
+  */
+template<typename Scalar> struct scalar_tanh_op {
+  EIGEN_EMPTY_STRUCT_CTOR(scalar_tanh_op)
+  inline const Scalar operator() (const Scalar& a) const { using std::tanh; return tanh(a); }
+  typedef typename packet_traits<Scalar>::type Packet;
+  inline Packet packetOp(const Packet& a) const { return internal::ptanh(a); }
+};
+template<typename Scalar>
+struct functor_traits<scalar_tanh_op<Scalar> >
+{
+  enum {
+    Cost = 5 * NumTraits<Scalar>::MulCost,
+    PacketAccess = packet_traits<Scalar>::HasTanh
+  };
+};
+
+/** \internal
+  * \brief Template functor to compute the error function of a scalar
+  * \sa class CwiseUnaryOp, ArrayBase::erf()
+  */
+template<typename Scalar> struct scalar_erf_op {
+  EIGEN_EMPTY_STRUCT_CTOR(scalar_erf_op)
+  inline const Scalar operator() (const Scalar& a) const { return numext::erf(a); }
+  typedef typename packet_traits<Scalar>::type Packet;
+  inline Packet packetOp(const Packet& a) const { return internal::perf(a); }
+};
+template<typename Scalar>
+struct functor_traits<scalar_erf_op<Scalar> >
+{
+  enum {
+    Cost = 5 * NumTraits<Scalar>::MulCost,
+    PacketAccess = packet_traits<Scalar>::HasErf
+  };
+};
+
+/** \internal
+  * \brief Template functor to compute the logarithm of one plus a scalar
+  * \sa class CwiseUnaryOp, ArrayBase::log1p()
+  */
+template<typename Scalar> struct scalar_log1p_op {
+  EIGEN_EMPTY_STRUCT_CTOR(scalar_log1p_op)
+  inline const Scalar operator() (const Scalar& a) const { return numext::log1p(a); }
+  typedef typename packet_traits<Scalar>::type Packet;
+  inline Packet packetOp(const Packet& a) const { return internal::plog1p(a); }
+};
+template<typename Scalar>
+struct functor_traits<scalar_log1p_op<Scalar> >
+{
+  enum {
+    Cost = 5 * NumTraits<Scalar>::MulCost,
+    PacketAccess = packet_traits<Scalar>::HasLog1p
+  };
+};
+
+/** \internal
+  * \brief Template functor to compute the exponential of a scalar minus one
+  * \sa class CwiseUnaryOp, ArrayBase::expm1()
+  */
+template<typename Scalar> struct scalar_expm1_op {
+  EIGEN_EMPTY_STRUCT_CTOR(scalar_expm1_op)
+  inline const Scalar operator() (const Scalar& a) const { return numext::expm1(a); }
+  typedef typename packet_traits<Scalar>::type Packet;
+  inline Packet packetOp(const Packet& a) const { return internal::pexpm1(a); }
+};
+template<typename Scalar>
+struct functor_traits<scalar_expm1_op<Scalar> >
+{
+  enum {
+    Cost = 5 * NumTraits<Scalar>::MulCost,
+    PacketAccess = packet_traits<Scalar>::HasExpm1
+  };
+};
+
+/** \internal
+  * \returns the exponent \a e as an int if it is -2, -1, 1 or 2, for which the packet version of pow
+  * is evaluated by at most two multiplications or divisions, and 0 otherwise.
+  */
+template<typename Scalar, bool Vectorized = packet_traits<Scalar>::HasPow>
+struct pow_small_integer_exponent
+{
+  static inline int run(const Scalar&) { return 0; }
+};
+template<typename Scalar>
+struct pow_small_integer_exponent<Scalar,true>
+{
+  static inline int run(const Scalar& e)
+  {
+    return (e >= Scalar(-2) && e <= Scalar(2) && e == Scalar(int(e))) ? int(e) : 0;
+  }
+};
+
 /** \internal
   * \brief Template functor to raise a scalar to a power
   * \sa class CwiseUnaryOp, Cwise::pow
   */
 template<typename Scalar>
 struct scalar_pow_op {
+  typedef typename packet_traits<Scalar>::type Packet;
   // FIXME default copy constructors seems bugged with std::complex<>
-  inline scalar_pow_op(const scalar_pow_op& other) : m_exponent(other.m_exponent) { }
-  inline scalar_pow_op(const Scalar& exponent) : m_exponent(exponent) {}
+  inline scalar_pow_op(const scalar_pow_op& other) : m_exponent(other.m_exponent), m_integerExponent(other.m_integerExponent) { }
+  inline scalar_pow_op(const Scalar& exponent)
+    : m_exponent(exponent), m_integerExponent(pow_small_integer_exponent<Scalar>::run(exponent)) {}
   inline Scalar operator() (const Scalar& a) const { return numext::pow(a, m_exponent); }
+  inline Packet packetOp(const Packet& a) const
+  {
+    if(m_integerExponent == 0)
+      return internal::ppow(a, pset1<Packet>(m_exponent));
+    // a^2, a^-1 and a^-2 are within 1 ulp as ppow, for the cost of one or two operations;
+    // larger integer exponents are left to ppow, whose error does not grow with them as repeated squaring does
+    Packet res = (m_integerExponent == 2 || m_integerExponent == -2) ? pmul(a, a) : a;
+    return m_integerExponent < 0 ? pdiv(pset1<Packet>(Scalar(1)), res) : res;
+  }
   const Scalar m_exponent;
+  const int m_integerExponent;
 };
 template<typename Scalar>
 struct functor_traits<scalar_pow_op<Scalar> >
-{ enum { Cost = 5 * NumTraits<Scalar>::MulCost, PacketAccess = false }; };
+{ enum { Cost = 5 * NumTraits<Scalar>::MulCost, PacketAccess = packet_traits<Scalar>::HasPow }; };
 
 /** \internal
   * \brief Template functor to compute the quotient between a scalar and array entries.
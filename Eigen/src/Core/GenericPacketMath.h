@@ -52,11 +52,14 @@ struct default_packet_traits
     HasMax    = 1,
     HasConj   = 1,
     HasSetLinear = 1,
+    HasCmp    = 0,
 
     HasDiv    = 0,
     HasSqrt   = 0,
     HasExp    = 0,
     HasLog    = 0,
+    HasLog1p  = 0,
+    HasExpm1  = 0,
     HasPow    = 0,
 
     HasSin    = 0,
@@ -64,10 +67,25 @@ struct default_packet_traits
     HasTan    = 0,
     HasASin   = 0,
     HasACos   = 0,
-    HasATan   = 0
+    HasATan   = 0,
+    HasTanh   = 0,
+    HasErf    = 0
   };
 };
 
+/** \internal Wraps the native packet type \a T into a distinct type, so that several packet types sharing
+  * the same native register type, such as the integer packets of SSE, can specialize the packet functions. */
+template<typename T, int UniqueId>
+struct eigen_packet_wrapper
+{
+  EIGEN_STRONG_INLINE eigen_packet_wrapper() {}
+  EIGEN_STRONG_INLINE eigen_packet_wrapper(const T& v) : m_val(v) {}
+  EIGEN_STRONG_INLINE operator T&() { return m_val; }
+  EIGEN_STRONG_INLINE operator const T&() const { return m_val; }
+  EIGEN_STRONG_INLINE eigen_packet_wrapper& operator=(const T& v) { m_val = v; return *this; }
+  T m_val;
+};
+
 template<typename T> struct packet_traits : default_packet_traits
 {
   typedef T type;
@@ -148,6 +166,78 @@ pxor(const Packet& a, const Packet& b) { return a ^ b; }
 template<typename Packet> inline Packet
 pandnot(const Packet& a, const Packet& b) { return a & (!b); }
 
+/** \internal \returns a mask having all the bits of the coefficients where a < b set, and the others cleared.
+  * The comparison functions, pselect() and pmovemask() are only provided when packet_traits::HasCmp is true. */
+template<typename Packet> inline Packet
+pcmp_lt(const Packet& a, const Packet& b);
+
+/** \internal \returns a mask having all the bits of the coefficients where a <= b set, and the others cleared */
+template<typename Packet> inline Packet
+pcmp_le(const Packet& a, const Packet& b);
+
+/** \internal \returns a mask having all the bits of the coefficients where a == b set, and the others cleared */
+template<typename Packet> inline Packet
+pcmp_eq(const Packet& a, const Packet& b);
+
+/** \internal \returns the coefficients of \a a where \a mask is set, and those of \b b elsewhere */
+template<typename Packet> inline Packet
+pselect(const Packet& mask, const Packet& a, const Packet& b);
+
+/** \internal \returns an integer whose bit i is set if the coefficient i of the mask \a a is set */
+template<typename Packet> inline int
+pmovemask(const Packet& a);
+
+/** \internal \returns a + b (coeff-wise), saturated to the range of the scalar type.
+  * The saturating arithmetic, the shifts, pmaddw(), pwiden_low(), pwiden_high() and pnarrow()
+  * are only provided for integer packets. */
+template<typename Packet> inline Packet
+padds(const Packet& a, const Packet& b);
+
+/** \internal \returns a - b (coeff-wise), saturated to the range of the scalar type */
+template<typename Packet> inline Packet
+psubs(const Packet& a, const Packet& b);
+
+/** \internal \returns \a a shifted left by \a N bits (coeff-wise) */
+template<int N, typename Packet> inline Packet
+plogical_shift_left(const Packet& a);
+
+/** \internal \returns \a a shifted right by \a N bits (coeff-wise), inserting zeros */
+template<int N, typename Packet> inline Packet
+plogical_shift_right(const Packet& a);
+
+/** \internal \returns \a a shifted right by \a N bits (coeff-wise), replicating the sign bit */
+template<int N, typename Packet> inline Packet
+parithmetic_shift_right(const Packet& a);
+
+/** \internal \returns \a c plus the exact products of the coefficients of \a a and \a b, accumulated into
+  * the wider coefficients of \a c: each coefficient of \a c accumulates unpacket_traits<Packet>::size / unpacket_traits<WidePacket>::size
+  * of the products. Hence predux(pmaddw(a,b,c)) is predux(c) plus the dot product of \a a and \a b. */
+template<typename Packet, typename WidePacket> inline WidePacket
+pmaddw(const Packet& a, const Packet& b, const WidePacket& c);
+
+/** \internal \returns the first half of the coefficients of \a a, converted to the twice wider WidePacket */
+template<typename WidePacket, typename Packet> inline WidePacket
+pwiden_low(const Packet& a);
+
+/** \internal \returns the second half of the coefficients of \a a, converted to the twice wider WidePacket */
+template<typename WidePacket, typename Packet> inline WidePacket
+pwiden_high(const Packet& a);
+
+/** \internal \returns the coefficients of \a a followed by those of \a b, saturated to the twice narrower NarrowPacket */
+template<typename NarrowPacket, typename Packet> inline NarrowPacket
+pnarrow(const Packet& a, const Packet& b);
+
+/** \internal \returns the coefficients of \a a converted to the scalar type of TgtPacket, which has the same size.
+  * Conversions to integers truncate toward zero. It is only provided when type_casting_traits::VectorizedCast is true. */
+template<typename SrcPacket, typename TgtPacket> inline TgtPacket
+pcast(const SrcPacket& a);
+
+/** \internal Tells whether the conversion from \a SrcScalar to \a TgtScalar is vectorized by pcast() */
+template<typename SrcScalar, typename TgtScalar> struct type_casting_traits
+{
+  enum { VectorizedCast = 0 };
+};
+
 /** \internal \returns a packet version of \a *from, from must be 16 bytes aligned */
 template<typename Packet> inline Packet
 pload(const typename unpacket_traits<Packet>::type* from) { return *from; }
@@ -250,6 +340,14 @@ Packet pasin(const Packet& a) { using std::asin; return asin(a); }
 template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
 Packet pacos(const Packet& a) { using std::acos; return acos(a); }
 
+/** \internal \returns the arc tangent of \a a (coeff-wise) */
+template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+Packet patan(const Packet& a) { using std::atan; return atan(a); }
+
+/** \internal \returns the hyperbolic tangent of \a a (coeff-wise) */
+template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+Packet ptanh(const Packet& a) { using std::tanh; return tanh(a); }
+
 /** \internal \returns the exp of \a a (coeff-wise) */
 template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
 Packet pexp(const Packet& a) { using std::exp; return exp(a); }
@@ -258,6 +356,22 @@ Packet pexp(const Packet& a) { using std::exp; return exp(a); }
 template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
 Packet plog(const Packet& a) { using std::log; return log(a); }
 
+/** \internal \returns the exp of \a a minus one (coeff-wise) */
+template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+Packet pexpm1(const Packet& a) { return numext::expm1(a); }
+
+/** \internal \returns the log of one plus \a a (coeff-wise) */
+template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+Packet plog1p(const Packet& a) { return numext::log1p(a); }
+
+/** \internal \returns \a a to the power \a b (coeff-wise) */
+template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+Packet ppow(const Packet& a, const Packet& b) { return numext::pow(a, b); }
+
+/** \internal \returns the error function of \a a (coeff-wise) */
+template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+Packet perf(const Packet& a) { return numext::erf(a); }
+
 /** \internal \returns the square-root of \a a (coeff-wise) */
 template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
 Packet psqrt(const Packet& a) { using std::sqrt; return sqrt(a); }
@@ -412,6 +412,89 @@ struct pow_retval
   typedef Scalar type;
 };
 
+/****************************************************************************
+* Implementation of log1p                                                *
+****************************************************************************/
+
+// W. Kahan's formula, accurate near zero without requiring C99's log1p
+template<typename Scalar>
+struct log1p_impl
+{
+  static inline Scalar run(const Scalar& x)
+  {
+    using std::log;
+    Scalar x1p = Scalar(1) + x;
+    if(x1p == Scalar(1))
+      return x;
+    Scalar log1 = log(x1p);
+    return log1 == x1p ? log1 : x * (log1 / (x1p - Scalar(1)));
+  }
+};
+
+template<typename Scalar>
+struct log1p_retval
+{
+  typedef Scalar type;
+};
+
+/****************************************************************************
+* Implementation of expm1                                                *
+****************************************************************************/
+
+// W. Kahan's formula, accurate near zero without requiring C99's expm1
+template<typename Scalar>
+struct expm1_impl
+{
+  static inline Scalar run(const Scalar& x)
+  {
+    using std::exp;
+    using std::log;
+    Scalar u = exp(x);
+    if(u == Scalar(1))
+      return x;
+    Scalar um1 = u - Scalar(1);
+    if(um1 == Scalar(-1))
+      return Scalar(-1);
+    Scalar logu = log(u);
+    return logu == u ? u : um1 * (x / logu);
+  }
+};
+
+template<typename Scalar>
+struct expm1_retval
+{
+  typedef Scalar type;
+};
+
+/****************************************************************************
+* Implementation of erf                                                  *
+****************************************************************************/
+
+// erf is not part of C++98, but all the supported C libraries provide the C99 version
+template<typename Scalar>
+struct erf_impl
+{
+  static inline Scalar run(const Scalar& x) { return Scalar(::erf(double(x))); }
+};
+
+template<>
+struct erf_impl<float>
+{
+  static inline float run(const float& x) { return ::erff(x); }
+};
+
+template<>
+struct erf_impl<long double>
+{
+  static inline long double run(const long double& x) { return ::erfl(x); }
+};
+
+template<typename Scalar>
+struct erf_retval
+{
+  typedef Scalar type;
+};
+
 /****************************************************************************
 * Implementation of random                                               *
 ****************************************************************************/
@@ -625,6 +708,24 @@ inline EIGEN_MATHFUNC_RETVAL(pow, Scalar) pow(const Scalar& x, const Scalar& y)
   return EIGEN_MATHFUNC_IMPL(pow, Scalar)::run(x, y);
 }
 
+template<typename Scalar>
+inline EIGEN_MATHFUNC_RETVAL(log1p, Scalar) log1p(const Scalar& x)
+{
+  return EIGEN_MATHFUNC_IMPL(log1p, Scalar)::run(x);
+}
+
+template<typename Scalar>
+inline EIGEN_MATHFUNC_RETVAL(expm1, Scalar) expm1(const Scalar& x)
+{
+  return EIGEN_MATHFUNC_IMPL(expm1, Scalar)::run(x);
+}
+
+template<typename Scalar>
+inline EIGEN_MATHFUNC_RETVAL(erf, Scalar) erf(const Scalar& x)
+{
+  return EIGEN_MATHFUNC_IMPL(erf, Scalar)::run(x);
+}
+
 // std::isfinite is non standard, so let's define our own version,
 // even though it is not very efficient.
 template<typename T> bool (isfinite)(const T& x)
@@ -296,6 +296,7 @@ template<typename Derived> class MatrixBase
     { return cwiseNotEqual(other).any(); }
 
     NoAlias<Derived,Eigen::MatrixBase > noalias();
+    ParallelAssign<Derived,Eigen::MatrixBase > parallel();
 
     inline const ForceAlignedAccess<Derived> forceAlignedAccess() const;
     inline ForceAlignedAccess<Derived> forceAlignedAccess();
@@ -38,12 +38,16 @@ class NoAlias
       * \sa MatrixBase::lazyAssign() */
     template<typename OtherDerived>
     EIGEN_STRONG_INLINE ExpressionType& operator=(const StorageBase<OtherDerived>& other)
-    { return internal::assign_selector<ExpressionType,OtherDerived,false>::run(m_expression,other.derived()); }
+    {
+      EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
+      return internal::assign_selector<ExpressionType,OtherDerived,false>::run(m_expression,other.derived());
+    }
 
     /** \sa MatrixBase::operator+= */
     template<typename OtherDerived>
     EIGEN_STRONG_INLINE ExpressionType& operator+=(const StorageBase<OtherDerived>& other)
     {
+      EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
       typedef SelfCwiseBinaryOp<internal::scalar_sum_op<Scalar>, ExpressionType, OtherDerived> SelfAdder;
       SelfAdder tmp(m_expression);
       typedef typename internal::nested<OtherDerived>::type OtherDerivedNested;
@@ -56,6 +60,7 @@ class NoAlias
     template<typename OtherDerived>
     EIGEN_STRONG_INLINE ExpressionType& operator-=(const StorageBase<OtherDerived>& other)
     {
+      EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
       typedef SelfCwiseBinaryOp<internal::scalar_difference_op<Scalar>, ExpressionType, OtherDerived> SelfAdder;
       SelfAdder tmp(m_expression);
       typedef typename internal::nested<OtherDerived>::type OtherDerivedNested;
@@ -67,11 +72,19 @@ class NoAlias
 #ifndef EIGEN_PARSED_BY_DOXYGEN
     template<typename ProductDerived, typename Lhs, typename Rhs>
     EIGEN_STRONG_INLINE ExpressionType& operator+=(const ProductBase<ProductDerived, Lhs,Rhs>& other)
-    { other.derived().addTo(m_expression); return m_expression; }
+    {
+      EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
+      other.derived().addTo(m_expression);
+      return m_expression;
+    }
 
     template<typename ProductDerived, typename Lhs, typename Rhs>
     EIGEN_STRONG_INLINE ExpressionType& operator-=(const ProductBase<ProductDerived, Lhs,Rhs>& other)
-    { other.derived().subTo(m_expression); return m_expression; }
+    {
+      EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
+      other.derived().subTo(m_expression);
+      return m_expression;
+    }
 
     template<typename Lhs, typename Rhs, int NestingFlags>
     EIGEN_STRONG_INLINE ExpressionType& operator+=(const CoeffBasedProduct<Lhs,Rhs,NestingFlags>& other)
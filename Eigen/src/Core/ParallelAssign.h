@@ -0,0 +1,262 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_PARALLELASSIGN_H
+#define EIGEN_PARALLELASSIGN_H
+
+namespace Eigen {
+
+#ifndef EIGEN_PARALLEL_ASSIGN_THRESHOLD
+// minimal amount of work, in evaluated coefficients, given to each thread
+#define EIGEN_PARALLEL_ASSIGN_THRESHOLD 32768
+#endif
+
+namespace internal {
+
+// Number of coefficients of the nested expressions evaluated by an assignment from Derived.
+template<typename Derived> struct parallel_assign_work
+{
+  typedef typename Derived::Index Index;
+  static Index run(const Derived& src) { return src.size(); }
+};
+
+// Each coefficient of a partial reduction reduces a whole column or row.
+template<typename MatrixType, typename MemberOp, int Direction>
+struct parallel_assign_work<PartialReduxExpr<MatrixType, MemberOp, Direction> >
+{
+  typedef PartialReduxExpr<MatrixType, MemberOp, Direction> Xpr;
+  typedef typename Xpr::Index Index;
+  static Index run(const Xpr& src)
+  {
+    return src.size() * (Direction==Vertical ? src.nestedExpression().rows() : src.nestedExpression().cols());
+  }
+};
+
+// Position of the first coefficient of dst within its cache line of lineSize coefficients,
+// or 0 if the coefficients of its inner vectors are not contiguous in memory.
+template<typename Derived, bool HasDirectAccess = bool(traits<Derived>::Flags & DirectAccessBit)>
+struct parallel_assign_line_offset
+{
+  typedef typename Derived::Index Index;
+  static Index run(const Derived&, Index) { return 0; }
+};
+
+template<typename Derived>
+struct parallel_assign_line_offset<Derived, true>
+{
+  typedef typename Derived::Index Index;
+  typedef typename Derived::Scalar Scalar;
+  static Index run(const Derived& dst, Index lineSize)
+  {
+    if(dst.innerStride()!=1 || 64 % sizeof(Scalar) != 0)
+      return 0;
+    return Index((std::size_t(dst.data()) / sizeof(Scalar)) % std::size_t(lineSize));
+  }
+};
+
+struct parallel_assign_op
+{
+  template<typename Dst, typename Src> static void run(Dst& dst, const Src& src) { dst.lazyAssign(src); }
+};
+
+struct parallel_add_assign_op
+{
+  template<typename Dst, typename Src> static void run(Dst& dst, const Src& src) { dst += src; }
+};
+
+struct parallel_sub_assign_op
+{
+  template<typename Dst, typename Src> static void run(Dst& dst, const Src& src) { dst -= src; }
+};
+
+} // end namespace internal
+
+/** \class ParallelAssign
+  * \ingroup Core_Module
+  *
+  * \brief Pseudo expression providing assignment operators evaluating the source expression with several threads
+  *
+  * \param ExpressionType the type of the object on which to do the parallel assignment
+  *
+  * This class represents an expression whose assignment operators split the destination into
+  * contiguous chunks, and evaluate each chunk of the source expression on its own thread.
+  * Like NoAlias, it assumes no aliasing between the target expression and the source expression.
+  * It is the return type of MatrixBase::parallel() and ArrayBase::parallel()
+  * and most of the time this is the only way it is used.
+  *
+  * \sa MatrixBase::parallel(), class NoAlias
+  */
+template<typename ExpressionType, template <typename> class StorageBase>
+class ParallelAssign
+{
+    typedef typename ExpressionType::Scalar Scalar;
+    typedef typename ExpressionType::Index Index;
+  public:
+    ParallelAssign(ExpressionType& expression) : m_expression(expression) {}
+
+    /** Behaves like MatrixBase::lazyAssign(other), evaluating \a other with several threads
+      * \sa MatrixBase::lazyAssign() */
+    template<typename OtherDerived>
+    ExpressionType& operator=(const StorageBase<OtherDerived>& other)
+    {
+      m_expression.resize(other.rows(), other.cols());
+      run<internal::parallel_assign_op>(other.derived());
+      return m_expression;
+    }
+
+    /** \sa MatrixBase::operator+= */
+    template<typename OtherDerived>
+    ExpressionType& operator+=(const StorageBase<OtherDerived>& other)
+    {
+      run<internal::parallel_add_assign_op>(other.derived());
+      return m_expression;
+    }
+
+    /** \sa MatrixBase::operator-= */
+    template<typename OtherDerived>
+    ExpressionType& operator-=(const StorageBase<OtherDerived>& other)
+    {
+      run<internal::parallel_sub_assign_op>(other.derived());
+      return m_expression;
+    }
+
+#ifndef EIGEN_PARSED_BY_DOXYGEN
+    // Products are evaluated by their own kernels, which are already parallelized when worth it.
+    template<typename ProductDerived, typename Lhs, typename Rhs>
+    EIGEN_STRONG_INLINE ExpressionType& operator=(const ProductBase<ProductDerived, Lhs,Rhs>& other)
+    { return m_expression.noalias() = other.derived(); }
+
+    template<typename ProductDerived, typename Lhs, typename Rhs>
+    EIGEN_STRONG_INLINE ExpressionType& operator+=(const ProductBase<ProductDerived, Lhs,Rhs>& other)
+    { return m_expression.noalias() += other.derived(); }
+
+    template<typename ProductDerived, typename Lhs, typename Rhs>
+    EIGEN_STRONG_INLINE ExpressionType& operator-=(const ProductBase<ProductDerived, Lhs,Rhs>& other)
+    { return m_expression.noalias() -= other.derived(); }
+
+    template<typename OtherDerived>
+    ExpressionType& operator=(const ReturnByValue<OtherDerived>& func)
+    { return m_expression = func; }
+#endif
+
+    ExpressionType& expression() const
+    {
+      return m_expression;
+    }
+
+  protected:
+
+    // Assigns the block of other starting at the outer slice outerStart and the inner index innerStart.
+    template<typename Op, typename OtherDerived>
+    void runBlock(const OtherDerived& other, Index outerStart, Index outerSize, Index innerStart, Index innerSize)
+    {
+      const bool rowMajor = ExpressionType::IsRowMajor;
+      const Index startRow = rowMajor ? outerStart : innerStart;
+      const Index startCol = rowMajor ? innerStart : outerStart;
+      const Index blockRows = rowMajor ? outerSize : innerSize;
+      const Index blockCols = rowMajor ? innerSize : outerSize;
+      Block<ExpressionType> dst(m_expression, startRow, startCol, blockRows, blockCols);
+      Op::run(dst, Block<const OtherDerived>(other, startRow, startCol, blockRows, blockCols));
+    }
+
+    // Inner index starting the chunk t out of threads, rounded to the nearest multiple of lineSize
+    // once shifted by the offset of the first coefficient within its cache line.
+    static Index chunkBoundary(Index t, Index threads, Index innerSize, Index lineSize, Index offset)
+    {
+      if(t==0 || t==threads)
+        return t==0 ? 0 : innerSize;
+      const Index aligned = ((t*innerSize/threads + offset + lineSize/2)/lineSize)*lineSize - offset;
+      return (std::min)((std::max)(aligned, Index(0)), innerSize);
+    }
+
+    template<typename Op, typename OtherDerived>
+    void run(const OtherDerived& other)
+    {
+      eigen_assert(m_expression.rows() == other.rows() && m_expression.cols() == other.cols());
+#ifdef EIGEN_HAS_OPENMP
+      const Index work = internal::parallel_assign_work<OtherDerived>::run(other);
+      const Index threads = (std::min)(Index(nbThreads()), work / Index(EIGEN_PARALLEL_ASSIGN_THRESHOLD));
+      if(threads>1 && omp_get_num_threads()==1)
+      {
+        const Index outerSize = m_expression.outerSize();
+        const Index innerSize = m_expression.innerSize();
+        if(outerSize >= threads)
+        {
+          // one range of whole outer slices per thread
+          #pragma omp parallel for num_threads(threads)
+          for(Index t=0; t<threads; ++t)
+          {
+            const Index start = (t*outerSize)/threads;
+            const Index end = ((t+1)*outerSize)/threads;
+            runBlock<Op>(other, start, end-start, 0, innerSize);
+          }
+        }
+        else
+        {
+          // few long slices: the inner dimension is split at addresses of the first slice which
+          // start a cache line, so that the threads hardly ever write to the same line
+          const Index lineSize = (std::max)(Index(1), Index(64/sizeof(Scalar)));
+          const Index offset = internal::parallel_assign_line_offset<ExpressionType>::run(m_expression, lineSize);
+          #pragma omp parallel for num_threads(threads)
+          for(Index t=0; t<threads; ++t)
+          {
+            const Index start = chunkBoundary(t, threads, innerSize, lineSize, offset);
+            const Index end = chunkBoundary(t+1, threads, innerSize, lineSize, offset);
+            if(end>start)
+              runBlock<Op>(other, 0, outerSize, start, end-start);
+          }
+        }
+        return;
+      }
+#endif
+      Op::run(m_expression, other);
+    }
+
+    ExpressionType& m_expression;
+};
+
+/** \returns a pseudo expression of \c *this whose assignment operators evaluate the source
+  * expression with several threads, each thread computing a contiguous chunk of \c *this.
+  *
+  * This is only relevant if OpenMP is enabled, and when the source expression is expensive
+  * enough: the number of threads is at most nbThreads(), and each thread is given at least
+  * EIGEN_PARALLEL_ASSIGN_THRESHOLD evaluated coefficients, counting the whole column or row
+  * reduced by each coefficient of a colwise() or rowwise() reduction. Otherwise, and within
+  * an already running parallel region, the assignment is done by the calling thread.
+  *
+  * Example:
+  * \code
+  * A.parallel()  = (B.array().exp() + C.array()).matrix();
+  * v.parallel()  = M.colwise().squaredNorm();
+  * A.parallel() += B.cwiseAbs2();
+  * \endcode
+  *
+  * As with noalias(), \c *this must not alias the source expression. Matrix products are
+  * evaluated as with noalias(), by their own kernels.
+  *
+  * \sa class ParallelAssign, noalias(), setNbThreads()
+  */
+template<typename Derived>
+ParallelAssign<Derived,MatrixBase> MatrixBase<Derived>::parallel()
+{
+  return derived();
+}
+
+/** \returns a pseudo expression of \c *this whose assignment operators evaluate the source
+  * expression with several threads.
+  *
+  * \sa MatrixBase::parallel(), class ParallelAssign
+  */
+template<typename Derived>
+ParallelAssign<Derived,ArrayBase> ArrayBase<Derived>::parallel()
+{
+  return derived();
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_PARALLELASSIGN_H
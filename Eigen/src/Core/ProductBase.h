@@ -123,6 +123,7 @@ class ProductBase : public MatrixBase<Derived>
     // Implicit conversion to the nested type (trigger the evaluation of the product)
     operator const PlainObject& () const
     {
+      EIGEN_INTERNAL_TEMPORARIES_NESTED_SCOPE
       m_result.resize(m_lhs.rows(), m_rhs.cols());
       derived().evalTo(m_result);
       return m_result;
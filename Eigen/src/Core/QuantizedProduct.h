@@ -0,0 +1,198 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_QUANTIZEDPRODUCT_H
+#define EIGEN_QUANTIZEDPRODUCT_H
+
+namespace Eigen {
+
+namespace internal {
+
+template<typename Lhs, typename Rhs>
+struct traits<QuantizedProduct<Lhs,Rhs> >
+{
+  typedef Matrix<int, Lhs::RowsAtCompileTime, Rhs::ColsAtCompileTime, 0,
+                 Lhs::MaxRowsAtCompileTime, Rhs::MaxColsAtCompileTime> ReturnType;
+};
+
+// The operands of the kernel: the expression itself when it has a usable direct access, its evaluation otherwise.
+template<typename XprType>
+struct quantized_operand
+{
+  enum {
+    HasUsableDirectAccess = (int(XprType::Flags)&DirectAccessBit) && int(inner_stride_at_compile_time<XprType>::ret)==1,
+    StorageOrder = (int(XprType::Flags)&RowMajorBit) ? RowMajor : ColMajor
+  };
+  typedef typename conditional<bool(HasUsableDirectAccess), const XprType&, typename XprType::PlainObject>::type type;
+};
+
+// Integer destinations receive the accumulators, floating point ones the dequantized values.
+template<typename Dest, bool IsInteger = NumTraits<typename Dest::Scalar>::IsInteger>
+struct quantized_product_dequantize
+{
+  template<typename Acc, typename Scales>
+  static void run(Dest& dst, const Acc& acc, const Scales& lhsScales, const Scales& rhsScales)
+  {
+    eigen_assert(lhsScales.size()==0 && rhsScales.size()==0
+                 && "the scales are only applied when evaluating into a floating point matrix");
+    EIGEN_UNUSED_VARIABLE(lhsScales);
+    EIGEN_UNUSED_VARIABLE(rhsScales);
+    dst = acc.template cast<typename Dest::Scalar>();
+  }
+};
+
+template<typename Dest>
+struct quantized_product_dequantize<Dest,false>
+{
+  template<typename Acc, typename Scales>
+  static void run(Dest& dst, const Acc& acc, const Scales& lhsScales, const Scales& rhsScales)
+  {
+    typedef typename Dest::Scalar Scalar;
+    typedef Matrix<Scalar,Dynamic,1> ScaleVector;
+    const ScaleVector lhs = lhsScales.size()==0 ? ScaleVector::Ones(acc.rows()) : lhsScales.template cast<Scalar>();
+    const ScaleVector rhs = rhsScales.size()==0 ? ScaleVector::Ones(acc.cols()) : rhsScales.template cast<Scalar>();
+    dst = lhs.asDiagonal() * acc.template cast<Scalar>() * rhs.asDiagonal();
+  }
+};
+
+} // end namespace internal
+
+/** \class QuantizedProduct
+  * \ingroup Core_Module
+  *
+  * \brief Product of two 8-bit integer matrices accumulated in 32-bit integers
+  *
+  * \param Lhs the type of the left-hand side, a matrix expression of signed char or unsigned char
+  * \param Rhs the type of the right-hand side, a matrix expression of signed char or unsigned char
+  *
+  * This class is the return type of quantizedProduct(). The product is evaluated by a dedicated kernel
+  * which widens the operands while packing them, and accumulates pairs of products with pmaddwd when
+  * SSE2 is enabled. The intermediate results never overflow as long as the depth is below 32768.
+  *
+  * Quantized matrices usually represent real matrices through affine mappings \f$ x = s(q - z) \f$,
+  * where the scale \f$ s \f$ and the zero point \f$ z \f$ are given per row of the left-hand side, and
+  * per column of the right-hand side. setZeroPoints() makes the product compute \f$ (A - z_A)(B - z_B) \f$
+  * from the integer product and the sums of the rows of \f$ A \f$ and of the columns of \f$ B \f$, and
+  * setScales() gives the scales applied when the product is evaluated into a floating point matrix:
+  * \code
+  * Matrix<signed char,Dynamic,Dynamic> A;   // quantized weights
+  * Matrix<unsigned char,Dynamic,Dynamic> B; // quantized activations
+  * MatrixXi C = quantizedProduct(A, B);     // exact integer product
+  * MatrixXf D = quantizedProduct(A, B).setZeroPoints(0, 128).setScales(weightScales, inputScales);
+  * \endcode
+  */
+template<typename Lhs, typename Rhs>
+class QuantizedProduct : public ReturnByValue<QuantizedProduct<Lhs,Rhs> >
+{
+    typedef typename internal::traits<Lhs>::Scalar LhsScalar;
+    typedef typename internal::traits<Rhs>::Scalar RhsScalar;
+  public:
+    typedef typename Lhs::Index Index;
+    typedef Matrix<int,Dynamic,1> ZeroPointVector;
+    typedef Matrix<float,Dynamic,1> ScaleVector;
+
+    QuantizedProduct(const Lhs& lhs, const Rhs& rhs)
+      : m_lhs(lhs), m_rhs(rhs)
+    {
+      EIGEN_STATIC_ASSERT((internal::is_same<LhsScalar,signed char>::value || internal::is_same<LhsScalar,unsigned char>::value)
+                       && (internal::is_same<RhsScalar,signed char>::value || internal::is_same<RhsScalar,unsigned char>::value),
+                          THE_MATRIX_OR_EXPRESSION_THAT_YOU_PASSED_DOES_NOT_HAVE_THE_EXPECTED_TYPE)
+      eigen_assert(lhs.cols() == rhs.rows() && "invalid matrix product");
+    }
+
+    inline Index rows() const { return m_lhs.rows(); }
+    inline Index cols() const { return m_rhs.cols(); }
+
+    /** Sets the zero point of each row of the left-hand side, and of each column of the right-hand side.
+      * Empty vectors stand for zero points equal to zero. */
+    template<typename LhsZeroPoints, typename RhsZeroPoints>
+    QuantizedProduct& setZeroPoints(const DenseBase<LhsZeroPoints>& lhsZeroPoints, const DenseBase<RhsZeroPoints>& rhsZeroPoints)
+    {
+      eigen_assert((lhsZeroPoints.size()==0 || lhsZeroPoints.size()==rows())
+                && (rhsZeroPoints.size()==0 || rhsZeroPoints.size()==cols()));
+      m_lhsZeroPoints = lhsZeroPoints.derived().template cast<int>();
+      m_rhsZeroPoints = rhsZeroPoints.derived().template cast<int>();
+      return *this;
+    }
+
+    /** Sets the zero points of the whole left-hand side and of the whole right-hand side. */
+    QuantizedProduct& setZeroPoints(int lhsZeroPoint, int rhsZeroPoint)
+    {
+      return setZeroPoints(ZeroPointVector::Constant(rows(), lhsZeroPoint), ZeroPointVector::Constant(cols(), rhsZeroPoint));
+    }
+
+    /** Sets the scale of each row of the left-hand side, and of each column of the right-hand side,
+      * by which the coefficients of the result are multiplied when it is evaluated into a floating
+      * point matrix. Empty vectors stand for unit scales. */
+    template<typename LhsScales, typename RhsScales>
+    QuantizedProduct& setScales(const DenseBase<LhsScales>& lhsScales, const DenseBase<RhsScales>& rhsScales)
+    {
+      eigen_assert((lhsScales.size()==0 || lhsScales.size()==rows())
+                && (rhsScales.size()==0 || rhsScales.size()==cols()));
+      m_lhsScales = lhsScales.derived().template cast<float>();
+      m_rhsScales = rhsScales.derived().template cast<float>();
+      return *this;
+    }
+
+    /** Sets the scales of the whole left-hand side and of the whole right-hand side. */
+    QuantizedProduct& setScales(float lhsScale, float rhsScale)
+    {
+      return setScales(ScaleVector::Constant(rows(), lhsScale), ScaleVector::Constant(cols(), rhsScale));
+    }
+
+    template<typename Dest> void evalTo(Dest& dst) const
+    {
+      typedef internal::quantized_operand<typename internal::remove_all<Lhs>::type> LhsOperand;
+      typedef internal::quantized_operand<typename internal::remove_all<Rhs>::type> RhsOperand;
+      typename LhsOperand::type lhs(m_lhs);
+      typename RhsOperand::type rhs(m_rhs);
+      const Index depth = m_lhs.cols();
+
+      Matrix<int,Dynamic,Dynamic> acc = Matrix<int,Dynamic,Dynamic>::Zero(rows(), cols());
+
+      typedef internal::quantized_gemm_functor<Index,LhsScalar,LhsOperand::StorageOrder,RhsScalar,RhsOperand::StorageOrder> GemmFunctor;
+      internal::parallelize_gemm<(Lhs::MaxRowsAtCompileTime>32 || Lhs::MaxRowsAtCompileTime==Dynamic)>(
+        GemmFunctor(lhs.data(), lhs.outerStride(), rhs.data(), rhs.outerStride(), acc.data(), acc.outerStride(), depth, cols()),
+        rows(), cols(), false);
+
+      // sum_k (a_ik - za_i)(b_kj - zb_j) = sum_k a_ik b_kj - (sum_k a_ik - depth za_i) zb_j - za_i sum_k b_kj
+      if(m_lhsZeroPoints.size()>0 || m_rhsZeroPoints.size()>0)
+      {
+        const ZeroPointVector za = m_lhsZeroPoints.size()==0 ? ZeroPointVector::Zero(rows()) : m_lhsZeroPoints;
+        const ZeroPointVector zb = m_rhsZeroPoints.size()==0 ? ZeroPointVector::Zero(cols()) : m_rhsZeroPoints;
+        if(!zb.isZero())
+          acc.noalias() -= (lhs.template cast<int>().rowwise().sum() - int(depth) * za) * zb.transpose();
+        if(!za.isZero())
+          acc.noalias() -= za * rhs.template cast<int>().colwise().sum();
+      }
+
+      internal::quantized_product_dequantize<Dest>::run(dst, acc, m_lhsScales, m_rhsScales);
+    }
+
+  protected:
+    typename Lhs::Nested m_lhs;
+    typename Rhs::Nested m_rhs;
+    ZeroPointVector m_lhsZeroPoints;
+    ZeroPointVector m_rhsZeroPoints;
+    ScaleVector m_lhsScales;
+    ScaleVector m_rhsScales;
+};
+
+/** \returns an expression of the product of the 8-bit integer matrices \a lhs and \a rhs,
+  * accumulated in 32-bit integers.
+  *
+  * \sa class QuantizedProduct
+  */
+template<typename Lhs, typename Rhs>
+QuantizedProduct<Lhs,Rhs> quantizedProduct(const MatrixBase<Lhs>& lhs, const MatrixBase<Rhs>& rhs)
+{
+  return QuantizedProduct<Lhs,Rhs>(lhs.derived(), rhs.derived());
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_QUANTIZEDPRODUCT_H
@@ -19,6 +19,11 @@ namespace internal {
 //  * implement other kind of vectorization
 //  * factorize code
 
+#ifndef EIGEN_PARALLEL_REDUX_THRESHOLD
+// minimal number of coefficients reduced by each thread
+#define EIGEN_PARALLEL_REDUX_THRESHOLD 65536
+#endif
+
 /***************************************************************************
 * Part 1 : the logic deciding a strategy for vectorization and unrolling
 ***************************************************************************/
@@ -195,19 +200,50 @@ struct redux_impl<Func, Derived, LinearVectorizedTraversal, NoUnrolling>
   typedef typename Derived::Scalar Scalar;
   typedef typename packet_traits<Scalar>::type PacketScalar;
   typedef typename Derived::Index Index;
+  enum {
+    packetSize = packet_traits<Scalar>::size,
+    alignment = bool(Derived::Flags & DirectAccessBit) || bool(Derived::Flags & AlignedBit)
+              ? Aligned : Unaligned
+  };
 
   static Scalar run(const Derived& mat, const Func& func)
   {
     const Index size = mat.size();
     eigen_assert(size && "you are using an empty matrix");
-    const Index packetSize = packet_traits<Scalar>::size;
     const Index alignedStart = internal::first_aligned(mat);
-    enum {
-      alignment = bool(Derived::Flags & DirectAccessBit) || bool(Derived::Flags & AlignedBit)
-                ? Aligned : Unaligned
-    };
-    const Index alignedSize2 = ((size-alignedStart)/(2*packetSize))*(2*packetSize);
-    const Index alignedSize = ((size-alignedStart)/(packetSize))*(packetSize);
+#ifdef EIGEN_HAS_OPENMP
+    // Very large reductions are split into one contiguous range per thread. The ranges start
+    // on aligned packets, and their partial results are combined in order. Note that the rounding
+    // errors, hence the result of a floating point sum, then depend on the number of threads.
+    const Index threads = (std::min)(Index(nbThreads()), size / Index(EIGEN_PARALLEL_REDUX_THRESHOLD));
+    if(threads>1 && omp_get_num_threads()==1)
+    {
+      const Index blockSize = ((size-alignedStart)/(threads*packetSize))*packetSize;
+      ei_declare_aligned_stack_constructed_variable(Scalar, partial, threads, 0);
+      #pragma omp parallel for num_threads(threads)
+      for(Index t=0; t<threads; ++t)
+      {
+        const Index start = alignedStart + t*blockSize;
+        const Index end = t+1==threads ? size : start + blockSize;
+        partial[t] = t==0 ? run(mat, func, 0, alignedStart, end) : run(mat, func, start, start, end);
+      }
+      Scalar res = partial[0];
+      for(Index t=1; t<threads; ++t)
+        res = func(res, partial[t]);
+      return res;
+    }
+#endif
+    return run(mat, func, 0, alignedStart, size);
+  }
+
+  // Reduces the coefficients start to end-1, the packets being loaded from alignedStart.
+  // Four independent accumulators hide the latency of func.packetOp.
+  static Scalar run(const Derived& mat, const Func& func, Index start, Index alignedStart, Index end)
+  {
+    const Index alignedSize4 = ((end-alignedStart)/(4*packetSize))*(4*packetSize);
+    const Index alignedSize2 = ((end-alignedStart)/(2*packetSize))*(2*packetSize);
+    const Index alignedSize = ((end-alignedStart)/(packetSize))*(packetSize);
+    const Index alignedEnd4 = alignedStart + alignedSize4;
     const Index alignedEnd2 = alignedStart + alignedSize2;
     const Index alignedEnd  = alignedStart + alignedSize;
     Scalar res;
@@ -217,10 +253,25 @@ struct redux_impl<Func, Derived, LinearVectorizedTraversal, NoUnrolling>
       if(alignedSize>packetSize) // we have at least two packets to partly unroll the loop
       {
         PacketScalar packet_res1 = mat.template packet<alignment>(alignedStart+packetSize);
-        for(Index index = alignedStart + 2*packetSize; index < alignedEnd2; index += 2*packetSize)
+        if(alignedSize4)
         {
-          packet_res0 = func.packetOp(packet_res0, mat.template packet<alignment>(index));
-          packet_res1 = func.packetOp(packet_res1, mat.template packet<alignment>(index+packetSize));
+          PacketScalar packet_res2 = mat.template packet<alignment>(alignedStart+2*packetSize);
+          PacketScalar packet_res3 = mat.template packet<alignment>(alignedStart+3*packetSize);
+          for(Index index = alignedStart + 4*packetSize; index < alignedEnd4; index += 4*packetSize)
+          {
+            packet_res0 = func.packetOp(packet_res0, mat.template packet<alignment>(index));
+            packet_res1 = func.packetOp(packet_res1, mat.template packet<alignment>(index+packetSize));
+            packet_res2 = func.packetOp(packet_res2, mat.template packet<alignment>(index+2*packetSize));
+            packet_res3 = func.packetOp(packet_res3, mat.template packet<alignment>(index+3*packetSize));
+          }
+
+          packet_res0 = func.packetOp(packet_res0, packet_res2);
+          packet_res1 = func.packetOp(packet_res1, packet_res3);
+          if(alignedEnd2>alignedEnd4)
+          {
+            packet_res0 = func.packetOp(packet_res0, mat.template packet<alignment>(alignedEnd4));
+            packet_res1 = func.packetOp(packet_res1, mat.template packet<alignment>(alignedEnd4+packetSize));
+          }
         }
 
         packet_res0 = func.packetOp(packet_res0,packet_res1);
@@ -229,17 +280,17 @@ struct redux_impl<Func, Derived, LinearVectorizedTraversal, NoUnrolling>
       }
       res = func.predux(packet_res0);
 
-      for(Index index = 0; index < alignedStart; ++index)
+      for(Index index = start; index < alignedStart; ++index)
         res = func(res,mat.coeff(index));
 
-      for(Index index = alignedEnd; index < size; ++index)
+      for(Index index = alignedEnd; index < end; ++index)
         res = func(res,mat.coeff(index));
     }
     else // too small to vectorize anything.
          // since this is dynamic-size hence inefficient anyway for such small sizes, don't try to optimize.
     {
-      res = mat.coeff(0);
-      for(Index index = 1; index < size; ++index)
+      res = mat.coeff(start);
+      for(Index index = start+1; index < end; ++index)
         res = func(res,mat.coeff(index));
     }
 
@@ -97,6 +97,9 @@ class PartialReduxExpr : internal::no_assignment_operator,
         return m_functor(m_matrix.row(index));
     }
 
+    const typename internal::remove_all<MatrixTypeNested>::type& nestedExpression() const
+    { return m_matrix; }
+
   protected:
     MatrixTypeNested m_matrix;
     const MemberOp m_functor;
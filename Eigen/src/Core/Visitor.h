@@ -162,6 +162,119 @@ struct functor_traits<max_coeff_visitor<Scalar> > {
   };
 };
 
+/** \internal
+  * \brief Computes minCoeff(Index*,Index*) and maxCoeff(Index*,Index*)
+  *
+  * The vectorized version keeps, in each lane, the running extremum and the position where it has been reached.
+  * Both are updated with a packet comparison followed by two pselect(). The positions are stored as packets of
+  * Scalar, relative to the beginning of chunks short enough for them to be exactly representable.
+  * The traversal is linear, so it is only used when the linear order is the column major order of the visitors,
+  * and ties are resolved in favor of the smallest position to return the same coefficient as the visitor.
+  * The lanes start from the extremum found so far, with a negative position, rather than from the first packets,
+  * such that NaN coefficients are skipped exactly as by the visitor, unless the first one is NaN.
+  */
+template<typename Derived, bool IsMax,
+         bool Vectorize = packet_traits<typename Derived::Scalar>::Vectorizable
+                       && packet_traits<typename Derived::Scalar>::HasCmp
+                       && (int(Derived::Flags) & ActualPacketAccessBit)
+                       && (int(Derived::Flags) & LinearAccessBit)
+                       && (Derived::IsVectorAtCompileTime || !Derived::IsRowMajor)
+                       && (Derived::SizeAtCompileTime == Dynamic
+                           || Derived::SizeAtCompileTime >= 4 * packet_traits<typename Derived::Scalar>::size)>
+struct minmax_coeff_impl
+{
+  typedef typename Derived::Index Index;
+  typedef typename Derived::Scalar Scalar;
+  typedef typename conditional<IsMax, max_coeff_visitor<Derived>, min_coeff_visitor<Derived> >::type Visitor;
+
+  static inline Scalar run(const Derived& mat, Index& row, Index& col)
+  {
+    Visitor visitor;
+    mat.visit(visitor);
+    row = visitor.row;
+    col = visitor.col;
+    return visitor.res;
+  }
+};
+
+template<typename Derived, bool IsMax>
+struct minmax_coeff_impl<Derived, IsMax, true>
+{
+  typedef typename Derived::Index Index;
+  typedef typename Derived::Scalar Scalar;
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum {
+    PacketSize = packet_traits<Scalar>::size,
+    alignment = bool(Derived::Flags & DirectAccessBit) || bool(Derived::Flags & AlignedBit)
+              ? Aligned : Unaligned
+  };
+
+  static EIGEN_STRONG_INLINE bool better(const Scalar& a, const Scalar& b)
+  { return IsMax ? b < a : a < b; }
+
+  static EIGEN_STRONG_INLINE Packet pbetter(const Packet& a, const Packet& b)
+  { return IsMax ? pcmp_lt(b, a) : pcmp_lt(a, b); }
+
+  static inline Scalar run(const Derived& mat, Index& row, Index& col)
+  {
+    const Index size = mat.size();
+    eigen_assert(size && "you are using an empty matrix");
+    const Index alignedStart = internal::first_aligned(mat);
+    const Index alignedEnd2 = alignedStart + ((size-alignedStart)/(2*PacketSize))*(2*PacketSize);
+
+    Scalar res = mat.coeff(0);
+    Index index = 0;
+    for(Index i = 1; i < alignedStart; ++i)
+      if(better(mat.coeff(i), res)) { res = mat.coeff(i); index = i; }
+
+    // the longest chunks whose positions are exact in Scalar
+    const Index maxChunk = std::numeric_limits<Scalar>::digits < std::numeric_limits<Index>::digits
+                         ? Index(1) << std::numeric_limits<Scalar>::digits
+                         : NumTraits<Index>::highest();
+    const Index chunkSize = (maxChunk / (2*PacketSize)) * (2*PacketSize);
+    const Packet step = pset1<Packet>(Scalar(2*PacketSize));
+    for(Index chunkStart = alignedStart; chunkStart < alignedEnd2; chunkStart += chunkSize)
+    {
+      const Index chunkEnd = (std::min)(alignedEnd2, chunkStart + chunkSize);
+      Packet pos0 = plset<Scalar>(Scalar(0));
+      Packet pos1 = plset<Scalar>(Scalar(PacketSize));
+      Packet index0 = pset1<Packet>(Scalar(-1)), index1 = index0;
+      Packet res0 = pset1<Packet>(res), res1 = res0;
+      for(Index i = chunkStart; i < chunkEnd; i += 2*PacketSize, pos0 = padd(pos0, step), pos1 = padd(pos1, step))
+      {
+        Packet p0 = mat.template packet<alignment>(i);
+        Packet p1 = mat.template packet<alignment>(i + PacketSize);
+        Packet mask0 = pbetter(p0, res0);
+        Packet mask1 = pbetter(p1, res1);
+        res0 = pselect(mask0, p0, res0);
+        res1 = pselect(mask1, p1, res1);
+        index0 = pselect(mask0, pos0, index0);
+        index1 = pselect(mask1, pos1, index1);
+      }
+
+      EIGEN_ALIGN16 Scalar values[2*PacketSize];
+      EIGEN_ALIGN16 Scalar positions[2*PacketSize];
+      pstore(values, res0);
+      pstore(values + PacketSize, res1);
+      pstore(positions, index0);
+      pstore(positions + PacketSize, index1);
+      for(int k = 0; k < 2*PacketSize; ++k)
+      {
+        if(positions[k] < Scalar(0)) continue;
+        Index i = chunkStart + Index(positions[k]);
+        if(better(values[k], res) || (values[k] == res && i < index)) { res = values[k]; index = i; }
+      }
+    }
+
+    for(Index i = (std::max)(alignedEnd2, Index(1)); i < size; ++i)
+      if(better(mat.coeff(i), res)) { res = mat.coeff(i); index = i; }
+
+    row = index % mat.rows();
+    col = index / mat.rows();
+    return res;
+  }
+};
+
 } // end namespace internal
 
 /** \returns the minimum of all coefficients of *this and puts in *row and *col its location.
@@ -174,11 +287,11 @@ template<typename IndexType>
 typename internal::traits<Derived>::Scalar
 DenseBase<Derived>::minCoeff(IndexType* rowId, IndexType* colId) const
 {
-  internal::min_coeff_visitor<Derived> minVisitor;
-  this->visit(minVisitor);
-  *rowId = minVisitor.row;
-  if (colId) *colId = minVisitor.col;
-  return minVisitor.res;
+  Index row, col;
+  Scalar res = internal::minmax_coeff_impl<Derived, false>::run(derived(), row, col);
+  *rowId = row;
+  if (colId) *colId = col;
+  return res;
 }
 
 /** \returns the minimum of all coefficients of *this and puts in *index its location.
@@ -192,10 +305,10 @@ typename internal::traits<Derived>::Scalar
 DenseBase<Derived>::minCoeff(IndexType* index) const
 {
   EIGEN_STATIC_ASSERT_VECTOR_ONLY(Derived)
-  internal::min_coeff_visitor<Derived> minVisitor;
-  this->visit(minVisitor);
-  *index = (RowsAtCompileTime==1) ? minVisitor.col : minVisitor.row;
-  return minVisitor.res;
+  Index row, col;
+  Scalar res = internal::minmax_coeff_impl<Derived, false>::run(derived(), row, col);
+  *index = (RowsAtCompileTime==1) ? col : row;
+  return res;
 }
 
 /** \returns the maximum of all coefficients of *this and puts in *row and *col its location.
@@ -208,11 +321,11 @@ template<typename IndexType>
 typename internal::traits<Derived>::Scalar
 DenseBase<Derived>::maxCoeff(IndexType* rowPtr, IndexType* colPtr) const
 {
-  internal::max_coeff_visitor<Derived> maxVisitor;
-  this->visit(maxVisitor);
-  *rowPtr = maxVisitor.row;
-  if (colPtr) *colPtr = maxVisitor.col;
-  return maxVisitor.res;
+  Index row, col;
+  Scalar res = internal::minmax_coeff_impl<Derived, true>::run(derived(), row, col);
+  *rowPtr = row;
+  if (colPtr) *colPtr = col;
+  return res;
 }
 
 /** \returns the maximum of all coefficients of *this and puts in *index its location.
@@ -226,10 +339,10 @@ typename internal::traits<Derived>::Scalar
 DenseBase<Derived>::maxCoeff(IndexType* index) const
 {
   EIGEN_STATIC_ASSERT_VECTOR_ONLY(Derived)
-  internal::max_coeff_visitor<Derived> maxVisitor;
-  this->visit(maxVisitor);
-  *index = (RowsAtCompileTime==1) ? maxVisitor.col : maxVisitor.row;
-  return maxVisitor.res;
+  Index row, col;
+  Scalar res = internal::minmax_coeff_impl<Derived, true>::run(derived(), row, col);
+  *index = (RowsAtCompileTime==1) ? col : row;
+  return res;
 }
 
 } // end namespace Eigen
@@ -0,0 +1,182 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BFLOAT16_H
+#define EIGEN_BFLOAT16_H
+
+namespace Eigen {
+
+struct bfloat16;
+
+namespace internal {
+
+EIGEN_STRONG_INLINE bfloat16 raw_uint16_to_bfloat16(unsigned short x);
+
+/** \internal \returns the upper 16 bits of the float \a ff, rounded to nearest even */
+EIGEN_STRONG_INLINE unsigned short float_to_bfloat16_rtne(float ff)
+{
+  unsigned int f;
+  std::memcpy(&f, &ff, sizeof(float));
+  // keep NaNs quiet, the rounding could turn them into infinities
+  if((f & 0x7fffffffu) > 0x7f800000u)
+    return static_cast<unsigned short>((f >> 16) | 0x0040u);
+  f += 0x7fffu + ((f >> 16) & 1u);
+  return static_cast<unsigned short>(f >> 16);
+}
+
+/** \internal \returns the float value of the bfloat16 number \a h */
+EIGEN_STRONG_INLINE float bfloat16_to_float(unsigned short h)
+{
+  const unsigned int f = static_cast<unsigned int>(h) << 16;
+  float res;
+  std::memcpy(&res, &f, sizeof(float));
+  return res;
+}
+
+} // end namespace internal
+
+/** \class bfloat16
+  * \ingroup Core_Module
+  *
+  * \brief Brain floating point scalar type, i.e., a float truncated to its 16 upper bits
+  *
+  * A bfloat16 has the 8 exponent bits of a float, and hence its range, but only 7 mantissa bits,
+  * giving about 2 significant decimal digits. Like half, with which it shares its interface, it halves
+  * the memory footprint of matrices whose precision requirements are low.
+  *
+  * The conversion from float rounds to nearest even. The arithmetic operators, the vectorization
+  * and the matrix products follow class half.
+  *
+  * \sa class half
+  */
+struct bfloat16
+{
+  bfloat16() {}
+  explicit bfloat16(float f) : x(internal::float_to_bfloat16_rtne(f)) {}
+
+  operator float() const { return internal::bfloat16_to_float(x); }
+
+  bfloat16& operator+=(const bfloat16& other) { return *this = bfloat16(float(*this) + float(other)); }
+  bfloat16& operator-=(const bfloat16& other) { return *this = bfloat16(float(*this) - float(other)); }
+  bfloat16& operator*=(const bfloat16& other) { return *this = bfloat16(float(*this) * float(other)); }
+  bfloat16& operator/=(const bfloat16& other) { return *this = bfloat16(float(*this) / float(other)); }
+
+  /** the upper 16 bits of the float representation */
+  unsigned short x;
+};
+
+namespace internal {
+
+EIGEN_STRONG_INLINE bfloat16 raw_uint16_to_bfloat16(unsigned short x)
+{
+  bfloat16 h;
+  h.x = x;
+  return h;
+}
+
+} // end namespace internal
+
+inline bfloat16 operator+(const bfloat16& a, const bfloat16& b) { return bfloat16(float(a) + float(b)); }
+inline bfloat16 operator-(const bfloat16& a, const bfloat16& b) { return bfloat16(float(a) - float(b)); }
+inline bfloat16 operator*(const bfloat16& a, const bfloat16& b) { return bfloat16(float(a) * float(b)); }
+inline bfloat16 operator/(const bfloat16& a, const bfloat16& b) { return bfloat16(float(a) / float(b)); }
+inline bfloat16 operator-(const bfloat16& a) { return internal::raw_uint16_to_bfloat16(static_cast<unsigned short>(a.x ^ 0x8000)); }
+
+inline bool operator==(const bfloat16& a, const bfloat16& b) { return float(a) == float(b); }
+inline bool operator!=(const bfloat16& a, const bfloat16& b) { return float(a) != float(b); }
+inline bool operator< (const bfloat16& a, const bfloat16& b) { return float(a) <  float(b); }
+inline bool operator<=(const bfloat16& a, const bfloat16& b) { return float(a) <= float(b); }
+inline bool operator> (const bfloat16& a, const bfloat16& b) { return float(a) >  float(b); }
+inline bool operator>=(const bfloat16& a, const bfloat16& b) { return float(a) >= float(b); }
+
+inline std::ostream& operator<<(std::ostream& os, const bfloat16& h) { return os << float(h); }
+
+inline bfloat16 abs(const bfloat16& a) { return internal::raw_uint16_to_bfloat16(static_cast<unsigned short>(a.x & 0x7fff)); }
+inline bfloat16 sqrt(const bfloat16& a)  { return bfloat16(std::sqrt(float(a))); }
+inline bfloat16 exp(const bfloat16& a)   { return bfloat16(std::exp(float(a))); }
+inline bfloat16 log(const bfloat16& a)   { return bfloat16(std::log(float(a))); }
+inline bfloat16 sin(const bfloat16& a)   { return bfloat16(std::sin(float(a))); }
+inline bfloat16 cos(const bfloat16& a)   { return bfloat16(std::cos(float(a))); }
+inline bfloat16 tan(const bfloat16& a)   { return bfloat16(std::tan(float(a))); }
+inline bfloat16 asin(const bfloat16& a)  { return bfloat16(std::asin(float(a))); }
+inline bfloat16 acos(const bfloat16& a)  { return bfloat16(std::acos(float(a))); }
+inline bfloat16 atan(const bfloat16& a)  { return bfloat16(std::atan(float(a))); }
+inline bfloat16 tanh(const bfloat16& a)  { return bfloat16(std::tanh(float(a))); }
+inline bfloat16 floor(const bfloat16& a) { return bfloat16(std::floor(float(a))); }
+inline bfloat16 ceil(const bfloat16& a)  { return bfloat16(std::ceil(float(a))); }
+inline bfloat16 pow(const bfloat16& a, const bfloat16& b) { return bfloat16(std::pow(float(a), float(b))); }
+inline bool (isnan)(const bfloat16& a) { return (a.x & 0x7fff) > 0x7f80; }
+inline bool (isinf)(const bfloat16& a) { return (a.x & 0x7fff) == 0x7f80; }
+
+} // end namespace Eigen
+
+namespace std {
+
+template<>
+class numeric_limits<Eigen::bfloat16>
+{
+  public:
+    static const bool is_specialized = true;
+    static const bool is_signed = true;
+    static const bool is_integer = false;
+    static const bool is_exact = false;
+    static const bool has_infinity = true;
+    static const bool has_quiet_NaN = true;
+    static const bool has_signaling_NaN = true;
+    static const float_denorm_style has_denorm = denorm_present;
+    static const bool has_denorm_loss = false;
+    static const float_round_style round_style = round_to_nearest;
+    static const bool is_iec559 = false;
+    static const bool is_bounded = true;
+    static const bool is_modulo = false;
+    static const int digits = 8;
+    static const int digits10 = 2;
+    static const int radix = 2;
+    static const int min_exponent = -125;
+    static const int min_exponent10 = -37;
+    static const int max_exponent = 128;
+    static const int max_exponent10 = 38;
+    static const bool traps = false;
+    static const bool tinyness_before = false;
+
+    static Eigen::bfloat16 (min)() { return Eigen::internal::raw_uint16_to_bfloat16(0x0080); }
+    static Eigen::bfloat16 (max)() { return Eigen::internal::raw_uint16_to_bfloat16(0x7f7f); }
+    static Eigen::bfloat16 epsilon() { return Eigen::internal::raw_uint16_to_bfloat16(0x3c00); }
+    static Eigen::bfloat16 round_error() { return Eigen::internal::raw_uint16_to_bfloat16(0x3f00); }
+    static Eigen::bfloat16 infinity() { return Eigen::internal::raw_uint16_to_bfloat16(0x7f80); }
+    static Eigen::bfloat16 quiet_NaN() { return Eigen::internal::raw_uint16_to_bfloat16(0x7fc0); }
+    static Eigen::bfloat16 signaling_NaN() { return Eigen::internal::raw_uint16_to_bfloat16(0x7f81); }
+    static Eigen::bfloat16 denorm_min() { return Eigen::internal::raw_uint16_to_bfloat16(0x0001); }
+};
+
+} // end namespace std
+
+namespace Eigen {
+
+template<> struct NumTraits<bfloat16>
+  : GenericNumTraits<bfloat16>
+{
+  enum {
+    RequireInitialization = 0
+  };
+
+  static inline bfloat16 dummy_precision() { return bfloat16(5e-2f); }
+};
+
+namespace internal {
+
+template<> struct random_impl<bfloat16>
+{
+  static inline bfloat16 run(const bfloat16& x, const bfloat16& y) { return bfloat16(random<float>(float(x), float(y))); }
+  static inline bfloat16 run() { return run(bfloat16(-1.f), bfloat16(1.f)); }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_BFLOAT16_H
@@ -0,0 +1,245 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_HALF_H
+#define EIGEN_HALF_H
+
+namespace Eigen {
+
+struct half;
+
+namespace internal {
+
+EIGEN_STRONG_INLINE half raw_uint16_to_half(unsigned short x);
+
+/** \internal \returns the IEEE 754 binary16 representation of \a ff, rounded to nearest even */
+EIGEN_STRONG_INLINE unsigned short float_to_half_rtne(float ff)
+{
+#ifdef EIGEN_VECTORIZE_F16C
+  return static_cast<unsigned short>(_cvtss_sh(ff, 0));
+#else
+  const unsigned int f32infty = 255u << 23;
+  const unsigned int f16max = (127u + 16u) << 23;
+  const unsigned int denorm_magic_bits = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+  float denorm_magic;
+  std::memcpy(&denorm_magic, &denorm_magic_bits, sizeof(float));
+
+  unsigned int f;
+  std::memcpy(&f, &ff, sizeof(float));
+  const unsigned int sign = f & 0x80000000u;
+  f ^= sign;
+
+  unsigned short o;
+  if(f >= f16max)
+  {
+    // overflows and infinities to infinity, NaNs to a quiet NaN
+    o = (f > f32infty) ? 0x7e00 : 0x7c00;
+  }
+  else if(f < (113u << 23))
+  {
+    // the result is subnormal or zero: the addition performs the rounding
+    float af;
+    std::memcpy(&af, &f, sizeof(float));
+    af += denorm_magic;
+    std::memcpy(&f, &af, sizeof(float));
+    o = static_cast<unsigned short>(f - denorm_magic_bits);
+  }
+  else
+  {
+    // rebias the exponent and round the mantissa, ties to even
+    const unsigned int mant_odd = (f >> 13) & 1u;
+    f += (static_cast<unsigned int>(15 - 127) << 23) + 0xfffu;
+    f += mant_odd;
+    o = static_cast<unsigned short>(f >> 13);
+  }
+  return static_cast<unsigned short>(o | (sign >> 16));
+#endif
+}
+
+/** \internal \returns the float value of the IEEE 754 binary16 number \a h */
+EIGEN_STRONG_INLINE float half_to_float(unsigned short h)
+{
+#ifdef EIGEN_VECTORIZE_F16C
+  return _cvtsh_ss(h);
+#else
+  const unsigned int shifted_exp = 0x7c00u << 13;
+  unsigned int o = (h & 0x7fffu) << 13;
+  const unsigned int exp = shifted_exp & o;
+  o += (127u - 15u) << 23;
+
+  if(exp == shifted_exp)
+  {
+    // infinity or NaN
+    o += (128u - 16u) << 23;
+  }
+  else if(exp == 0)
+  {
+    // zero or subnormal: renormalize through a float subtraction
+    const unsigned int magic_bits = 113u << 23;
+    float magic, of;
+    o += 1u << 23;
+    std::memcpy(&magic, &magic_bits, sizeof(float));
+    std::memcpy(&of, &o, sizeof(float));
+    of -= magic;
+    std::memcpy(&o, &of, sizeof(float));
+  }
+  o |= (h & 0x8000u) << 16;
+
+  float res;
+  std::memcpy(&res, &o, sizeof(float));
+  return res;
+#endif
+}
+
+} // end namespace internal
+
+/** \class half
+  * \ingroup Core_Module
+  *
+  * \brief IEEE 754 half precision floating point scalar type
+  *
+  * A half stores a binary16 number: 1 sign bit, 5 exponent bits and 10 mantissa bits, giving about
+  * 3 significant decimal digits in the range [6e-5, 65504]. It is meant to halve the memory footprint
+  * of large matrices whose precision requirements are low, such as the weights of neural networks.
+  *
+  * The arithmetic operators convert their operands to float, and round the result back to half.
+  * A half converts implicitly to float, while the conversion from float, which rounds to nearest even,
+  * is explicit. When SSE is enabled, the coefficient-wise operations, the reductions and the conversions
+  * from and to float, i.e. cast<float>() and cast<half>(), are vectorized, using the F16C instructions when
+  * they are available (e.g., -mf16c). The matrix products of half matrices read the 16-bit operands
+  * and accumulate in float.
+  *
+  * \sa class bfloat16
+  */
+struct half
+{
+  half() {}
+  explicit half(float f) : x(internal::float_to_half_rtne(f)) {}
+
+  operator float() const { return internal::half_to_float(x); }
+
+  half& operator+=(const half& other) { return *this = half(float(*this) + float(other)); }
+  half& operator-=(const half& other) { return *this = half(float(*this) - float(other)); }
+  half& operator*=(const half& other) { return *this = half(float(*this) * float(other)); }
+  half& operator/=(const half& other) { return *this = half(float(*this) / float(other)); }
+
+  /** the binary16 representation */
+  unsigned short x;
+};
+
+namespace internal {
+
+EIGEN_STRONG_INLINE half raw_uint16_to_half(unsigned short x)
+{
+  half h;
+  h.x = x;
+  return h;
+}
+
+} // end namespace internal
+
+inline half operator+(const half& a, const half& b) { return half(float(a) + float(b)); }
+inline half operator-(const half& a, const half& b) { return half(float(a) - float(b)); }
+inline half operator*(const half& a, const half& b) { return half(float(a) * float(b)); }
+inline half operator/(const half& a, const half& b) { return half(float(a) / float(b)); }
+inline half operator-(const half& a) { return internal::raw_uint16_to_half(static_cast<unsigned short>(a.x ^ 0x8000)); }
+
+inline bool operator==(const half& a, const half& b) { return float(a) == float(b); }
+inline bool operator!=(const half& a, const half& b) { return float(a) != float(b); }
+inline bool operator< (const half& a, const half& b) { return float(a) <  float(b); }
+inline bool operator<=(const half& a, const half& b) { return float(a) <= float(b); }
+inline bool operator> (const half& a, const half& b) { return float(a) >  float(b); }
+inline bool operator>=(const half& a, const half& b) { return float(a) >= float(b); }
+
+inline std::ostream& operator<<(std::ostream& os, const half& h) { return os << float(h); }
+
+// Math functions found by argument dependent lookup, e.g., after a "using std::sqrt".
+inline half abs(const half& a) { return internal::raw_uint16_to_half(static_cast<unsigned short>(a.x & 0x7fff)); }
+inline half sqrt(const half& a)  { return half(std::sqrt(float(a))); }
+inline half exp(const half& a)   { return half(std::exp(float(a))); }
+inline half log(const half& a)   { return half(std::log(float(a))); }
+inline half sin(const half& a)   { return half(std::sin(float(a))); }
+inline half cos(const half& a)   { return half(std::cos(float(a))); }
+inline half tan(const half& a)   { return half(std::tan(float(a))); }
+inline half asin(const half& a)  { return half(std::asin(float(a))); }
+inline half acos(const half& a)  { return half(std::acos(float(a))); }
+inline half atan(const half& a)  { return half(std::atan(float(a))); }
+inline half tanh(const half& a)  { return half(std::tanh(float(a))); }
+inline half floor(const half& a) { return half(std::floor(float(a))); }
+inline half ceil(const half& a)  { return half(std::ceil(float(a))); }
+inline half pow(const half& a, const half& b) { return half(std::pow(float(a), float(b))); }
+inline bool (isnan)(const half& a) { return (a.x & 0x7fff) > 0x7c00; }
+inline bool (isinf)(const half& a) { return (a.x & 0x7fff) == 0x7c00; }
+
+} // end namespace Eigen
+
+namespace std {
+
+template<>
+class numeric_limits<Eigen::half>
+{
+  public:
+    static const bool is_specialized = true;
+    static const bool is_signed = true;
+    static const bool is_integer = false;
+    static const bool is_exact = false;
+    static const bool has_infinity = true;
+    static const bool has_quiet_NaN = true;
+    static const bool has_signaling_NaN = true;
+    static const float_denorm_style has_denorm = denorm_present;
+    static const bool has_denorm_loss = false;
+    static const float_round_style round_style = round_to_nearest;
+    static const bool is_iec559 = false;
+    static const bool is_bounded = true;
+    static const bool is_modulo = false;
+    static const int digits = 11;
+    static const int digits10 = 3;
+    static const int radix = 2;
+    static const int min_exponent = -13;
+    static const int min_exponent10 = -4;
+    static const int max_exponent = 16;
+    static const int max_exponent10 = 4;
+    static const bool traps = false;
+    static const bool tinyness_before = false;
+
+    static Eigen::half (min)() { return Eigen::internal::raw_uint16_to_half(0x0400); }
+    static Eigen::half (max)() { return Eigen::internal::raw_uint16_to_half(0x7bff); }
+    static Eigen::half epsilon() { return Eigen::internal::raw_uint16_to_half(0x1400); }
+    static Eigen::half round_error() { return Eigen::internal::raw_uint16_to_half(0x3800); }
+    static Eigen::half infinity() { return Eigen::internal::raw_uint16_to_half(0x7c00); }
+    static Eigen::half quiet_NaN() { return Eigen::internal::raw_uint16_to_half(0x7e00); }
+    static Eigen::half signaling_NaN() { return Eigen::internal::raw_uint16_to_half(0x7d00); }
+    static Eigen::half denorm_min() { return Eigen::internal::raw_uint16_to_half(0x0001); }
+};
+
+} // end namespace std
+
+namespace Eigen {
+
+template<> struct NumTraits<half>
+  : GenericNumTraits<half>
+{
+  enum {
+    RequireInitialization = 0
+  };
+
+  static inline half dummy_precision() { return half(1e-2f); }
+};
+
+namespace internal {
+
+template<> struct random_impl<half>
+{
+  static inline half run(const half& x, const half& y) { return half(random<float>(float(x), float(y))); }
+  static inline half run() { return run(half(-1.f), half(1.f)); }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_HALF_H
@@ -0,0 +1,241 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_HALF_PACKET_MATH_SSE_H
+#define EIGEN_HALF_PACKET_MATH_SSE_H
+
+namespace Eigen {
+
+namespace internal {
+
+// The packets of four 16-bit floats only use the low 64 bits of a __m128i, such that they
+// match the size of a Packet4f: all the arithmetic is done in single precision.
+typedef eigen_packet_wrapper<__m128i, 4> Packet4h;
+typedef eigen_packet_wrapper<__m128i, 5> Packet4bf;
+
+template<> struct packet_traits<half> : default_packet_traits
+{
+  typedef Packet4h type;
+  enum {
+    Vectorizable = 1,
+    AlignedOnScalar = 1,
+    size=4,
+
+    HasDiv = 1
+  };
+};
+template<> struct packet_traits<bfloat16> : default_packet_traits
+{
+  typedef Packet4bf type;
+  enum {
+    Vectorizable = 1,
+    AlignedOnScalar = 1,
+    size=4,
+
+    HasDiv = 1
+  };
+};
+
+template<> struct unpacket_traits<Packet4h>  { typedef half     type; enum {size=4}; };
+template<> struct unpacket_traits<Packet4bf> { typedef bfloat16 type; enum {size=4}; };
+
+// packs the low 16 bits of the four 32-bit words of a into its low 64 bits
+EIGEN_STRONG_INLINE __m128i pack_low_words(const __m128i& a)
+{
+#ifdef EIGEN_VECTORIZE_SSE4_1
+  return _mm_packus_epi32(_mm_and_si128(a, _mm_set1_epi32(0xffff)), _mm_setzero_si128());
+#else
+  return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16), _mm_setzero_si128());
+#endif
+}
+
+EIGEN_STRONG_INLINE Packet4f half2float(const Packet4h& a)
+{
+#ifdef EIGEN_VECTORIZE_F16C
+  return _mm_cvtph_ps(a);
+#else
+  const __m128i h = _mm_unpacklo_epi16(a, _mm_setzero_si128());
+  const __m128i expmant = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+  const __m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expmant), 16);
+  // scaling the shifted exponent and mantissa by 2^112 rebiases the exponent, and normalizes the subnormals
+  const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expmant, 13)), _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23)));
+  // infinities and NaNs get the maximal exponent
+  const __m128i infnan = _mm_and_si128(_mm_cmpgt_epi32(expmant, _mm_set1_epi32(0x7bff)), _mm_set1_epi32(255 << 23));
+  return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infnan)));
+#endif
+}
+
+// rounds to nearest even, like float_to_half_rtne()
+EIGEN_STRONG_INLINE Packet4h float2half(const Packet4f& a)
+{
+#ifdef EIGEN_VECTORIZE_F16C
+  return _mm_cvtps_ph(a, 0);
+#else
+  const __m128i f = _mm_castps_si128(a);
+  const __m128i justsign = _mm_and_si128(f, _mm_set1_epi32(0x80000000));
+  const __m128i absf = _mm_xor_si128(f, justsign);
+  const __m128 absf_ps = _mm_castsi128_ps(absf);
+
+  // overflows become infinities, and NaNs quiet NaNs
+  const __m128i is_nan = _mm_castps_si128(_mm_cmpunord_ps(absf_ps, absf_ps));
+  const __m128i is_regular = _mm_cmpgt_epi32(_mm_set1_epi32((127 + 16) << 23), absf);
+  const __m128i inf_or_nan = _mm_or_si128(_mm_and_si128(is_nan, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7c00));
+
+  // subnormal results: the float addition does the rounding
+  const __m128i subnorm_magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+  const __m128i is_sub = _mm_cmpgt_epi32(_mm_set1_epi32(113 << 23), absf);
+  const __m128i subnorm = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absf_ps, _mm_castsi128_ps(subnorm_magic))), subnorm_magic);
+
+  // normal results: rebias the exponent and round the mantissa, adding one more when its last kept bit is odd
+  const __m128i mant_odd = _mm_srai_epi32(_mm_slli_epi32(absf, 31 - 13), 31);
+  const __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(absf, _mm_set1_epi32(0xfff - ((127 - 15) << 23))), mant_odd), 13);
+
+  const __m128i finite = _mm_or_si128(_mm_and_si128(is_sub, subnorm), _mm_andnot_si128(is_sub, normal));
+  const __m128i res = _mm_or_si128(_mm_and_si128(is_regular, finite), _mm_andnot_si128(is_regular, inf_or_nan));
+  return pack_low_words(_mm_or_si128(res, _mm_srli_epi32(justsign, 16)));
+#endif
+}
+
+EIGEN_STRONG_INLINE Packet4f bf16_to_float(const Packet4bf& a)
+{
+  return _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), a));
+}
+
+// rounds to nearest even, like float_to_bfloat16_rtne()
+EIGEN_STRONG_INLINE Packet4bf float_to_bf16(const Packet4f& a)
+{
+  const __m128i f = _mm_castps_si128(a);
+  const __m128i lsb = _mm_and_si128(_mm_srli_epi32(f, 16), _mm_set1_epi32(1));
+  const __m128i rounded = _mm_srli_epi32(_mm_add_epi32(f, _mm_add_epi32(lsb, _mm_set1_epi32(0x7fff))), 16);
+  const __m128i quiet_nan = _mm_or_si128(_mm_srli_epi32(f, 16), _mm_set1_epi32(0x0040));
+  const __m128i is_nan = _mm_castps_si128(_mm_cmpunord_ps(a, a));
+  return pack_low_words(_mm_or_si128(_mm_and_si128(is_nan, quiet_nan), _mm_andnot_si128(is_nan, rounded)));
+}
+
+template<> struct type_casting_traits<half,float>     { enum { VectorizedCast = 1 }; };
+template<> struct type_casting_traits<float,half>     { enum { VectorizedCast = 1 }; };
+template<> struct type_casting_traits<bfloat16,float> { enum { VectorizedCast = 1 }; };
+template<> struct type_casting_traits<float,bfloat16> { enum { VectorizedCast = 1 }; };
+
+template<> EIGEN_STRONG_INLINE Packet4f  pcast<Packet4h,Packet4f>(const Packet4h& a)   { return half2float(a); }
+template<> EIGEN_STRONG_INLINE Packet4h  pcast<Packet4f,Packet4h>(const Packet4f& a)   { return float2half(a); }
+template<> EIGEN_STRONG_INLINE Packet4f  pcast<Packet4bf,Packet4f>(const Packet4bf& a) { return bf16_to_float(a); }
+template<> EIGEN_STRONG_INLINE Packet4bf pcast<Packet4f,Packet4bf>(const Packet4f& a)  { return float_to_bf16(a); }
+
+template<> EIGEN_STRONG_INLINE Packet4h  pset1<Packet4h>(const half& from)      { return _mm_set1_epi16(static_cast<short>(from.x)); }
+template<> EIGEN_STRONG_INLINE Packet4bf pset1<Packet4bf>(const bfloat16& from) { return _mm_set1_epi16(static_cast<short>(from.x)); }
+
+template<> EIGEN_STRONG_INLINE Packet4h  plset<half>(const half& a)         { return float2half(plset<float>(float(a))); }
+template<> EIGEN_STRONG_INLINE Packet4bf plset<bfloat16>(const bfloat16& a) { return float_to_bf16(plset<float>(float(a))); }
+
+template<> EIGEN_STRONG_INLINE Packet4h padd<Packet4h>(const Packet4h& a, const Packet4h& b) { return float2half(padd(half2float(a), half2float(b))); }
+template<> EIGEN_STRONG_INLINE Packet4h psub<Packet4h>(const Packet4h& a, const Packet4h& b) { return float2half(psub(half2float(a), half2float(b))); }
+template<> EIGEN_STRONG_INLINE Packet4h pmul<Packet4h>(const Packet4h& a, const Packet4h& b) { return float2half(pmul(half2float(a), half2float(b))); }
+template<> EIGEN_STRONG_INLINE Packet4h pdiv<Packet4h>(const Packet4h& a, const Packet4h& b) { return float2half(pdiv(half2float(a), half2float(b))); }
+template<> EIGEN_STRONG_INLINE Packet4h pmin<Packet4h>(const Packet4h& a, const Packet4h& b) { return float2half(pmin(half2float(a), half2float(b))); }
+template<> EIGEN_STRONG_INLINE Packet4h pmax<Packet4h>(const Packet4h& a, const Packet4h& b) { return float2half(pmax(half2float(a), half2float(b))); }
+template<> EIGEN_STRONG_INLINE Packet4h pmadd(const Packet4h& a, const Packet4h& b, const Packet4h& c)
+{ return float2half(pmadd(half2float(a), half2float(b), half2float(c))); }
+
+template<> EIGEN_STRONG_INLINE Packet4bf padd<Packet4bf>(const Packet4bf& a, const Packet4bf& b) { return float_to_bf16(padd(bf16_to_float(a), bf16_to_float(b))); }
+template<> EIGEN_STRONG_INLINE Packet4bf psub<Packet4bf>(const Packet4bf& a, const Packet4bf& b) { return float_to_bf16(psub(bf16_to_float(a), bf16_to_float(b))); }
+template<> EIGEN_STRONG_INLINE Packet4bf pmul<Packet4bf>(const Packet4bf& a, const Packet4bf& b) { return float_to_bf16(pmul(bf16_to_float(a), bf16_to_float(b))); }
+template<> EIGEN_STRONG_INLINE Packet4bf pdiv<Packet4bf>(const Packet4bf& a, const Packet4bf& b) { return float_to_bf16(pdiv(bf16_to_float(a), bf16_to_float(b))); }
+template<> EIGEN_STRONG_INLINE Packet4bf pmin<Packet4bf>(const Packet4bf& a, const Packet4bf& b) { return float_to_bf16(pmin(bf16_to_float(a), bf16_to_float(b))); }
+template<> EIGEN_STRONG_INLINE Packet4bf pmax<Packet4bf>(const Packet4bf& a, const Packet4bf& b) { return float_to_bf16(pmax(bf16_to_float(a), bf16_to_float(b))); }
+template<> EIGEN_STRONG_INLINE Packet4bf pmadd(const Packet4bf& a, const Packet4bf& b, const Packet4bf& c)
+{ return float_to_bf16(pmadd(bf16_to_float(a), bf16_to_float(b), bf16_to_float(c))); }
+
+// the sign bit is handled directly
+template<> EIGEN_STRONG_INLINE Packet4h  pnegate(const Packet4h& a)  { return _mm_xor_si128(a, _mm_set1_epi16(-0x8000)); }
+template<> EIGEN_STRONG_INLINE Packet4bf pnegate(const Packet4bf& a) { return _mm_xor_si128(a, _mm_set1_epi16(-0x8000)); }
+
+template<> EIGEN_STRONG_INLINE Packet4h  pconj(const Packet4h& a)  { return a; }
+template<> EIGEN_STRONG_INLINE Packet4bf pconj(const Packet4bf& a) { return a; }
+
+template<> EIGEN_STRONG_INLINE Packet4h  pabs(const Packet4h& a)  { return _mm_and_si128(a, _mm_set1_epi16(0x7fff)); }
+template<> EIGEN_STRONG_INLINE Packet4bf pabs(const Packet4bf& a) { return _mm_and_si128(a, _mm_set1_epi16(0x7fff)); }
+
+// the 64 bits loads and stores only require the alignment of the scalars
+template<> EIGEN_STRONG_INLINE Packet4h  pload<Packet4h>(const half* from)       { EIGEN_DEBUG_ALIGNED_LOAD return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(from)); }
+template<> EIGEN_STRONG_INLINE Packet4bf pload<Packet4bf>(const bfloat16* from)  { EIGEN_DEBUG_ALIGNED_LOAD return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(from)); }
+template<> EIGEN_STRONG_INLINE Packet4h  ploadu<Packet4h>(const half* from)      { EIGEN_DEBUG_UNALIGNED_LOAD return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(from)); }
+template<> EIGEN_STRONG_INLINE Packet4bf ploadu<Packet4bf>(const bfloat16* from) { EIGEN_DEBUG_UNALIGNED_LOAD return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(from)); }
+
+template<> EIGEN_STRONG_INLINE Packet4h ploaddup<Packet4h>(const half* from)
+{
+  __m128i tmp = _mm_cvtsi32_si128(int(from[0].x | (unsigned(from[1].x) << 16)));
+  return _mm_unpacklo_epi16(tmp, tmp);
+}
+template<> EIGEN_STRONG_INLINE Packet4bf ploaddup<Packet4bf>(const bfloat16* from)
+{
+  __m128i tmp = _mm_cvtsi32_si128(int(from[0].x | (unsigned(from[1].x) << 16)));
+  return _mm_unpacklo_epi16(tmp, tmp);
+}
+
+template<> EIGEN_STRONG_INLINE void pstore<half>(half* to, const Packet4h& from)              { EIGEN_DEBUG_ALIGNED_STORE _mm_storel_epi64(reinterpret_cast<__m128i*>(to), from); }
+template<> EIGEN_STRONG_INLINE void pstore<bfloat16>(bfloat16* to, const Packet4bf& from)    { EIGEN_DEBUG_ALIGNED_STORE _mm_storel_epi64(reinterpret_cast<__m128i*>(to), from); }
+template<> EIGEN_STRONG_INLINE void pstoreu<half>(half* to, const Packet4h& from)            { EIGEN_DEBUG_UNALIGNED_STORE _mm_storel_epi64(reinterpret_cast<__m128i*>(to), from); }
+template<> EIGEN_STRONG_INLINE void pstoreu<bfloat16>(bfloat16* to, const Packet4bf& from)   { EIGEN_DEBUG_UNALIGNED_STORE _mm_storel_epi64(reinterpret_cast<__m128i*>(to), from); }
+
+template<> EIGEN_STRONG_INLINE void prefetch<half>(const half* addr)         { _mm_prefetch((const char*)(addr), _MM_HINT_T0); }
+template<> EIGEN_STRONG_INLINE void prefetch<bfloat16>(const bfloat16* addr) { _mm_prefetch((const char*)(addr), _MM_HINT_T0); }
+
+template<> EIGEN_STRONG_INLINE half     pfirst<Packet4h>(const Packet4h& a)   { return raw_uint16_to_half(static_cast<unsigned short>(_mm_cvtsi128_si32(a))); }
+template<> EIGEN_STRONG_INLINE bfloat16 pfirst<Packet4bf>(const Packet4bf& a) { return raw_uint16_to_bfloat16(static_cast<unsigned short>(_mm_cvtsi128_si32(a))); }
+
+template<> EIGEN_STRONG_INLINE Packet4h  preverse(const Packet4h& a)  { return _mm_shufflelo_epi16(a, 0x1B); }
+template<> EIGEN_STRONG_INLINE Packet4bf preverse(const Packet4bf& a) { return _mm_shufflelo_epi16(a, 0x1B); }
+
+// the coefficients of a packet are reduced in single precision, with a single final rounding, but
+// the packets accumulated by padd in the reductions of longer expressions are rounded at each step
+template<> EIGEN_STRONG_INLINE half predux<Packet4h>(const Packet4h& a)     { return half(predux(half2float(a))); }
+template<> EIGEN_STRONG_INLINE half predux_mul<Packet4h>(const Packet4h& a) { return half(predux_mul(half2float(a))); }
+template<> EIGEN_STRONG_INLINE half predux_min<Packet4h>(const Packet4h& a) { return half(predux_min(half2float(a))); }
+template<> EIGEN_STRONG_INLINE half predux_max<Packet4h>(const Packet4h& a) { return half(predux_max(half2float(a))); }
+template<> EIGEN_STRONG_INLINE Packet4h preduxp<Packet4h>(const Packet4h* vecs)
+{
+  Packet4f tmp[4] = { half2float(vecs[0]), half2float(vecs[1]), half2float(vecs[2]), half2float(vecs[3]) };
+  return float2half(preduxp(tmp));
+}
+
+template<> EIGEN_STRONG_INLINE bfloat16 predux<Packet4bf>(const Packet4bf& a)     { return bfloat16(predux(bf16_to_float(a))); }
+template<> EIGEN_STRONG_INLINE bfloat16 predux_mul<Packet4bf>(const Packet4bf& a) { return bfloat16(predux_mul(bf16_to_float(a))); }
+template<> EIGEN_STRONG_INLINE bfloat16 predux_min<Packet4bf>(const Packet4bf& a) { return bfloat16(predux_min(bf16_to_float(a))); }
+template<> EIGEN_STRONG_INLINE bfloat16 predux_max<Packet4bf>(const Packet4bf& a) { return bfloat16(predux_max(bf16_to_float(a))); }
+template<> EIGEN_STRONG_INLINE Packet4bf preduxp<Packet4bf>(const Packet4bf* vecs)
+{
+  Packet4f tmp[4] = { bf16_to_float(vecs[0]), bf16_to_float(vecs[1]), bf16_to_float(vecs[2]), bf16_to_float(vecs[3]) };
+  return float_to_bf16(preduxp(tmp));
+}
+
+// shifts of the concatenation of the two low 64 bits words
+template<int Offset>
+struct palign_impl<Offset,Packet4h>
+{
+  static EIGEN_STRONG_INLINE void run(Packet4h& first, const Packet4h& second)
+  {
+    if (Offset!=0)
+      first = _mm_or_si128(_mm_srli_epi64(first, 16*Offset), _mm_slli_epi64(second, 16*(4-Offset)));
+  }
+};
+
+template<int Offset>
+struct palign_impl<Offset,Packet4bf>
+{
+  static EIGEN_STRONG_INLINE void run(Packet4bf& first, const Packet4bf& second)
+  {
+    if (Offset!=0)
+      first = _mm_or_si128(_mm_srli_epi64(first, 16*Offset), _mm_slli_epi64(second, 16*(4-Offset)));
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_HALF_PACKET_MATH_SSE_H
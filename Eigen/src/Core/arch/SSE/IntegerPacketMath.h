@@ -0,0 +1,436 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_INTEGER_PACKET_MATH_SSE_H
+#define EIGEN_INTEGER_PACKET_MATH_SSE_H
+
+namespace Eigen {
+
+namespace internal {
+
+// All the integer packets are stored in a __m128i, hence the wrappers making them distinct types.
+// Packet4i remains a plain __m128i.
+typedef eigen_packet_wrapper<__m128i, 1> Packet16uc;
+typedef eigen_packet_wrapper<__m128i, 2> Packet8s;
+
+// 64 bits integers are only vectorized for the 64 bits std::ptrdiff_t of x86-64, which is also Eigen's default index type
+#if EIGEN_ARCH_x86_64 && !defined(__ILP32__)
+#define EIGEN_VECTORIZE_SSE_INT64
+typedef eigen_packet_wrapper<__m128i, 3> Packet2l;
+#endif
+
+template<> struct packet_traits<unsigned char> : default_packet_traits
+{
+  typedef Packet16uc type;
+  enum {
+    Vectorizable = 1,
+    AlignedOnScalar = 1,
+    size=16,
+
+    HasCmp = 1
+  };
+};
+template<> struct packet_traits<short> : default_packet_traits
+{
+  typedef Packet8s type;
+  enum {
+    Vectorizable = 1,
+    AlignedOnScalar = 1,
+    size=8,
+
+    HasCmp = 1
+  };
+};
+
+template<> struct unpacket_traits<Packet16uc> { typedef unsigned char type; enum {size=16}; };
+template<> struct unpacket_traits<Packet8s>   { typedef short         type; enum {size=8}; };
+
+#ifdef EIGEN_VECTORIZE_SSE_INT64
+template<> struct packet_traits<std::ptrdiff_t> : default_packet_traits
+{
+  typedef Packet2l type;
+  enum {
+    Vectorizable = 1,
+    AlignedOnScalar = 1,
+    size=2,
+
+    HasCmp = 1
+  };
+};
+template<> struct unpacket_traits<Packet2l> { typedef std::ptrdiff_t type; enum {size=2}; };
+#endif
+
+template<> EIGEN_STRONG_INLINE Packet16uc pset1<Packet16uc>(const unsigned char& from) { return _mm_set1_epi8(static_cast<char>(from)); }
+template<> EIGEN_STRONG_INLINE Packet8s   pset1<Packet8s>(const short& from)           { return _mm_set1_epi16(from); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc plset<unsigned char>(const unsigned char& a)
+{ return _mm_add_epi8(pset1<Packet16uc>(a), _mm_setr_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15)); }
+template<> EIGEN_STRONG_INLINE Packet8s plset<short>(const short& a)
+{ return _mm_add_epi16(pset1<Packet8s>(a), _mm_setr_epi16(0,1,2,3,4,5,6,7)); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc padd<Packet16uc>(const Packet16uc& a, const Packet16uc& b) { return _mm_add_epi8(a,b); }
+template<> EIGEN_STRONG_INLINE Packet8s   padd<Packet8s>(const Packet8s& a, const Packet8s& b)       { return _mm_add_epi16(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc psub<Packet16uc>(const Packet16uc& a, const Packet16uc& b) { return _mm_sub_epi8(a,b); }
+template<> EIGEN_STRONG_INLINE Packet8s   psub<Packet8s>(const Packet8s& a, const Packet8s& b)       { return _mm_sub_epi16(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc padds<Packet16uc>(const Packet16uc& a, const Packet16uc& b) { return _mm_adds_epu8(a,b); }
+template<> EIGEN_STRONG_INLINE Packet8s   padds<Packet8s>(const Packet8s& a, const Packet8s& b)       { return _mm_adds_epi16(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc psubs<Packet16uc>(const Packet16uc& a, const Packet16uc& b) { return _mm_subs_epu8(a,b); }
+template<> EIGEN_STRONG_INLINE Packet8s   psubs<Packet8s>(const Packet8s& a, const Packet8s& b)       { return _mm_subs_epi16(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc pnegate(const Packet16uc& a) { return _mm_sub_epi8(_mm_setzero_si128(), a); }
+template<> EIGEN_STRONG_INLINE Packet8s   pnegate(const Packet8s& a)   { return _mm_sub_epi16(_mm_setzero_si128(), a); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc pconj(const Packet16uc& a) { return a; }
+template<> EIGEN_STRONG_INLINE Packet8s   pconj(const Packet8s& a)   { return a; }
+
+// SSE has no 8 bits multiplication: the even and odd bytes are multiplied as 16 bits integers
+template<> EIGEN_STRONG_INLINE Packet16uc pmul<Packet16uc>(const Packet16uc& a, const Packet16uc& b)
+{
+  __m128i even = _mm_mullo_epi16(a,b);
+  __m128i odd  = _mm_mullo_epi16(_mm_srli_epi16(a,8), _mm_srli_epi16(b,8));
+  return _mm_or_si128(_mm_slli_epi16(odd,8), _mm_and_si128(even, _mm_set1_epi16(0xFF)));
+}
+template<> EIGEN_STRONG_INLINE Packet8s pmul<Packet8s>(const Packet8s& a, const Packet8s& b) { return _mm_mullo_epi16(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc pmadd(const Packet16uc& a, const Packet16uc& b, const Packet16uc& c) { return padd(pmul(a,b), c); }
+template<> EIGEN_STRONG_INLINE Packet8s   pmadd(const Packet8s& a, const Packet8s& b, const Packet8s& c)       { return padd(pmul(a,b), c); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc pmin<Packet16uc>(const Packet16uc& a, const Packet16uc& b) { return _mm_min_epu8(a,b); }
+template<> EIGEN_STRONG_INLINE Packet8s   pmin<Packet8s>(const Packet8s& a, const Packet8s& b)       { return _mm_min_epi16(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc pmax<Packet16uc>(const Packet16uc& a, const Packet16uc& b) { return _mm_max_epu8(a,b); }
+template<> EIGEN_STRONG_INLINE Packet8s   pmax<Packet8s>(const Packet8s& a, const Packet8s& b)       { return _mm_max_epi16(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc pabs(const Packet16uc& a) { return a; }
+template<> EIGEN_STRONG_INLINE Packet8s pabs(const Packet8s& a)
+{
+#ifdef EIGEN_VECTORIZE_SSSE3
+  return _mm_abs_epi16(a);
+#else
+  return _mm_max_epi16(a, _mm_sub_epi16(_mm_setzero_si128(), a));
+#endif
+}
+
+template<> EIGEN_STRONG_INLINE Packet16uc pand<Packet16uc>(const Packet16uc& a, const Packet16uc& b) { return _mm_and_si128(a,b); }
+template<> EIGEN_STRONG_INLINE Packet8s   pand<Packet8s>(const Packet8s& a, const Packet8s& b)       { return _mm_and_si128(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc por<Packet16uc>(const Packet16uc& a, const Packet16uc& b) { return _mm_or_si128(a,b); }
+template<> EIGEN_STRONG_INLINE Packet8s   por<Packet8s>(const Packet8s& a, const Packet8s& b)       { return _mm_or_si128(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc pxor<Packet16uc>(const Packet16uc& a, const Packet16uc& b) { return _mm_xor_si128(a,b); }
+template<> EIGEN_STRONG_INLINE Packet8s   pxor<Packet8s>(const Packet8s& a, const Packet8s& b)       { return _mm_xor_si128(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc pandnot<Packet16uc>(const Packet16uc& a, const Packet16uc& b) { return _mm_andnot_si128(a,b); }
+template<> EIGEN_STRONG_INLINE Packet8s   pandnot<Packet8s>(const Packet8s& a, const Packet8s& b)       { return _mm_andnot_si128(a,b); }
+
+// the unsigned comparisons rely on min(a,b)==a <=> a<=b
+template<> EIGEN_STRONG_INLINE Packet16uc pcmp_eq<Packet16uc>(const Packet16uc& a, const Packet16uc& b) { return _mm_cmpeq_epi8(a,b); }
+template<> EIGEN_STRONG_INLINE Packet16uc pcmp_le<Packet16uc>(const Packet16uc& a, const Packet16uc& b) { return _mm_cmpeq_epi8(_mm_min_epu8(a,b),a); }
+template<> EIGEN_STRONG_INLINE Packet16uc pcmp_lt<Packet16uc>(const Packet16uc& a, const Packet16uc& b)
+{ return _mm_andnot_si128(_mm_cmpeq_epi8(a,b), _mm_cmpeq_epi8(_mm_min_epu8(a,b),a)); }
+
+template<> EIGEN_STRONG_INLINE Packet8s pcmp_eq<Packet8s>(const Packet8s& a, const Packet8s& b) { return _mm_cmpeq_epi16(a,b); }
+template<> EIGEN_STRONG_INLINE Packet8s pcmp_lt<Packet8s>(const Packet8s& a, const Packet8s& b) { return _mm_cmplt_epi16(a,b); }
+template<> EIGEN_STRONG_INLINE Packet8s pcmp_le<Packet8s>(const Packet8s& a, const Packet8s& b) { return _mm_or_si128(_mm_cmplt_epi16(a,b),_mm_cmpeq_epi16(a,b)); }
+
+#ifdef EIGEN_VECTORIZE_SSE4_1
+template<> EIGEN_STRONG_INLINE Packet16uc pselect<Packet16uc>(const Packet16uc& mask, const Packet16uc& a, const Packet16uc& b) { return _mm_blendv_epi8(b,a,mask); }
+template<> EIGEN_STRONG_INLINE Packet8s   pselect<Packet8s>(const Packet8s& mask, const Packet8s& a, const Packet8s& b)         { return _mm_blendv_epi8(b,a,mask); }
+#else
+template<> EIGEN_STRONG_INLINE Packet16uc pselect<Packet16uc>(const Packet16uc& mask, const Packet16uc& a, const Packet16uc& b) { return _mm_or_si128(_mm_and_si128(mask,a),_mm_andnot_si128(mask,b)); }
+template<> EIGEN_STRONG_INLINE Packet8s   pselect<Packet8s>(const Packet8s& mask, const Packet8s& a, const Packet8s& b)         { return _mm_or_si128(_mm_and_si128(mask,a),_mm_andnot_si128(mask,b)); }
+#endif
+
+template<> EIGEN_STRONG_INLINE int pmovemask<Packet16uc>(const Packet16uc& a) { return _mm_movemask_epi8(a); }
+template<> EIGEN_STRONG_INLINE int pmovemask<Packet8s>(const Packet8s& a) { return _mm_movemask_epi8(_mm_packs_epi16(a, _mm_setzero_si128())); }
+
+// SSE has no 8 bits shifts: the bits shifted across the bytes are masked out
+template<int N> EIGEN_STRONG_INLINE Packet16uc plogical_shift_left(const Packet16uc& a)
+{ return _mm_and_si128(_mm_slli_epi16(a,N), _mm_set1_epi8(static_cast<char>((0xFF << N) & 0xFF))); }
+template<int N> EIGEN_STRONG_INLINE Packet16uc plogical_shift_right(const Packet16uc& a)
+{ return _mm_and_si128(_mm_srli_epi16(a,N), _mm_set1_epi8(static_cast<char>(0xFF >> N))); }
+
+template<int N> EIGEN_STRONG_INLINE Packet8s plogical_shift_left(const Packet8s& a)     { return _mm_slli_epi16(a,N); }
+template<int N> EIGEN_STRONG_INLINE Packet8s plogical_shift_right(const Packet8s& a)    { return _mm_srli_epi16(a,N); }
+template<int N> EIGEN_STRONG_INLINE Packet8s parithmetic_shift_right(const Packet8s& a) { return _mm_srai_epi16(a,N); }
+
+template<int N> EIGEN_STRONG_INLINE Packet4i plogical_shift_left(const Packet4i& a)     { return _mm_slli_epi32(a,N); }
+template<int N> EIGEN_STRONG_INLINE Packet4i plogical_shift_right(const Packet4i& a)    { return _mm_srli_epi32(a,N); }
+template<int N> EIGEN_STRONG_INLINE Packet4i parithmetic_shift_right(const Packet4i& a) { return _mm_srai_epi32(a,N); }
+
+// widening multiply-accumulate: pmaddwd sums the 32 bits products of adjacent pairs of 16 bits integers,
+// and the bytes are zero extended to 16 bits integers first
+template<> EIGEN_STRONG_INLINE Packet4i pmaddw(const Packet8s& a, const Packet8s& b, const Packet4i& c)
+{ return _mm_add_epi32(_mm_madd_epi16(a,b), c); }
+template<> EIGEN_STRONG_INLINE Packet4i pmaddw(const Packet16uc& a, const Packet16uc& b, const Packet4i& c)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(a,zero), _mm_unpacklo_epi8(b,zero));
+  __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(a,zero), _mm_unpackhi_epi8(b,zero));
+  return _mm_add_epi32(_mm_add_epi32(lo,hi), c);
+}
+
+template<> EIGEN_STRONG_INLINE Packet8s pwiden_low<Packet8s,Packet16uc>(const Packet16uc& a)  { return _mm_unpacklo_epi8(a,_mm_setzero_si128()); }
+template<> EIGEN_STRONG_INLINE Packet8s pwiden_high<Packet8s,Packet16uc>(const Packet16uc& a) { return _mm_unpackhi_epi8(a,_mm_setzero_si128()); }
+// sign extension
+template<> EIGEN_STRONG_INLINE Packet4i pwiden_low<Packet4i,Packet8s>(const Packet8s& a)  { return _mm_srai_epi32(_mm_unpacklo_epi16(a,a),16); }
+template<> EIGEN_STRONG_INLINE Packet4i pwiden_high<Packet4i,Packet8s>(const Packet8s& a) { return _mm_srai_epi32(_mm_unpackhi_epi16(a,a),16); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc pnarrow<Packet16uc,Packet8s>(const Packet8s& a, const Packet8s& b) { return _mm_packus_epi16(a,b); }
+template<> EIGEN_STRONG_INLINE Packet8s   pnarrow<Packet8s,Packet4i>(const Packet4i& a, const Packet4i& b)   { return _mm_packs_epi32(a,b); }
+
+template<> struct type_casting_traits<int,float> { enum { VectorizedCast = 1 }; };
+template<> struct type_casting_traits<float,int> { enum { VectorizedCast = 1 }; };
+
+template<> EIGEN_STRONG_INLINE Packet4f pcast<Packet4i,Packet4f>(const Packet4i& a) { return _mm_cvtepi32_ps(a); }
+template<> EIGEN_STRONG_INLINE Packet4i pcast<Packet4f,Packet4i>(const Packet4f& a) { return _mm_cvttps_epi32(a); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc pload<Packet16uc>(const unsigned char* from) { EIGEN_DEBUG_ALIGNED_LOAD return _mm_load_si128(reinterpret_cast<const __m128i*>(from)); }
+template<> EIGEN_STRONG_INLINE Packet8s   pload<Packet8s>(const short* from)           { EIGEN_DEBUG_ALIGNED_LOAD return _mm_load_si128(reinterpret_cast<const __m128i*>(from)); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc ploadu<Packet16uc>(const unsigned char* from) { EIGEN_DEBUG_UNALIGNED_LOAD return _mm_loadu_si128(reinterpret_cast<const __m128i*>(from)); }
+template<> EIGEN_STRONG_INLINE Packet8s   ploadu<Packet8s>(const short* from)           { EIGEN_DEBUG_UNALIGNED_LOAD return _mm_loadu_si128(reinterpret_cast<const __m128i*>(from)); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc ploaddup<Packet16uc>(const unsigned char* from)
+{
+  __m128i tmp = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(from));
+  return _mm_unpacklo_epi8(tmp, tmp);
+}
+template<> EIGEN_STRONG_INLINE Packet8s ploaddup<Packet8s>(const short* from)
+{
+  __m128i tmp = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(from));
+  return _mm_unpacklo_epi16(tmp, tmp);
+}
+
+template<> EIGEN_STRONG_INLINE void pstore<unsigned char>(unsigned char* to, const Packet16uc& from) { EIGEN_DEBUG_ALIGNED_STORE _mm_store_si128(reinterpret_cast<__m128i*>(to), from); }
+template<> EIGEN_STRONG_INLINE void pstore<short>(short* to, const Packet8s& from)                   { EIGEN_DEBUG_ALIGNED_STORE _mm_store_si128(reinterpret_cast<__m128i*>(to), from); }
+
+template<> EIGEN_STRONG_INLINE void pstoreu<unsigned char>(unsigned char* to, const Packet16uc& from) { EIGEN_DEBUG_UNALIGNED_STORE _mm_storeu_si128(reinterpret_cast<__m128i*>(to), from); }
+template<> EIGEN_STRONG_INLINE void pstoreu<short>(short* to, const Packet8s& from)                   { EIGEN_DEBUG_UNALIGNED_STORE _mm_storeu_si128(reinterpret_cast<__m128i*>(to), from); }
+
+template<> EIGEN_STRONG_INLINE void prefetch<unsigned char>(const unsigned char* addr) { _mm_prefetch((const char*)(addr), _MM_HINT_T0); }
+template<> EIGEN_STRONG_INLINE void prefetch<short>(const short* addr)                 { _mm_prefetch((const char*)(addr), _MM_HINT_T0); }
+
+template<> EIGEN_STRONG_INLINE unsigned char pfirst<Packet16uc>(const Packet16uc& a) { return static_cast<unsigned char>(_mm_cvtsi128_si32(a)); }
+template<> EIGEN_STRONG_INLINE short         pfirst<Packet8s>(const Packet8s& a)     { return static_cast<short>(_mm_cvtsi128_si32(a)); }
+
+template<> EIGEN_STRONG_INLINE Packet16uc preverse(const Packet16uc& a)
+{
+#ifdef EIGEN_VECTORIZE_SSSE3
+  return _mm_shuffle_epi8(a, _mm_setr_epi8(15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0));
+#else
+  // reverse the 16 bits words, then swap the bytes of each word
+  __m128i w = _mm_shuffle_epi32(a, 0x1B);
+  w = _mm_shufflehi_epi16(_mm_shufflelo_epi16(w, 0xB1), 0xB1);
+  return _mm_or_si128(_mm_slli_epi16(w,8), _mm_srli_epi16(w,8));
+#endif
+}
+template<> EIGEN_STRONG_INLINE Packet8s preverse(const Packet8s& a)
+{
+  __m128i w = _mm_shuffle_epi32(a, 0x1B);
+  return _mm_shufflehi_epi16(_mm_shufflelo_epi16(w, 0xB1), 0xB1);
+}
+
+// the sums of absolute differences with zero add the bytes of each half as 16 bits integers
+template<> EIGEN_STRONG_INLINE unsigned char predux<Packet16uc>(const Packet16uc& a)
+{
+  __m128i sad = _mm_sad_epu8(a, _mm_setzero_si128());
+  return static_cast<unsigned char>(_mm_cvtsi128_si32(sad) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(sad,sad)));
+}
+template<> EIGEN_STRONG_INLINE short predux<Packet8s>(const Packet8s& a)
+{
+  return static_cast<short>(predux<Packet4i>(_mm_madd_epi16(a, _mm_set1_epi16(1))));
+}
+
+template<> EIGEN_STRONG_INLINE Packet16uc preduxp<Packet16uc>(const Packet16uc* vecs)
+{
+  EIGEN_ALIGN16 unsigned char aux[16];
+  for(int i=0; i<16; ++i)
+    aux[i] = predux(vecs[i]);
+  return pload<Packet16uc>(aux);
+}
+template<> EIGEN_STRONG_INLINE Packet8s preduxp<Packet8s>(const Packet8s* vecs)
+{
+  EIGEN_ALIGN16 short aux[8];
+  for(int i=0; i<8; ++i)
+    aux[i] = predux(vecs[i]);
+  return pload<Packet8s>(aux);
+}
+
+template<> EIGEN_STRONG_INLINE unsigned char predux_mul<Packet16uc>(const Packet16uc& a)
+{
+  EIGEN_ALIGN16 unsigned char aux[16];
+  pstore(aux, a);
+  unsigned char res = 1;
+  for(int i=0; i<16; ++i)
+    res *= aux[i];
+  return res;
+}
+template<> EIGEN_STRONG_INLINE short predux_mul<Packet8s>(const Packet8s& a)
+{
+  Packet8s tmp = _mm_mullo_epi16(a, _mm_unpackhi_epi64(a,a));
+  tmp = _mm_mullo_epi16(tmp, _mm_shuffle_epi32(tmp, 1));
+  return static_cast<short>(pfirst(tmp) * pfirst(Packet8s(_mm_srli_epi32(tmp,16))));
+}
+
+// min and max, folding the halves of the packet
+template<> EIGEN_STRONG_INLINE unsigned char predux_min<Packet16uc>(const Packet16uc& a)
+{
+  __m128i tmp = _mm_min_epu8(a, _mm_unpackhi_epi64(a,a));
+  tmp = _mm_min_epu8(tmp, _mm_shuffle_epi32(tmp, 1));
+  tmp = _mm_min_epu8(tmp, _mm_srli_epi32(tmp, 16));
+  tmp = _mm_min_epu8(tmp, _mm_srli_epi16(tmp, 8));
+  return pfirst(Packet16uc(tmp));
+}
+template<> EIGEN_STRONG_INLINE short predux_min<Packet8s>(const Packet8s& a)
+{
+  __m128i tmp = _mm_min_epi16(a, _mm_unpackhi_epi64(a,a));
+  tmp = _mm_min_epi16(tmp, _mm_shuffle_epi32(tmp, 1));
+  tmp = _mm_min_epi16(tmp, _mm_srli_epi32(tmp, 16));
+  return pfirst(Packet8s(tmp));
+}
+
+template<> EIGEN_STRONG_INLINE unsigned char predux_max<Packet16uc>(const Packet16uc& a)
+{
+  __m128i tmp = _mm_max_epu8(a, _mm_unpackhi_epi64(a,a));
+  tmp = _mm_max_epu8(tmp, _mm_shuffle_epi32(tmp, 1));
+  tmp = _mm_max_epu8(tmp, _mm_srli_epi32(tmp, 16));
+  tmp = _mm_max_epu8(tmp, _mm_srli_epi16(tmp, 8));
+  return pfirst(Packet16uc(tmp));
+}
+template<> EIGEN_STRONG_INLINE short predux_max<Packet8s>(const Packet8s& a)
+{
+  __m128i tmp = _mm_max_epi16(a, _mm_unpackhi_epi64(a,a));
+  tmp = _mm_max_epi16(tmp, _mm_shuffle_epi32(tmp, 1));
+  tmp = _mm_max_epi16(tmp, _mm_srli_epi32(tmp, 16));
+  return pfirst(Packet8s(tmp));
+}
+
+// byte shifts of the concatenation of the two packets
+template<int Offset>
+struct palign_impl<Offset,Packet16uc>
+{
+  static EIGEN_STRONG_INLINE void run(Packet16uc& first, const Packet16uc& second)
+  {
+    if (Offset!=0)
+      first = _mm_or_si128(_mm_srli_si128(first, Offset), _mm_slli_si128(second, 16-Offset));
+  }
+};
+
+template<int Offset>
+struct palign_impl<Offset,Packet8s>
+{
+  static EIGEN_STRONG_INLINE void run(Packet8s& first, const Packet8s& second)
+  {
+    if (Offset!=0)
+      first = _mm_or_si128(_mm_srli_si128(first, Offset*2), _mm_slli_si128(second, 16-Offset*2));
+  }
+};
+
+#ifdef EIGEN_VECTORIZE_SSE_INT64
+
+template<> EIGEN_STRONG_INLINE Packet2l pset1<Packet2l>(const std::ptrdiff_t& from) { return _mm_set1_epi64x(from); }
+template<> EIGEN_STRONG_INLINE Packet2l plset<std::ptrdiff_t>(const std::ptrdiff_t& a) { return _mm_add_epi64(pset1<Packet2l>(a), _mm_set_epi64x(1,0)); }
+
+template<> EIGEN_STRONG_INLINE Packet2l padd<Packet2l>(const Packet2l& a, const Packet2l& b) { return _mm_add_epi64(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2l psub<Packet2l>(const Packet2l& a, const Packet2l& b) { return _mm_sub_epi64(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2l pnegate(const Packet2l& a) { return _mm_sub_epi64(_mm_setzero_si128(), a); }
+template<> EIGEN_STRONG_INLINE Packet2l pconj(const Packet2l& a) { return a; }
+
+// the low 64 bits of the product are lo(a)*lo(b) + (hi(a)*lo(b) + lo(a)*hi(b)) << 32
+template<> EIGEN_STRONG_INLINE Packet2l pmul<Packet2l>(const Packet2l& a, const Packet2l& b)
+{
+  __m128i cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a,32), b), _mm_mul_epu32(a, _mm_srli_epi64(b,32)));
+  return _mm_add_epi64(_mm_mul_epu32(a,b), _mm_slli_epi64(cross,32));
+}
+template<> EIGEN_STRONG_INLINE Packet2l pmadd(const Packet2l& a, const Packet2l& b, const Packet2l& c) { return padd(pmul(a,b), c); }
+
+template<> EIGEN_STRONG_INLINE Packet2l pand<Packet2l>(const Packet2l& a, const Packet2l& b)    { return _mm_and_si128(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2l por<Packet2l>(const Packet2l& a, const Packet2l& b)     { return _mm_or_si128(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2l pxor<Packet2l>(const Packet2l& a, const Packet2l& b)    { return _mm_xor_si128(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2l pandnot<Packet2l>(const Packet2l& a, const Packet2l& b) { return _mm_andnot_si128(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet2l pcmp_eq<Packet2l>(const Packet2l& a, const Packet2l& b)
+{
+#ifdef EIGEN_VECTORIZE_SSE4_1
+  return _mm_cmpeq_epi64(a,b);
+#else
+  __m128i eq = _mm_cmpeq_epi32(a,b);
+  return _mm_and_si128(eq, _mm_shuffle_epi32(eq, 0xB1));
+#endif
+}
+template<> EIGEN_STRONG_INLINE Packet2l pcmp_lt<Packet2l>(const Packet2l& a, const Packet2l& b)
+{
+#ifdef EIGEN_VECTORIZE_SSE4_2
+  return _mm_cmpgt_epi64(b,a);
+#else
+  // compare the signed high words, and the unsigned low words when the high words are equal
+  const __m128i sign = _mm_set1_epi32(0x80000000);
+  __m128i hi_lt = _mm_cmplt_epi32(a,b);
+  __m128i hi_eq = _mm_cmpeq_epi32(a,b);
+  __m128i lo_lt = _mm_cmplt_epi32(_mm_xor_si128(a,sign), _mm_xor_si128(b,sign));
+  return _mm_or_si128(_mm_shuffle_epi32(hi_lt, 0xF5), _mm_and_si128(_mm_shuffle_epi32(hi_eq, 0xF5), _mm_shuffle_epi32(lo_lt, 0xA0)));
+#endif
+}
+template<> EIGEN_STRONG_INLINE Packet2l pcmp_le<Packet2l>(const Packet2l& a, const Packet2l& b)
+{ return _mm_or_si128(pcmp_lt(a,b), pcmp_eq(a,b)); }
+
+#ifdef EIGEN_VECTORIZE_SSE4_1
+template<> EIGEN_STRONG_INLINE Packet2l pselect<Packet2l>(const Packet2l& mask, const Packet2l& a, const Packet2l& b) { return _mm_blendv_epi8(b,a,mask); }
+#else
+template<> EIGEN_STRONG_INLINE Packet2l pselect<Packet2l>(const Packet2l& mask, const Packet2l& a, const Packet2l& b) { return _mm_or_si128(_mm_and_si128(mask,a),_mm_andnot_si128(mask,b)); }
+#endif
+template<> EIGEN_STRONG_INLINE int pmovemask<Packet2l>(const Packet2l& a) { return _mm_movemask_pd(_mm_castsi128_pd(a)); }
+
+template<> EIGEN_STRONG_INLINE Packet2l pmin<Packet2l>(const Packet2l& a, const Packet2l& b) { return pselect(pcmp_lt(a,b), a, b); }
+template<> EIGEN_STRONG_INLINE Packet2l pmax<Packet2l>(const Packet2l& a, const Packet2l& b) { return pselect(pcmp_lt(b,a), a, b); }
+template<> EIGEN_STRONG_INLINE Packet2l pabs(const Packet2l& a)
+{
+  __m128i sign = _mm_shuffle_epi32(_mm_srai_epi32(a,31), 0xF5);
+  return _mm_sub_epi64(_mm_xor_si128(a,sign), sign);
+}
+
+template<int N> EIGEN_STRONG_INLINE Packet2l plogical_shift_left(const Packet2l& a)  { return _mm_slli_epi64(a,N); }
+template<int N> EIGEN_STRONG_INLINE Packet2l plogical_shift_right(const Packet2l& a) { return _mm_srli_epi64(a,N); }
+
+template<> EIGEN_STRONG_INLINE Packet2l pload<Packet2l>(const std::ptrdiff_t* from)  { EIGEN_DEBUG_ALIGNED_LOAD return _mm_load_si128(reinterpret_cast<const __m128i*>(from)); }
+template<> EIGEN_STRONG_INLINE Packet2l ploadu<Packet2l>(const std::ptrdiff_t* from) { EIGEN_DEBUG_UNALIGNED_LOAD return _mm_loadu_si128(reinterpret_cast<const __m128i*>(from)); }
+template<> EIGEN_STRONG_INLINE Packet2l ploaddup<Packet2l>(const std::ptrdiff_t* from) { return pset1<Packet2l>(from[0]); }
+template<> EIGEN_STRONG_INLINE void pstore<std::ptrdiff_t>(std::ptrdiff_t* to, const Packet2l& from)  { EIGEN_DEBUG_ALIGNED_STORE _mm_store_si128(reinterpret_cast<__m128i*>(to), from); }
+template<> EIGEN_STRONG_INLINE void pstoreu<std::ptrdiff_t>(std::ptrdiff_t* to, const Packet2l& from) { EIGEN_DEBUG_UNALIGNED_STORE _mm_storeu_si128(reinterpret_cast<__m128i*>(to), from); }
+template<> EIGEN_STRONG_INLINE void prefetch<std::ptrdiff_t>(const std::ptrdiff_t* addr) { _mm_prefetch((const char*)(addr), _MM_HINT_T0); }
+
+template<> EIGEN_STRONG_INLINE std::ptrdiff_t pfirst<Packet2l>(const Packet2l& a) { return _mm_cvtsi128_si64(a); }
+template<> EIGEN_STRONG_INLINE Packet2l preverse(const Packet2l& a) { return _mm_shuffle_epi32(a, 0x4E); }
+
+template<> EIGEN_STRONG_INLINE std::ptrdiff_t predux<Packet2l>(const Packet2l& a) { return pfirst(Packet2l(_mm_add_epi64(a, _mm_unpackhi_epi64(a,a)))); }
+template<> EIGEN_STRONG_INLINE Packet2l preduxp<Packet2l>(const Packet2l* vecs)
+{ return _mm_add_epi64(_mm_unpacklo_epi64(vecs[0], vecs[1]), _mm_unpackhi_epi64(vecs[0], vecs[1])); }
+template<> EIGEN_STRONG_INLINE std::ptrdiff_t predux_mul<Packet2l>(const Packet2l& a) { return pfirst(pmul(a, Packet2l(_mm_unpackhi_epi64(a,a)))); }
+template<> EIGEN_STRONG_INLINE std::ptrdiff_t predux_min<Packet2l>(const Packet2l& a) { return pfirst(pmin(a, Packet2l(_mm_unpackhi_epi64(a,a)))); }
+template<> EIGEN_STRONG_INLINE std::ptrdiff_t predux_max<Packet2l>(const Packet2l& a) { return pfirst(pmax(a, Packet2l(_mm_unpackhi_epi64(a,a)))); }
+
+template<int Offset>
+struct palign_impl<Offset,Packet2l>
+{
+  static EIGEN_STRONG_INLINE void run(Packet2l& first, const Packet2l& second)
+  {
+    if (Offset==1)
+      first = _mm_unpacklo_epi64(_mm_unpackhi_epi64(first,first), second);
+  }
+};
+
+#endif // EIGEN_VECTORIZE_SSE_INT64
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_INTEGER_PACKET_MATH_SSE_H
@@ -10,6 +10,8 @@
 
 /* The sin, cos, exp, and log functions of this file come from
  * Julien Pommier's sse math library: http://gruntthepeon.free.fr/ssemath/
+ * Their double precision versions, and the atan and tanh functions, are rewritten the same way
+ * from the cephes library.
  */
 
 #ifndef EIGEN_MATH_FUNCTIONS_SSE_H
@@ -25,6 +27,8 @@ Packet4f plog<Packet4f>(const Packet4f& _x)
   Packet4f x = _x;
   _EIGEN_DECLARE_CONST_Packet4f(1 , 1.0f);
   _EIGEN_DECLARE_CONST_Packet4f(half, 0.5f);
+  _EIGEN_DECLARE_CONST_Packet4f(25, 25.0f);
+  _EIGEN_DECLARE_CONST_Packet4f(2p25, 33554432.0f);
   _EIGEN_DECLARE_CONST_Packet4i(0x7f, 0x7f);
 
   _EIGEN_DECLARE_CONST_Packet4f_FROM_INT(inv_mant_mask, ~0x7f800000);
@@ -55,7 +59,9 @@ Packet4f plog<Packet4f>(const Packet4f& _x)
   Packet4f invalid_mask = _mm_cmpnge_ps(x, _mm_setzero_ps()); // not greater equal is true if x is NaN
   Packet4f iszero_mask = _mm_cmpeq_ps(x, _mm_setzero_ps());
 
-  x = pmax(x, p4f_min_norm_pos);  /* cut off denormalized stuff */
+  /* the denormalized numbers are scaled by 2^25 */
+  Packet4f denorm_mask = _mm_cmplt_ps(x, p4f_min_norm_pos);
+  x = pmul(x, _mm_or_ps(_mm_and_ps(denorm_mask, p4f_2p25), _mm_andnot_ps(denorm_mask, p4f_1)));
   emm0 = _mm_srli_epi32(_mm_castps_si128(x), 23);
 
   /* keep only the fractional part */
@@ -63,7 +69,7 @@ Packet4f plog<Packet4f>(const Packet4f& _x)
   x = _mm_or_ps(x, p4f_half);
 
   emm0 = _mm_sub_epi32(emm0, p4i_0x7f);
-  Packet4f e = padd(_mm_cvtepi32_ps(emm0), p4f_1);
+  Packet4f e = psub(padd(_mm_cvtepi32_ps(emm0), p4f_1), _mm_and_ps(denorm_mask, p4f_25));
 
   /* part2:
      if( x < SQRTHF ) {
@@ -103,6 +109,105 @@ Packet4f plog<Packet4f>(const Packet4f& _x)
                    _mm_and_ps(iszero_mask, p4f_minus_inf));
 }
 
+/* natural logarithm computed for 2 simultaneous doubles, with the cephes log polynomial of double
+   precision: log(1+x) = x - x^2/2 + x^3 P(x)/Q(x) for 1/sqrt(2) <= 1+x < sqrt(2),
+   the denormalized numbers being scaled by 2^54 first
+*/
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d plog<Packet2d>(const Packet2d& _x)
+{
+  Packet2d x = _x;
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(half, 0.5);
+  _EIGEN_DECLARE_CONST_Packet2d(54, 54.0);
+  _EIGEN_DECLARE_CONST_Packet2d(2p54, 18014398509481984.0);
+  _EIGEN_DECLARE_CONST_Packet4i(1022, 1022);
+
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(inv_mant_mask, ~0x7ff00000, 0xffffffff);
+
+  /* the smallest non denormalized double number */
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(min_norm_pos,  0x00100000, 0);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(minus_inf,     0xfff00000, 0);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(plus_inf,      0x7ff00000, 0);
+
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_SQRTHF, 0.70710678118654752440E0);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_p0, 1.01875663804580931796E-4);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_p1, 4.97494994976747001425E-1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_p2, 4.70579119878881725854E0);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_p3, 1.44989225341610930846E1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_p4, 1.79368678507819816313E1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_p5, 7.70838733755885391666E0);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_q1, 1.12873587189167450590E1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_q2, 4.52279145837532221105E1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_q3, 8.29875266912776603211E1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_q4, 7.11544750618563894466E1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_q5, 2.31251620126765340583E1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_C1, -2.121944400546905827679e-4);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_C2, 0.693359375);
+
+  Packet4i emm0;
+
+  Packet2d invalid_mask = _mm_cmpnge_pd(x, _mm_setzero_pd()); // not greater equal is true if x is NaN
+  Packet2d iszero_mask = _mm_cmpeq_pd(x, _mm_setzero_pd());
+  Packet2d isinf_mask = _mm_cmpeq_pd(x, p2d_plus_inf);
+
+  /* the denormalized numbers are scaled by 2^54 */
+  Packet2d denorm_mask = _mm_cmplt_pd(x, p2d_min_norm_pos);
+  x = pmul(x, _mm_or_pd(_mm_and_pd(denorm_mask, p2d_2p54), _mm_andnot_pd(denorm_mask, p2d_1)));
+
+  /* the exponents, in the two lower 32 bits integers */
+  emm0 = _mm_srli_epi64(_mm_castpd_si128(x), 52);
+  emm0 = _mm_shuffle_epi32(emm0, _MM_SHUFFLE(3,1,2,0));
+  emm0 = _mm_sub_epi32(emm0, p4i_1022);
+  Packet2d e = psub(_mm_cvtepi32_pd(emm0), _mm_and_pd(denorm_mask, p2d_54));
+
+  /* keep only the fractional part, in [0.5,1) */
+  x = _mm_and_pd(x, p2d_inv_mant_mask);
+  x = _mm_or_pd(x, p2d_half);
+
+  /* part2:
+     if( x < SQRTHF ) {
+       e -= 1;
+       x = x + x - 1.0;
+     } else { x = x - 1.0; }
+  */
+  Packet2d mask = _mm_cmplt_pd(x, p2d_cephes_SQRTHF);
+  Packet2d tmp = _mm_and_pd(x, mask);
+  x = psub(x, p2d_1);
+  e = psub(e, _mm_and_pd(p2d_1, mask));
+  x = padd(x, tmp);
+
+  Packet2d x2 = pmul(x,x);
+  Packet2d x3 = pmul(x2,x);
+
+  /* y = x^3 P(x) / Q(x), the two polynomials being evaluated by halves */
+  Packet2d y, y1, py, qy;
+  y  = pmadd(p2d_cephes_log_p0, x, p2d_cephes_log_p1);
+  y1 = pmadd(p2d_cephes_log_p3, x, p2d_cephes_log_p4);
+  y  = pmadd(y , x, p2d_cephes_log_p2);
+  y1 = pmadd(y1, x, p2d_cephes_log_p5);
+  py = pmadd(y, x3, y1);
+
+  y  = padd(x, p2d_cephes_log_q1);
+  y1 = pmadd(p2d_cephes_log_q3, x, p2d_cephes_log_q4);
+  y  = pmadd(y , x, p2d_cephes_log_q2);
+  y1 = pmadd(y1, x, p2d_cephes_log_q5);
+  qy = pmadd(y, x3, y1);
+
+  y = pdiv(pmul(py, x3), qy);
+
+  y1 = pmul(e, p2d_cephes_log_C1);
+  tmp = pmul(x2, p2d_half);
+  y = padd(y, y1);
+  x = psub(x, tmp);
+  y1 = pmul(e, p2d_cephes_log_C2);
+  x = padd(x, y);
+  x = padd(x, y1);
+  // negative arg will be NAN, 0 will be -INF, +INF remains +INF
+  x = _mm_or_pd(_mm_andnot_pd(isinf_mask, _mm_or_pd(x, invalid_mask)), _mm_and_pd(isinf_mask, p2d_plus_inf));
+  return _mm_or_pd(_mm_andnot_pd(iszero_mask, x), _mm_and_pd(iszero_mask, p2d_minus_inf));
+}
+
 template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
 Packet4f pexp<Packet4f>(const Packet4f& _x)
 {
@@ -442,6 +547,748 @@ Packet4f pcos<Packet4f>(const Packet4f& _x)
   return _mm_xor_ps(y, sign_bit);
 }
 
+/* evaluation of 2 sines at once, rewriting the cephes sin function of double precision the same way
+   as psin<Packet4f> does for sinf. The reduction modulo Pi/4 loses all precision for arguments larger
+   than 2^30, for which we fall back to the C library.
+*/
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d psin<Packet2d>(const Packet2d& _x)
+{
+  Packet2d x = _x;
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(half, 0.5);
+  _EIGEN_DECLARE_CONST_Packet2d(lossth, 1.073741824e9);
+
+  _EIGEN_DECLARE_CONST_Packet4i(1, 1);
+  _EIGEN_DECLARE_CONST_Packet4i(not1, ~1);
+  _EIGEN_DECLARE_CONST_Packet4i(2, 2);
+  _EIGEN_DECLARE_CONST_Packet4i(4, 4);
+
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(sign_mask, 0x80000000, 0);
+
+  _EIGEN_DECLARE_CONST_Packet2d(minus_cephes_DP1, -7.85398125648498535156E-1);
+  _EIGEN_DECLARE_CONST_Packet2d(minus_cephes_DP2, -3.77489470793079817668E-8);
+  _EIGEN_DECLARE_CONST_Packet2d(minus_cephes_DP3, -2.69515142907905952645E-15);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p0,  1.58962301576546568060E-10);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p1, -2.50507477628578072866E-8);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p2,  2.75573136213857245213E-6);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p3, -1.98412698295895385996E-4);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p4,  8.33333333332211858878E-3);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p5, -1.66666666666666307295E-1);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p0, -1.13585365213876817300E-11);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p1,  2.08757008419747316778E-9);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p2, -2.75573141792967388112E-7);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p3,  2.48015872888517045348E-5);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p4, -1.38888888888730564116E-3);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p5,  4.16666666666665929218E-2);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_FOPI, 1.27323954473516268615); // 4 / M_PI
+
+  // this also catches infinite and NaN arguments
+  if(_mm_movemask_pd(_mm_cmpnle_pd(pabs(x), p2d_lossth)))
+  {
+    using std::sin;
+    EIGEN_ALIGN16 double v[2];
+    pstore(v, x);
+    v[0] = sin(v[0]);
+    v[1] = sin(v[1]);
+    return pload<Packet2d>(v);
+  }
+
+  Packet2d xmm1, xmm2, xmm3, sign_bit, y;
+  Packet4i emm2;
+
+  /* extract the sign bit (upper one), and take the absolute value */
+  sign_bit = _mm_and_pd(x, p2d_sign_mask);
+  x = pabs(x);
+
+  /* scale by 4/Pi */
+  y = pmul(x, p2d_cephes_FOPI);
+
+  /* store the integer part of y in the two lower integers of emm2 */
+  emm2 = _mm_cvttpd_epi32(y);
+  /* j=(j+1) & (~1) (see the cephes sources) */
+  emm2 = _mm_add_epi32(emm2, p4i_1);
+  emm2 = _mm_and_si128(emm2, p4i_not1);
+  y = _mm_cvtepi32_pd(emm2);
+  /* duplicate each j over the 64 bits of its double, so that the integer masks below are double masks */
+  emm2 = _mm_shuffle_epi32(emm2, _MM_SHUFFLE(1,1,0,0));
+
+  /* get the swap sign flag, and the polynom selection mask:
+     there is one polynom for 0 <= x <= Pi/4
+     and another one for Pi/4<x<=Pi/2
+
+     Both branches will be computed.
+  */
+  Packet2d swap_sign_bit = _mm_and_pd(_mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(emm2, p4i_4), p4i_4)), p2d_sign_mask);
+  Packet2d poly_mask = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(emm2, p4i_2), _mm_setzero_si128()));
+  sign_bit = _mm_xor_pd(sign_bit, swap_sign_bit);
+
+  /* The magic pass: "Extended precision modular arithmetic"
+     x = ((x - y * DP1) - y * DP2) - y * DP3; */
+  xmm1 = pmul(y, p2d_minus_cephes_DP1);
+  xmm2 = pmul(y, p2d_minus_cephes_DP2);
+  xmm3 = pmul(y, p2d_minus_cephes_DP3);
+  x = padd(x, xmm1);
+  x = padd(x, xmm2);
+  x = padd(x, xmm3);
+
+  /* Evaluate the first polynom  (0 <= x <= Pi/4) */
+  Packet2d z = pmul(x,x);
+  y = pmadd(p2d_coscof_p0, z, p2d_coscof_p1);
+  y = pmadd(y, z, p2d_coscof_p2);
+  y = pmadd(y, z, p2d_coscof_p3);
+  y = pmadd(y, z, p2d_coscof_p4);
+  y = pmadd(y, z, p2d_coscof_p5);
+  y = pmul(y, z);
+  y = pmul(y, z);
+  y = psub(y, pmul(z, p2d_half));
+  y = padd(y, p2d_1);
+
+  /* Evaluate the second polynom  (Pi/4 <= x <= 0) */
+  Packet2d y2 = pmadd(p2d_sincof_p0, z, p2d_sincof_p1);
+  y2 = pmadd(y2, z, p2d_sincof_p2);
+  y2 = pmadd(y2, z, p2d_sincof_p3);
+  y2 = pmadd(y2, z, p2d_sincof_p4);
+  y2 = pmadd(y2, z, p2d_sincof_p5);
+  y2 = pmul(y2, z);
+  y2 = pmadd(y2, x, x);
+
+  /* select the correct result from the two polynoms */
+  y2 = _mm_and_pd(poly_mask, y2);
+  y = _mm_andnot_pd(poly_mask, y);
+  y = _mm_or_pd(y,y2);
+  /* update the sign */
+  return _mm_xor_pd(y, sign_bit);
+}
+
+/* almost the same as psin */
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d pcos<Packet2d>(const Packet2d& _x)
+{
+  Packet2d x = _x;
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(half, 0.5);
+  _EIGEN_DECLARE_CONST_Packet2d(lossth, 1.073741824e9);
+
+  _EIGEN_DECLARE_CONST_Packet4i(1, 1);
+  _EIGEN_DECLARE_CONST_Packet4i(not1, ~1);
+  _EIGEN_DECLARE_CONST_Packet4i(2, 2);
+  _EIGEN_DECLARE_CONST_Packet4i(4, 4);
+
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(sign_mask, 0x80000000, 0);
+
+  _EIGEN_DECLARE_CONST_Packet2d(minus_cephes_DP1, -7.85398125648498535156E-1);
+  _EIGEN_DECLARE_CONST_Packet2d(minus_cephes_DP2, -3.77489470793079817668E-8);
+  _EIGEN_DECLARE_CONST_Packet2d(minus_cephes_DP3, -2.69515142907905952645E-15);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p0,  1.58962301576546568060E-10);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p1, -2.50507477628578072866E-8);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p2,  2.75573136213857245213E-6);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p3, -1.98412698295895385996E-4);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p4,  8.33333333332211858878E-3);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p5, -1.66666666666666307295E-1);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p0, -1.13585365213876817300E-11);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p1,  2.08757008419747316778E-9);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p2, -2.75573141792967388112E-7);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p3,  2.48015872888517045348E-5);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p4, -1.38888888888730564116E-3);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p5,  4.16666666666665929218E-2);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_FOPI, 1.27323954473516268615); // 4 / M_PI
+
+  if(_mm_movemask_pd(_mm_cmpnle_pd(pabs(x), p2d_lossth)))
+  {
+    using std::cos;
+    EIGEN_ALIGN16 double v[2];
+    pstore(v, x);
+    v[0] = cos(v[0]);
+    v[1] = cos(v[1]);
+    return pload<Packet2d>(v);
+  }
+
+  Packet2d xmm1, xmm2, xmm3, y;
+  Packet4i emm2;
+
+  x = pabs(x);
+
+  /* scale by 4/Pi */
+  y = pmul(x, p2d_cephes_FOPI);
+
+  /* get the integer part of y */
+  emm2 = _mm_cvttpd_epi32(y);
+  /* j=(j+1) & (~1) (see the cephes sources) */
+  emm2 = _mm_add_epi32(emm2, p4i_1);
+  emm2 = _mm_and_si128(emm2, p4i_not1);
+  y = _mm_cvtepi32_pd(emm2);
+
+  emm2 = _mm_sub_epi32(emm2, p4i_2);
+  emm2 = _mm_shuffle_epi32(emm2, _MM_SHUFFLE(1,1,0,0));
+
+  /* get the swap sign flag, and the polynom selection mask */
+  Packet2d sign_bit = _mm_and_pd(_mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(emm2, p4i_4), _mm_setzero_si128())), p2d_sign_mask);
+  Packet2d poly_mask = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(emm2, p4i_2), _mm_setzero_si128()));
+
+  /* The magic pass: "Extended precision modular arithmetic"
+     x = ((x - y * DP1) - y * DP2) - y * DP3; */
+  xmm1 = pmul(y, p2d_minus_cephes_DP1);
+  xmm2 = pmul(y, p2d_minus_cephes_DP2);
+  xmm3 = pmul(y, p2d_minus_cephes_DP3);
+  x = padd(x, xmm1);
+  x = padd(x, xmm2);
+  x = padd(x, xmm3);
+
+  /* Evaluate the first polynom  (0 <= x <= Pi/4) */
+  Packet2d z = pmul(x,x);
+  y = pmadd(p2d_coscof_p0, z, p2d_coscof_p1);
+  y = pmadd(y, z, p2d_coscof_p2);
+  y = pmadd(y, z, p2d_coscof_p3);
+  y = pmadd(y, z, p2d_coscof_p4);
+  y = pmadd(y, z, p2d_coscof_p5);
+  y = pmul(y, z);
+  y = pmul(y, z);
+  y = psub(y, pmul(z, p2d_half));
+  y = padd(y, p2d_1);
+
+  /* Evaluate the second polynom  (Pi/4 <= x <= 0) */
+  Packet2d y2 = pmadd(p2d_sincof_p0, z, p2d_sincof_p1);
+  y2 = pmadd(y2, z, p2d_sincof_p2);
+  y2 = pmadd(y2, z, p2d_sincof_p3);
+  y2 = pmadd(y2, z, p2d_sincof_p4);
+  y2 = pmadd(y2, z, p2d_sincof_p5);
+  y2 = pmul(y2, z);
+  y2 = pmadd(y2, x, x);
+
+  /* select the correct result from the two polynoms */
+  y2 = _mm_and_pd(poly_mask, y2);
+  y  = _mm_andnot_pd(poly_mask, y);
+  y  = _mm_or_pd(y,y2);
+
+  /* update the sign */
+  return _mm_xor_pd(y, sign_bit);
+}
+
+/* hyperbolic tangent of 2 doubles, following the cephes tanh function:
+   x + x^3 P(x^2)/Q(x^2) for |x| < 0.625, and 1 - 2/(exp(2x)+1) otherwise.
+*/
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d ptanh<Packet2d>(const Packet2d& _x)
+{
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(2 , 2.0);
+  _EIGEN_DECLARE_CONST_Packet2d(small, 0.625);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(sign_mask, 0x80000000, 0);
+
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_tanh_p0, -9.64399179425052238628E-1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_tanh_p1, -9.92877231001918586564E1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_tanh_p2, -1.61468768441708447952E3);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_tanh_q1,  1.12811678491632931402E2);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_tanh_q2,  2.23548839060100448583E3);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_tanh_q3,  4.84406305325125486048E3);
+
+  Packet2d sign_bit = _mm_and_pd(_x, p2d_sign_mask);
+  Packet2d nan_mask = _mm_cmpunord_pd(_x, _x);
+  Packet2d z = pabs(_x);
+  Packet2d small_mask = _mm_cmplt_pd(z, p2d_small);
+
+  /* the small arguments */
+  Packet2d x2 = pmul(_x, _x);
+  Packet2d p = pmadd(p2d_cephes_tanh_p0, x2, p2d_cephes_tanh_p1);
+  p = pmadd(p, x2, p2d_cephes_tanh_p2);
+  Packet2d q = padd(x2, p2d_cephes_tanh_q1);
+  q = pmadd(q, x2, p2d_cephes_tanh_q2);
+  q = pmadd(q, x2, p2d_cephes_tanh_q3);
+  Packet2d y_small = pmadd(pmul(_x, x2), pdiv(p, q), _x);
+  // keeps the sign of -0
+  y_small = _mm_or_pd(y_small, sign_bit);
+
+  /* the large ones, with the sign of x */
+  Packet2d y_large = psub(p2d_1, pdiv(p2d_2, padd(pexp(padd(z, z)), p2d_1)));
+  y_large = _mm_xor_pd(y_large, sign_bit);
+
+  Packet2d y = _mm_or_pd(_mm_and_pd(small_mask, y_small), _mm_andnot_pd(small_mask, y_large));
+  return _mm_or_pd(y, nan_mask);
+}
+
+/* hyperbolic tangent of 4 floats, computed in double precision */
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4f ptanh<Packet4f>(const Packet4f& x)
+{
+  Packet2d lo = ptanh<Packet2d>(_mm_cvtps_pd(x));
+  Packet2d hi = ptanh<Packet2d>(_mm_cvtps_pd(_mm_movehl_ps(x,x)));
+  return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+}
+
+/* arc tangent of 4 floats, following the cephes atanf function */
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4f patan<Packet4f>(const Packet4f& _x)
+{
+  _EIGEN_DECLARE_CONST_Packet4f(1 , 1.0f);
+  _EIGEN_DECLARE_CONST_Packet4f(minus_1 , -1.0f);
+  _EIGEN_DECLARE_CONST_Packet4f_FROM_INT(sign_mask, 0x80000000);
+
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_T3PO8, 2.414213562373095f); // tan(3*Pi/8)
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_TPO8, 0.4142135623730950f); // tan(Pi/8)
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_PIO2, 1.5707963267948966192f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_PIO4, 0.7853981633974483096f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_atan_p0,  8.05374449538e-2f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_atan_p1, -1.38776856032E-1f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_atan_p2,  1.99777106478E-1f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_atan_p3, -3.33329491539E-1f);
+
+  Packet4f sign_bit = _mm_and_ps(_x, p4f_sign_mask);
+  Packet4f x = pabs(_x);
+
+  /* range reduction:
+     if( x > tan(3*Pi/8) ) { y = Pi/2; x = -1/x; }
+     else if( x > tan(Pi/8) ) { y = Pi/4; x = (x-1)/(x+1); }
+     else y = 0;
+  */
+  Packet4f big_mask = _mm_cmpgt_ps(x, p4f_cephes_T3PO8);
+  Packet4f mid_mask = _mm_andnot_ps(big_mask, _mm_cmpgt_ps(x, p4f_cephes_TPO8));
+  Packet4f x_big = pdiv(p4f_minus_1, x);
+  Packet4f x_mid = pdiv(psub(x, p4f_1), padd(x, p4f_1));
+  x = _mm_or_ps(_mm_andnot_ps(_mm_or_ps(big_mask, mid_mask), x),
+                _mm_or_ps(_mm_and_ps(big_mask, x_big), _mm_and_ps(mid_mask, x_mid)));
+  Packet4f y = _mm_or_ps(_mm_and_ps(big_mask, p4f_cephes_PIO2), _mm_and_ps(mid_mask, p4f_cephes_PIO4));
+
+  Packet4f z = pmul(x, x);
+  Packet4f p = pmadd(p4f_cephes_atan_p0, z, p4f_cephes_atan_p1);
+  p = pmadd(p, z, p4f_cephes_atan_p2);
+  p = pmadd(p, z, p4f_cephes_atan_p3);
+  p = pmul(p, z);
+  y = padd(y, pmadd(p, x, x));
+
+  /* update the sign */
+  return _mm_xor_ps(y, sign_bit);
+}
+
+/* arc tangent of 2 doubles, following the cephes atan function */
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d patan<Packet2d>(const Packet2d& _x)
+{
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(minus_1 , -1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(half, 0.5);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(sign_mask, 0x80000000, 0);
+
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_T3P8, 2.41421356237309504880); // tan(3*Pi/8)
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_mid, 0.66);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_PIO2, 1.57079632679489661923);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_PIO4, 7.85398163397448309616E-1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_MOREBITS, 6.123233995736765886130E-17);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_p0, -8.750608600031904122785E-1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_p1, -1.615753718733365076637E1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_p2, -7.500855792314704667340E1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_p3, -1.228866684490136173410E2);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_p4, -6.485021904942025371773E1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_q0,  2.485846490142306297962E1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_q1,  1.650270098316988542046E2);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_q2,  4.328810604912902668951E2);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_q3,  4.853903996359136964868E2);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_q4,  1.945506571482613964425E2);
+
+  Packet2d sign_bit = _mm_and_pd(_x, p2d_sign_mask);
+  Packet2d x = pabs(_x);
+
+  /* range reduction:
+     if( x > tan(3*Pi/8) ) { y = Pi/2; x = -1/x; }
+     else if( x > 0.66 ) { y = Pi/4; x = (x-1)/(x+1); }
+     else y = 0;
+  */
+  Packet2d big_mask = _mm_cmpgt_pd(x, p2d_cephes_T3P8);
+  Packet2d mid_mask = _mm_andnot_pd(big_mask, _mm_cmpgt_pd(x, p2d_cephes_mid));
+  Packet2d x_big = pdiv(p2d_minus_1, x);
+  Packet2d x_mid = pdiv(psub(x, p2d_1), padd(x, p2d_1));
+  x = _mm_or_pd(_mm_andnot_pd(_mm_or_pd(big_mask, mid_mask), x),
+                _mm_or_pd(_mm_and_pd(big_mask, x_big), _mm_and_pd(mid_mask, x_mid)));
+  Packet2d y = _mm_or_pd(_mm_and_pd(big_mask, p2d_cephes_PIO2), _mm_and_pd(mid_mask, p2d_cephes_PIO4));
+  /* the low order bits of Pi/2 and Pi/4 */
+  Packet2d morebits = _mm_or_pd(_mm_and_pd(big_mask, p2d_cephes_MOREBITS),
+                                _mm_and_pd(mid_mask, pmul(p2d_half, p2d_cephes_MOREBITS)));
+
+  Packet2d z = pmul(x, x);
+  Packet2d p = pmadd(p2d_cephes_atan_p0, z, p2d_cephes_atan_p1);
+  p = pmadd(p, z, p2d_cephes_atan_p2);
+  p = pmadd(p, z, p2d_cephes_atan_p3);
+  p = pmadd(p, z, p2d_cephes_atan_p4);
+  Packet2d q = padd(z, p2d_cephes_atan_q0);
+  q = pmadd(q, z, p2d_cephes_atan_q1);
+  q = pmadd(q, z, p2d_cephes_atan_q2);
+  q = pmadd(q, z, p2d_cephes_atan_q3);
+  q = pmadd(q, z, p2d_cephes_atan_q4);
+  z = pdiv(pmul(z, p), q);
+  z = padd(pmadd(x, z, x), morebits);
+  y = padd(y, z);
+
+  /* update the sign */
+  return _mm_xor_pd(y, sign_bit);
+}
+
+/* error function of 4 floats, as the ratio of an odd polynomial of degree 13 over an even polynomial
+   of degree 8, on [-4,4] beyond which erf is 1 in single precision. The ratio is evaluated in double
+   precision, whose rounding errors are negligible, and below 1e-4 it is replaced by 2x/sqrt(pi),
+   which also avoids the underflow of the polynomials near the denormalized numbers.
+*/
+EIGEN_STRONG_INLINE Packet2d perf_float(const Packet2d& _x)
+{
+  _EIGEN_DECLARE_CONST_Packet2d(4 , 4.0);
+  _EIGEN_DECLARE_CONST_Packet2d(minus_4 , -4.0);
+  _EIGEN_DECLARE_CONST_Packet2d(tiny, 1e-4);
+  _EIGEN_DECLARE_CONST_Packet2d(2_sqrtpi, 1.12837916709551257390);
+
+  _EIGEN_DECLARE_CONST_Packet2d(erf_p1,  -1.60960333262415e-02);
+  _EIGEN_DECLARE_CONST_Packet2d(erf_p3,  -2.95459980854025e-03);
+  _EIGEN_DECLARE_CONST_Packet2d(erf_p5,  -7.34990630326855e-04);
+  _EIGEN_DECLARE_CONST_Packet2d(erf_p7,  -5.69250639462346e-05);
+  _EIGEN_DECLARE_CONST_Packet2d(erf_p9,  -2.10102402082508e-06);
+  _EIGEN_DECLARE_CONST_Packet2d(erf_p11,  2.77068142495902e-08);
+  _EIGEN_DECLARE_CONST_Packet2d(erf_p13, -2.72614225801306e-10);
+  _EIGEN_DECLARE_CONST_Packet2d(erf_q0,  -1.42647390514189e-02);
+  _EIGEN_DECLARE_CONST_Packet2d(erf_q2,  -7.37332916720468e-03);
+  _EIGEN_DECLARE_CONST_Packet2d(erf_q4,  -1.68282697438203e-03);
+  _EIGEN_DECLARE_CONST_Packet2d(erf_q6,  -2.13374055278905e-04);
+  _EIGEN_DECLARE_CONST_Packet2d(erf_q8,  -1.45660718464996e-05);
+
+  Packet2d nan_mask = _mm_cmpunord_pd(_x, _x);
+  Packet2d tiny_mask = _mm_cmplt_pd(pabs(_x), p2d_tiny);
+  Packet2d x = pmax(pmin(_x, p2d_4), p2d_minus_4);
+  Packet2d x2 = pmul(x, x);
+
+  Packet2d p = pmadd(x2, p2d_erf_p13, p2d_erf_p11);
+  p = pmadd(x2, p, p2d_erf_p9);
+  p = pmadd(x2, p, p2d_erf_p7);
+  p = pmadd(x2, p, p2d_erf_p5);
+  p = pmadd(x2, p, p2d_erf_p3);
+  p = pmadd(x2, p, p2d_erf_p1);
+  p = pmul(x, p);
+
+  Packet2d q = pmadd(x2, p2d_erf_q8, p2d_erf_q6);
+  q = pmadd(x2, q, p2d_erf_q4);
+  q = pmadd(x2, q, p2d_erf_q2);
+  q = pmadd(x2, q, p2d_erf_q0);
+
+  Packet2d y = _mm_or_pd(_mm_and_pd(tiny_mask, pmul(x, p2d_2_sqrtpi)), _mm_andnot_pd(tiny_mask, pdiv(p, q)));
+  return _mm_or_pd(y, nan_mask);
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4f perf<Packet4f>(const Packet4f& x)
+{
+  Packet2d lo = perf_float(_mm_cvtps_pd(x));
+  Packet2d hi = perf_float(_mm_cvtps_pd(_mm_movehl_ps(x,x)));
+  return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+}
+
+/* log(1+x) and exp(x)-1 are computed with W. Kahan's formulas from plog and pexp:
+     log1p(x) = x * log(u) / (u-1), with u = 1+x, and x itself if u == 1
+     expm1(x) = (u-1) * x / log(u), with u = exp(x), and x itself if u == 1
+   which recover the bits of x lost by the rounding of u. Near the overflow of pexp, and beyond,
+   expm1(x) = exp(x/2)^2, which overflows to +inf where the result does.
+*/
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4f plog1p<Packet4f>(const Packet4f& x)
+{
+  _EIGEN_DECLARE_CONST_Packet4f(1 , 1.0f);
+  _EIGEN_DECLARE_CONST_Packet4f_FROM_INT(plus_inf, 0x7f800000);
+  Packet4f u = padd(x, p4f_1);
+  Packet4f log_u = plog(u);
+  Packet4f small_mask = _mm_cmpeq_ps(u, p4f_1);
+  // log1p(+inf) is +inf, which the formula would turn to NaN
+  Packet4f inf_mask = _mm_cmpeq_ps(u, p4f_plus_inf);
+  Packet4f y = pmul(x, pdiv(log_u, psub(u, p4f_1)));
+  y = _mm_or_ps(_mm_and_ps(inf_mask, u), _mm_andnot_ps(inf_mask, y));
+  return _mm_or_ps(_mm_and_ps(small_mask, x), _mm_andnot_ps(small_mask, y));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d plog1p<Packet2d>(const Packet2d& x)
+{
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(plus_inf, 0x7ff00000, 0);
+  Packet2d u = padd(x, p2d_1);
+  Packet2d log_u = plog(u);
+  Packet2d small_mask = _mm_cmpeq_pd(u, p2d_1);
+  // log1p(+inf) is +inf, which the formula would turn to NaN
+  Packet2d inf_mask = _mm_cmpeq_pd(u, p2d_plus_inf);
+  Packet2d y = pmul(x, pdiv(log_u, psub(u, p2d_1)));
+  y = _mm_or_pd(_mm_and_pd(inf_mask, u), _mm_andnot_pd(inf_mask, y));
+  return _mm_or_pd(_mm_and_pd(small_mask, x), _mm_andnot_pd(small_mask, y));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4f pexpm1<Packet4f>(const Packet4f& x)
+{
+  _EIGEN_DECLARE_CONST_Packet4f(1 , 1.0f);
+  _EIGEN_DECLARE_CONST_Packet4f(minus_1 , -1.0f);
+  _EIGEN_DECLARE_CONST_Packet4f(half, 0.5f);
+  _EIGEN_DECLARE_CONST_Packet4f(exp_hi, 88.0f);
+  Packet4f u = pexp(x);
+  Packet4f u_minus_1 = psub(u, p4f_1);
+  Packet4f small_mask = _mm_cmpeq_ps(u, p4f_1);
+  Packet4f minus_1_mask = _mm_cmpeq_ps(u_minus_1, p4f_minus_1);
+  Packet4f large_mask = _mm_cmpgt_ps(x, p4f_exp_hi);
+  Packet4f y = pmul(u_minus_1, pdiv(x, plog(u)));
+  Packet4f v = pexp(pmul(x, p4f_half));
+  y = _mm_or_ps(_mm_and_ps(minus_1_mask, p4f_minus_1), _mm_andnot_ps(minus_1_mask, y));
+  y = _mm_or_ps(_mm_and_ps(large_mask, pmul(v, v)), _mm_andnot_ps(large_mask, y));
+  return _mm_or_ps(_mm_and_ps(small_mask, x), _mm_andnot_ps(small_mask, y));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d pexpm1<Packet2d>(const Packet2d& x)
+{
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(minus_1 , -1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(half, 0.5);
+  _EIGEN_DECLARE_CONST_Packet2d(exp_hi, 709.0);
+  Packet2d u = pexp(x);
+  Packet2d u_minus_1 = psub(u, p2d_1);
+  Packet2d small_mask = _mm_cmpeq_pd(u, p2d_1);
+  Packet2d minus_1_mask = _mm_cmpeq_pd(u_minus_1, p2d_minus_1);
+  Packet2d large_mask = _mm_cmpgt_pd(x, p2d_exp_hi);
+  Packet2d y = pmul(u_minus_1, pdiv(x, plog(u)));
+  Packet2d v = pexp(pmul(x, p2d_half));
+  y = _mm_or_pd(_mm_and_pd(minus_1_mask, p2d_minus_1), _mm_andnot_pd(minus_1_mask, y));
+  y = _mm_or_pd(_mm_and_pd(large_mask, pmul(v, v)), _mm_andnot_pd(large_mask, y));
+  return _mm_or_pd(_mm_and_pd(small_mask, x), _mm_andnot_pd(small_mask, y));
+}
+
+/* The error free transformations of the double-double arithmetic, a+b = s+e and a*b = p+e exactly,
+   whose results may overwrite the operands.
+   The products use Veltkamp's splitting of the operands in two halves of 26 bits, since SSE2 has no fused
+   multiply-add; the splitting overflows for operands larger than 2^996.
+*/
+EIGEN_STRONG_INLINE void ptwo_sum(const Packet2d& a, const Packet2d& b, Packet2d& s, Packet2d& e)
+{
+  Packet2d sum = padd(a, b);
+  Packet2d bb = psub(sum, a);
+  e = padd(psub(a, psub(sum, bb)), psub(b, bb));
+  s = sum;
+}
+
+// the same when |a| >= |b|
+EIGEN_STRONG_INLINE void pfast_two_sum(const Packet2d& a, const Packet2d& b, Packet2d& s, Packet2d& e)
+{
+  Packet2d sum = padd(a, b);
+  e = psub(b, psub(sum, a));
+  s = sum;
+}
+
+EIGEN_STRONG_INLINE void psplit(const Packet2d& a, Packet2d& hi, Packet2d& lo)
+{
+  _EIGEN_DECLARE_CONST_Packet2d(split, 134217729.0);
+  Packet2d c = pmul(a, p2d_split);
+  hi = psub(c, psub(c, a));
+  lo = psub(a, hi);
+}
+
+EIGEN_STRONG_INLINE void ptwo_prod(const Packet2d& a, const Packet2d& b, Packet2d& p, Packet2d& e)
+{
+  Packet2d a_hi, a_lo, b_hi, b_lo;
+  psplit(a, a_hi, a_lo);
+  psplit(b, b_hi, b_lo);
+  Packet2d prod = pmul(a, b);
+  e = padd(padd(padd(psub(pmul(a_hi, b_hi), prod), pmul(a_hi, b_lo)), pmul(a_lo, b_hi)), pmul(a_lo, b_lo));
+  p = prod;
+}
+
+/* log(x) = hi + lo for 2 positive doubles, with a relative error below 2^-62:
+   x = 2^e m with 1/sqrt(2) <= m < sqrt(2), and log(m) = 2 atanh(s) = 2s + 2s^3/3 + 2s^5/5 + ... with s = (m-1)/(m+1),
+   whose two first terms, and the sum with e*log(2), are evaluated in double-double arithmetic.
+   0, +inf and NaN give -inf, +inf and NaN in hi, and 0 in lo.
+*/
+EIGEN_STRONG_INLINE void plog_extended(const Packet2d& _x, Packet2d& hi, Packet2d& lo)
+{
+  Packet2d x = _x;
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(2 , 2.0);
+  _EIGEN_DECLARE_CONST_Packet2d(half, 0.5);
+  _EIGEN_DECLARE_CONST_Packet2d(54, 54.0);
+  _EIGEN_DECLARE_CONST_Packet2d(2p54, 18014398509481984.0);
+  _EIGEN_DECLARE_CONST_Packet4i(1022, 1022);
+
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(inv_mant_mask, ~0x7ff00000, 0xffffffff);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(min_norm_pos,  0x00100000, 0);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(minus_inf,     0xfff00000, 0);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(plus_inf,      0x7ff00000, 0);
+
+  _EIGEN_DECLARE_CONST_Packet2d(SQRTHF, 0.70710678118654752440E0);
+  /* log(2) in two parts, the first one of 42 bits such that its products by the exponents are exact */
+  _EIGEN_DECLARE_CONST_Packet2d(ln2_hi, 0.69314718055989033);
+  _EIGEN_DECLARE_CONST_Packet2d(ln2_lo, 5.4979230187083712e-14);
+  _EIGEN_DECLARE_CONST_Packet2d(two_thirds_hi, 0.66666666666666663);
+  _EIGEN_DECLARE_CONST_Packet2d(two_thirds_lo, 3.7007434154171883e-17);
+
+  Packet2d iszero_mask = _mm_cmpeq_pd(x, _mm_setzero_pd());
+  Packet2d isinf_mask = _mm_cmpeq_pd(x, p2d_plus_inf);
+  Packet2d nan_mask = _mm_cmpunord_pd(x, x);
+
+  /* the denormalized numbers are scaled by 2^54 */
+  Packet2d denorm_mask = _mm_cmplt_pd(x, p2d_min_norm_pos);
+  x = pmul(x, _mm_or_pd(_mm_and_pd(denorm_mask, p2d_2p54), _mm_andnot_pd(denorm_mask, p2d_1)));
+
+  /* the exponents, in the two lower 32 bits integers, and the fractional parts in [0.5,1) */
+  Packet4i emm0 = _mm_srli_epi64(_mm_castpd_si128(x), 52);
+  emm0 = _mm_shuffle_epi32(emm0, _MM_SHUFFLE(3,1,2,0));
+  emm0 = _mm_sub_epi32(emm0, p4i_1022);
+  Packet2d e = psub(_mm_cvtepi32_pd(emm0), _mm_and_pd(denorm_mask, p2d_54));
+  Packet2d m = _mm_or_pd(_mm_and_pd(x, p2d_inv_mant_mask), p2d_half);
+  Packet2d mask = _mm_cmplt_pd(m, p2d_SQRTHF);
+  m = padd(m, _mm_and_pd(m, mask));
+  e = psub(e, _mm_and_pd(p2d_1, mask));
+
+  /* s = s_hi + s_lo, from f = m-1 which is exact */
+  Packet2d f = psub(m, p2d_1);
+  Packet2d d_hi, d_lo, p, p_lo;
+  ptwo_sum(p2d_2, f, d_hi, d_lo);
+  Packet2d s_hi = pdiv(f, d_hi);
+  ptwo_prod(s_hi, d_hi, p, p_lo);
+  Packet2d s_lo = pdiv(psub(psub(psub(f, p), p_lo), pmul(s_hi, d_lo)), d_hi);
+
+  /* s^2, s^3, and 2s^3/3 */
+  Packet2d s2, s2_lo, s3, s3_lo, t, t_lo;
+  ptwo_prod(s_hi, s_hi, s2, s2_lo);
+  s2_lo = padd(s2_lo, pmul(padd(s_hi, s_hi), s_lo));
+  ptwo_prod(s_hi, s2, s3, s3_lo);
+  s3_lo = padd(s3_lo, padd(pmul(s_hi, s2_lo), pmul(s_lo, s2)));
+  ptwo_prod(s3, p2d_two_thirds_hi, t, t_lo);
+  t_lo = padd(t_lo, padd(pmul(s3, p2d_two_thirds_lo), pmul(s3_lo, p2d_two_thirds_hi)));
+
+  /* the other terms, 2s^3 (s^2/5 + s^4/7 + ... + s^24/27), in double precision */
+  Packet2d r = pset1<Packet2d>(2.0/27);
+  r = pmadd(r, s2, pset1<Packet2d>(2.0/25));
+  r = pmadd(r, s2, pset1<Packet2d>(2.0/23));
+  r = pmadd(r, s2, pset1<Packet2d>(2.0/21));
+  r = pmadd(r, s2, pset1<Packet2d>(2.0/19));
+  r = pmadd(r, s2, pset1<Packet2d>(2.0/17));
+  r = pmadd(r, s2, pset1<Packet2d>(2.0/15));
+  r = pmadd(r, s2, pset1<Packet2d>(2.0/13));
+  r = pmadd(r, s2, pset1<Packet2d>(2.0/11));
+  r = pmadd(r, s2, pset1<Packet2d>(2.0/9));
+  r = pmadd(r, s2, pset1<Packet2d>(2.0/7));
+  r = pmadd(r, s2, pset1<Packet2d>(2.0/5));
+  r = pmul(pmul(r, s2), s3);
+
+  /* log(m) = 2s + 2s^3/3 + r, and log(x) = e*log(2) + log(m) */
+  Packet2d l, l_lo;
+  ptwo_sum(padd(s_hi, s_hi), t, l, l_lo);
+  l_lo = padd(l_lo, padd(padd(s_lo, s_lo), padd(t_lo, r)));
+  ptwo_sum(pmul(e, p2d_ln2_hi), l, hi, lo);
+  lo = padd(lo, padd(l_lo, pmul(e, p2d_ln2_lo)));
+  pfast_two_sum(hi, lo, hi, lo);
+
+  Packet2d special_mask = _mm_or_pd(_mm_or_pd(iszero_mask, isinf_mask), nan_mask);
+  hi = _mm_or_pd(_mm_and_pd(iszero_mask, p2d_minus_inf), _mm_andnot_pd(iszero_mask, hi));
+  hi = _mm_or_pd(_mm_and_pd(isinf_mask, p2d_plus_inf), _mm_andnot_pd(isinf_mask, hi));
+  hi = _mm_or_pd(hi, nan_mask);
+  lo = _mm_andnot_pd(special_mask, lo);
+}
+
+/* exp(hi + lo) for 2 doubles with |lo| <= ulp(hi) and -745.2 <= hi <= 709.79, with a single final rounding of
+   an approximation whose relative error is about 2^-58: hi + lo = n*log(2) + g with |g| <= log(2)/2, and
+   exp(g) = 1 + g + g^2 (1/2! + g/3! + ... + g^13/15!), where 1 + g is evaluated in double-double arithmetic.
+   2^n is applied in two factors, which reach both the overflow and the denormalized numbers.
+*/
+EIGEN_STRONG_INLINE Packet2d pexp_extended(const Packet2d& hi, const Packet2d& lo)
+{
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_LOG2EF, 1.4426950408889634073599);
+  _EIGEN_DECLARE_CONST_Packet2d(ln2_hi, 0.69314718055989033);
+  _EIGEN_DECLARE_CONST_Packet2d(ln2_lo, 5.4979230187083712e-14);
+  static const __m128i p4i_1023_0 = _mm_setr_epi32(1023, 1023, 0, 0);
+
+  /* n = round(x/log(2)), and g = x - n*log(2) with n*ln2_hi exact */
+  Packet4i n = _mm_cvtpd_epi32(pmul(hi, p2d_cephes_LOG2EF));
+  Packet2d fn = _mm_cvtepi32_pd(n);
+  Packet2d g, g_lo;
+  ptwo_sum(psub(hi, pmul(fn, p2d_ln2_hi)), psub(lo, pmul(fn, p2d_ln2_lo)), g, g_lo);
+
+  Packet2d q = pset1<Packet2d>(1.0/1307674368000.0);
+  q = pmadd(q, g, pset1<Packet2d>(1.0/87178291200.0));
+  q = pmadd(q, g, pset1<Packet2d>(1.0/6227020800.0));
+  q = pmadd(q, g, pset1<Packet2d>(1.0/479001600.0));
+  q = pmadd(q, g, pset1<Packet2d>(1.0/39916800.0));
+  q = pmadd(q, g, pset1<Packet2d>(1.0/3628800.0));
+  q = pmadd(q, g, pset1<Packet2d>(1.0/362880.0));
+  q = pmadd(q, g, pset1<Packet2d>(1.0/40320.0));
+  q = pmadd(q, g, pset1<Packet2d>(1.0/5040.0));
+  q = pmadd(q, g, pset1<Packet2d>(1.0/720.0));
+  q = pmadd(q, g, pset1<Packet2d>(1.0/120.0));
+  q = pmadd(q, g, pset1<Packet2d>(1.0/24.0));
+  q = pmadd(q, g, pset1<Packet2d>(1.0/6.0));
+  q = pmadd(q, g, pset1<Packet2d>(0.5));
+  q = pmadd(pmul(g, g), q, pmul(g, g_lo));
+
+  Packet2d r, r_lo;
+  ptwo_sum(p2d_1, g, r, r_lo);
+  r = padd(r, padd(r_lo, padd(g_lo, q)));
+
+  /* 2^n = 2^n1 2^n2 with n1 = n/2, both of them being normalized */
+  Packet4i n1 = _mm_srai_epi32(n, 1);
+  Packet4i n2 = _mm_sub_epi32(n, n1);
+  n1 = _mm_shuffle_epi32(_mm_slli_epi32(_mm_add_epi32(n1, p4i_1023_0), 20), _MM_SHUFFLE(1,2,0,3));
+  n2 = _mm_shuffle_epi32(_mm_slli_epi32(_mm_add_epi32(n2, p4i_1023_0), 20), _MM_SHUFFLE(1,2,0,3));
+  return pmul(pmul(r, _mm_castsi128_pd(n1)), _mm_castsi128_pd(n2));
+}
+
+/* x^y = exp(y*log|x|) for 2 doubles, negated for a negative x and an odd integer y.
+   y*log|x| is evaluated in double-double arithmetic, such that the rounding errors do not grow with it,
+   and the results, denormalized numbers included, are within 1 ulp, and exact for most exact powers.
+   The special cases follow the C pow function.
+*/
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d ppow<Packet2d>(const Packet2d& x, const Packet2d& y)
+{
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(minus_1 , -1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(half, 0.5);
+  _EIGEN_DECLARE_CONST_Packet2d(2p52, 4503599627370496.0);
+  _EIGEN_DECLARE_CONST_Packet2d(exp_hi,  709.79);
+  _EIGEN_DECLARE_CONST_Packet2d(exp_lo, -745.2);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(sign_mask, 0x80000000, 0);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(plus_inf, 0x7ff00000, 0);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(minus_inf, 0xfff00000, 0);
+
+  Packet2d l_hi, l_lo, t_hi, t_lo;
+  plog_extended(pabs(x), l_hi, l_lo);
+  ptwo_prod(y, l_hi, t_hi, t_lo);
+  t_lo = padd(t_lo, pmul(y, l_lo));
+  // the splitting of the large or infinite operands gives NaN, while t_hi is then out of the range of exp
+  t_lo = _mm_and_pd(t_lo, _mm_cmpord_pd(t_lo, t_lo));
+
+  Packet2d nan_mask = _mm_cmpunord_pd(t_hi, t_hi);
+  Packet2d over_mask = _mm_cmpgt_pd(t_hi, p2d_exp_hi);
+  Packet2d under_mask = _mm_cmplt_pd(t_hi, p2d_exp_lo);
+  Packet2d r = pexp_extended(t_hi, t_lo);
+  r = _mm_or_pd(_mm_andnot_pd(_mm_or_pd(over_mask, under_mask), r), _mm_and_pd(over_mask, p2d_plus_inf));
+  r = _mm_or_pd(r, nan_mask);
+
+  /* y is an integer if it does not change when rounded through 2^52, or if it is larger than 2^52 */
+  Packet2d abs_y = pabs(y);
+  Packet2d half_y = pmul(abs_y, p2d_half);
+  Packet2d y_int = _mm_or_pd(_mm_cmpge_pd(abs_y, p2d_2p52),
+                             _mm_cmpeq_pd(psub(padd(abs_y, p2d_2p52), p2d_2p52), abs_y));
+  Packet2d half_y_int = _mm_or_pd(_mm_cmpge_pd(half_y, p2d_2p52),
+                                  _mm_cmpeq_pd(psub(padd(half_y, p2d_2p52), p2d_2p52), half_y));
+  Packet2d y_odd = _mm_andnot_pd(half_y_int, y_int);
+  /* the sign of x, -0 included, for the odd integers y, and NaN for a finite negative x and a non integer y */
+  r = _mm_xor_pd(r, _mm_and_pd(_mm_and_pd(x, p2d_sign_mask), y_odd));
+  Packet2d neg_mask = _mm_and_pd(_mm_cmplt_pd(x, _mm_setzero_pd()), _mm_cmpneq_pd(x, p2d_minus_inf));
+  r = _mm_or_pd(r, _mm_andnot_pd(y_int, neg_mask));
+
+  /* x^0 = 1^y = (-1)^(+-inf) = 1 */
+  Packet2d one_mask = _mm_or_pd(_mm_cmpeq_pd(y, _mm_setzero_pd()), _mm_cmpeq_pd(x, p2d_1));
+  one_mask = _mm_or_pd(one_mask, _mm_and_pd(_mm_cmpeq_pd(x, p2d_minus_1), _mm_cmpeq_pd(abs_y, p2d_plus_inf)));
+  return _mm_or_pd(_mm_andnot_pd(one_mask, r), _mm_and_pd(one_mask, p2d_1));
+}
+
+/* x^y for 4 floats, computed in double precision */
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4f ppow<Packet4f>(const Packet4f& x, const Packet4f& y)
+{
+  Packet2d lo = ppow<Packet2d>(_mm_cvtps_pd(x), _mm_cvtps_pd(y));
+  Packet2d hi = ppow<Packet2d>(_mm_cvtps_pd(_mm_movehl_ps(x,x)), _mm_cvtps_pd(_mm_movehl_ps(y,y)));
+  return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+}
+
 #if EIGEN_FAST_MATH
 
 // This is based on Quake3's fast inverse square root.
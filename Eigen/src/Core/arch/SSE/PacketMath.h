@@ -54,6 +54,9 @@ template<> struct is_arithmetic<__m128d> { enum { value = true }; };
 #define _EIGEN_DECLARE_CONST_Packet4f_FROM_INT(NAME,X) \
   const Packet4f p4f_##NAME = _mm_castsi128_ps(pset1<Packet4i>(X))
 
+#define _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(NAME,HI,LO) \
+  const Packet2d p2d_##NAME = _mm_castsi128_pd(_mm_set_epi32(HI,LO,HI,LO))
+
 #define _EIGEN_DECLARE_CONST_Packet4i(NAME,X) \
   const Packet4i p4i_##NAME = pset1<Packet4i>(X)
 
@@ -69,9 +72,16 @@ template<> struct packet_traits<float>  : default_packet_traits
     HasDiv  = 1,
     HasSin  = EIGEN_FAST_MATH,
     HasCos  = EIGEN_FAST_MATH,
+    HasATan = 1,
+    HasTanh = 1,
+    HasErf  = 1,
     HasLog  = 1,
+    HasLog1p = 1,
     HasExp  = 1,
-    HasSqrt = 1
+    HasExpm1 = 1,
+    HasPow  = 1,
+    HasSqrt = 1,
+    HasCmp  = 1
   };
 };
 template<> struct packet_traits<double> : default_packet_traits
@@ -83,8 +93,17 @@ template<> struct packet_traits<double> : default_packet_traits
     size=2,
 
     HasDiv  = 1,
+    HasSin  = EIGEN_FAST_MATH,
+    HasCos  = EIGEN_FAST_MATH,
+    HasATan = 1,
+    HasTanh = 1,
+    HasLog  = 1,
+    HasLog1p = 1,
     HasExp  = 1,
-    HasSqrt = 1
+    HasExpm1 = 1,
+    HasPow  = 1,
+    HasSqrt = 1,
+    HasCmp  = 1
   };
 };
 template<> struct packet_traits<int>    : default_packet_traits
@@ -94,7 +113,10 @@ template<> struct packet_traits<int>    : default_packet_traits
     // FIXME check the Has*
     Vectorizable = 1,
     AlignedOnScalar = 1,
-    size=4
+    size=4,
+
+    HasDiv = 1,
+    HasCmp = 1
   };
 };
 
@@ -166,9 +188,13 @@ template<> EIGEN_STRONG_INLINE Packet4i pmul<Packet4i>(const Packet4i& a, const
 
 template<> EIGEN_STRONG_INLINE Packet4f pdiv<Packet4f>(const Packet4f& a, const Packet4f& b) { return _mm_div_ps(a,b); }
 template<> EIGEN_STRONG_INLINE Packet2d pdiv<Packet2d>(const Packet2d& a, const Packet2d& b) { return _mm_div_pd(a,b); }
-template<> EIGEN_STRONG_INLINE Packet4i pdiv<Packet4i>(const Packet4i& /*a*/, const Packet4i& /*b*/)
-{ eigen_assert(false && "packet integer division are not supported by SSE");
-  return pset1<Packet4i>(0);
+// SSE has no integer division, but the quotients of 32 bits integers computed in double precision
+// are close enough to be exact once truncated
+template<> EIGEN_STRONG_INLINE Packet4i pdiv<Packet4i>(const Packet4i& a, const Packet4i& b)
+{
+  Packet2d q0 = _mm_div_pd(_mm_cvtepi32_pd(a), _mm_cvtepi32_pd(b));
+  Packet2d q1 = _mm_div_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(a,a)), _mm_cvtepi32_pd(_mm_unpackhi_epi64(b,b)));
+  return _mm_unpacklo_epi64(_mm_cvttpd_epi32(q0), _mm_cvttpd_epi32(q1));
 }
 
 // for some weird raisons, it has to be overloaded for packet of integers
@@ -216,6 +242,32 @@ template<> EIGEN_STRONG_INLINE Packet4f pandnot<Packet4f>(const Packet4f& a, con
 template<> EIGEN_STRONG_INLINE Packet2d pandnot<Packet2d>(const Packet2d& a, const Packet2d& b) { return _mm_andnot_pd(a,b); }
 template<> EIGEN_STRONG_INLINE Packet4i pandnot<Packet4i>(const Packet4i& a, const Packet4i& b) { return _mm_andnot_si128(a,b); }
 
+template<> EIGEN_STRONG_INLINE Packet4f pcmp_lt<Packet4f>(const Packet4f& a, const Packet4f& b) { return _mm_cmplt_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2d pcmp_lt<Packet2d>(const Packet2d& a, const Packet2d& b) { return _mm_cmplt_pd(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4i pcmp_lt<Packet4i>(const Packet4i& a, const Packet4i& b) { return _mm_cmplt_epi32(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet4f pcmp_le<Packet4f>(const Packet4f& a, const Packet4f& b) { return _mm_cmple_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2d pcmp_le<Packet2d>(const Packet2d& a, const Packet2d& b) { return _mm_cmple_pd(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4i pcmp_le<Packet4i>(const Packet4i& a, const Packet4i& b) { return _mm_or_si128(_mm_cmplt_epi32(a,b),_mm_cmpeq_epi32(a,b)); }
+
+template<> EIGEN_STRONG_INLINE Packet4f pcmp_eq<Packet4f>(const Packet4f& a, const Packet4f& b) { return _mm_cmpeq_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2d pcmp_eq<Packet2d>(const Packet2d& a, const Packet2d& b) { return _mm_cmpeq_pd(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4i pcmp_eq<Packet4i>(const Packet4i& a, const Packet4i& b) { return _mm_cmpeq_epi32(a,b); }
+
+#ifdef EIGEN_VECTORIZE_SSE4_1
+template<> EIGEN_STRONG_INLINE Packet4f pselect<Packet4f>(const Packet4f& mask, const Packet4f& a, const Packet4f& b) { return _mm_blendv_ps(b,a,mask); }
+template<> EIGEN_STRONG_INLINE Packet2d pselect<Packet2d>(const Packet2d& mask, const Packet2d& a, const Packet2d& b) { return _mm_blendv_pd(b,a,mask); }
+template<> EIGEN_STRONG_INLINE Packet4i pselect<Packet4i>(const Packet4i& mask, const Packet4i& a, const Packet4i& b) { return _mm_blendv_epi8(b,a,mask); }
+#else
+template<> EIGEN_STRONG_INLINE Packet4f pselect<Packet4f>(const Packet4f& mask, const Packet4f& a, const Packet4f& b) { return _mm_or_ps(_mm_and_ps(mask,a),_mm_andnot_ps(mask,b)); }
+template<> EIGEN_STRONG_INLINE Packet2d pselect<Packet2d>(const Packet2d& mask, const Packet2d& a, const Packet2d& b) { return _mm_or_pd(_mm_and_pd(mask,a),_mm_andnot_pd(mask,b)); }
+template<> EIGEN_STRONG_INLINE Packet4i pselect<Packet4i>(const Packet4i& mask, const Packet4i& a, const Packet4i& b) { return _mm_or_si128(_mm_and_si128(mask,a),_mm_andnot_si128(mask,b)); }
+#endif
+
+template<> EIGEN_STRONG_INLINE int pmovemask<Packet4f>(const Packet4f& a) { return _mm_movemask_ps(a); }
+template<> EIGEN_STRONG_INLINE int pmovemask<Packet2d>(const Packet2d& a) { return _mm_movemask_pd(a); }
+template<> EIGEN_STRONG_INLINE int pmovemask<Packet4i>(const Packet4i& a) { return _mm_movemask_ps(_mm_castsi128_ps(a)); }
+
 template<> EIGEN_STRONG_INLINE Packet4f pload<Packet4f>(const float*   from) { EIGEN_DEBUG_ALIGNED_LOAD return _mm_load_ps(from); }
 template<> EIGEN_STRONG_INLINE Packet2d pload<Packet2d>(const double*  from) { EIGEN_DEBUG_ALIGNED_LOAD return _mm_load_pd(from); }
 template<> EIGEN_STRONG_INLINE Packet4i pload<Packet4i>(const int*     from) { EIGEN_DEBUG_ALIGNED_LOAD return _mm_load_si128(reinterpret_cast<const Packet4i*>(from)); }
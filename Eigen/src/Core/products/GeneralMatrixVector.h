@@ -96,9 +96,11 @@ EIGEN_DONT_INLINE void general_matrix_vector_product<Index,LhsScalar,ColMajor,Co
   const Index peeledSize = alignedSize - RhsPacketSize*peels - RhsPacketSize + 1;
 
   const Index alignmentStep = LhsPacketSize>1 ? (LhsPacketSize - lhsStride % LhsPacketSize) & LhsPacketAlignedMask : 0;
+  // the FirstAligned pattern realigns the three next columns with palign, which assumes packets of 4 coefficients
   Index alignmentPattern = alignmentStep==0 ? AllAligned
                        : alignmentStep==(LhsPacketSize/2) ? EvenAligned
-                       : FirstAligned;
+                       : LhsPacketSize==4 ? FirstAligned
+                       : NoneAligned;
 
   // we cannot assume the first element is aligned because of sub-matrices
   const Index lhsAlignmentOffset = internal::first_aligned(lhs,size);
@@ -359,9 +361,11 @@ EIGEN_DONT_INLINE void general_matrix_vector_product<Index,LhsScalar,RowMajor,Co
   const Index peeledSize = alignedSize - RhsPacketSize*peels - RhsPacketSize + 1;
 
   const Index alignmentStep = LhsPacketSize>1 ? (LhsPacketSize - lhsStride % LhsPacketSize) & LhsPacketAlignedMask : 0;
+  // the FirstAligned pattern realigns the three next columns with palign, which assumes packets of 4 coefficients
   Index alignmentPattern = alignmentStep==0 ? AllAligned
                          : alignmentStep==(LhsPacketSize/2) ? EvenAligned
-                         : FirstAligned;
+                         : LhsPacketSize==4 ? FirstAligned
+                         : NoneAligned;
 
   // we cannot assume the first element is aligned because of sub-matrices
   const Index lhsAlignmentOffset = internal::first_aligned(lhs,depth);
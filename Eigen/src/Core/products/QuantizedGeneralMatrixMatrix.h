@@ -0,0 +1,257 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_QUANTIZED_GENERAL_MATRIX_MATRIX_H
+#define EIGEN_QUANTIZED_GENERAL_MATRIX_MATRIX_H
+
+namespace Eigen {
+
+namespace internal {
+
+/* Products of 8-bit integer matrices, i.e., of signed char and unsigned char matrices,
+ * accumulated in 32-bit integers.
+ *
+ * The operands are widened to 16 bits while being packed, and the coefficients of two
+ * consecutive depths are interleaved such that the micro kernel can multiply them by pairs
+ * with pmaddwd, which sums the two 32-bit products. Since the widened operands are at most
+ * 255 in magnitude, the products are exact whatever the signedness of the operands, which is
+ * not the case of pmaddubsw which saturates its 16-bit sums.
+ *
+ * The micro kernel computes 8x4 blocks of the result, hence the packed blocks are padded
+ * with zeros to multiples of 8 rows, 4 columns and 2 depths.
+ */
+
+/* Packs the rows x depth block of the lhs by panels of 8 rows.
+ * For each pair of depths (k,k+1), a panel holds the 16 values lhs(i,k), lhs(i,k+1) of its 8 rows i.
+ */
+template<typename Scalar, typename Index, int StorageOrder>
+struct quantized_pack_lhs
+{
+  EIGEN_DONT_INLINE void operator()(short* blockA, const Scalar* _lhs, Index lhsStride, Index depth, Index rows)
+  {
+    const_blas_data_mapper<Scalar, Index, StorageOrder> lhs(_lhs,lhsStride);
+    const Index pairs = (depth+1)/2;
+    Index count = 0;
+    for(Index i=0; i<rows; i+=8)
+    {
+      const Index actualRows = (std::min)(Index(8), rows-i);
+      for(Index k=0; k<pairs; ++k)
+      {
+        const bool odd = 2*k+1<depth;
+        for(Index r=0; r<8; ++r)
+        {
+          blockA[count++] = r<actualRows ? short(lhs(i+r,2*k)) : short(0);
+          blockA[count++] = r<actualRows && odd ? short(lhs(i+r,2*k+1)) : short(0);
+        }
+      }
+    }
+  }
+};
+
+/* Packs the depth x cols panel of the rhs by panels of 4 columns.
+ * Each int holds the two 16-bit values rhs(k,j), rhs(k+1,j) of a pair of depths, such that the
+ * micro kernel can broadcast them with a single pset1.
+ */
+template<typename Scalar, typename Index, int StorageOrder>
+struct quantized_pack_rhs
+{
+  EIGEN_DONT_INLINE void operator()(int* blockB, const Scalar* _rhs, Index rhsStride, Index depth, Index cols)
+  {
+    const_blas_data_mapper<Scalar, Index, StorageOrder> rhs(_rhs,rhsStride);
+    const Index pairs = (depth+1)/2;
+    Index count = 0;
+    for(Index j=0; j<cols; j+=4)
+    {
+      const Index actualCols = (std::min)(Index(4), cols-j);
+      for(Index k=0; k<pairs; ++k)
+      {
+        const bool odd = 2*k+1<depth;
+        for(Index c=0; c<4; ++c)
+        {
+          const unsigned int lo = c<actualCols ? static_cast<unsigned short>(short(rhs(2*k,j+c))) : 0u;
+          const unsigned int hi = c<actualCols && odd ? static_cast<unsigned short>(short(rhs(2*k+1,j+c))) : 0u;
+          blockB[count++] = static_cast<int>(lo | (hi << 16));
+        }
+      }
+    }
+  }
+};
+
+/* res += A * B, where A is a rows x depth block packed by quantized_pack_lhs,
+ * B a depth x cols panel packed by quantized_pack_rhs, and res is column major.
+ */
+template<typename Index>
+struct quantized_gebp_kernel
+{
+  EIGEN_DONT_INLINE void operator()(int* res, Index resStride, const short* blockA, const int* blockB,
+                                    Index rows, Index depth, Index cols)
+  {
+    const Index pairs = (depth+1)/2;
+    for(Index j=0; j<cols; j+=4)
+    {
+      const Index actualCols = (std::min)(Index(4), cols-j);
+      for(Index i=0; i<rows; i+=8)
+      {
+        const Index actualRows = (std::min)(Index(8), rows-i);
+        const short* A = blockA + 2*i*pairs;
+        const int* B = blockB + j*pairs;
+#ifdef EIGEN_VECTORIZE_SSE2
+        Packet4i C[8];
+        for(int c=0; c<8; ++c)
+          C[c] = pset1<Packet4i>(0);
+        for(Index k=0; k<pairs; ++k)
+        {
+          const Packet8s a0 = pload<Packet8s>(A);
+          const Packet8s a1 = pload<Packet8s>(A+8);
+          Packet8s b0 = Packet8s(pset1<Packet4i>(B[0]));
+          Packet8s b1 = Packet8s(pset1<Packet4i>(B[1]));
+          C[0] = pmaddw(a0,b0,C[0]);
+          C[1] = pmaddw(a1,b0,C[1]);
+          C[2] = pmaddw(a0,b1,C[2]);
+          C[3] = pmaddw(a1,b1,C[3]);
+          b0 = Packet8s(pset1<Packet4i>(B[2]));
+          b1 = Packet8s(pset1<Packet4i>(B[3]));
+          C[4] = pmaddw(a0,b0,C[4]);
+          C[5] = pmaddw(a1,b0,C[5]);
+          C[6] = pmaddw(a0,b1,C[6]);
+          C[7] = pmaddw(a1,b1,C[7]);
+          A += 16;
+          B += 4;
+        }
+        for(Index c=0; c<actualCols; ++c)
+        {
+          int* r = res + (j+c)*resStride + i;
+          if(actualRows==8)
+          {
+            pstoreu(r,   padd(ploadu<Packet4i>(r),   C[2*c]));
+            pstoreu(r+4, padd(ploadu<Packet4i>(r+4), C[2*c+1]));
+          }
+          else
+          {
+            EIGEN_ALIGN16 int tmp[8];
+            pstore(tmp,   C[2*c]);
+            pstore(tmp+4, C[2*c+1]);
+            for(Index r2=0; r2<actualRows; ++r2)
+              r[r2] += tmp[r2];
+          }
+        }
+#else
+        int C[4][8] = {{0}};
+        for(Index k=0; k<pairs; ++k)
+        {
+          for(int c=0; c<4; ++c)
+          {
+            const int b0 = static_cast<short>(B[c] & 0xffff);
+            const int b1 = B[c] >> 16;
+            for(int r=0; r<8; ++r)
+              C[c][r] += A[2*r]*b0 + A[2*r+1]*b1;
+          }
+          A += 16;
+          B += 4;
+        }
+        for(Index c=0; c<actualCols; ++c)
+          for(Index r=0; r<actualRows; ++r)
+            res[(j+c)*resStride + i + r] += C[c][r];
+#endif
+      }
+    }
+  }
+};
+
+/* C += A * B, A and B being 8-bit integer matrices, and C a column major int matrix.
+ * The depth is cut by blocks of kc, and for each of them a kc x cols panel of B
+ * and mc x kc blocks of A are packed for the micro kernel.
+ */
+template<typename Index, typename LhsScalar, int LhsStorageOrder, typename RhsScalar, int RhsStorageOrder>
+struct quantized_gemm
+{
+  static void run(Index rows, Index cols, Index depth,
+                  const LhsScalar* _lhs, Index lhsStride,
+                  const RhsScalar* _rhs, Index rhsStride,
+                  int* res, Index resStride)
+  {
+    if(rows==0 || cols==0 || depth==0)
+      return;
+
+    const_blas_data_mapper<LhsScalar, Index, LhsStorageOrder> lhs(_lhs,lhsStride);
+    const_blas_data_mapper<RhsScalar, Index, RhsStorageOrder> rhs(_rhs,rhsStride);
+
+    Index kc = depth;
+    Index mc = rows;
+    Index nc = cols;
+    computeProductBlockingSizes<short,short>(kc, mc, nc);
+    kc = ((kc+1)/2)*2;
+    mc = (std::max)(Index(8), (mc/8)*8);
+
+    std::size_t sizeA = ((std::min)(mc,rows)+7)/8*8 * kc;
+    std::size_t sizeB = (cols+3)/4*4 * kc/2;
+    ei_declare_aligned_stack_constructed_variable(short, blockA, sizeA, 0);
+    ei_declare_aligned_stack_constructed_variable(int, blockB, sizeB, 0);
+
+    quantized_pack_lhs<LhsScalar, Index, LhsStorageOrder> pack_lhs;
+    quantized_pack_rhs<RhsScalar, Index, RhsStorageOrder> pack_rhs;
+    quantized_gebp_kernel<Index> gebp;
+
+    for(Index k2=0; k2<depth; k2+=kc)
+    {
+      const Index actual_kc = (std::min)(k2+kc,depth)-k2;
+
+      pack_rhs(blockB, &rhs(k2,0), rhsStride, actual_kc, cols);
+
+      for(Index i2=0; i2<rows; i2+=mc)
+      {
+        const Index actual_mc = (std::min)(i2+mc,rows)-i2;
+
+        pack_lhs(blockA, &lhs(i2,k2), lhsStride, actual_kc, actual_mc);
+
+        gebp(res+i2, resStride, blockA, blockB, actual_mc, actual_kc, cols);
+      }
+    }
+  }
+};
+
+/* Functor running quantized_gemm on a block of the result, as expected by parallelize_gemm.
+ * Each thread is given a disjoint block of rows and packs its own blocks.
+ */
+template<typename Index, typename LhsScalar, int LhsStorageOrder, typename RhsScalar, int RhsStorageOrder>
+struct quantized_gemm_functor
+{
+  typedef quantized_gemm<Index,LhsScalar,LhsStorageOrder,RhsScalar,RhsStorageOrder> Gemm;
+
+  quantized_gemm_functor(const LhsScalar* lhs, Index lhsStride, const RhsScalar* rhs, Index rhsStride,
+                         int* res, Index resStride, Index depth, Index cols)
+    : m_lhs(lhs), m_lhsStride(lhsStride), m_rhs(rhs), m_rhsStride(rhsStride),
+      m_res(res), m_resStride(resStride), m_depth(depth), m_cols(cols)
+  {}
+
+  void initParallelSession() const {}
+
+  void operator()(Index row, Index rows, Index col=0, Index cols=-1, GemmParallelInfo<Index>* /*info*/=0) const
+  {
+    if(cols==-1)
+      cols = m_cols;
+    Gemm::run(rows, cols, m_depth,
+              m_lhs + (LhsStorageOrder==RowMajor ? row*m_lhsStride : row), m_lhsStride,
+              m_rhs + (RhsStorageOrder==RowMajor ? col : col*m_rhsStride), m_rhsStride,
+              m_res + row + col*m_resStride, m_resStride);
+  }
+
+  const LhsScalar* m_lhs;
+  Index m_lhsStride;
+  const RhsScalar* m_rhs;
+  Index m_rhsStride;
+  int* m_res;
+  Index m_resStride;
+  Index m_depth;
+  Index m_cols;
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_QUANTIZED_GENERAL_MATRIX_MATRIX_H
@@ -0,0 +1,196 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_REDUCED_PRECISION_PRODUCT_H
+#define EIGEN_REDUCED_PRECISION_PRODUCT_H
+
+namespace Eigen {
+
+namespace internal {
+
+/* Matrix products of 16-bit floating point matrices, i.e., of half and bfloat16 matrices.
+ *
+ * The operands are read in their 16-bit representation, converted to float by blocks fitting
+ * in the cache, and the products are accumulated in float by the float kernels. Each coefficient
+ * of the result is then rounded once, instead of after every multiply-add.
+ */
+
+/* GEMM: C += alpha * A * B, C being column major.
+ * The float accumulator holds a rows x nc panel of C, and the blocks of A and B are converted
+ * to float right before being packed for gebp.
+ */
+template<typename Index, typename Scalar, int LhsStorageOrder, int RhsStorageOrder>
+struct reduced_precision_gemm
+{
+  typedef Scalar ResScalar;
+  static void run(Index rows, Index cols, Index depth,
+                  const Scalar* _lhs, Index lhsStride,
+                  const Scalar* _rhs, Index rhsStride,
+                  Scalar* _res, Index resStride,
+                  Scalar alpha,
+                  level3_blocking<Scalar,Scalar>& /*blocking*/,
+                  GemmParallelInfo<Index>* /*info*/ = 0)
+  {
+    // In a parallel session, each thread is given a disjoint block of the result,
+    // hence the threads do not need to share any packed block.
+    typedef gebp_traits<float,float> Traits;
+    typedef Matrix<float,Dynamic,Dynamic,LhsStorageOrder> LhsBlock;
+    typedef Matrix<float,Dynamic,Dynamic,RhsStorageOrder> RhsBlock;
+
+    Map<const Matrix<Scalar,Dynamic,Dynamic,LhsStorageOrder>, 0, OuterStride<> > lhs(_lhs, rows, depth, OuterStride<>(lhsStride));
+    Map<const Matrix<Scalar,Dynamic,Dynamic,RhsStorageOrder>, 0, OuterStride<> > rhs(_rhs, depth, cols, OuterStride<>(rhsStride));
+    Map<Matrix<Scalar,Dynamic,Dynamic>, 0, OuterStride<> > res(_res, rows, cols, OuterStride<>(resStride));
+
+    Index kc = depth;
+    Index mc = rows;
+    Index nc = cols;
+    computeProductBlockingSizes<float,float>(kc, mc, nc);
+    // bound the accumulator to about 1M floats
+    nc = (std::min)(cols, (std::max)(Index(Traits::nr), Index(1024*1024) / (std::max)(rows, Index(1))));
+
+    std::size_t sizeA = kc*mc;
+    std::size_t sizeB = kc*nc;
+    std::size_t sizeW = kc*Traits::WorkSpaceFactor;
+    std::size_t sizeC = rows*nc;
+    ei_declare_aligned_stack_constructed_variable(float, lhsBuffer, sizeA, 0);
+    ei_declare_aligned_stack_constructed_variable(float, rhsBuffer, sizeB, 0);
+    ei_declare_aligned_stack_constructed_variable(float, blockA, sizeA, 0);
+    ei_declare_aligned_stack_constructed_variable(float, blockB, sizeB, 0);
+    ei_declare_aligned_stack_constructed_variable(float, blockW, sizeW, 0);
+    ei_declare_aligned_stack_constructed_variable(float, acc, sizeC, 0);
+
+    gemm_pack_lhs<float, Index, Traits::mr, Traits::LhsProgress, LhsStorageOrder> pack_lhs;
+    gemm_pack_rhs<float, Index, Traits::nr, RhsStorageOrder> pack_rhs;
+    gebp_kernel<float, float, Index, Traits::mr, Traits::nr, false, false> gebp;
+
+    const float actualAlpha = float(alpha);
+
+    for(Index j2=0; j2<cols; j2+=nc)
+    {
+      const Index actual_nc = (std::min)(j2+nc,cols)-j2;
+      Map<Matrix<float,Dynamic,Dynamic>, Aligned> accumulator(acc, rows, actual_nc);
+      accumulator.setZero();
+
+      for(Index k2=0; k2<depth; k2+=kc)
+      {
+        const Index actual_kc = (std::min)(k2+kc,depth)-k2;
+
+        // convert the kc x nc panel of B, then pack it
+        Map<RhsBlock, Aligned>(rhsBuffer, actual_kc, actual_nc) = rhs.block(k2, j2, actual_kc, actual_nc).template cast<float>();
+        pack_rhs(blockB, rhsBuffer, RhsStorageOrder==ColMajor ? actual_kc : actual_nc, actual_kc, actual_nc);
+
+        for(Index i2=0; i2<rows; i2+=mc)
+        {
+          const Index actual_mc = (std::min)(i2+mc,rows)-i2;
+
+          Map<LhsBlock, Aligned>(lhsBuffer, actual_mc, actual_kc) = lhs.block(i2, k2, actual_mc, actual_kc).template cast<float>();
+          pack_lhs(blockA, lhsBuffer, LhsStorageOrder==ColMajor ? actual_mc : actual_kc, actual_kc, actual_mc);
+
+          gebp(acc+i2, rows, blockA, blockB, actual_mc, actual_kc, actual_nc, actualAlpha, -1, -1, 0, 0, blockW);
+        }
+      }
+
+      res.middleCols(j2, actual_nc) = (res.middleCols(j2, actual_nc).template cast<float>() + accumulator).template cast<Scalar>();
+    }
+  }
+};
+
+template<typename Index, int LhsStorageOrder, bool ConjugateLhs, int RhsStorageOrder, bool ConjugateRhs>
+struct general_matrix_matrix_product<Index,half,LhsStorageOrder,ConjugateLhs,half,RhsStorageOrder,ConjugateRhs,ColMajor>
+  : reduced_precision_gemm<Index,half,LhsStorageOrder,RhsStorageOrder>
+{};
+
+template<typename Index, int LhsStorageOrder, bool ConjugateLhs, int RhsStorageOrder, bool ConjugateRhs>
+struct general_matrix_matrix_product<Index,bfloat16,LhsStorageOrder,ConjugateLhs,bfloat16,RhsStorageOrder,ConjugateRhs,ColMajor>
+  : reduced_precision_gemm<Index,bfloat16,LhsStorageOrder,RhsStorageOrder>
+{};
+
+/* GEMV: y += alpha * A * x
+ * With a column major A, four columns are accumulated at once into a float copy of y.
+ * With a row major A, each coefficient of y is a dot product accumulated in float.
+ */
+template<typename Index, typename Scalar, int StorageOrder>
+struct reduced_precision_gemv;
+
+template<typename Index, typename Scalar>
+struct reduced_precision_gemv<Index,Scalar,ColMajor>
+{
+  typedef Scalar ResScalar;
+  static void run(Index rows, Index cols,
+                  const Scalar* lhs, Index lhsStride,
+                  const Scalar* rhs, Index rhsIncr,
+                  Scalar* res, Index resIncr, Scalar alpha)
+  {
+    Map<const Matrix<Scalar,Dynamic,Dynamic>, 0, OuterStride<> > A(lhs, rows, cols, OuterStride<>(lhsStride));
+    Map<const Matrix<Scalar,Dynamic,1>, 0, InnerStride<> > x(rhs, cols, InnerStride<>(rhsIncr));
+    Map<Matrix<Scalar,Dynamic,1>, 0, InnerStride<> > y(res, rows, InnerStride<>(resIncr));
+
+    ei_declare_aligned_stack_constructed_variable(float, acc, rows, 0);
+    Map<Matrix<float,Dynamic,1>, Aligned> accumulator(acc, rows);
+    accumulator.setZero();
+
+    const Index peeledCols = (cols/4)*4;
+    for(Index j=0; j<peeledCols; j+=4)
+      accumulator += float(x.coeff(j))   * A.col(j).template cast<float>()
+                   + float(x.coeff(j+1)) * A.col(j+1).template cast<float>()
+                   + float(x.coeff(j+2)) * A.col(j+2).template cast<float>()
+                   + float(x.coeff(j+3)) * A.col(j+3).template cast<float>();
+    for(Index j=peeledCols; j<cols; ++j)
+      accumulator += float(x.coeff(j)) * A.col(j).template cast<float>();
+
+    y = (y.template cast<float>() + float(alpha) * accumulator).template cast<Scalar>();
+  }
+};
+
+template<typename Index, typename Scalar>
+struct reduced_precision_gemv<Index,Scalar,RowMajor>
+{
+  typedef Scalar ResScalar;
+  static void run(Index rows, Index cols,
+                  const Scalar* lhs, Index lhsStride,
+                  const Scalar* rhs, Index rhsIncr,
+                  Scalar* res, Index resIncr, Scalar alpha)
+  {
+    Map<const Matrix<Scalar,Dynamic,Dynamic,RowMajor>, 0, OuterStride<> > A(lhs, rows, cols, OuterStride<>(lhsStride));
+    Map<const Matrix<Scalar,1,Dynamic>, 0, InnerStride<> > x(rhs, cols, InnerStride<>(rhsIncr));
+
+    // x is converted once, and read for every row
+    ei_declare_aligned_stack_constructed_variable(float, xBuffer, cols, 0);
+    Map<Matrix<float,1,Dynamic>, Aligned> xf(xBuffer, cols);
+    xf = x.template cast<float>();
+
+    const float actualAlpha = float(alpha);
+    for(Index i=0; i<rows; ++i)
+      res[i*resIncr] = Scalar(float(res[i*resIncr]) + actualAlpha * A.row(i).template cast<float>().cwiseProduct(xf).sum());
+  }
+};
+
+template<typename Index, bool ConjugateLhs, bool ConjugateRhs, int Version>
+struct general_matrix_vector_product<Index,half,ColMajor,ConjugateLhs,half,ConjugateRhs,Version>
+  : reduced_precision_gemv<Index,half,ColMajor>
+{};
+
+template<typename Index, bool ConjugateLhs, bool ConjugateRhs, int Version>
+struct general_matrix_vector_product<Index,half,RowMajor,ConjugateLhs,half,ConjugateRhs,Version>
+  : reduced_precision_gemv<Index,half,RowMajor>
+{};
+
+template<typename Index, bool ConjugateLhs, bool ConjugateRhs, int Version>
+struct general_matrix_vector_product<Index,bfloat16,ColMajor,ConjugateLhs,bfloat16,ConjugateRhs,Version>
+  : reduced_precision_gemv<Index,bfloat16,ColMajor>
+{};
+
+template<typename Index, bool ConjugateLhs, bool ConjugateRhs, int Version>
+struct general_matrix_vector_product<Index,bfloat16,RowMajor,ConjugateLhs,bfloat16,ConjugateRhs,Version>
+  : reduced_precision_gemv<Index,bfloat16,RowMajor>
+{};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_REDUCED_PRECISION_PRODUCT_H
@@ -74,6 +74,7 @@ template<typename Derived> class ArrayBase;
 
 template<typename ExpressionType, unsigned int Added, unsigned int Removed> class Flagged;
 template<typename ExpressionType, template <typename> class StorageBase > class NoAlias;
+template<typename ExpressionType, template <typename> class StorageBase > class ParallelAssign;
 template<typename ExpressionType> class NestByValue;
 template<typename ExpressionType> class ForceAlignedAccess;
 template<typename ExpressionType> class SwapWrapper;
@@ -117,6 +118,7 @@ template<typename MatrixType> class SparseView;
 template<typename ExpressionType> class WithFormat;
 template<typename MatrixType> struct CommaInitializer;
 template<typename Derived> class ReturnByValue;
+template<typename Lhs, typename Rhs> class QuantizedProduct;
 template<typename ExpressionType> class ArrayWrapper;
 template<typename ExpressionType> class MatrixWrapper;
 
@@ -167,6 +169,11 @@ template<typename Scalar> struct scalar_sin_op;
 template<typename Scalar> struct scalar_acos_op;
 template<typename Scalar> struct scalar_asin_op;
 template<typename Scalar> struct scalar_tan_op;
+template<typename Scalar> struct scalar_atan_op;
+template<typename Scalar> struct scalar_tanh_op;
+template<typename Scalar> struct scalar_erf_op;
+template<typename Scalar> struct scalar_log1p_op;
+template<typename Scalar> struct scalar_expm1_op;
 template<typename Scalar> struct scalar_pow_op;
 template<typename Scalar> struct scalar_inverse_op;
 template<typename Scalar> struct scalar_square_op;
@@ -285,6 +292,9 @@ struct stem_function
 };
 }
 
+// defined in products/Parallelizer.h
+inline int nbThreads();
+
 
 #ifdef EIGEN2_SUPPORT
 template<typename ExpressionType> class Cwise;
@@ -206,6 +206,71 @@ inline void check_that_malloc_is_allowed()
 {}
 #endif
 
+/*****************************************************************************
+*** Counting of the temporaries created by the assignments                 ***
+*****************************************************************************/
+
+#ifdef EIGEN_DEBUG_TEMPORARIES
+
+/* When EIGEN_DEBUG_TEMPORARIES is defined, the heap allocations of dense matrices and arrays are counted,
+ * and at the end of each assignment which is not nested in another one, the number of allocations
+ * since the previous report is passed to EIGEN_DEBUG_TEMPORARIES_REPORT. This number includes the
+ * temporaries created while building the right-hand side, e.g., the evaluation of a product nested
+ * in a coefficient-wise expression, and the reallocation of the destination if it is resized.
+ * The constructions of matrices are not reported by themselves, their allocations are reported
+ * with the next assignment. The counters are not thread safe.
+ */
+#ifndef EIGEN_DEBUG_TEMPORARIES_REPORT
+#define EIGEN_DEBUG_TEMPORARIES_REPORT(count) \
+  if(count>0) std::cerr << "Eigen: " << count << " temporaries allocated by the assignment or since the previous one\n";
+#endif
+
+inline std::size_t& temporaries_counter()
+{
+  static std::size_t value = 0;
+  return value;
+}
+
+inline int& temporaries_depth()
+{
+  static int value = 0;
+  return value;
+}
+
+inline void on_temporary_allocation(std::size_t size)
+{
+  if(size!=0)
+    ++temporaries_counter();
+}
+
+/* Marks the duration of an assignment, or of an evaluation which is not reported by itself. */
+class temporaries_scope
+{
+  public:
+    explicit temporaries_scope(bool report) : m_report(report) { ++temporaries_depth(); }
+    ~temporaries_scope()
+    {
+      if(--temporaries_depth()==0 && m_report)
+      {
+        const std::size_t count = temporaries_counter();
+        temporaries_counter() = 0;
+        EIGEN_DEBUG_TEMPORARIES_REPORT(count)
+      }
+    }
+  private:
+    bool m_report;
+};
+
+#define EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE Eigen::internal::temporaries_scope eigen_temporaries_scope(true);
+#define EIGEN_INTERNAL_TEMPORARIES_NESTED_SCOPE Eigen::internal::temporaries_scope eigen_temporaries_scope(false);
+
+#else
+
+#define EIGEN_INTERNAL_TEMPORARIES_ASSIGNMENT_SCOPE
+#define EIGEN_INTERNAL_TEMPORARIES_NESTED_SCOPE
+
+#endif
+
 /** \internal Allocates \a size bytes. The returned pointer is guaranteed to have 16 bytes alignment.
   * On allocation error, the returned pointer is null, and std::bad_alloc is thrown.
   */
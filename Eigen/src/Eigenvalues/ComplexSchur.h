@@ -13,6 +13,7 @@
 #define EIGEN_COMPLEX_SCHUR_H
 
 #include "./HessenbergDecomposition.h"
+#include "./MultishiftQR.h"
 
 namespace Eigen { 
 
@@ -181,6 +182,9 @@ template<typename _MatrixType> class ComplexSchur
       * to be \f$25n^3\f$ complex flops, or \f$10n^3\f$ complex flops
       * if \a computeU is false.
       *
+      * As for RealSchur, active submatrices of size 75 and more are processed by the small-bulge multishift QR
+      * algorithm with aggressive early deflation.
+      *
       * Example: \include ComplexSchur_compute.cpp
       * Output: \verbinclude ComplexSchur_compute.out
       *
@@ -421,6 +425,10 @@ void ComplexSchur<MatrixType>::reduceToTriangularForm(bool computeU)
       --il;
     }
 
+    // large active submatrices are processed by multishift QR sweeps with aggressive early deflation
+    if(internal::multishift_qr<ComplexMatrixType, ComplexSchur<Matrix<ComplexScalar,Dynamic,Dynamic> > >::run(m_matT, m_matU, computeU, il, iu, iter))
+      continue;
+
     /* perform the QR step using Givens rotations. The first rotation
        creates a bulge; the (il+2,il) element becomes nonzero. This
        bulge is chased down to the bottom of the active submatrix. */
@@ -0,0 +1,526 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// We used the "The multishift QR algorithm. Part I: Maintaining well-focused
+// shifts and level 3 performance" and "Part II: Aggressive early deflation"
+// papers written by K. Braman, R. Byers and R. Mathias, and the "On swapping
+// diagonal blocks in real Schur form" paper written by Z. Bai and J. W. Demmel.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_MULTISHIFT_QR_H
+#define EIGEN_MULTISHIFT_QR_H
+
+#include "./HessenbergDecomposition.h"
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal
+  * \returns the size (1 or 2) of the diagonal block starting at row \a i of the (quasi) triangular matrix \a T.
+  * For complex matrices all the blocks are 1x1.
+  */
+template<typename MatrixType>
+inline typename MatrixType::Index schur_block_size(const MatrixType& T, typename MatrixType::Index i)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  return (!NumTraits<Scalar>::IsComplex && i+1<T.rows() && T.coeff(i+1,i)!=Scalar(0)) ? 2 : 1;
+}
+
+/** \internal
+  * Computes the eigenvalues of the leading \a n rows of the (quasi) triangular matrix \a T.
+  */
+template<typename MatrixType, typename EigenvaluesType>
+void schur_block_eigenvalues(const MatrixType& T, typename MatrixType::Index n, EigenvaluesType& eivals)
+{
+  using std::sqrt;
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef std::complex<RealScalar> ComplexScalar;
+  eivals.resize(n);
+  for(Index i=0; i<n;)
+  {
+    if(schur_block_size(T, i)==2 && i+1<n)
+    {
+      // T is real here: the 2x2 block has a pair of complex conjugate eigenvalues
+      RealScalar p = RealScalar(0.5) * numext::real(T.coeff(i,i) - T.coeff(i+1,i+1));
+      RealScalar disc = p*p + numext::real(T.coeff(i,i+1) * T.coeff(i+1,i));
+      RealScalar z = disc < RealScalar(0) ? sqrt(-disc) : RealScalar(0);
+      RealScalar mean = numext::real(T.coeff(i+1,i+1)) + p;
+      eivals.coeffRef(i)   = ComplexScalar(mean, z);
+      eivals.coeffRef(i+1) = ComplexScalar(mean, -z);
+      i += 2;
+    }
+    else
+    {
+      eivals.coeffRef(i) = ComplexScalar(T.coeff(i,i));
+      i += 1;
+    }
+  }
+}
+
+/** \internal
+  * Swaps the adjacent diagonal blocks of sizes \a p and \a q starting at row \a j of the (quasi) triangular matrix \a T,
+  * and updates the Schur vectors \a V accordingly.
+  *
+  * The invariant subspace of the trailing block is obtained from the solution X of the Sylvester equation
+  * A11 X - X A22 = A12 as in the direct swapping method of Bai and Demmel. The swap is rejected, and false is
+  * returned, when both blocks share an eigenvalue or when it would not be backward stable.
+  */
+template<typename MatrixType, typename VectorsType>
+bool schur_swap_blocks(MatrixType& T, VectorsType& V, typename MatrixType::Index j,
+                       typename MatrixType::Index p, typename MatrixType::Index q)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic,0,4,4> SmallMatrixType;
+  typedef Matrix<Scalar,Dynamic,1,0,4,1> SmallVectorType;
+  const Index n = p+q;
+  const Index size = T.cols();
+
+  // solve the Sylvester equation in its Kronecker form (at most 4x4)
+  SmallMatrixType K = SmallMatrixType::Zero(p*q, p*q);
+  SmallVectorType rhs(p*q);
+  for(Index c=0; c<q; ++c)
+    for(Index r=0; r<p; ++r)
+    {
+      rhs.coeffRef(r+c*p) = T.coeff(j+r, j+p+c);
+      for(Index r2=0; r2<p; ++r2)
+        K.coeffRef(r+c*p, r2+c*p) += T.coeff(j+r, j+r2);
+      for(Index c2=0; c2<q; ++c2)
+        K.coeffRef(r+c*p, r+c2*p) -= T.coeff(j+p+c2, j+p+c);
+    }
+  FullPivLU<SmallMatrixType> lu(K);
+  if(!lu.isInvertible())
+    return false;
+  SmallVectorType x = lu.solve(rhs);
+
+  // G is the unitary factor of the QR decomposition of [-X; I], whose range is the invariant subspace of A22
+  SmallMatrixType Z = SmallMatrixType::Zero(n, q);
+  for(Index c=0; c<q; ++c)
+  {
+    for(Index r=0; r<p; ++r)
+      Z.coeffRef(r,c) = -x.coeff(r+c*p);
+    Z.coeffRef(p+c,c) = Scalar(1);
+  }
+  SmallMatrixType G = SmallMatrixType::Identity(n, n);
+  Scalar workspace[4];
+  for(Index c=0; c<q; ++c)
+  {
+    SmallVectorType essential;
+    Scalar tau;
+    RealScalar beta;
+    Z.col(c).tail(n-c).makeHouseholder(essential, tau, beta);
+    Z.bottomRightCorner(n-c, q-c).applyHouseholderOnTheLeft(essential, tau, workspace);
+    G.rightCols(n-c).applyHouseholderOnTheRight(essential.conjugate(), numext::conj(tau), workspace);
+  }
+
+  // reject the swap if the transformed block is not numerically block upper triangular
+  SmallMatrixType B = G.adjoint() * T.block(j, j, n, n) * G;
+  if(B.bottomLeftCorner(p, q).norm() > RealScalar(10) * NumTraits<RealScalar>::epsilon() * T.block(j, j, n, n).norm())
+    return false;
+
+  T.block(j, j, n, size-j) = G.adjoint() * T.block(j, j, n, size-j);
+  T.block(0, j, j+n, n) = T.block(0, j, j+n, n) * G;
+  V.middleCols(j, n) = V.middleCols(j, n) * G;
+  T.block(j+q, j, p, q).setZero();
+  return true;
+}
+
+/** \internal
+  * Converts the sum and the product of a pair of shifts to the scalar type of the matrix.
+  * For real matrices the shifts are either real, or a complex conjugate pair, such that the imaginary parts vanish.
+  */
+template<typename Scalar, bool IsComplex = NumTraits<Scalar>::IsComplex> struct multishift_qr_shift_cast
+{
+  template<typename ComplexScalar>
+  static Scalar run(const ComplexScalar& x) { return numext::real(x); }
+};
+
+template<typename Scalar> struct multishift_qr_shift_cast<Scalar,true>
+{
+  template<typename ComplexScalar>
+  static Scalar run(const ComplexScalar& x) { return Scalar(x); }
+};
+
+/** \internal
+  * Aggressive early deflation on the bottom \a nw rows of the active window il..iu of the Hessenberg matrix \a T.
+  *
+  * The trailing nw x nw window is reduced to Schur form. The eigenvalues whose coupling with the rest of the matrix
+  * (the "spike") is negligible are deflated, the other ones are moved to the top of the window and returned as
+  * shifts for the next sweep. The window is then brought back to Hessenberg form and the transformations are applied
+  * to the rest of \a T and to \a U.
+  *
+  * \returns the number of deflated eigenvalues, which now lie in rows iu-nd+1..iu decoupled from the active window
+  */
+template<typename SchurType, typename MatrixType, typename UMatrixType, typename ShiftsType>
+typename MatrixType::Index multishift_qr_aed(MatrixType& T, UMatrixType& U, bool computeU,
+                                             typename MatrixType::Index il, typename MatrixType::Index iu,
+                                             typename MatrixType::Index nw, ShiftsType& shifts)
+{
+  using std::abs;
+  using std::sqrt;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+  const Index size = T.cols();
+  nw = (std::min)(nw, iu-il+1);
+  const Index kwtop = iu - nw + 1;
+  const Scalar s = kwtop > il ? T.coeff(kwtop, kwtop-1) : Scalar(0);
+
+  // Schur form of the window, Tw = V^* T(kwtop:iu,kwtop:iu) V
+  SchurType schur(nw);
+  schur.computeFromHessenberg(T.block(kwtop, kwtop, nw, nw), DenseType::Identity(nw, nw), true);
+  if(schur.info()!=Success)
+  {
+    shifts.resize(0);
+    return 0;
+  }
+  DenseType Tw = schur.matrixT();
+  DenseType V = schur.matrixU();
+
+  // detect the deflatable eigenvalues from the bottom, and move the other ones to the top of the window:
+  // the blocks in [0,ilst) cannot be deflated, the ones in [ilst,ns) are not checked yet
+  const RealScalar ulp = NumTraits<RealScalar>::epsilon();
+  const RealScalar smlnum = (std::numeric_limits<RealScalar>::min)() * (RealScalar(nw) / ulp);
+  Index ns = nw;
+  Index ilst = 0;
+  while(ilst<ns)
+  {
+    Index kend = ns-1;
+    Index bs = (kend>0 && schur_block_size(Tw, kend-1)==2) ? 2 : 1;
+    Index kb = kend-bs+1;
+    RealScalar foo = abs(Tw.coeff(kend,kend));
+    if(bs==2)
+      foo += sqrt(abs(Tw.coeff(kend,kend-1))) * sqrt(abs(Tw.coeff(kend-1,kend)));
+    if(foo==RealScalar(0))
+      foo = abs(s);
+    RealScalar spike = abs(s) * V.row(0).segment(kb, bs).cwiseAbs().maxCoeff();
+    if(spike <= (std::max)(smlnum, ulp*foo))
+    {
+      ns -= bs;
+      continue;
+    }
+    for(Index pos=kb; pos>ilst;)
+    {
+      Index prev = (pos-2>=ilst && schur_block_size(Tw, pos-2)==2) ? 2 : 1;
+      if(!schur_swap_blocks(Tw, V, pos-prev, prev, bs))
+      {
+        // the block cannot be moved: stop looking for deflations
+        ilst = ns;
+        break;
+      }
+      pos -= prev;
+    }
+    if(ilst<ns)
+      ilst += bs;
+  }
+  // the undeflated eigenvalues are the shifts for the next sweep
+  schur_block_eigenvalues(Tw, ns, shifts);
+
+  if(ns==nw && s!=Scalar(0))
+    return 0;   // nothing deflated: keep T unchanged
+
+  // the spike is V^* (s e_1); restore the Hessenberg form of the undeflated part
+  VectorType spike = VectorType::Zero(nw);
+  spike.head(ns) = s * V.row(0).head(ns).adjoint();
+  if(ns>1 && s!=Scalar(0))
+  {
+    VectorType essential;
+    Scalar tau;
+    RealScalar beta;
+    VectorType workspace(nw);
+    spike.head(ns).makeHouseholder(essential, tau, beta);
+    Tw.topRows(ns).applyHouseholderOnTheLeft(essential, tau, workspace.data());
+    Tw.leftCols(ns).applyHouseholderOnTheRight(essential.conjugate(), numext::conj(tau), workspace.data());
+    V.leftCols(ns).applyHouseholderOnTheRight(essential.conjugate(), numext::conj(tau), workspace.data());
+    spike.head(ns).setZero();
+    spike.coeffRef(0) = beta;
+
+    HessenbergDecomposition<DenseType> hess(Tw.topLeftCorner(ns, ns));
+    DenseType Qh = hess.matrixQ();
+    Tw.topLeftCorner(ns, ns) = hess.matrixH();
+    Tw.topRightCorner(ns, nw-ns) = Qh.adjoint() * Tw.topRightCorner(ns, nw-ns);
+    V.leftCols(ns) = V.leftCols(ns) * Qh;
+  }
+
+  // copy the window back and apply V to the rest of the matrix
+  T.block(kwtop, kwtop, nw, nw) = Tw;
+  if(kwtop>il)
+    T.col(kwtop-1).segment(kwtop, nw) = spike;
+  if(iu+1<size)
+    T.block(kwtop, iu+1, nw, size-iu-1) = V.adjoint() * T.block(kwtop, iu+1, nw, size-iu-1);
+  if(kwtop>0)
+    T.block(0, kwtop, kwtop, nw) = T.block(0, kwtop, kwtop, nw) * V;
+  if(computeU)
+    U.middleCols(kwtop, nw) = U.middleCols(kwtop, nw) * V;
+
+  return nw-ns;
+}
+
+/** \internal
+  * Performs a small-bulge multishift QR sweep on the active window il..iu of the Hessenberg matrix \a T.
+  *
+  * Each pair of \a shifts defines a 3x3 bulge. The bulges are introduced at the top of the window as a tightly packed
+  * chain, and chased down together. The reflections are only applied within a band around the chain, and accumulated
+  * into a small orthogonal matrix which is applied to the rest of \a T and to \a U by matrix-matrix products.
+  */
+template<typename MatrixType, typename UMatrixType, typename ShiftsType>
+void multishift_qr_sweep(MatrixType& T, UMatrixType& U, bool computeU,
+                         typename MatrixType::Index il, typename MatrixType::Index iu, const ShiftsType& shifts)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef typename ShiftsType::Scalar ComplexScalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+  typedef Matrix<Scalar,3,1> Vector3s;
+  typedef multishift_qr_shift_cast<Scalar> ShiftCast;
+
+  const Index size = T.cols();
+  const Index nbmps = shifts.size()/2;
+  eigen_assert(nbmps>0 && iu-il+1 >= 3*nbmps+3);
+
+  // bulge b is introduced at time 3*b, and lies at row k = il + t - 3*b at time t until it leaves the window
+  const Index nsteps = 3*(nbmps-1) + (iu-il);
+  const Index chunk = (std::max)(Index(3)*nbmps, Index(12));
+  DenseType Uloc;
+  Matrix<Scalar,Dynamic,1> workspaceVector(size);
+  Scalar* workspace = workspaceVector.data();
+
+  for(Index t0=0; t0<nsteps; t0+=chunk)
+  {
+    const Index t1 = (std::min)(t0+chunk, nsteps);
+    const Index btop = (std::min)(nbmps-1, (t1-1)/3);
+    const Index wlo = (std::max)(il, il + t0 - 3*btop - 1);
+    const Index whi = (std::min)(iu, il + t1 + 2);
+    const Index w = whi-wlo+1;
+    Uloc.setIdentity(w, w);
+
+    for(Index t=t0; t<t1; ++t)
+    {
+      // chase the lowest bulges first, such that the chain stays well separated
+      for(Index b=0; b<nbmps && t-3*b>=0; ++b)
+      {
+        const Index k = il + t - 3*b;
+        if(k>iu-1)
+          continue;
+        const Index nr = (k==iu-1) ? 2 : 3;
+        Vector3s v;
+        if(k==il)
+        {
+          // first column of (T - s1 I)(T - s2 I), scaled to avoid overflows
+          const ComplexScalar s1 = shifts.coeff(2*b), s2 = shifts.coeff(2*b+1);
+          const Scalar h00 = T.coeff(il,il), h10 = T.coeff(il+1,il), h01 = T.coeff(il,il+1);
+          const Scalar h11 = T.coeff(il+1,il+1), h21 = T.coeff(il+2,il+1);
+          RealScalar scale = numext::norm1(ComplexScalar(h00)-s2) + numext::norm1(ComplexScalar(h10));
+          if(scale==RealScalar(0))
+            scale = RealScalar(1);
+          const ComplexScalar h10s = ComplexScalar(h10) / scale;
+          v.coeffRef(0) = ShiftCast::run(h10s*ComplexScalar(h01) + (ComplexScalar(h00)-s1) * ((ComplexScalar(h00)-s2)/scale));
+          v.coeffRef(1) = ShiftCast::run(h10s * (ComplexScalar(h00)+ComplexScalar(h11)-s1-s2));
+          v.coeffRef(2) = ShiftCast::run(h10s * ComplexScalar(h21));
+        }
+        else
+          v.head(nr) = T.block(k, k-1, nr, 1);
+
+        Scalar tau;
+        RealScalar beta;
+        Matrix<Scalar,2,1> essential;
+        if(nr==3)
+          v.makeHouseholder(essential, tau, beta);
+        else
+        {
+          Matrix<Scalar,1,1> ess1;
+          v.head(2).makeHouseholder(ess1, tau, beta);
+          essential.coeffRef(0) = ess1.coeff(0);
+        }
+        if(k>il)
+        {
+          T.coeffRef(k,k-1) = beta;
+          T.block(k+1, k-1, nr-1, 1).setZero();
+        }
+        if(tau==Scalar(0))
+          continue;
+
+        // reflections restricted to the band, the rest being updated after the chunk
+        const Index rhi = (std::min)(k+3, iu);
+        if(nr==3)
+        {
+          T.block(k, k, 3, whi-k+1).applyHouseholderOnTheLeft(essential, tau, workspace);
+          T.block(wlo, k, rhi-wlo+1, 3).applyHouseholderOnTheRight(essential.conjugate(), numext::conj(tau), workspace);
+          Uloc.block(0, k-wlo, w, 3).applyHouseholderOnTheRight(essential.conjugate(), numext::conj(tau), workspace);
+        }
+        else
+        {
+          T.block(k, k, 2, whi-k+1).applyHouseholderOnTheLeft(essential.head(1), tau, workspace);
+          T.block(wlo, k, rhi-wlo+1, 2).applyHouseholderOnTheRight(essential.head(1).conjugate(), numext::conj(tau), workspace);
+          Uloc.block(0, k-wlo, w, 2).applyHouseholderOnTheRight(essential.head(1).conjugate(), numext::conj(tau), workspace);
+        }
+      }
+    }
+
+    // level 3 updates of the parts of T and U outside the band
+    if(whi+1<size)
+      T.block(wlo, whi+1, w, size-whi-1) = Uloc.adjoint() * T.block(wlo, whi+1, w, size-whi-1);
+    if(wlo>0)
+      T.block(0, wlo, wlo, w) = T.block(0, wlo, wlo, w) * Uloc;
+    if(computeU)
+      U.middleCols(wlo, w) = U.middleCols(wlo, w) * Uloc;
+  }
+
+  // clean up pollution due to round-off errors
+  for(Index i=il+2; i<=iu; ++i)
+  {
+    T.coeffRef(i,i-2) = Scalar(0);
+    if(i>il+2)
+      T.coeffRef(i,i-3) = Scalar(0);
+  }
+}
+
+/** \internal
+  * Performs one iteration of the small-bulge multishift QR algorithm with aggressive early deflation on the active
+  * window il..iu of the Hessenberg matrix \a T, as in LAPACK's xLAQR0. This is only worth it for large windows:
+  * false is returned when the window is too small, and the caller should fall back to a standard QR step.
+  *
+  * \a iter is the number of iterations since the last deflation, and is used to trigger exceptional shifts.
+  */
+template<typename MatrixType, typename SchurType,
+         bool Enabled = (MatrixType::MaxColsAtCompileTime==Dynamic || MatrixType::MaxColsAtCompileTime>=75)>
+struct multishift_qr
+{
+  /** The QR sweeps are replaced by multishift sweeps on windows of at least this size */
+  enum { MinSize = 75 };
+
+  template<typename UMatrixType>
+  static bool run(MatrixType& T, UMatrixType& U, bool computeU, typename MatrixType::Index il,
+                  typename MatrixType::Index iu, typename MatrixType::Index iter)
+  {
+    using std::abs;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef std::complex<RealScalar> ComplexScalar;
+    typedef Matrix<ComplexScalar,Dynamic,1> ShiftsType;
+    typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+
+    const Index active = iu-il+1;
+    // the standard QR step is in charge of small windows, and of reporting the failure on non finite entries
+    if(active<Index(MinSize) || !T.block(il, il, active, active).allFinite())
+      return false;
+
+    // number of shifts and size of the deflation window, as recommended by LAPACK's iparmq
+    Index nsr = 10;
+    if(active>=150)
+    {
+      Index log2 = 0;
+      while((Index(1)<<(log2+1)) <= active) ++log2;
+      nsr = (std::max)(Index(10), active/log2);
+    }
+    if(active>=590)  nsr = 64;
+    if(active>=3000) nsr = 128;
+    if(active>=6000) nsr = 256;
+    nsr = (std::min)(nsr, (active-3)/6);
+    nsr = (std::max)(Index(2), nsr - nsr%2);
+    const Index nw = active<=500 ? nsr : 3*nsr/2;
+
+    ShiftsType aedShifts;
+    const Index nd = multishift_qr_aed<SchurType>(T, U, computeU, il, iu, nw, aedShifts);
+    const Index bottom = iu-nd;
+    // skip the sweep if the deflation was successful enough
+    if(nd>0 && (100*nd > 14*nw || bottom-il+1 < Index(MinSize)))
+      return true;
+
+    ShiftsType candidates;
+    if(iter>0 && iter%6==0)
+    {
+      // exceptional shifts, built from the magnitudes of the subdiagonal entries
+      candidates.resize(nsr);
+      for(Index i=0; i+1<nsr; i+=2)
+      {
+        Index r = (std::max)(bottom-i, il+2);
+        RealScalar ss = abs(T.coeff(r,r-1)) + abs(T.coeff(r-1,r-2));
+        RealScalar aa = RealScalar(0.75)*ss + numext::real(T.coeff(r,r));
+        candidates.coeffRef(i)   = ComplexScalar(aa,  RealScalar(0.6614378277661477)*ss);
+        candidates.coeffRef(i+1) = ComplexScalar(aa, -RealScalar(0.6614378277661477)*ss);
+      }
+    }
+    else if(aedShifts.size()>=2)
+      candidates = aedShifts;
+    else
+    {
+      // not enough shifts from the deflation window: use the eigenvalues of the trailing submatrix
+      const Index ns = (std::min)(nsr, bottom-il+1);
+      SchurType schur(ns);
+      schur.computeFromHessenberg(T.block(bottom-ns+1, bottom-ns+1, ns, ns), DenseType::Identity(ns, ns), false);
+      if(schur.info()!=Success)
+        return false;
+      schur_block_eigenvalues(schur.matrixT(), ns, candidates);
+    }
+
+    // group the shifts in pairs, keeping the complex conjugate pairs together, and starting from the bottom ones
+    const Index maxPairs = (std::min)(nsr/2, (bottom-il+1-3)/3);
+    ShiftsType shifts(2*maxPairs);
+    Index npairs = 0;
+    Index pendingReal = -1;
+    for(Index i=candidates.size()-1; i>=0 && npairs<maxPairs; --i)
+    {
+      const ComplexScalar c = candidates.coeff(i);
+      if(NumTraits<Scalar>::IsComplex || numext::imag(c)==RealScalar(0))
+      {
+        if(pendingReal<0)
+          pendingReal = i;
+        else
+        {
+          shifts.coeffRef(2*npairs) = candidates.coeff(pendingReal);
+          shifts.coeffRef(2*npairs+1) = c;
+          ++npairs;
+          pendingReal = -1;
+        }
+      }
+      else if(i>0)
+      {
+        shifts.coeffRef(2*npairs) = c;
+        shifts.coeffRef(2*npairs+1) = candidates.coeff(i-1);
+        ++npairs;
+        --i;
+      }
+    }
+    if(npairs==0 && pendingReal>=0)
+    {
+      // a single real shift: use it twice
+      shifts.coeffRef(0) = shifts.coeffRef(1) = candidates.coeff(pendingReal);
+      npairs = 1;
+    }
+    if(npairs==0)
+      return false;
+
+    multishift_qr_sweep(T, U, computeU, il, bottom, shifts.head(2*npairs));
+    return true;
+  }
+};
+
+template<typename MatrixType, typename SchurType>
+struct multishift_qr<MatrixType, SchurType, false>
+{
+  template<typename UMatrixType>
+  static bool run(MatrixType&, UMatrixType&, bool, typename MatrixType::Index, typename MatrixType::Index,
+                  typename MatrixType::Index)
+  {
+    return false;
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_MULTISHIFT_QR_H
@@ -12,6 +12,7 @@
 #define EIGEN_REAL_SCHUR_H
 
 #include "./HessenbergDecomposition.h"
+#include "./MultishiftQR.h"
 
 namespace Eigen { 
 
@@ -160,6 +161,10 @@ template<typename _MatrixType> class RealSchur
       * may be taken to be \f$25n^3\f$ flops if \a computeU is true and
       * \f$10n^3\f$ flops if \a computeU is false.
       *
+      * Active windows of size 75 and more are processed by the small-bulge multishift QR
+      * algorithm with aggressive early deflation of Braman, Byers and Mathias instead. Most of the work is then
+      * performed by matrix-matrix products, and far fewer iterations are needed for large matrices.
+      *
       * Example: \include RealSchur_compute.cpp
       * Output: \verbinclude RealSchur_compute.out
       *
@@ -311,6 +316,9 @@ RealSchur<MatrixType>& RealSchur<MatrixType>::computeFromHessenberg(const HessMa
         iter = iter + 1;
         totalIter = totalIter + 1;
         if (totalIter > maxIters) break;
+        // large active windows are processed by multishift QR sweeps with aggressive early deflation
+        if (internal::multishift_qr<MatrixType, RealSchur<Matrix<Scalar,Dynamic,Dynamic> > >::run(m_matT, m_matU, computeU, il, iu, iter))
+          continue;
         Index im;
         initFrancisQRStep(il, iu, shiftInfo, im, firstHouseholderVector);
         performFrancisQRStep(il, im, iu, computeU, firstHouseholderVector, workspace);
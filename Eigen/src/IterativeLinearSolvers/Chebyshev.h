@@ -0,0 +1,642 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_CHEBYSHEV_H
+#define EIGEN_CHEBYSHEV_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal \returns the number of eigenvalues lower than \a x of the symmetric tridiagonal matrix
+  * of diagonal \a diag and sub-diagonal \a subdiag, from the signs of its LDL^T factorization (Sturm sequence) */
+template<typename RealVector>
+typename RealVector::Index tridiagonal_eigenvalue_count(const RealVector& diag, const RealVector& subdiag,
+                                                        typename RealVector::Scalar x)
+{
+  typedef typename RealVector::Scalar RealScalar;
+  typedef typename RealVector::Index Index;
+  const RealScalar tiny = (std::numeric_limits<RealScalar>::min)();
+  Index count = 0;
+  RealScalar d(1);
+  for(Index i=0; i<diag.size(); ++i)
+  {
+    d = diag(i) - x - (i>0 ? subdiag(i-1)*subdiag(i-1)/d : RealScalar(0));
+    if(d==RealScalar(0))
+      d = -tiny;
+    if(d<RealScalar(0))
+      ++count;
+  }
+  return count;
+}
+
+/** \internal Estimates the extreme eigenvalues of the preconditioned matrix \f$ M^{-1} A \f$, where \a mat and
+  * \a precond must be selfadjoint positive definite, by \a steps iterations of the preconditioned Lanczos process.
+  * The Lanczos coefficients are recovered from the ones of the conjugate gradient, and the extreme eigenvalues of
+  * the resulting tridiagonal matrix, the Ritz values, are computed by bisection.
+  * On output, \a lmin and \a lmax are the smallest and largest Ritz values, which lie inside the spectrum.
+  */
+template<typename MatrixType, typename Preconditioner, typename RealScalar>
+void chebyshev_eigenvalue_estimates(const MatrixType& mat, const Preconditioner& precond, int steps,
+                                    RealScalar& lmin, RealScalar& lmax)
+{
+  using std::sqrt;
+  using std::abs;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<RealScalar,Dynamic,1> RealVector;
+
+  const int n = mat.cols();
+  lmin = lmax = RealScalar(1);
+  if(n==0)
+    return;
+  steps = (std::max)(1, (std::min)(steps, n));
+
+  // a deterministic starting vector, which is not orthogonal to the smooth nor to the oscillating modes
+  VectorType r(n), z(n), p(n), tmp(n);
+  for(int i=0; i<n; ++i)
+    r(i) = Scalar(RealScalar(1) + RealScalar(i%7)/RealScalar(7));
+  z = precond.solve(r);
+  p = z;
+  RealScalar absNew = numext::real(r.dot(z));
+  const RealScalar absInit = absNew;
+
+  RealVector diag(steps), subdiag(steps);
+  RealScalar alphaOld(1), betaOld(0);
+  int k = 0;
+  while(k < steps)
+  {
+    tmp.noalias() = mat * p;
+    RealScalar pAp = numext::real(p.dot(tmp));
+    if(!(pAp > RealScalar(0)) || !(absNew > RealScalar(0)))
+      break;
+    RealScalar alpha = absNew / pAp;
+    diag(k) = RealScalar(1)/alpha + betaOld/alphaOld;
+    ++k;
+
+    r -= alpha * tmp;
+    z = precond.solve(r);
+    RealScalar absOld = absNew;
+    absNew = numext::real(r.dot(z));
+    RealScalar beta = absNew / absOld;
+    // stop once the Krylov space is exhausted
+    if(k==steps || !(absNew > NumTraits<RealScalar>::epsilon() * NumTraits<RealScalar>::epsilon() * absInit))
+      break;
+    subdiag(k-1) = sqrt(beta) / alpha;
+    p = z + beta * p;
+    alphaOld = alpha;
+    betaOld = beta;
+  }
+  if(k==0)
+    return;
+
+  // Gershgorin bounds of the tridiagonal matrix, refined by bisection
+  RealScalar lower = diag(0), upper = diag(0);
+  for(int i=0; i<k; ++i)
+  {
+    RealScalar radius = (i>0 ? abs(subdiag(i-1)) : RealScalar(0)) + (i<k-1 ? abs(subdiag(i)) : RealScalar(0));
+    lower = (std::min)(lower, diag(i) - radius);
+    upper = (std::max)(upper, diag(i) + radius);
+  }
+  const RealVector d = diag.head(k), s = subdiag.head((std::max)(k-1,0));
+  for(int which=0; which<2; ++which)
+  {
+    // the smallest eigenvalue is the lowest x with one eigenvalue below it, the largest one with k of them
+    const int target = which==0 ? 1 : k;
+    RealScalar lo = lower, hi = upper;
+    for(int it=0; it<128 && hi-lo > NumTraits<RealScalar>::epsilon() * (abs(lo)+abs(hi)); ++it)
+    {
+      RealScalar mid = (lo+hi)/RealScalar(2);
+      if(tridiagonal_eigenvalue_count(d, s, mid) >= target)
+        hi = mid;
+      else
+        lo = mid;
+    }
+    (which==0 ? lmin : lmax) = hi;
+  }
+}
+
+/** \internal Low-level Chebyshev iteration algorithm
+  *
+  * Each iteration costs one matrix-vector product, one application of the preconditioner and a few vector updates:
+  * the recurrence coefficients only depend on the bounds \a lmin and \a lmax of the spectrum of the preconditioned
+  * matrix, so that no inner product is needed.
+  *
+  * \param mat The matrix A
+  * \param rhs The right hand side vector b
+  * \param x On input and initial solution, on output the computed solution.
+  * \param precond A preconditioner being able to efficiently solve for an
+  *                approximation of Ax=b (regardless of b)
+  * \param lmin, lmax The bounds of the eigenvalues of the preconditioned matrix.
+  * \param iters On input the max number of iteration, on output the number of performed iterations.
+  * \param tol_error On input the tolerance error, on output an estimation of the relative error.
+  * \param checkInterval The residual norm is only computed every \a checkInterval iterations, and never when it
+  *                      is zero, in which case exactly \a iters iterations are performed.
+  *
+  * For references, please see:
+  *
+  * Saad, Y.
+  * Iterative Methods for Sparse Linear Systems, section 12.3.
+  * Society for Industrial and Applied Mathematics, Philadelphia, 2003.
+  */
+template<typename MatrixType, typename Rhs, typename Dest, typename Preconditioner>
+EIGEN_DONT_INLINE
+void chebyshev_iteration(const MatrixType& mat, const Rhs& rhs, Dest& x, const Preconditioner& precond,
+                         typename Dest::RealScalar lmin, typename Dest::RealScalar lmax,
+                         int& iters, typename Dest::RealScalar& tol_error, int checkInterval)
+{
+  using std::sqrt;
+  typedef typename Dest::RealScalar RealScalar;
+  typedef typename Dest::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+  const RealScalar tol = tol_error;
+  const int maxIters = iters;
+  const int n = mat.cols();
+  const bool check = checkInterval > 0;
+
+  // the initial guess of the polynomial preconditioners is zero, which saves one product
+  VectorType residual(n), z(n), d(n), tmp(n);
+  if(x.isZero(0))
+    residual = rhs;
+  else
+    residual = rhs - mat * x;
+
+  RealScalar rhsNorm2(0), threshold(0), residualNorm2(0);
+  if(check)
+  {
+    rhsNorm2 = rhs.squaredNorm();
+    if(rhsNorm2 == 0)
+    {
+      x.setZero();
+      iters = 0;
+      tol_error = 0;
+      return;
+    }
+    threshold = tol*tol*rhsNorm2;
+    residualNorm2 = residual.squaredNorm();
+    if(residualNorm2 < threshold || maxIters <= 0)
+    {
+      iters = 0;
+      tol_error = sqrt(residualNorm2 / rhsNorm2);
+      return;
+    }
+  }
+  else if(maxIters <= 0)
+  {
+    iters = 0;
+    return;
+  }
+
+  const RealScalar theta = (lmax + lmin) / RealScalar(2);
+  const RealScalar delta = (std::max)((lmax - lmin) / RealScalar(2), NumTraits<RealScalar>::epsilon() * theta);
+  const RealScalar sigma = theta / delta;
+  RealScalar rho = RealScalar(1) / sigma;
+
+  z = precond.solve(residual);
+  d = z / theta;
+  int i = 0;
+  while(true)
+  {
+    x += d;
+    ++i;
+    if(!check && i >= maxIters)
+      break;
+
+    if(check && (i % checkInterval == 0 || i >= maxIters))
+    {
+      // replace the updated residual by the true one, for the same cost, such that rounding errors do not
+      // accumulate
+      residual = rhs - mat * x;
+      residualNorm2 = residual.squaredNorm();
+      if(residualNorm2 < threshold || i >= maxIters)
+        break;
+    }
+    else
+    {
+      tmp.noalias() = mat * d;            // the bottleneck of the algorithm
+      residual -= tmp;
+    }
+
+    z = precond.solve(residual);
+    RealScalar rhoNew = RealScalar(1) / (RealScalar(2)*sigma - rho);
+    d = (rhoNew*rho) * d + (RealScalar(2)*rhoNew/delta) * z;
+    rho = rhoNew;
+  }
+  if(check)
+    tol_error = sqrt(residualNorm2 / rhsNorm2);
+  iters = i;
+}
+
+} // end namespace internal
+
+template< typename _MatrixType, int _UpLo=Lower,
+          typename _Preconditioner = DiagonalPreconditioner<typename _MatrixType::Scalar> >
+class ChebyshevIteration;
+
+namespace internal {
+
+template< typename _MatrixType, int _UpLo, typename _Preconditioner>
+struct traits<ChebyshevIteration<_MatrixType,_UpLo,_Preconditioner> >
+{
+  typedef _MatrixType MatrixType;
+  typedef _Preconditioner Preconditioner;
+};
+
+}
+
+/** \ingroup IterativeLinearSolvers_Module
+  * \brief A Chebyshev iteration solver for sparse self-adjoint positive definite problems
+  *
+  * This class allows to solve for A.x = b sparse linear problems using the Chebyshev iteration. Unlike the
+  * conjugate gradient, its iterations do not compute any inner product: with a DiagonalPreconditioner, each
+  * iteration is only made of one sparse matrix-vector product and of coefficient-wise vector updates, which
+  * need no global synchronization. The recurrence relies on bounds of the eigenvalues of the preconditioned
+  * matrix instead, which are estimated by a few Lanczos steps in compute(), or given by setEigenvalueBounds().
+  * The residual norm is only computed every ten iterations to check the convergence.
+  *
+  * \tparam _MatrixType the type of the matrix A, can be a dense or a sparse matrix.
+  * \tparam _UpLo the triangular part that will be used for the computations. It can be Lower,
+  *               Upper, or Lower|Upper in which the full matrix entries will be considered. Default is Lower.
+  * \tparam _Preconditioner the type of the preconditioner. Default is DiagonalPreconditioner
+  *
+  * The maximal number of iterations and tolerance value can be controlled via the setMaxIterations()
+  * and setTolerance() methods. The default tolerance is NumTraits<Scalar>::epsilon(), and the default maximal
+  * number of iterations is derived from it and from the eigenvalue bounds, see maxIterations().
+  *
+  * The convergence rate is the one of the conjugate gradient in the worst case, so that this solver is
+  * mostly useful when the inner products are the scaling limit, or as a smoother. See ChebyshevPreconditioner
+  * to combine the Chebyshev polynomials with ConjugateGradient.
+  * \code
+  * int n = 10000;
+  * VectorXd x(n), b(n);
+  * SparseMatrix<double> A(n,n);
+  * // fill A and b
+  * ChebyshevIteration<SparseMatrix<double> > solver;
+  * solver.compute(A);
+  * x = solver.solve(b);
+  * std::cout << "#iterations:     " << solver.iterations() << std::endl;
+  * std::cout << "estimated error: " << solver.error()      << std::endl;
+  * \endcode
+  *
+  * By default the iterations start with x=0 as an initial guess of the solution.
+  * One can control the start using the solveWithGuess() method.
+  *
+  * \sa class ConjugateGradient, class ChebyshevPreconditioner
+  */
+template< typename _MatrixType, int _UpLo, typename _Preconditioner>
+class ChebyshevIteration : public IterativeSolverBase<ChebyshevIteration<_MatrixType,_UpLo,_Preconditioner> >
+{
+  typedef IterativeSolverBase<ChebyshevIteration> Base;
+  using Base::mp_matrix;
+  using Base::m_error;
+  using Base::m_iterations;
+  using Base::m_info;
+  using Base::m_isInitialized;
+public:
+  typedef _MatrixType MatrixType;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef _Preconditioner Preconditioner;
+
+  enum {
+    UpLo = _UpLo
+  };
+
+public:
+
+  /** Default constructor. */
+  ChebyshevIteration() : Base(), m_lmin(1), m_lmax(1), m_userBounds(false) {}
+
+  /** Initialize the solver with matrix \a A for further \c Ax=b solving.
+    *
+    * This constructor is a shortcut for the default constructor followed
+    * by a call to compute().
+    *
+    * \warning this class stores a reference to the matrix A as well as some
+    * precomputed values that depend on it. Therefore, if \a A is changed
+    * this class becomes invalid. Call compute() to update it with the new
+    * matrix A, or modify a copy of A.
+    */
+  template<typename MatrixDerived>
+  explicit ChebyshevIteration(const EigenBase<MatrixDerived>& A)
+    : Base(A.derived()), m_lmin(1), m_lmax(1), m_userBounds(false)
+  {
+    estimateEigenvalueBounds();
+  }
+
+  ~ChebyshevIteration() {}
+
+  /** Initializes the preconditioner and estimates the eigenvalue bounds of the preconditioned matrix
+    * \a A, unless they have been set by setEigenvalueBounds(). */
+  template<typename MatrixDerived>
+  ChebyshevIteration& compute(const EigenBase<MatrixDerived>& A)
+  {
+    Base::compute(A.derived());
+    estimateEigenvalueBounds();
+    return *this;
+  }
+
+  /** \sa compute() */
+  template<typename MatrixDerived>
+  ChebyshevIteration& factorize(const EigenBase<MatrixDerived>& A)
+  {
+    Base::factorize(A.derived());
+    estimateEigenvalueBounds();
+    return *this;
+  }
+
+  /** Sets the bounds of the eigenvalues of the preconditioned matrix, which disables their estimation by
+    * compute(). The iteration converges faster with tight bounds, and diverges if \a lmax is too small. */
+  ChebyshevIteration& setEigenvalueBounds(const RealScalar& lmin, const RealScalar& lmax)
+  {
+    eigen_assert(RealScalar(0)<lmin && lmin<=lmax && "ChebyshevIteration: invalid eigenvalue bounds");
+    m_lmin = lmin;
+    m_lmax = lmax;
+    m_userBounds = true;
+    return *this;
+  }
+
+  /** \returns the max number of iterations. Unless set by setMaxIterations(), it is the number of iterations
+    * which reduces the error by the tolerance according to the eigenvalue bounds, at least the size of the
+    * problem, and at most ten times the size of the problem. */
+  int maxIterations() const
+  {
+    using std::sqrt;
+    using std::log;
+    using std::ceil;
+    if(Base::m_maxIterations>=0 || !mp_matrix)
+      return Base::maxIterations();
+    // the error is reduced by 2 q^k after k iterations, with q = (sqrt(kappa)-1)/(sqrt(kappa)+1)
+    RealScalar sqrtKappa = sqrt(m_lmax / m_lmin);
+    RealScalar q = (sqrtKappa - RealScalar(1)) / (sqrtKappa + RealScalar(1));
+    RealScalar tol = (std::max)(Base::m_tolerance, NumTraits<RealScalar>::epsilon());
+    RealScalar iters = q > RealScalar(0) ? ceil(log(tol / RealScalar(2)) / log(q)) : RealScalar(1);
+    const int n = mp_matrix->cols();
+    iters = (std::min)(iters + RealScalar(10), RealScalar((std::max)(10*n, 100)));
+    return (std::max)(n, int(iters));
+  }
+
+  /** \returns the lower bound of the eigenvalues of the preconditioned matrix */
+  RealScalar minEigenvalue() const { return m_lmin; }
+
+  /** \returns the upper bound of the eigenvalues of the preconditioned matrix */
+  RealScalar maxEigenvalue() const { return m_lmax; }
+
+  /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A
+    * \a x0 as an initial solution.
+    *
+    * \sa compute()
+    */
+  template<typename Rhs,typename Guess>
+  inline const internal::solve_retval_with_guess<ChebyshevIteration, Rhs, Guess>
+  solveWithGuess(const MatrixBase<Rhs>& b, const Guess& x0) const
+  {
+    eigen_assert(m_isInitialized && "ChebyshevIteration is not initialized.");
+    eigen_assert(Base::rows()==b.rows()
+              && "ChebyshevIteration::solve(): invalid number of rows of the right hand side matrix b");
+    return internal::solve_retval_with_guess
+            <ChebyshevIteration, Rhs, Guess>(*this, b.derived(), x0);
+  }
+
+  /** \internal */
+  template<typename Rhs,typename Dest>
+  void _solveWithGuess(const Rhs& b, Dest& x) const
+  {
+    // the columns converge at different rates: report the worst one
+    RealScalar maxError(0);
+    int maxIters = 0;
+    for(int j=0; j<b.cols(); ++j)
+    {
+      m_iterations = maxIterations();
+      m_error = Base::m_tolerance;
+
+      typename Dest::ColXpr xj(x,j);
+      internal::chebyshev_iteration(MatrixWrapperType(*mp_matrix), b.col(j), xj, Base::m_preconditioner,
+                                    m_lmin, m_lmax, m_iterations, m_error, 10);
+      maxError = (std::max)(maxError, m_error);
+      maxIters = (std::max)(maxIters, m_iterations);
+    }
+    m_error = maxError;
+    m_iterations = maxIters;
+
+    m_isInitialized = true;
+    m_info = m_error <= Base::m_tolerance ? Success : NoConvergence;
+  }
+
+  /** \internal */
+  template<typename Rhs,typename Dest>
+  void _solve(const Rhs& b, Dest& x) const
+  {
+    x.setZero();
+    _solveWithGuess(b,x);
+  }
+
+protected:
+  typedef typename internal::conditional<UpLo==(Lower|Upper) || internal::is_matrix_free<MatrixType>::value,
+                                         const MatrixType&,
+                                         SparseSelfAdjointView<const MatrixType, UpLo>
+                                        >::type MatrixWrapperType;
+
+  void estimateEigenvalueBounds()
+  {
+    if(m_userBounds)
+      return;
+    // the largest Ritz value underestimates the largest eigenvalue, while the iteration diverges when the latter
+    // is above the upper bound: enlarge it by 10%
+    internal::chebyshev_eigenvalue_estimates(MatrixWrapperType(*mp_matrix), Base::m_preconditioner, 20,
+                                             m_lmin, m_lmax);
+    m_lmax *= RealScalar(1.1);
+  }
+
+  RealScalar m_lmin, m_lmax;
+  bool m_userBounds;
+};
+
+
+namespace internal {
+
+template<typename _MatrixType, int _UpLo, typename _Preconditioner, typename Rhs>
+struct solve_retval<ChebyshevIteration<_MatrixType,_UpLo,_Preconditioner>, Rhs>
+  : solve_retval_base<ChebyshevIteration<_MatrixType,_UpLo,_Preconditioner>, Rhs>
+{
+  typedef ChebyshevIteration<_MatrixType,_UpLo,_Preconditioner> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+/** \ingroup IterativeLinearSolvers_Module
+  * \brief A Chebyshev polynomial preconditioner for self-adjoint positive definite problems
+  *
+  * This preconditioner approximately solves for A.x = b by a fixed number of Chebyshev iterations started
+  * from zero, preconditioned by the diagonal of A. This amounts to apply a polynomial of degree setDegree()
+  * in \f$ D^{-1} A \f$, which is selfadjoint and positive definite, so that it can be used with ConjugateGradient.
+  * Its application only needs sparse matrix-vector products and coefficient-wise vector updates, and no inner
+  * product, so that it adds no global synchronization to the solver while reducing its number of iterations.
+  *
+  * The polynomial minimizes the residual on the interval \f$ [\lambda_{max}/r, \lambda_{max}] \f$, where
+  * \f$ \lambda_{max} \f$ is the largest eigenvalue of \f$ D^{-1} A \f$, estimated by ten Lanczos steps and
+  * enlarged by 10%, and \f$ r \f$ is set by setEigenvalueRatio(). It thus damps the high frequency components of
+  * the error, and can also be used as a smoother.
+  *
+  * \tparam _MatrixType the type of the matrix A, can be a dense or a sparse matrix.
+  * \tparam _UpLo the triangular part of A used by the products, like for ConjugateGradient. Default is Lower.
+  *
+  * \code
+  * ConjugateGradient<SparseMatrix<double>, Lower, ChebyshevPreconditioner<SparseMatrix<double> > > cg;
+  * cg.preconditioner().setDegree(4);
+  * cg.compute(A);
+  * x = cg.solve(b);
+  * \endcode
+  *
+  * \warning this class stores a reference to the matrix A, which is the one of the solver when it is used
+  * as a preconditioner.
+  *
+  * \sa class ConjugateGradient, class ChebyshevIteration, class DiagonalPreconditioner
+  */
+template<typename _MatrixType, int _UpLo = Lower>
+class ChebyshevPreconditioner
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+    enum {
+      UpLo = _UpLo
+    };
+
+    ChebyshevPreconditioner()
+      : mp_matrix(0), m_degree(3), m_ratio(30), m_lmin(1), m_lmax(1), m_isInitialized(false)
+    {}
+
+    explicit ChebyshevPreconditioner(const MatrixType& mat)
+      : mp_matrix(0), m_degree(3), m_ratio(30), m_lmin(1), m_lmax(1), m_isInitialized(false)
+    {
+      compute(mat);
+    }
+
+    Index rows() const { return mp_matrix ? mp_matrix->rows() : 0; }
+    Index cols() const { return mp_matrix ? mp_matrix->cols() : 0; }
+
+    /** Sets the degree of the polynomial, that is the number of matrix-vector products per application
+      * (default is 3). */
+    ChebyshevPreconditioner& setDegree(int degree)
+    {
+      eigen_assert(degree>0);
+      m_degree = degree;
+      return *this;
+    }
+
+    /** Sets the ratio between the largest eigenvalue and the lower end of the interval on which the
+      * polynomial is minimized (default is 30). Takes effect at the next call to compute(). */
+    ChebyshevPreconditioner& setEigenvalueRatio(const RealScalar& ratio)
+    {
+      eigen_assert(ratio>=RealScalar(1));
+      m_ratio = ratio;
+      return *this;
+    }
+
+    /** \returns the degree of the polynomial */
+    int degree() const { return m_degree; }
+
+    /** \returns the estimate of the largest eigenvalue of \f$ D^{-1} A \f$, enlarged by 10% */
+    RealScalar maxEigenvalue() const { return m_lmax; }
+
+    ChebyshevPreconditioner& analyzePattern(const MatrixType& )
+    {
+      return *this;
+    }
+
+    ChebyshevPreconditioner& factorize(const MatrixType& mat)
+    {
+      mp_matrix = &mat;
+      m_jacobi.compute(mat);
+      RealScalar lmin;
+      internal::chebyshev_eigenvalue_estimates(MatrixWrapperType(mat), m_jacobi, 10, lmin, m_lmax);
+      m_lmax *= RealScalar(1.1);
+      m_lmin = m_lmax / m_ratio;
+      m_isInitialized = true;
+      return *this;
+    }
+
+    ChebyshevPreconditioner& compute(const MatrixType& mat)
+    {
+      return factorize(mat);
+    }
+
+    /** \internal */
+    template<typename Rhs, typename Dest>
+    void _solve(const Rhs& b, Dest& x) const
+    {
+      x.resize(b.rows(), b.cols());
+      VectorType y(b.rows());
+      for(Index j=0; j<b.cols(); ++j)
+      {
+        y.setZero();
+        int iters = m_degree;
+        RealScalar tol(0);
+        internal::chebyshev_iteration(MatrixWrapperType(*mp_matrix), b.col(j), y, m_jacobi,
+                                      m_lmin, m_lmax, iters, tol, 0);
+        x.col(j) = y;
+      }
+    }
+
+    template<typename Rhs> inline const internal::solve_retval<ChebyshevPreconditioner, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "ChebyshevPreconditioner is not initialized.");
+      eigen_assert(cols()==b.rows()
+                && "ChebyshevPreconditioner::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<ChebyshevPreconditioner, Rhs>(*this, b.derived());
+    }
+
+    ComputationInfo info() { return Success; }
+
+  protected:
+    typedef typename internal::conditional<UpLo==(Lower|Upper),
+                                           const MatrixType&,
+                                           SparseSelfAdjointView<const MatrixType, UpLo>
+                                          >::type MatrixWrapperType;
+
+    const MatrixType* mp_matrix;
+    DiagonalPreconditioner<Scalar> m_jacobi;
+    int m_degree;
+    RealScalar m_ratio;
+    RealScalar m_lmin, m_lmax;
+    bool m_isInitialized;
+};
+
+namespace internal {
+
+template<typename _MatrixType, int _UpLo, typename Rhs>
+struct solve_retval<ChebyshevPreconditioner<_MatrixType,_UpLo>, Rhs>
+  : solve_retval_base<ChebyshevPreconditioner<_MatrixType,_UpLo>, Rhs>
+{
+  typedef ChebyshevPreconditioner<_MatrixType,_UpLo> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_CHEBYSHEV_H
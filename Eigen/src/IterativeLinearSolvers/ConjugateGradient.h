@@ -201,7 +201,7 @@ public:
   template<typename Rhs,typename Dest>
   void _solveWithGuess(const Rhs& b, Dest& x) const
   {
-    typedef typename internal::conditional<UpLo==(Lower|Upper),
+    typedef typename internal::conditional<UpLo==(Lower|Upper) || internal::is_matrix_free<MatrixType>::value,
                                            const MatrixType&,
                                            SparseSelfAdjointView<const MatrixType, UpLo>
                                           >::type MatrixWrapperType;
@@ -0,0 +1,184 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_MATRIX_FREE_OPERATOR_H
+#define EIGEN_MATRIX_FREE_OPERATOR_H
+
+namespace Eigen {
+
+template<typename _Scalar, typename _Functor> class MatrixFreeOperator;
+
+namespace internal {
+
+template<typename _Scalar, typename _Functor>
+struct traits<MatrixFreeOperator<_Scalar,_Functor> >
+{
+  typedef _Scalar Scalar;
+  typedef typename NumTraits<_Scalar>::Real RealScalar;
+  typedef Dense StorageKind;
+  typedef DenseIndex Index;
+  enum {
+    RowsAtCompileTime = Dynamic,
+    ColsAtCompileTime = Dynamic,
+    MaxRowsAtCompileTime = Dynamic,
+    MaxColsAtCompileTime = Dynamic,
+    Flags = 0
+  };
+};
+
+/** \internal \c value is true when \a MatrixType is only known through its product with vectors */
+template<typename MatrixType> struct is_matrix_free { enum { value = false }; };
+template<typename _Scalar, typename _Functor>
+struct is_matrix_free<MatrixFreeOperator<_Scalar,_Functor> > { enum { value = true }; };
+
+template<typename Op, typename Rhs> class matrix_free_product;
+
+template<typename Op, typename Rhs>
+struct traits<matrix_free_product<Op,Rhs> >
+{
+  typedef Matrix<typename Op::Scalar, Dynamic, Rhs::ColsAtCompileTime> ReturnType;
+};
+
+/** \internal Expression of the product of a MatrixFreeOperator by a dense vector or matrix.
+  * The functor of the operator is called once per column, and the result is written directly into the destination. */
+template<typename Op, typename Rhs>
+class matrix_free_product : public ReturnByValue<matrix_free_product<Op,Rhs> >
+{
+  public:
+    typedef typename Op::Scalar Scalar;
+    typedef typename Op::Index Index;
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+    matrix_free_product(const Op& op, const Rhs& rhs) : m_op(op), m_rhs(rhs) {}
+
+    inline Index rows() const { return m_op.rows(); }
+    inline Index cols() const { return m_rhs.cols(); }
+
+    template<typename Dest> void evalTo(Dest& dst) const
+    {
+      eigen_assert(m_op.cols()==m_rhs.rows() && "invalid matrix product");
+      dst.resize(m_op.rows(), m_rhs.cols());
+      for(Index j=0; j<m_rhs.cols(); ++j)
+      {
+        Ref<const VectorType> x(m_rhs.col(j));
+        Ref<VectorType> y(dst.col(j));
+        if(x.data()==y.data())
+        {
+          // y = A * y, the functor expects distinct buffers
+          VectorType tmp(y.size());
+          m_op.functor()(x, Ref<VectorType>(tmp));
+          y = tmp;
+        }
+        else
+          m_op.functor()(x, y);
+      }
+    }
+
+  protected:
+    const Op& m_op;
+    typename nested<Rhs>::type m_rhs;
+};
+
+} // end namespace internal
+
+/** \ingroup IterativeLinearSolvers_Module
+  * \brief A linear operator defined by its product with vectors, for the iterative solvers
+  *
+  * The iterative solvers only access the matrix A through products \f$ y = A x \f$. This class exposes a
+  * user functor computing such products as a matrix, so that operators which are too large or too costly to be
+  * assembled, like stencils on structured grids or products of several matrices, can be passed to ConjugateGradient,
+  * BiCGSTAB, GMRES, DGMRES, MINRES and the other solvers of the IterativeSolvers module without materializing a
+  * SparseMatrix.
+  *
+  * \tparam _Scalar the scalar type of the operator
+  * \tparam _Functor the type of the product functor. It must be default constructible and provide the call operator:
+  * \code
+  * void operator()(const Ref<const Matrix<_Scalar,Dynamic,1> >& x, Ref<Matrix<_Scalar,Dynamic,1> > y) const;
+  * \endcode
+  * which writes \f$ A x \f$ into \a y. The vectors \a x and \a y have unit inner strides and never overlap, and the
+  * input values of \a y are undefined. Products by matrices call the functor once per column.
+  *
+  * Here is a typical usage example, for the 2D Laplacian on a \c n x \c n grid:
+  * \code
+  * struct Laplacian2D {
+  *   int n;
+  *   void operator()(const Ref<const VectorXd>& x, Ref<VectorXd> y) const {
+  *     // y(i*n+j) = 4*x(i*n+j) - x((i-1)*n+j) - x((i+1)*n+j) - x(i*n+j-1) - x(i*n+j+1)
+  *   }
+  * };
+  * Laplacian2D stencil;
+  * stencil.n = n;
+  * MatrixFreeOperator<double,Laplacian2D> A(n*n, n*n, stencil);
+  * ConjugateGradient<MatrixFreeOperator<double,Laplacian2D>, Lower|Upper, IdentityPreconditioner> cg(A);
+  * x = cg.solve(b);
+  * \endcode
+  *
+  * As for assembled matrices, the solvers store a reference to the operator, which must outlive them.
+  * The entries of the operator are not available, so the preconditioners which need them, like the default
+  * DiagonalPreconditioner or IncompleteLUT, cannot be used: use IdentityPreconditioner, or a preconditioner
+  * type whose compute() method accepts a MatrixFreeOperator. For self-adjoint solvers, the functor applies the
+  * full operator, and the \c UpLo template parameter is ignored.
+  *
+  * \sa class ConjugateGradient, class BiCGSTAB, class IdentityPreconditioner
+  */
+template<typename _Scalar, typename _Functor>
+class MatrixFreeOperator : public EigenBase<MatrixFreeOperator<_Scalar,_Functor> >
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef _Functor Functor;
+    typedef DenseIndex Index;
+    enum {
+      RowsAtCompileTime = Dynamic,
+      ColsAtCompileTime = Dynamic,
+      MaxRowsAtCompileTime = Dynamic,
+      MaxColsAtCompileTime = Dynamic
+    };
+
+    /** Default constructor, for an empty operator. */
+    MatrixFreeOperator() : m_rows(0), m_cols(0), m_functor() {}
+
+    /** Constructs a \a rows x \a cols operator whose products are computed by \a functor. */
+    MatrixFreeOperator(Index rows, Index cols, const Functor& functor = Functor())
+      : m_rows(rows), m_cols(cols), m_functor(functor)
+    {
+      eigen_assert(rows>=0 && cols>=0);
+    }
+
+    inline Index rows() const { return m_rows; }
+    inline Index cols() const { return m_cols; }
+
+    /** Sets the dimensions of the operator, without changing its functor. */
+    void resize(Index rows, Index cols)
+    {
+      eigen_assert(rows>=0 && cols>=0);
+      m_rows = rows;
+      m_cols = cols;
+    }
+
+    /** \returns a read-write reference to the product functor. */
+    Functor& functor() { return m_functor; }
+
+    /** \returns a read-only reference to the product functor. */
+    const Functor& functor() const { return m_functor; }
+
+    /** \returns an expression of the product of \c *this by the dense vector or matrix \a x */
+    template<typename Rhs>
+    inline const internal::matrix_free_product<MatrixFreeOperator,Rhs> operator*(const MatrixBase<Rhs>& x) const
+    {
+      return internal::matrix_free_product<MatrixFreeOperator,Rhs>(*this, x.derived());
+    }
+
+  protected:
+    Index m_rows, m_cols;
+    Functor m_functor;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_MATRIX_FREE_OPERATOR_H
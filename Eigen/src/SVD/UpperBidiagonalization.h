@@ -24,14 +24,16 @@ template<typename _MatrixType> class UpperBidiagonalization
     enum {
       RowsAtCompileTime = MatrixType::RowsAtCompileTime,
       ColsAtCompileTime = MatrixType::ColsAtCompileTime,
-      ColsAtCompileTimeMinusOne = internal::decrement_size<ColsAtCompileTime>::ret
+      ColsAtCompileTimeMinusOne = internal::decrement_size<ColsAtCompileTime>::ret,
+      // the diagonals of the bidiagonal factor are stored contiguously
+      BidiagonalOptions = ColsAtCompileTime==1 ? ColMajor : RowMajor
     };
     typedef typename MatrixType::Scalar Scalar;
     typedef typename MatrixType::RealScalar RealScalar;
     typedef typename MatrixType::Index Index;
     typedef Matrix<Scalar, 1, ColsAtCompileTime> RowVectorType;
     typedef Matrix<Scalar, RowsAtCompileTime, 1> ColVectorType;
-    typedef BandMatrix<RealScalar, ColsAtCompileTime, ColsAtCompileTime, 1, 0> BidiagonalType;
+    typedef BandMatrix<RealScalar, ColsAtCompileTime, ColsAtCompileTime, 1, 0, BidiagonalOptions> BidiagonalType;
     typedef Matrix<Scalar, ColsAtCompileTime, 1> DiagVectorType;
     typedef Matrix<Scalar, ColsAtCompileTimeMinusOne, 1> SuperDiagVectorType;
     typedef HouseholderSequence<
@@ -52,6 +54,17 @@ template<typename _MatrixType> class UpperBidiagonalization
     */
     UpperBidiagonalization() : m_householder(), m_bidiagonal(), m_isInitialized(false) {}
 
+    /** \brief Default Constructor with memory preallocation
+      *
+      * Like the default constructor but with preallocation of the internal data
+      * according to the specified problem size.
+      */
+    UpperBidiagonalization(Index rows, Index cols)
+      : m_householder(rows, cols),
+        m_bidiagonal(cols, cols),
+        m_isInitialized(false)
+    {}
+
     UpperBidiagonalization(const MatrixType& matrix)
       : m_householder(matrix.rows(), matrix.cols()),
         m_bidiagonal(matrix.cols(), matrix.cols()),
@@ -61,6 +74,7 @@ template<typename _MatrixType> class UpperBidiagonalization
     }
     
     UpperBidiagonalization& compute(const MatrixType& matrix);
+    UpperBidiagonalization& computeUnblocked(const MatrixType& matrix);
     
     const MatrixType& householder() const { return m_householder; }
     const BidiagonalType& bidiagonal() const { return m_bidiagonal; }
@@ -85,45 +99,247 @@ template<typename _MatrixType> class UpperBidiagonalization
     bool m_isInitialized;
 };
 
-template<typename _MatrixType>
-UpperBidiagonalization<_MatrixType>& UpperBidiagonalization<_MatrixType>::compute(const _MatrixType& matrix)
+/** \internal
+  * Reduces the rows x cols matrix \a mat (rows>=cols) to upper bidiagonal form in place, one Householder
+  * reflector at a time. The real diagonal and super-diagonal entries are written to \a diagonal and
+  * \a upper_diagonal, while the essential parts of the reflectors and their coefficients are stored in \a mat
+  * following the layout expected by UpperBidiagonalization::householderU() and householderV().
+  */
+template<typename MatrixType>
+void upperbidiagonalization_inplace_unblocked(MatrixType& mat,
+                                              typename MatrixType::RealScalar *diagonal,
+                                              typename MatrixType::RealScalar *upper_diagonal,
+                                              typename MatrixType::Scalar* tempData = 0)
 {
-  Index rows = matrix.rows();
-  Index cols = matrix.cols();
-  
-  eigen_assert(rows >= cols && "UpperBidiagonalization is only for matrices satisfying rows>=cols.");
-  
-  m_householder = matrix;
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
 
-  ColVectorType temp(rows);
+  Index rows = mat.rows();
+  Index cols = mat.cols();
+
+  Matrix<Scalar,Dynamic,1> tempVector;
+  if(tempData==0)
+  {
+    tempVector.resize(rows);
+    tempData = tempVector.data();
+  }
 
   for (Index k = 0; /* breaks at k==cols-1 below */ ; ++k)
   {
     Index remainingRows = rows - k;
     Index remainingCols = cols - k - 1;
 
-    // construct left householder transform in-place in m_householder
-    m_householder.col(k).tail(remainingRows)
-                 .makeHouseholderInPlace(m_householder.coeffRef(k,k),
-                                         m_bidiagonal.template diagonal<0>().coeffRef(k));
-    // apply householder transform to remaining part of m_householder on the left
-    m_householder.bottomRightCorner(remainingRows, remainingCols)
-                 .applyHouseholderOnTheLeft(m_householder.col(k).tail(remainingRows-1),
-                                            m_householder.coeff(k,k),
-                                            temp.data());
+    // construct left householder transform in-place in mat
+    mat.col(k).tail(remainingRows)
+       .makeHouseholderInPlace(mat.coeffRef(k,k), diagonal[k]);
+    // apply householder transform to remaining part of mat on the left
+    mat.bottomRightCorner(remainingRows, remainingCols)
+       .applyHouseholderOnTheLeft(mat.col(k).tail(remainingRows-1), mat.coeff(k,k), tempData);
 
     if(k == cols-1) break;
-    
-    // construct right householder transform in-place in m_householder
-    m_householder.row(k).tail(remainingCols)
-                 .makeHouseholderInPlace(m_householder.coeffRef(k,k+1),
-                                         m_bidiagonal.template diagonal<1>().coeffRef(k));
-    // apply householder transform to remaining part of m_householder on the left
-    m_householder.bottomRightCorner(remainingRows-1, remainingCols)
-                 .applyHouseholderOnTheRight(m_householder.row(k).tail(remainingCols-1).transpose(),
-                                             m_householder.coeff(k,k+1),
-                                             temp.data());
+
+    // construct right householder transform in-place in mat
+    mat.row(k).tail(remainingCols)
+       .makeHouseholderInPlace(mat.coeffRef(k,k+1), upper_diagonal[k]);
+    // apply householder transform to remaining part of mat on the left
+    mat.bottomRightCorner(remainingRows-1, remainingCols)
+       .applyHouseholderOnTheRight(mat.row(k).tail(remainingCols-1).transpose(), mat.coeff(k,k+1), tempData);
+  }
+}
+
+/** \internal
+  * Helper routine for the blocked reduction to upper bidiagonal form (this is LAPACK's xLABRD).
+  *
+  * Let's partition the matrix A:
+  *
+  *      | A00 A01 |
+  *  A = |         |
+  *      | A10 A11 |
+  *
+  * where A00 is \a bs x \a bs. This function reduces the left panel [A00; A10] and the top panel [A00 A01]
+  * to bidiagonal form, and accumulates the updates of the trailing block A11 in the matrices X and Y such that
+  * the k first left and right reflectors amount to:
+  *   \f[ A \leftarrow A - V Y^* - X U^* \f]
+  * where the columns of V (resp. U) are the left (resp. right) Householder vectors. The trailing block A11 is then
+  * updated at once using two matrix-matrix products.
+  *
+  * \a X and \a Y must have at least \c A.rows() x \a bs and \c A.cols() x \a bs coefficients.
+  */
+template<typename MatrixType, typename WorkMatrixType>
+void upperbidiagonalization_blocked_helper(MatrixType& A,
+                                           typename MatrixType::RealScalar *diagonal,
+                                           typename MatrixType::RealScalar *upper_diagonal,
+                                           typename MatrixType::Index bs,
+                                           WorkMatrixType& X,
+                                           WorkMatrixType& Y)
+{
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
+
+  Index brows = A.rows();
+  Index bcols = A.cols();
+  eigen_internal_assert(bs<bcols && bcols<=brows);
+
+  Scalar tau_v, tau_u, tau_u_prev(0);
+
+  for(Index k = 0; k < bs; ++k)
+  {
+    Index remainingRows = brows - k;
+    Index remainingCols = bcols - k - 1;
+
+    // 1 - update the k-th column of A, i.e.:  A(k:,k) -= V_k Y_k(k,:)^* + X_k U_k(k,:)^*
+    // The first k entries of A(:,k) hold U_k(k,:)^*, the last one being the implicit unit coefficient of u_{k-1}.
+    A.col(k).tail(remainingRows).noalias() -= A.block(k,0, remainingRows,k) * Y.row(k).head(k).adjoint();
+    A.col(k).tail(remainingRows).noalias() -= X.block(k,0, remainingRows,k) * A.col(k).head(k);
+    if(k>0) A.coeffRef(k-1,k) = tau_u_prev;
+
+    // 2 - construct the left Householder reflector v_k in-place
+    A.col(k).tail(remainingRows).makeHouseholderInPlace(tau_v, diagonal[k]);
+    // A(k,k) temporarily stores the unit coefficient of v_k, it will get tau_v at the end of this step
+    A.coeffRef(k,k) = Scalar(1);
+
+    // 3 - compute y_k = conj(tau_v) * ( A^* v_k - Y_k V_k^* v_k - U_k X_k^* v_k )
+    {
+      Block<WorkMatrixType,Dynamic,1> y_k(Y, k+1, k, remainingCols, 1);
+      // the head of the k-th column of Y is used as a temporary
+      Block<WorkMatrixType,Dynamic,1> tmp(Y, 0, k, k, 1);
+      y_k.noalias()  = A.block(k,k+1, remainingRows,remainingCols).adjoint() * A.col(k).tail(remainingRows);
+      tmp.noalias()  = A.block(k,0, remainingRows,k).adjoint() * A.col(k).tail(remainingRows);
+      y_k.noalias() -= Y.block(k+1,0, remainingCols,k) * tmp;
+      tmp.noalias()  = X.block(k,0, remainingRows,k).adjoint() * A.col(k).tail(remainingRows);
+      y_k.noalias() -= A.block(0,k+1, k,remainingCols).adjoint() * tmp;
+      y_k *= numext::conj(tau_v);
+    }
+
+    // 4 - update the k-th row of A, i.e.:  A(k,k+1:) -= V_{k+1}(k,:) Y_{k+1}^* + X_k(k,:) U_k^*
+    A.row(k).tail(remainingCols).noalias() -= A.row(k).head(k+1) * Y.block(k+1,0, remainingCols,k+1).adjoint();
+    A.row(k).tail(remainingCols).noalias() -= X.row(k).head(k) * A.block(0,k+1, k,remainingCols);
+
+    // 5 - construct the right Householder reflector in-place,
+    // the applied vector is u_k = conj(w_k) where w_k is the essential part stored in the k-th row of A.
+    A.row(k).tail(remainingCols).makeHouseholderInPlace(tau_u, upper_diagonal[k]);
+    // A(k,k+1) temporarily stores the unit coefficient of u_k, it will get tau_u during the next step
+    A.coeffRef(k,k+1) = Scalar(1);
+
+    // 6 - compute x_k = tau_u * ( A u_k - X_k U_k^* u_k - V_{k+1} Y_{k+1}^* u_k )
+    {
+      Block<WorkMatrixType,Dynamic,1> x_k(X, k+1, k, remainingRows-1, 1);
+      // the head of the k-th column of X is used as a temporary
+      Block<WorkMatrixType,Dynamic,1> tmp0(X, 0, k, k, 1), tmp1(X, 0, k, k+1, 1);
+      x_k.noalias()   = A.block(k+1,k+1, remainingRows-1,remainingCols) * A.row(k).tail(remainingCols).adjoint();
+      tmp0.noalias()  = A.block(0,k+1, k,remainingCols) * A.row(k).tail(remainingCols).adjoint();
+      x_k.noalias()  -= X.block(k+1,0, remainingRows-1,k) * tmp0;
+      tmp1.noalias()  = Y.block(k+1,0, remainingCols,k+1).adjoint() * A.row(k).tail(remainingCols).adjoint();
+      x_k.noalias()  -= A.block(k+1,0, remainingRows-1,k+1) * tmp1;
+      x_k *= tau_u;
+    }
+
+    A.coeffRef(k,k) = tau_v;
+    tau_u_prev = tau_u;
   }
+
+  // update the trailing block:  A11 -= A10 Y^* + X A01,
+  // where A01 holds U^* with the implicit unit coefficient of u_{bs-1} still in place.
+  A.bottomRightCorner(brows-bs,bcols-bs).noalias() -= A.block(bs,0, brows-bs,bs) * Y.block(bs,0, bcols-bs,bs).adjoint();
+  A.bottomRightCorner(brows-bs,bcols-bs).noalias() -= X.block(bs,0, brows-bs,bs) * A.block(0,bs, bs,bcols-bs);
+  A.coeffRef(bs-1,bs) = tau_u_prev;
+}
+
+/** \internal
+  * Blocked in-place reduction of \a A to upper bidiagonal form.
+  * Panels of \a maxBlockSize columns and rows are reduced by upperbidiagonalization_blocked_helper(),
+  * such that most of the work is performed by matrix-matrix products.
+  * The remaining small trailing block is reduced by upperbidiagonalization_inplace_unblocked().
+  */
+template<typename MatrixType, typename BidiagType>
+void upperbidiagonalization_inplace_blocked(MatrixType& A, BidiagType& bidiagonal,
+                                            typename MatrixType::Index maxBlockSize=32,
+                                            typename MatrixType::Scalar* tempData = 0)
+{
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Block<MatrixType,Dynamic,Dynamic> BlockType;
+
+  Index rows = A.rows();
+  Index cols = A.cols();
+  Index size = (std::min)(rows, cols);
+  Index blockSize = (std::min)(maxBlockSize,size);
+
+  RealScalar* diagonal = bidiagonal.template diagonal<0>().data();
+  RealScalar* upper_diagonal = bidiagonal.template diagonal<1>().data();
+
+  // X and Y are the workspace of the panel reductions
+  Matrix<Scalar,Dynamic,Dynamic> X(rows,blockSize), Y(cols,blockSize);
+
+  for(Index k = 0; k < size; k += blockSize)
+  {
+    Index bs = (std::min)(size-k,blockSize);  // actual size of the block
+    Index brows = rows - k;                   // rows of the block
+    Index bcols = cols - k;                   // columns of the block
+
+    // partition the matrix A:
+    //
+    //      | A00 A01 A02 |
+    //      |             |
+    // A  = | A10 A11 A12 |
+    //      |             |
+    //      | A20 A21 A22 |
+    //
+    // where A11 is a bs x bs diagonal block, and let:
+    //      | A11 A12 |
+    //  B = |         |
+    //      | A21 A22 |
+    BlockType B = A.block(k,k,brows,bcols);
+
+    // If B is too small, or A22 empty, then let's finish with the unblocked algorithm
+    if(k+bs==cols || bcols<48) // somewhat arbitrary threshold
+    {
+      upperbidiagonalization_inplace_unblocked(B, diagonal+k, upper_diagonal+k, tempData);
+      break;
+    }
+    else
+    {
+      upperbidiagonalization_blocked_helper(B, diagonal+k, upper_diagonal+k, bs, X, Y);
+    }
+  }
+}
+
+template<typename _MatrixType>
+UpperBidiagonalization<_MatrixType>& UpperBidiagonalization<_MatrixType>::computeUnblocked(const _MatrixType& matrix)
+{
+  Index rows = matrix.rows();
+  Index cols = matrix.cols();
+
+  eigen_assert(rows >= cols && "UpperBidiagonalization is only for matrices satisfying rows>=cols.");
+
+  m_householder = matrix;
+
+  ColVectorType temp(rows);
+
+  upperbidiagonalization_inplace_unblocked(m_householder,
+                                           m_bidiagonal.template diagonal<0>().data(),
+                                           m_bidiagonal.template diagonal<1>().data(),
+                                           temp.data());
+
+  m_isInitialized = true;
+  return *this;
+}
+
+template<typename _MatrixType>
+UpperBidiagonalization<_MatrixType>& UpperBidiagonalization<_MatrixType>::compute(const _MatrixType& matrix)
+{
+  Index rows = matrix.rows();
+  Index cols = matrix.cols();
+
+  eigen_assert(rows >= cols && "UpperBidiagonalization is only for matrices satisfying rows>=cols.");
+
+  m_householder = matrix;
+
+  ColVectorType temp(rows);
+
+  upperbidiagonalization_inplace_blocked(m_householder, m_bidiagonal, 32, temp.data());
+
   m_isInitialized = true;
   return *this;
 }
@@ -217,6 +217,14 @@ class SimplicialCholeskyBase : internal::noncopyable
     
     void ordering(const MatrixType& a, CholMatrixType& ap);
 
+    template<bool DoLDLT, typename OtherDerived>
+    void rankUpdate(const SparseMatrixBase<OtherDerived>& w, const RealScalar& sigma);
+
+    template<bool DoLDLT>
+    bool rankUpdate_preordered(const std::vector<Index>& pattern, Scalar* y, RealScalar sigma);
+
+    void updatePattern(const std::vector<std::pair<Index, std::vector<Index> > >& columns, bool doLDLT);
+
     /** keeps off-diagonal entries; drops diagonal entries */
     struct keep_diag {
       inline bool operator() (const Index& row, const Index& col, const Scalar&) const
@@ -365,6 +373,27 @@ public:
       Base::template factorize<false>(a);
     }
 
+    /** Updates the decomposition to the one of \f$ A + \sigma W W^* \f$, where \a w is a sparse matrix
+      * with as many rows as A. A rank k modification is performed as k successive rank one updates, or downdates
+      * when \a sigma is negative.
+      *
+      * Each rank one modification only touches the columns of the factor on the path of the elimination tree
+      * starting at the first nonzero of the permuted column of \a w. When the modification creates new nonzeros
+      * in the factor, its pattern and the elimination tree are updated first, and the factor is reallocated.
+      *
+      * The modification applies to the factorized matrix, that is after the transformation of the diagonal
+      * set by setShift(). After a failure, info() returns \c NumericalIssue and the decomposition must be
+      * recomputed.
+      *
+      * \sa compute(), LLT::rankUpdate()
+      */
+    template<typename OtherDerived>
+    SimplicialLLT& rankUpdate(const SparseMatrixBase<OtherDerived>& w, const RealScalar& sigma = 1)
+    {
+      Base::template rankUpdate<false>(w, sigma);
+      return *this;
+    }
+
     /** \returns the determinant of the underlying matrix from the current factorization */
     Scalar determinant() const
     {
@@ -460,6 +489,19 @@ public:
       Base::template factorize<true>(a);
     }
 
+    /** Updates the decomposition to the one of \f$ A + \sigma W W^* \f$, where \a w is a sparse matrix
+      * with as many rows as A. A rank k modification is performed as k successive rank one updates, or downdates
+      * when \a sigma is negative.
+      *
+      * See SimplicialLLT::rankUpdate() for the details.
+      */
+    template<typename OtherDerived>
+    SimplicialLDLT& rankUpdate(const SparseMatrixBase<OtherDerived>& w, const RealScalar& sigma = 1)
+    {
+      Base::template rankUpdate<true>(w, sigma);
+      return *this;
+    }
+
     /** \returns the determinant of the underlying matrix from the current factorization */
     Scalar determinant() const
     {
@@ -558,6 +600,20 @@ public:
         Base::template factorize<false>(a);
     }
 
+    /** Updates the decomposition to the one of \f$ A + \sigma W W^* \f$.
+      *
+      * \sa SimplicialLLT::rankUpdate()
+      */
+    template<typename OtherDerived>
+    SimplicialCholesky& rankUpdate(const SparseMatrixBase<OtherDerived>& w, const RealScalar& sigma = 1)
+    {
+      if(m_LDLT)
+        Base::template rankUpdate<true>(w, sigma);
+      else
+        Base::template rankUpdate<false>(w, sigma);
+      return *this;
+    }
+
     /** \internal */
     template<typename Rhs,typename Dest>
     void _solve(const MatrixBase<Rhs> &b, MatrixBase<Dest> &dest) const
@@ -636,6 +692,204 @@ void SimplicialCholeskyBase<Derived>::ordering(const MatrixType& a, CholMatrixTy
   ap.template selfadjointView<Upper>() = a.template selfadjointView<UpLo>().twistedBy(m_P);
 }
 
+template<typename Derived>
+template<bool DoLDLT, typename OtherDerived>
+void SimplicialCholeskyBase<Derived>::rankUpdate(const SparseMatrixBase<OtherDerived>& w, const RealScalar& sigma)
+{
+  using std::sqrt;
+  using std::abs;
+  eigen_assert(m_factorizationIsOk && "The decomposition is not in a valid state for updating, you must first call either compute() or symbolic()/numeric()");
+  eigen_assert(w.rows()==rows());
+
+  if(m_info!=Success || sigma==RealScalar(0))
+    return;
+
+  // A + sigma w w^* = A +/- (sqrt(|sigma|) w) (sqrt(|sigma|) w)^*
+  const Index size = rows();
+  const RealScalar scale = sqrt(abs(sigma));
+  const RealScalar sign = sigma > RealScalar(0) ? RealScalar(1) : RealScalar(-1);
+  const typename internal::nested<OtherDerived>::type wmat(w.derived());
+  typedef typename internal::remove_all<typename internal::nested<OtherDerived>::type>::type WNested;
+
+  ei_declare_aligned_stack_constructed_variable(Scalar, y, size, 0);
+  for(Index i = 0; i < size; ++i)
+    y[i] = Scalar(0);
+
+  std::vector<Index> pattern;
+  for(Index c = 0; c < wmat.cols(); ++c)
+  {
+    // scatter the permuted column P w into y
+    pattern.clear();
+    for(typename WNested::InnerIterator it(wmat,c); it; ++it)
+    {
+      Index i = m_P.size()>0 ? Index(m_P.indices()(it.index())) : Index(it.index());
+      y[i] += scale * it.value();
+      pattern.push_back(i);
+    }
+    std::sort(pattern.begin(), pattern.end());
+    pattern.erase(std::unique(pattern.begin(), pattern.end()), pattern.end());
+
+    if(!rankUpdate_preordered<DoLDLT>(pattern, y, sign))
+    {
+      m_info = NumericalIssue;
+      return;
+    }
+  }
+}
+
+/** \internal Performs the rank one modification of the factor by +/- y y^*, where \a y is the scattered permuted
+  * vector of nonzero pattern \a pattern. On output, \a y is zero. */
+template<typename Derived>
+template<bool DoLDLT>
+bool SimplicialCholeskyBase<Derived>::rankUpdate_preordered(const std::vector<Index>& pattern, Scalar* y, RealScalar sigma)
+{
+  using std::sqrt;
+  if(pattern.empty())
+    return true;
+
+  const Index diag = DoLDLT ? 0 : 1;
+
+  // Symbolic update: the modification starts at the first nonzero j of y, and the nonzero pattern of the
+  // updated column j is the union of the one of L(:,j) and of y below j. The pattern of y below j becomes
+  // the one of the new L(:,j), whose first nonzero is the new parent of j.
+  std::vector<Index> path, current(pattern), next;
+  std::vector<std::pair<Index, std::vector<Index> > > filled;
+  while(!current.empty())
+  {
+    const Index j = current.front();
+    path.push_back(j);
+    const Index* begin = m_matrix.innerIndexPtr() + m_matrix.outerIndexPtr()[j] + diag;
+    const Index* end = m_matrix.innerIndexPtr() + m_matrix.outerIndexPtr()[j] + m_nonZerosPerCol[j];
+    next.resize(current.size() - 1 + (end - begin));
+    next.erase(std::set_union(current.begin()+1, current.end(), begin, end, next.begin()), next.end());
+    if(Index(next.size()) > end-begin)
+      filled.push_back(std::make_pair(j, next));
+    m_parent[j] = next.empty() ? -1 : next.front();
+    current.swap(next);
+  }
+  if(!filled.empty())
+    updatePattern(filled, DoLDLT);
+
+  // Numeric update along the path, following Gill, Golub, Murray and Saunders, "Methods for modifying matrix
+  // factorizations", 1974, in the versions of T. A. Davis and W. W. Hager.
+  const Index* Lp = m_matrix.outerIndexPtr();
+  const Index* Li = m_matrix.innerIndexPtr();
+  Scalar* Lx = m_matrix.valuePtr();
+  bool ok = true;
+  RealScalar beta(1);
+  for(std::size_t k = 0; k < path.size(); ++k)
+  {
+    const Index j = path[k];
+    const Index pend = Lp[j] + m_nonZerosPerCol[j];
+    if(DoLDLT)
+    {
+      const Scalar p = y[j];
+      const RealScalar d = numext::real(m_diag[j]);
+      const RealScalar betaBar = beta + sigma * numext::abs2(p) / d;
+      if(betaBar == RealScalar(0) || !(numext::isfinite)(betaBar))
+      {
+        ok = false;
+        break;
+      }
+      const Scalar gamma = sigma * numext::conj(p) / (d * betaBar);
+      m_diag[j] = d * betaBar / beta;
+      beta = betaBar;
+      for(Index q = Lp[j]; q < pend; ++q)
+      {
+        y[Li[q]] -= p * Lx[q];
+        Lx[q] += gamma * y[Li[q]];
+      }
+    }
+    else
+    {
+      Index q = Lp[j];
+      const Scalar alpha = y[j] / Lx[q];
+      RealScalar beta2 = beta * beta + sigma * numext::abs2(alpha);
+      if(!(beta2 > RealScalar(0)))
+      {
+        ok = false;       // the downdated matrix is not positive definite
+        break;
+      }
+      beta2 = sqrt(beta2);
+      const RealScalar delta = sigma > 0 ? beta / beta2 : beta2 / beta;
+      const Scalar gamma = sigma * numext::conj(alpha) / (beta2 * beta);
+      Lx[q] = delta * Lx[q] + (sigma > 0 ? gamma * y[j] : Scalar(0));
+      beta = beta2;
+      for(++q; q < pend; ++q)
+      {
+        const Scalar w1 = y[Li[q]];
+        const Scalar w2 = y[Li[q]] = w1 - alpha * Lx[q];
+        Lx[q] = delta * Lx[q] + gamma * (sigma > 0 ? w1 : w2);
+      }
+    }
+  }
+
+  // all the nonzeros of y lie on the path
+  for(std::size_t k = 0; k < path.size(); ++k)
+    y[path[k]] = Scalar(0);
+  return ok;
+}
+
+/** \internal Reallocates the factor with the enlarged nonzero patterns of the given columns. The new coefficients
+  * are set to zero. */
+template<typename Derived>
+void SimplicialCholeskyBase<Derived>::updatePattern(const std::vector<std::pair<Index, std::vector<Index> > >& columns, bool doLDLT)
+{
+  const Index size = m_matrix.cols();
+  const Index diag = doLDLT ? 0 : 1;
+  VectorXi nonZerosPerCol = m_nonZerosPerCol;
+  for(std::size_t k = 0; k < columns.size(); ++k)
+    nonZerosPerCol[columns[k].first] = int(columns[k].second.size() + diag);
+
+  CholMatrixType L(size, size);
+  Index* Lp = L.outerIndexPtr();
+  Lp[0] = 0;
+  for(Index j = 0; j < size; ++j)
+    Lp[j+1] = Lp[j] + nonZerosPerCol[j];
+  L.resizeNonZeros(Lp[size]);
+  Index* Li = L.innerIndexPtr();
+  Scalar* Lx = L.valuePtr();
+
+  const Index* oldLp = m_matrix.outerIndexPtr();
+  const Index* oldLi = m_matrix.innerIndexPtr();
+  const Scalar* oldLx = m_matrix.valuePtr();
+  std::size_t next = 0;
+  for(Index j = 0; j < size; ++j)
+  {
+    Index p = oldLp[j], pend = oldLp[j] + m_nonZerosPerCol[j], q = Lp[j];
+    if(next < columns.size() && columns[next].first == j)
+    {
+      // merge the old coefficients into the new pattern, which contains the old one
+      const std::vector<Index>& rows = columns[next].second;
+      for(Index d = 0; d < diag; ++d, ++p, ++q)
+      {
+        Li[q] = oldLi[p];
+        Lx[q] = oldLx[p];
+      }
+      for(std::size_t k = 0; k < rows.size(); ++k, ++q)
+      {
+        Li[q] = rows[k];
+        if(p < pend && oldLi[p] == rows[k])
+          Lx[q] = oldLx[p++];
+        else
+          Lx[q] = Scalar(0);
+      }
+      ++next;
+    }
+    else
+    {
+      for(; p < pend; ++p, ++q)
+      {
+        Li[q] = oldLi[p];
+        Lx[q] = oldLx[p];
+      }
+    }
+  }
+
+  m_matrix.swap(L);
+  m_nonZerosPerCol.swap(nonZerosPerCol);
+}
+
 namespace internal {
   
 template<typename Derived, typename Rhs>
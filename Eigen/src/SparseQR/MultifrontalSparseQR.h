@@ -0,0 +1,740 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_MULTIFRONTAL_SPARSE_QR_H
+#define EIGEN_MULTIFRONTAL_SPARSE_QR_H
+
+namespace Eigen {
+
+template<typename MatrixType, typename OrderingType> class MultifrontalSparseQR;
+template<typename MultifrontalSparseQRType> struct MultifrontalSparseQRMatrixQReturnType;
+template<typename MultifrontalSparseQRType> struct MultifrontalSparseQRMatrixQTransposeReturnType;
+template<typename MultifrontalSparseQRType, typename Derived> struct MultifrontalSparseQR_QProduct;
+
+namespace internal {
+  template <typename MultifrontalSparseQRType> struct traits<MultifrontalSparseQRMatrixQReturnType<MultifrontalSparseQRType> >
+  {
+    typedef typename MultifrontalSparseQRType::MatrixType ReturnType;
+    typedef typename ReturnType::Index Index;
+    typedef typename ReturnType::StorageKind StorageKind;
+  };
+  template <typename MultifrontalSparseQRType, typename Derived> struct traits<MultifrontalSparseQR_QProduct<MultifrontalSparseQRType, Derived> >
+  {
+    typedef typename Derived::PlainObject ReturnType;
+  };
+
+/** \internal A frontal matrix of the multifrontal QR factorization: the dense matrix gathering the rows of the
+  * permuted matrix whose first nonzero is in one of its pivot columns, and the contribution blocks of its children.
+  * Its pivot columns are eliminated by a dense Householder QR factorization, whose remaining upper triangular block
+  * is passed to the parent front. */
+template<typename Scalar, typename Index>
+struct multifrontal_qr_front
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+
+  Index firstPivot;                // the pivot columns are firstPivot, ..., firstPivot+nbPivots-1
+  Index nbPivots;
+  Index nbOriginalRows;            // number of rows coming from the matrix, stored first
+  Index nbContributionRows;        // number of rows passed to the parent
+  Index parent;                    // parent front, or -1
+  std::vector<Index> cols;         // sorted column pattern, starting with the pivot columns
+  std::vector<Index> rows;         // global row indices of the rows of the front
+  std::vector<Index> children;
+  DenseMatrix qr;                  // the Householder vectors and the triangular factor
+  Matrix<Scalar,Dynamic,1> hcoeffs;
+  DenseMatrix contribution;        // the block passed to the parent, freed once assembled
+};
+
+/** \internal Calls \a kernel on every front, level after level of the assembly tree. The fronts of a level are
+  * independent and are distributed among the threads, except when the level has a single front, whose dense
+  * factorization can use the threads by itself. */
+template<typename IndexVector, typename Kernel>
+void multifrontal_level_sweep(const IndexVector& ptr, const IndexVector& fronts, bool forward, Kernel& kernel)
+{
+  typedef typename IndexVector::Scalar Index;
+  const Index nbLevels = ptr.size()-1;
+  for(Index k=0; k<nbLevels; ++k)
+  {
+    const Index l = forward ? k : nbLevels-1-k;
+    const Index start = ptr(l), end = ptr(l+1);
+    #ifdef EIGEN_HAS_OPENMP
+    if(nbThreads()>1 && end-start>1)
+    {
+      #pragma omp parallel for schedule(dynamic) num_threads(nbThreads())
+      for(Index q=start; q<end; ++q)
+        kernel(fronts(q));
+      continue;
+    }
+    #endif
+    for(Index q=start; q<end; ++q)
+      kernel(fronts(q));
+  }
+}
+
+} // end namespace internal
+
+/**
+  * \ingroup SparseQR_Module
+  * \class MultifrontalSparseQR
+  * \brief Sparse multifrontal QR factorization
+  *
+  * This class implements the multifrontal QR decomposition A*P = Q*R of a sparse matrix A with at least as many
+  * rows as columns. The columns are first permuted by the fill-reducing ordering, and the columns of the
+  * factor R sharing the same nonzero pattern are grouped into supernodes. Each supernode owns a dense frontal
+  * matrix, assembling the rows of A whose first nonzero is in one of its columns and the triangular contribution
+  * blocks of its children in the column elimination tree. The fronts are factorized by the blocked dense
+  * HouseholderQR, and the fronts of a same level of the tree, which are independent, are processed in parallel
+  * when OpenMP is enabled.
+  *
+  * Compared to SparseQR, most of the work is done by matrix-matrix products on the dense fronts, which is much
+  * faster when the factor R has a significant fill-in. Q is stored as the sequence of the Householder reflectors
+  * of the fronts, use matrixQ() to apply it. The factorization is not rank-revealing: if a diagonal coefficient
+  * of R is below the pivot threshold, info() returns \c NumericalIssue. Use SparseQR for rank deficient
+  * matrices.
+  *
+  * \tparam _MatrixType The type of the sparse matrix A, must be a column-major SparseMatrix<>
+  * \tparam _OrderingType The fill-reducing ordering method, COLAMDOrdering<> is recommended. See the
+  *  \link OrderingMethods_Module OrderingMethods \endlink module for the list of built-in and external ordering methods.
+  *
+  * \warning The input sparse matrix A must be in compressed mode (see SparseMatrix::makeCompressed()).
+  *
+  * \sa class SparseQR
+  */
+template<typename _MatrixType, typename _OrderingType>
+class MultifrontalSparseQR
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef _OrderingType OrderingType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef SparseMatrix<Scalar,ColMajor,Index> QRMatrixType;
+    typedef Matrix<Index, Dynamic, 1> IndexVector;
+    typedef Matrix<Scalar, Dynamic, 1> ScalarVector;
+    typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrix;
+    typedef PermutationMatrix<Dynamic, Dynamic, Index> PermutationType;
+    typedef internal::multifrontal_qr_front<Scalar,Index> Front;
+  public:
+    MultifrontalSparseQR() : m_isInitialized(false), m_analysisIsok(false), m_factorizationIsok(false), m_lastError(""), m_useDefaultThreshold(true)
+    { }
+
+    /** Construct a QR factorization of the matrix \a mat.
+      *
+      * \warning The matrix \a mat must be in compressed mode (see SparseMatrix::makeCompressed()).
+      *
+      * \sa compute()
+      */
+    MultifrontalSparseQR(const MatrixType& mat) : m_isInitialized(false), m_analysisIsok(false), m_factorizationIsok(false), m_lastError(""), m_useDefaultThreshold(true)
+    {
+      compute(mat);
+    }
+
+    /** Computes the QR factorization of the sparse matrix \a mat.
+      *
+      * \warning The matrix \a mat must be in compressed mode (see SparseMatrix::makeCompressed()).
+      *
+      * \sa analyzePattern(), factorize()
+      */
+    void compute(const MatrixType& mat)
+    {
+      analyzePattern(mat);
+      factorize(mat);
+    }
+    void analyzePattern(const MatrixType& mat);
+    void factorize(const MatrixType& mat);
+
+    /** \returns the number of rows of the represented matrix.
+      */
+    inline Index rows() const { return m_R.rows(); }
+
+    /** \returns the number of columns of the represented matrix.
+      */
+    inline Index cols() const { return m_R.cols(); }
+
+    /** \returns a const reference to the \b sparse upper triangular matrix R of the QR factorization.
+      */
+    const QRMatrixType& matrixR() const { return m_R; }
+
+    /** \returns the number of diagonal coefficients of R above the pivot threshold.
+      *
+      * \sa setPivotThreshold()
+      */
+    Index rank() const
+    {
+      eigen_assert(m_isInitialized && "The factorization should be called first, use compute()");
+      return m_nonzeropivots;
+    }
+
+    /** \returns the number of frontal matrices, that is of supernodes of the factor R */
+    Index nbFronts() const { return Index(m_fronts.size()); }
+
+    /** \returns an expression of the matrix Q as products of the Householder reflectors of the fronts.
+      * The common usage of this function is to apply it to a dense matrix or vector
+      * \code
+      * VectorXd B1, B2;
+      * // Initialize B1
+      * B2 = matrixQ() * B1;
+      * \endcode
+      */
+    MultifrontalSparseQRMatrixQReturnType<MultifrontalSparseQR> matrixQ() const
+    { return MultifrontalSparseQRMatrixQReturnType<MultifrontalSparseQR>(*this); }
+
+    /** \returns a const reference to the fill-reducing column permutation P such that A*P = Q*R
+      */
+    const PermutationType& colsPermutation() const
+    {
+      eigen_assert(m_isInitialized && "Decomposition is not initialized.");
+      return m_outputPerm_c;
+    }
+
+    /** \returns A string describing the type of error.
+      * This method is provided to ease debugging, not to handle errors.
+      */
+    std::string lastErrorMessage() const { return m_lastError; }
+
+    /** Sets the threshold below which a diagonal coefficient of R is considered as zero.
+      *
+      * The default is the one of SparseQR.
+      */
+    void setPivotThreshold(const RealScalar& threshold)
+    {
+      m_useDefaultThreshold = false;
+      m_threshold = threshold;
+    }
+
+    /** \returns the solution X of \f$ A X = B \f$ using the current decomposition of A, in the least squares
+      * sense when A has more rows than columns.
+      *
+      * \sa compute()
+      */
+    template<typename Rhs>
+    inline const internal::solve_retval<MultifrontalSparseQR, Rhs> solve(const MatrixBase<Rhs>& B) const
+    {
+      eigen_assert(m_isInitialized && "The factorization should be called first, use compute()");
+      eigen_assert(this->rows() == B.rows() && "MultifrontalSparseQR::solve() : invalid number of rows in the right hand side matrix");
+      return internal::solve_retval<MultifrontalSparseQR, Rhs>(*this, B.derived());
+    }
+    template<typename Rhs>
+    inline const internal::sparse_solve_retval<MultifrontalSparseQR, Rhs> solve(const SparseMatrixBase<Rhs>& B) const
+    {
+      eigen_assert(m_isInitialized && "The factorization should be called first, use compute()");
+      eigen_assert(this->rows() == B.rows() && "MultifrontalSparseQR::solve() : invalid number of rows in the right hand side matrix");
+      return internal::sparse_solve_retval<MultifrontalSparseQR, Rhs>(*this, B.derived());
+    }
+
+    /** \brief Reports whether previous computation was successful.
+      *
+      * \returns \c Success if computation was successful,
+      *          \c NumericalIssue if the matrix does not have full column rank
+      *          \c InvalidInput if the input matrix is invalid
+      */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "Decomposition is not initialized.");
+      return m_info;
+    }
+
+    /** \internal */
+    template<typename Rhs, typename Dest>
+    bool _solve(const MatrixBase<Rhs> &B, MatrixBase<Dest> &dest) const
+    {
+      eigen_assert(m_isInitialized && "The factorization should be called first, use compute()");
+      eigen_assert(this->rows() == B.rows() && "MultifrontalSparseQR::solve() : invalid number of rows in the right hand side matrix");
+
+      // Compute Q^T * b, then solve with the triangular matrix R
+      typename Dest::PlainObject y = B;
+      _applyQ(y, true);
+      const Index n = cols();
+      typename Dest::PlainObject x = m_R.topLeftCorner(n, n).template triangularView<Upper>().solve(y.topRows(n));
+      dest = colsPermutation() * x;
+      return true;
+    }
+
+    /** \internal Applies Q, or its adjoint when \a adjoint is true, to the dense matrix \a X in place. */
+    template<typename Dest>
+    void _applyQ(Dest& X, bool adjoint) const
+    {
+      eigen_assert(m_factorizationIsok && X.rows()==rows());
+      typename Dest::PlainObject tmp(X.rows(), X.cols());
+      if(!adjoint)
+      {
+        // the rows of R are the rows m_rowPerm of the transformed matrix
+        for(Index i = 0; i < rows(); ++i)
+          tmp.row(m_rowPerm(i)) = X.row(i);
+        X.swap(tmp);
+      }
+      apply_fronts<Dest> kernel(*this, X, adjoint);
+      internal::multifrontal_level_sweep(m_levelPtr, m_levelFronts, adjoint, kernel);
+      if(adjoint)
+      {
+        for(Index i = 0; i < rows(); ++i)
+          tmp.row(i) = X.row(m_rowPerm(i));
+        X.swap(tmp);
+      }
+    }
+
+  protected:
+
+    /** \internal Applies the Householder reflectors of a front to the rows it covers */
+    template<typename Dest>
+    struct apply_fronts
+    {
+      apply_fronts(const MultifrontalSparseQR& qr, Dest& X, bool adjoint) : m_qr(qr), m_X(X), m_adjoint(adjoint) {}
+      void operator()(Index f)
+      {
+        const Front& front = m_qr.m_fronts[f];
+        const Index t = Index(front.rows.size());
+        if(front.hcoeffs.size()==0)
+          return;
+        Matrix<typename Dest::Scalar,Dynamic,Dynamic> G(t, m_X.cols());
+        for(Index i = 0; i < t; ++i)
+          G.row(i) = m_X.row(front.rows[i]);
+        // as in HouseholderQR, the Q of the front is H_0^* H_1^*... and its inverse is (H_0 H_1 ...)^T
+        if(m_adjoint)
+          G.applyOnTheLeft(householderSequence(front.qr, front.hcoeffs).transpose());
+        else
+          G.applyOnTheLeft(householderSequence(front.qr, front.hcoeffs.conjugate()));
+        for(Index i = 0; i < t; ++i)
+          m_X.row(front.rows[i]) = G.row(i);
+      }
+      const MultifrontalSparseQR& m_qr;
+      Dest& m_X;
+      bool m_adjoint;
+    };
+
+    /** \internal Assembles and factorizes a front */
+    struct factorize_front
+    {
+      factorize_front(MultifrontalSparseQR& qr) : m_qr(qr) {}
+      void operator()(Index f)
+      {
+        Front& front = m_qr.m_fronts[f];
+        const Index t = Index(front.rows.size()), c = Index(front.cols.size());
+        DenseMatrix F = DenseMatrix::Zero(t, c);
+
+        // rows of the matrix
+        for(Index r = 0; r < front.nbOriginalRows; ++r)
+          for(typename RowMajorMatrix::InnerIterator it(m_qr.m_pmat, front.rows[r]); it; ++it)
+            F(r, localColumn(front, it.index())) += it.value();
+
+        // contribution blocks of the children, whose columns are a subset of the ones of the front
+        Index r0 = front.nbOriginalRows;
+        for(std::size_t k = 0; k < front.children.size(); ++k)
+        {
+          Front& child = m_qr.m_fronts[front.children[k]];
+          const Index cbRows = child.nbContributionRows;
+          for(Index j = 0; j < child.contribution.cols(); ++j)
+          {
+            const Index lj = localColumn(front, child.cols[child.nbPivots + j]);
+            F.col(lj).segment(r0, cbRows) = child.contribution.col(j);
+          }
+          r0 += cbRows;
+          child.contribution.resize(0,0);
+        }
+
+        const Index npiv = front.nbPivots;
+        if(t == 0)
+        {
+          front.qr = F;
+          front.hcoeffs.resize(0);
+          front.contribution.resize(0, c-npiv);
+          return;
+        }
+        HouseholderQR<DenseMatrix> qr(F);
+        front.qr = qr.matrixQR();
+        front.hcoeffs = qr.hCoeffs();
+        if(front.nbContributionRows > 0)
+          front.contribution = front.qr.block(npiv, npiv, front.nbContributionRows, c-npiv).template triangularView<Upper>();
+        else
+          front.contribution.resize(0, c-npiv);
+      }
+      static Index localColumn(const Front& front, Index j)
+      {
+        return Index(std::lower_bound(front.cols.begin(), front.cols.end(), j) - front.cols.begin());
+      }
+      MultifrontalSparseQR& m_qr;
+    };
+
+    typedef SparseMatrix<Scalar,RowMajor,Index> RowMajorMatrix;
+
+    bool m_isInitialized;
+    bool m_analysisIsok;
+    bool m_factorizationIsok;
+    mutable ComputationInfo m_info;
+    std::string m_lastError;
+    RowMajorMatrix m_pmat;          // The column permuted matrix
+    QRMatrixType m_R;               // The triangular factor matrix
+    std::vector<Front> m_fronts;    // The frontal matrices, in increasing order of their pivot columns
+    IndexVector m_levelPtr;         // The fronts of the level l are m_levelFronts(m_levelPtr(l):m_levelPtr(l+1)-1)
+    IndexVector m_levelFronts;
+    IndexVector m_rowPerm;          // The row of the transformed matrix holding each row of R, followed by the other rows
+    PermutationType m_perm_c;       // Fill-reducing  Column  permutation
+    PermutationType m_outputPerm_c; // The final column permutation
+    RealScalar m_threshold;         // Threshold to determine null pivots
+    bool m_useDefaultThreshold;     // Use default threshold
+    Index m_nonzeropivots;          // Number of non zero pivots found
+    bool m_structurallyDeficient;   // Whether some pivot columns have no row in their front
+
+    template <typename, typename > friend struct MultifrontalSparseQR_QProduct;
+};
+
+/** \brief Symbolic analysis of the multifrontal QR factorization
+  *
+  * \warning The matrix \a mat must be in compressed mode (see SparseMatrix::makeCompressed()).
+  *
+  * In this step, the fill-reducing permutation is computed and applied to the columns of A, the nonzero
+  * patterns of the columns of R are computed and grouped into supernodes, and the frontal matrices are
+  * set up together with the levels of their assembly tree. Only the sparsity pattern of \a mat is exploited.
+  */
+template <typename MatrixType, typename OrderingType>
+void MultifrontalSparseQR<MatrixType,OrderingType>::analyzePattern(const MatrixType& mat)
+{
+  eigen_assert(mat.isCompressed() && "MultifrontalSparseQR requires a sparse matrix in compressed mode. Call .makeCompressed() before passing it to MultifrontalSparseQR");
+  const Index m = mat.rows();
+  const Index n = mat.cols();
+  m_isInitialized = true;
+  m_factorizationIsok = false;
+  if(m < n)
+  {
+    m_lastError = "MultifrontalSparseQR requires at least as many rows as columns";
+    m_info = InvalidInput;
+    m_analysisIsok = false;
+    return;
+  }
+
+  // Compute the column fill reducing ordering
+  {
+    typename internal::conditional<MatrixType::IsRowMajor,QRMatrixType,const MatrixType&>::type matCpy(mat);
+    OrderingType ord;
+    ord(matCpy, m_perm_c);
+  }
+  if (!m_perm_c.size())
+  {
+    m_perm_c.resize(n);
+    m_perm_c.indices().setLinSpaced(n, 0,n-1);
+  }
+  m_outputPerm_c = m_perm_c.inverse();
+  m_pmat = mat * m_outputPerm_c;
+  m_R.resize(m, n);
+
+  // Assign each row to the column of its first nonzero
+  IndexVector rowPtr = IndexVector::Zero(n+1), firstCol(m);
+  for(Index i = 0; i < m; ++i)
+  {
+    Index j = n;
+    for(typename RowMajorMatrix::InnerIterator it(m_pmat, i); it; ++it)
+      j = (std::min)(j, Index(it.index()));
+    firstCol(i) = j < n ? j : Index(-1);
+    if(j < n)
+      ++rowPtr(j+1);
+  }
+  for(Index j = 0; j < n; ++j)
+    rowPtr(j+1) += rowPtr(j);
+  IndexVector assignedRows(rowPtr(n)), fill = rowPtr.head(n);
+  for(Index i = 0; i < m; ++i)
+    if(firstCol(i) >= 0)
+      assignedRows(fill(firstCol(i))++) = i;
+
+  // Nonzero pattern of each column of R: the columns of its rows and of the contributions of its children in
+  // the column elimination tree, whose parent is the first column of the contribution. Computed in increasing
+  // order, the children being lower than their parent.
+  std::vector<std::vector<Index> > pattern(n), childrenOf(n);
+  IndexVector rowCount(n), mark = IndexVector::Constant(n, -1), parent = IndexVector::Constant(n, -1);
+  for(Index j = 0; j < n; ++j)
+  {
+    std::vector<Index>& p = pattern[j];
+    p.push_back(j);
+    mark(j) = j;
+    rowCount(j) = rowPtr(j+1) - rowPtr(j);
+    for(Index q = rowPtr(j); q < rowPtr(j+1); ++q)
+      for(typename RowMajorMatrix::InnerIterator it(m_pmat, assignedRows(q)); it; ++it)
+        if(mark(it.index()) != j)
+        {
+          mark(it.index()) = j;
+          p.push_back(it.index());
+        }
+    for(std::size_t k = 0; k < childrenOf[j].size(); ++k)
+    {
+      const Index c = childrenOf[j][k];
+      rowCount(j) += (std::min)(rowCount(c), Index(pattern[c].size())) - 1;
+      for(std::size_t q = 1; q < pattern[c].size(); ++q)
+        if(mark(pattern[c][q]) != j)
+        {
+          mark(pattern[c][q]) = j;
+          p.push_back(pattern[c][q]);
+        }
+    }
+    std::sort(p.begin(), p.end());
+    if(p.size() > 1 && rowCount(j) > 1)
+    {
+      parent(j) = p[1];
+      childrenOf[p[1]].push_back(j);
+    }
+  }
+
+  // Group the chains of columns sharing the same pattern into fundamental supernodes
+  IndexVector frontOf(n);
+  m_fronts.clear();
+  for(Index j = 0; j < n; ++j)
+  {
+    const Front* last = m_fronts.empty() ? 0 : &m_fronts.back();
+    if(j > 0 && parent(j-1) == j && childrenOf[j].size() == 1
+       && pattern[j].size() + last->nbPivots == last->cols.size())
+    {
+      frontOf(j) = frontOf(j-1);
+      ++m_fronts.back().nbPivots;
+    }
+    else
+    {
+      frontOf(j) = Index(m_fronts.size());
+      m_fronts.push_back(Front());
+      Front& front = m_fronts.back();
+      front.firstPivot = j;
+      front.nbPivots = 1;
+      front.cols.swap(pattern[j]);
+    }
+  }
+
+  // Rows of the fronts: the assigned rows of the matrix, then the contribution rows of the children, which keep
+  // the indices of the rows of the children they come from
+  m_rowPerm.resize(m);
+  mark.setConstant(m, -1);
+  m_structurallyDeficient = false;
+  const Index nbFronts = Index(m_fronts.size());
+  IndexVector level = IndexVector::Zero(nbFronts);
+  Index nbLevels = 0;
+  for(Index f = 0; f < nbFronts; ++f)
+  {
+    Front& front = m_fronts[f];
+    const Index first = front.firstPivot, npiv = front.nbPivots, c = Index(front.cols.size());
+    front.rows.assign(assignedRows.data() + rowPtr(first), assignedRows.data() + rowPtr(first+npiv));
+    front.nbOriginalRows = Index(front.rows.size());
+    for(std::size_t k = 0; k < childrenOf[first].size(); ++k)
+    {
+      const Index child = frontOf(childrenOf[first][k]);
+      const Front& cf = m_fronts[child];
+      front.children.push_back(child);
+      front.rows.insert(front.rows.end(), cf.rows.begin() + cf.nbPivots, cf.rows.begin() + cf.nbPivots + cf.nbContributionRows);
+      level(f) = (std::max)(level(f), level(child)+1);
+    }
+    const Index t = Index(front.rows.size());
+    front.nbContributionRows = (std::max)(Index(0), (std::min)(t, c) - npiv);
+    front.parent = front.nbContributionRows > 0 && c > npiv ? frontOf(front.cols[npiv]) : Index(-1);
+    if(front.parent < 0)
+      front.nbContributionRows = 0;
+    nbLevels = (std::max)(nbLevels, level(f)+1);
+
+    // the rows holding the rows of R
+    for(Index k = 0; k < (std::min)(t, npiv); ++k)
+    {
+      m_rowPerm(first+k) = front.rows[k];
+      mark(front.rows[k]) = 1;
+    }
+    if(t < npiv)
+      m_structurallyDeficient = true;
+  }
+  // the other rows, in increasing order. Structurally missing rows of R are taken among them.
+  {
+    std::vector<bool> hasRow(n, false);
+    for(Index f = 0; f < nbFronts; ++f)
+      for(Index k = 0; k < (std::min)(Index(m_fronts[f].rows.size()), m_fronts[f].nbPivots); ++k)
+        hasRow[m_fronts[f].firstPivot+k] = true;
+    Index i = 0;
+    for(Index j = 0; j < n; ++j)
+      if(!hasRow[j])
+      {
+        while(mark(i) >= 0) ++i;
+        m_rowPerm(j) = i;
+        mark(i) = 1;
+      }
+    Index next = n;
+    for(i = 0; i < m; ++i)
+      if(mark(i) < 0)
+        m_rowPerm(next++) = i;
+  }
+
+  // Level sets of the assembly tree
+  m_levelPtr = IndexVector::Zero(nbLevels+1);
+  for(Index f = 0; f < nbFronts; ++f)
+    ++m_levelPtr(level(f)+1);
+  for(Index l = 0; l < nbLevels; ++l)
+    m_levelPtr(l+1) += m_levelPtr(l);
+  m_levelFronts.resize(nbFronts);
+  IndexVector pos = m_levelPtr.head(nbLevels);
+  for(Index f = 0; f < nbFronts; ++f)
+    m_levelFronts(pos(level(f))++) = f;
+
+  m_info = Success;
+  m_analysisIsok = true;
+}
+
+/** \brief Performs the numerical QR factorization of the input matrix
+  *
+  * The function MultifrontalSparseQR::analyzePattern(const MatrixType&) must have been called beforehand with
+  * a matrix having the same sparsity pattern than \a mat.
+  *
+  * \param mat The sparse column-major matrix
+  */
+template <typename MatrixType, typename OrderingType>
+void MultifrontalSparseQR<MatrixType,OrderingType>::factorize(const MatrixType& mat)
+{
+  using std::abs;
+  using std::sqrt;
+  eigen_assert(m_isInitialized && "analyzePattern() should be called before this step");
+  if(!m_analysisIsok)
+    return;
+  const Index m = mat.rows();
+  const Index n = mat.cols();
+  eigen_assert(m_R.rows()==m && m_R.cols()==n && "MultifrontalSparseQR::factorize(): the pattern of the matrix has changed");
+
+  m_pmat = mat * m_outputPerm_c;
+
+  // the default threshold of SparseQR
+  RealScalar pivotThreshold = m_threshold;
+  if(m_useDefaultThreshold)
+  {
+    Matrix<RealScalar,Dynamic,1> colNorms = Matrix<RealScalar,Dynamic,1>::Zero(n);
+    for(Index i = 0; i < m; ++i)
+      for(typename RowMajorMatrix::InnerIterator it(m_pmat, i); it; ++it)
+        colNorms(it.index()) += numext::abs2(it.value());
+    RealScalar max2Norm = n > 0 ? sqrt(colNorms.maxCoeff()) : RealScalar(0);
+    if(max2Norm==RealScalar(0))
+      max2Norm = RealScalar(1);
+    pivotThreshold = 20 * (m + n) * max2Norm * NumTraits<RealScalar>::epsilon();
+  }
+
+  factorize_front kernel(*this);
+  internal::multifrontal_level_sweep(m_levelPtr, m_levelFronts, true, kernel);
+
+  // Gather the rows of R
+  std::vector<Triplet<Scalar,Index> > triplets;
+  m_nonzeropivots = 0;
+  for(std::size_t f = 0; f < m_fronts.size(); ++f)
+  {
+    const Front& front = m_fronts[f];
+    const Index nr = (std::min)(Index(front.rows.size()), front.nbPivots);
+    for(Index k = 0; k < nr; ++k)
+    {
+      if(abs(front.qr(k,k)) > pivotThreshold)
+        ++m_nonzeropivots;
+      for(Index j = k; j < Index(front.cols.size()); ++j)
+        triplets.push_back(Triplet<Scalar,Index>(front.firstPivot+k, front.cols[j], front.qr(k,j)));
+    }
+  }
+  m_R.setFromTriplets(triplets.begin(), triplets.end());
+
+  m_factorizationIsok = true;
+  if(m_nonzeropivots < n)
+  {
+    m_lastError = "The matrix does not have full column rank";
+    m_info = NumericalIssue;
+  }
+  else
+    m_info = Success;
+}
+
+namespace internal {
+
+template<typename _MatrixType, typename OrderingType, typename Rhs>
+struct solve_retval<MultifrontalSparseQR<_MatrixType,OrderingType>, Rhs>
+  : solve_retval_base<MultifrontalSparseQR<_MatrixType,OrderingType>, Rhs>
+{
+  typedef MultifrontalSparseQR<_MatrixType,OrderingType> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+template<typename _MatrixType, typename OrderingType, typename Rhs>
+struct sparse_solve_retval<MultifrontalSparseQR<_MatrixType, OrderingType>, Rhs>
+ : sparse_solve_retval_base<MultifrontalSparseQR<_MatrixType, OrderingType>, Rhs>
+{
+  typedef MultifrontalSparseQR<_MatrixType, OrderingType> Dec;
+  EIGEN_MAKE_SPARSE_SOLVE_HELPERS(Dec, Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    this->defaultEvalTo(dst);
+  }
+};
+} // end namespace internal
+
+template <typename MultifrontalSparseQRType, typename Derived>
+struct MultifrontalSparseQR_QProduct : ReturnByValue<MultifrontalSparseQR_QProduct<MultifrontalSparseQRType, Derived> >
+{
+  typedef typename MultifrontalSparseQRType::Index Index;
+  MultifrontalSparseQR_QProduct(const MultifrontalSparseQRType& qr, const Derived& other, bool transpose) :
+  m_qr(qr),m_other(other),m_transpose(transpose) {}
+  inline Index rows() const { return m_qr.rows(); }
+  inline Index cols() const { return m_other.cols(); }
+
+  template<typename DesType>
+  void evalTo(DesType& res) const
+  {
+    eigen_assert(m_qr.rows() == m_other.rows() && "Non conforming object sizes");
+    res = m_other;
+    m_qr._applyQ(res, m_transpose);
+  }
+
+  const MultifrontalSparseQRType& m_qr;
+  const Derived& m_other;
+  bool m_transpose;
+};
+
+template<typename MultifrontalSparseQRType>
+struct MultifrontalSparseQRMatrixQReturnType : public EigenBase<MultifrontalSparseQRMatrixQReturnType<MultifrontalSparseQRType> >
+{
+  typedef typename MultifrontalSparseQRType::Index Index;
+  typedef typename MultifrontalSparseQRType::Scalar Scalar;
+  enum {
+    RowsAtCompileTime = Dynamic,
+    ColsAtCompileTime = Dynamic
+  };
+  MultifrontalSparseQRMatrixQReturnType(const MultifrontalSparseQRType& qr) : m_qr(qr) {}
+  template<typename Derived>
+  MultifrontalSparseQR_QProduct<MultifrontalSparseQRType, Derived> operator*(const MatrixBase<Derived>& other)
+  {
+    return MultifrontalSparseQR_QProduct<MultifrontalSparseQRType,Derived>(m_qr,other.derived(),false);
+  }
+  MultifrontalSparseQRMatrixQTransposeReturnType<MultifrontalSparseQRType> adjoint() const
+  {
+    return MultifrontalSparseQRMatrixQTransposeReturnType<MultifrontalSparseQRType>(m_qr);
+  }
+  inline Index rows() const { return m_qr.rows(); }
+  inline Index cols() const { return m_qr.rows(); }
+  // To use for operations with the transpose of Q
+  MultifrontalSparseQRMatrixQTransposeReturnType<MultifrontalSparseQRType> transpose() const
+  {
+    return MultifrontalSparseQRMatrixQTransposeReturnType<MultifrontalSparseQRType>(m_qr);
+  }
+  template<typename Dest> void evalTo(MatrixBase<Dest>& dest) const
+  {
+    dest.derived() = Dest::Identity(m_qr.rows(), m_qr.rows());
+    m_qr._applyQ(dest.derived(), false);
+  }
+
+  const MultifrontalSparseQRType& m_qr;
+};
+
+template<typename MultifrontalSparseQRType>
+struct MultifrontalSparseQRMatrixQTransposeReturnType
+{
+  MultifrontalSparseQRMatrixQTransposeReturnType(const MultifrontalSparseQRType& qr) : m_qr(qr) {}
+  template<typename Derived>
+  MultifrontalSparseQR_QProduct<MultifrontalSparseQRType,Derived> operator*(const MatrixBase<Derived>& other)
+  {
+    return MultifrontalSparseQR_QProduct<MultifrontalSparseQRType,Derived>(m_qr,other.derived(), true);
+  }
+  const MultifrontalSparseQRType& m_qr;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_MULTIFRONTAL_SPARSE_QR_H
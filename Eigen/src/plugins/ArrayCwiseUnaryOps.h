@@ -131,6 +131,58 @@ tan() const
   return derived();
 }
 
+/** \returns an expression of the coefficient-wise arc tan of *this.
+  *
+  * \sa tan(), asin(), acos()
+  */
+inline const CwiseUnaryOp<internal::scalar_atan_op<Scalar>, const Derived>
+atan() const
+{
+  return derived();
+}
+
+/** \returns an expression of the coefficient-wise hyperbolic tan of *this.
+  *
+  * \sa tan(), exp()
+  */
+inline const CwiseUnaryOp<internal::scalar_tanh_op<Scalar>, const Derived>
+tanh() const
+{
+  return derived();
+}
+
+/** \returns an expression of the coefficient-wise error function of *this.
+  *
+  * \sa exp()
+  */
+inline const CwiseUnaryOp<internal::scalar_erf_op<Scalar>, const Derived>
+erf() const
+{
+  return derived();
+}
+
+/** \returns an expression of the coefficient-wise logarithm of 1 plus *this,
+  * accurate for coefficients close to zero.
+  *
+  * \sa log(), expm1()
+  */
+inline const CwiseUnaryOp<internal::scalar_log1p_op<Scalar>, const Derived>
+log1p() const
+{
+  return derived();
+}
+
+/** \returns an expression of the coefficient-wise exponential of *this minus 1,
+  * accurate for coefficients close to zero.
+  *
+  * \sa exp(), log1p()
+  */
+inline const CwiseUnaryOp<internal::scalar_expm1_op<Scalar>, const Derived>
+expm1() const
+{
+  return derived();
+}
+
 
 /** \returns an expression of the coefficient-wise power of *this to the given exponent.
   *
@@ -83,6 +83,18 @@ template<typename ArrayType> void array(const ArrayType& m)
   VERIFY_IS_APPROX(m3.rowwise() -= rv1, m1.rowwise() - rv1);
 }
 
+template<typename BoolExpr> void check_boolean_redux(const BoolExpr& b)
+{
+  typedef typename BoolExpr::Index Index;
+  Index count = 0;
+  for(Index j = 0; j < b.cols(); ++j)
+    for(Index i = 0; i < b.rows(); ++i)
+      if(b.coeff(i,j)) ++count;
+  VERIFY_IS_EQUAL(b.count(), count);
+  VERIFY_IS_EQUAL(b.any(), count > 0);
+  VERIFY_IS_EQUAL(b.all(), count == b.size());
+}
+
 template<typename ArrayType> void comparisons(const ArrayType& m)
 {
   using std::abs;
@@ -144,6 +156,24 @@ template<typename ArrayType> void comparisons(const ArrayType& m)
   RealScalar a = m1.abs().mean();
   VERIFY( (m1<-a || m1>a).count() == (m1.abs()>a).count());
 
+  // all(), any() and count() of comparisons with ties, against coefficient loops
+  m3 = m2;
+  for(Index k = 0; k < rows*cols/2; ++k)
+  {
+    Index i = internal::random<Index>(0, rows*cols-1);
+    m3(i) = m1(i);
+  }
+  check_boolean_redux(m1 < m3);
+  check_boolean_redux(m1 <= m3);
+  check_boolean_redux(m1 > m3);
+  check_boolean_redux(m1 >= m3);
+  check_boolean_redux(m1 == m3);
+  check_boolean_redux(m1 != m3);
+  check_boolean_redux(m1 < m3 && m1 != Scalar(0));
+  check_boolean_redux(m1 > m3 || m1 == m3);
+  check_boolean_redux(m1 == m1);
+  check_boolean_redux(m1 != m1);
+
   typedef Array<typename ArrayType::Index, Dynamic, 1> ArrayOfIndices;
 
   // TODO allows colwise/rowwise for array
@@ -174,6 +204,15 @@ template<typename ArrayType> void array_real(const ArrayType& m)
   VERIFY_IS_APPROX(m1.asin(), asin(m1));
   VERIFY_IS_APPROX(m1.acos(), acos(m1));
   VERIFY_IS_APPROX(m1.tan(), tan(m1));
+  VERIFY_IS_APPROX(m1.atan(), atan(m1));
+  VERIFY_IS_APPROX(m1.tanh(), tanh(m1));
+  VERIFY_IS_APPROX(m1.erf(), erf(m1));
+  VERIFY_IS_APPROX(m1.expm1(), expm1(m1));
+  VERIFY_IS_APPROX(m1.abs().log1p(), log1p(m1.abs()));
+  VERIFY_IS_APPROX(m1.tan().atan(), m1);
+  VERIFY_IS_APPROX(m1.tanh(), (RealScalar(2)*m1).expm1() / ((RealScalar(2)*m1).exp() + RealScalar(1)));
+  VERIFY_IS_APPROX(m1.expm1(), m1.exp() - RealScalar(1));
+  VERIFY_IS_APPROX(m1.abs().log1p(), (m1.abs() + RealScalar(1)).log());
   
   VERIFY_IS_APPROX(cos(m1+RealScalar(3)*m2), cos((m1+RealScalar(3)*m2).eval()));
 
@@ -202,6 +241,9 @@ template<typename ArrayType> void array_real(const ArrayType& m)
   m3 = m1.abs();
   VERIFY_IS_APPROX(m3.pow(RealScalar(0.5)), m3.sqrt());
   VERIFY_IS_APPROX(pow(m3,RealScalar(0.5)), m3.sqrt());
+  VERIFY_IS_APPROX(m3.pow(RealScalar(1.5)), m3 * m3.sqrt());
+  VERIFY_IS_APPROX(m1.pow(3), m1.cube());
+  VERIFY_IS_APPROX((m3 + RealScalar(1)).pow(-2), (m3 + RealScalar(1)).square().inverse());
 
   // scalar by array division
   const RealScalar tiny = sqrt(std::numeric_limits<RealScalar>::epsilon());
@@ -280,6 +322,7 @@ void test_array()
     CALL_SUBTEST_3( comparisons(Array44d()) );
     CALL_SUBTEST_5( comparisons(ArrayXXf(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
     CALL_SUBTEST_6( comparisons(ArrayXXi(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_7( comparisons(ArrayXXd(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
   }
   for(int i = 0; i < g_repeat; i++) {
     CALL_SUBTEST_1( min_max(Array<float, 1, 1>()) );
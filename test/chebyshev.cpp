@@ -0,0 +1,128 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "sparse_solver.h"
+#include <Eigen/IterativeLinearSolvers>
+#include <Eigen/Eigenvalues>
+
+template<typename T> void test_chebyshev_T()
+{
+  ChebyshevIteration<SparseMatrix<T>, Lower      > cheb_colmajor_lower_diag;
+  ChebyshevIteration<SparseMatrix<T>, Upper      > cheb_colmajor_upper_diag;
+  ChebyshevIteration<SparseMatrix<T>, Lower|Upper> cheb_colmajor_loup_diag;
+  ConjugateGradient<SparseMatrix<T>, Lower, ChebyshevPreconditioner<SparseMatrix<T>, Lower> > cg_colmajor_lower_cheb;
+  ConjugateGradient<SparseMatrix<T>, Upper, ChebyshevPreconditioner<SparseMatrix<T>, Upper> > cg_colmajor_upper_cheb;
+
+  CALL_SUBTEST( check_sparse_spd_solving(cheb_colmajor_lower_diag) );
+  CALL_SUBTEST( check_sparse_spd_solving(cheb_colmajor_upper_diag) );
+  CALL_SUBTEST( check_sparse_spd_solving(cheb_colmajor_loup_diag)  );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_lower_cheb)   );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_upper_cheb)   );
+}
+
+// 5-point finite difference discretization of the Laplacian on a n x n grid, with a variable coefficient
+template<typename Scalar>
+SparseMatrix<Scalar> chebyshev_laplacian(int n)
+{
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  std::vector<Triplet<Scalar> > triplets;
+  for(int i=0; i<n; ++i)
+    for(int j=0; j<n; ++j)
+    {
+      int k = i*n+j;
+      RealScalar c = RealScalar(1) + RealScalar(i)/RealScalar(n);
+      triplets.push_back(Triplet<Scalar>(k, k, Scalar(4*c)));
+      if(i>0)   triplets.push_back(Triplet<Scalar>(k, k-n, Scalar(-c)));
+      if(i<n-1) triplets.push_back(Triplet<Scalar>(k, k+n, Scalar(-c)));
+      if(j>0)   triplets.push_back(Triplet<Scalar>(k, k-1, Scalar(-c)));
+      if(j<n-1) triplets.push_back(Triplet<Scalar>(k, k+1, Scalar(-c)));
+    }
+  SparseMatrix<Scalar> A(n*n, n*n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  // make it symmetric
+  return SparseMatrix<Scalar>((A + SparseMatrix<Scalar>(A.adjoint())) * Scalar(0.5));
+}
+
+template<typename T> void test_chebyshev_laplacian()
+{
+  typedef Matrix<T,Dynamic,1> VectorType;
+  typedef Matrix<T,Dynamic,Dynamic> DenseMatrix;
+  typedef typename NumTraits<T>::Real RealScalar;
+  const RealScalar tol(1e-8);
+
+  int n = internal::random<int>(4,20);
+  SparseMatrix<T> A = chebyshev_laplacian<T>(n);
+  VectorType b = VectorType::Random(n*n);
+
+  // the estimated bounds contain the largest eigenvalue of the Jacobi preconditioned matrix
+  VectorType invSqrtDiag = A.diagonal().cwiseSqrt().cwiseInverse();
+  DenseMatrix scaled = invSqrtDiag.asDiagonal() * DenseMatrix(A) * invSqrtDiag.asDiagonal();
+  SelfAdjointEigenSolver<DenseMatrix> eig(scaled, EigenvaluesOnly);
+  RealScalar lmin = eig.eigenvalues().minCoeff(), lmax = eig.eigenvalues().maxCoeff();
+
+  ChebyshevIteration<SparseMatrix<T>, Lower> cheb;
+  cheb.setTolerance(tol);
+  cheb.setMaxIterations(100*n);
+  cheb.compute(A);
+  VERIFY(cheb.maxEigenvalue() >= lmax);
+  VERIFY(cheb.maxEigenvalue() <= RealScalar(1.2) * lmax);
+  VERIFY(cheb.minEigenvalue() >= lmin * RealScalar(0.999));
+  VectorType x = cheb.solve(b);
+  VERIFY_IS_EQUAL(cheb.info(), Success);
+  VERIFY((A*x - b).norm() <= tol * b.norm());
+  VERIFY(cheb.iterations() % 10 == 0);
+
+  // with the exact bounds, the convergence rate is the one of the conjugate gradient in the worst case
+  ChebyshevIteration<SparseMatrix<T>, Lower|Upper> exact;
+  exact.setEigenvalueBounds(lmin, lmax);
+  exact.setTolerance(tol);
+  exact.setMaxIterations(100*n);
+  exact.compute(A);
+  VERIFY_IS_EQUAL(exact.minEigenvalue(), lmin);
+  x = exact.solve(b);
+  VERIFY_IS_EQUAL(exact.info(), Success);
+  VERIFY((A*x - b).norm() <= tol * b.norm());
+  RealScalar sqrtKappa = std::sqrt(lmax / lmin);
+  RealScalar bound = std::log(RealScalar(2)/tol) * (sqrtKappa + 1) / RealScalar(2) + 10;
+  VERIFY(RealScalar(exact.iterations()) <= bound);
+
+  // starting from the solution
+  x = exact.solveWithGuess(b, x);
+  VERIFY(exact.iterations() == 0);
+
+  // the polynomial preconditioner is selfadjoint positive definite, and reduces the iterations of the
+  // conjugate gradient
+  ChebyshevPreconditioner<SparseMatrix<T>, Lower> precond(A);
+  VectorType c = VectorType::Random(n*n);
+  VectorType pb = precond.solve(b), pc = precond.solve(c);
+  VERIFY(internal::isApprox(c.dot(pb), pc.dot(b)));
+  VERIFY(numext::real(b.dot(pb)) > RealScalar(0));
+
+  ConjugateGradient<SparseMatrix<T>, Lower> cg_diag(A);
+  ConjugateGradient<SparseMatrix<T>, Lower, ChebyshevPreconditioner<SparseMatrix<T>, Lower> > cg_cheb;
+  cg_diag.setTolerance(tol);
+  cg_cheb.setTolerance(tol);
+  cg_cheb.preconditioner().setDegree(4);
+  cg_cheb.compute(A);
+  VERIFY_IS_EQUAL(cg_cheb.preconditioner().degree(), 4);
+  x = cg_diag.solve(b);
+  VERIFY_IS_EQUAL(cg_diag.info(), Success);
+  x = cg_cheb.solve(b);
+  VERIFY_IS_EQUAL(cg_cheb.info(), Success);
+  VERIFY((A*x - b).norm() <= RealScalar(10) * tol * b.norm());
+  VERIFY(cg_cheb.iterations() < cg_diag.iterations());
+}
+
+void test_chebyshev()
+{
+  CALL_SUBTEST_1(test_chebyshev_T<double>());
+  CALL_SUBTEST_2(test_chebyshev_T<std::complex<double> >());
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_3(test_chebyshev_laplacian<double>());
+    CALL_SUBTEST_4(test_chebyshev_laplacian<std::complex<double> >());
+  }
+}
@@ -0,0 +1,102 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+
+static std::size_t nb_temporaries;
+static int nb_reports;
+
+#define EIGEN_DEBUG_TEMPORARIES
+#define EIGEN_DEBUG_TEMPORARIES_REPORT(count) { nb_temporaries = count; ++nb_reports; }
+
+#include "main.h"
+
+// checks that the assignment XPR is reported once, with N temporaries
+#define VERIFY_TEMPORARIES_COUNT(XPR,N) {\
+    internal::temporaries_counter() = 0; \
+    nb_reports = 0; \
+    XPR; \
+    if(nb_reports!=1 || nb_temporaries!=std::size_t(N)) \
+      std::cerr << "nb_reports == " << nb_reports << ", nb_temporaries == " << nb_temporaries << "\n"; \
+    VERIFY( (#XPR) && nb_reports==1 && nb_temporaries==std::size_t(N) ); \
+  }
+
+template<typename MatrixType> void expression_cache(const MatrixType& m)
+{
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::PlainObject PlainObject;
+  typedef Array<Scalar,Dynamic,Dynamic> ArrayType;
+
+  const Index rows = m.rows();
+  const Index cols = m.cols();
+  const MatrixType a = MatrixType::Random(rows, rows);
+  const MatrixType b = MatrixType::Random(rows, cols);
+  MatrixType c(rows, cols);
+  ArrayType y(rows, cols);
+  const ArrayType ref = (a*b).array().exp() / (a*b).array().exp().sum();
+
+  ExpressionCache cache;
+  VERIFY_IS_EQUAL(cache.size(), std::size_t(0));
+  {
+    Map<const PlainObject,Aligned> ab = cache.eval(a*b);
+    VERIFY_IS_APPROX(ab, (a*b).eval());
+    y = ab.array().exp() / ab.array().exp().sum();
+    VERIFY_IS_APPROX(y, ref);
+  }
+  {
+    Map<const ArrayType,Aligned> e = cache.eval((a*b).array().exp());
+    y = e / e.sum();
+    VERIFY_IS_APPROX(y, ref);
+  }
+  VERIFY_IS_EQUAL(cache.size(), std::size_t(2));
+
+  // the buffers are reused after clear()
+  const std::size_t capacity = cache.capacity();
+  VERIFY(capacity >= 2 * std::size_t(rows*cols) * sizeof(Scalar));
+  for(int k=0; k<3; ++k)
+  {
+    cache.clear();
+    VERIFY_IS_EQUAL(cache.size(), std::size_t(0));
+    Map<const PlainObject,Aligned> ab = cache.eval(a*b);
+    Map<const PlainObject,Aligned> aab = cache.eval(a.adjoint() * (a*b));
+    Map<const PlainObject,Aligned> s = cache.eval(a + a.adjoint());
+    VERIFY_IS_APPROX(aab, (a.adjoint() * a * b).eval());
+    VERIFY_IS_APPROX(s, (a + a.adjoint()).eval());
+    VERIFY_IS_APPROX(ab, (a*b).eval());
+    VERIFY(reinterpret_cast<std::size_t>(ab.data()) % 16 == 0);
+  }
+  VERIFY(cache.capacity() >= capacity);
+
+  // the hidden temporaries
+  VERIFY_TEMPORARIES_COUNT( c = a*b, 1 );
+  VERIFY_TEMPORARIES_COUNT( c.noalias() = a*b, 0 );
+  VERIFY_TEMPORARIES_COUNT( c.noalias() += a*b, 0 );
+  VERIFY_TEMPORARIES_COUNT( c = b + b, 0 );
+  VERIFY_TEMPORARIES_COUNT( y = (a*b).array().exp() / (a*b).array().exp().sum(), 2 );
+  VERIFY_TEMPORARIES_COUNT( c += (a*b).cwiseProduct(b), 1 );
+  VERIFY_TEMPORARIES_COUNT( y += (a*b).array(), 1 );
+  cache.clear();
+  VERIFY_TEMPORARIES_COUNT( y = cache.eval(a*b).array().exp(), 0 );
+  {
+    Map<const ArrayType,Aligned> e = cache.eval((a*b).array().exp());
+    VERIFY_TEMPORARIES_COUNT( y = e / e.sum(), 0 );
+  }
+  // the reallocation of the destination
+  MatrixType d;
+  VERIFY_TEMPORARIES_COUNT( d = a + a, 1 );
+  VERIFY_TEMPORARIES_COUNT( d = a + a, 0 );
+}
+
+void test_expression_cache()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( expression_cache(MatrixXd(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_2( expression_cache(MatrixXf(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_3( expression_cache(MatrixXcd(internal::random<int>(1,EIGEN_TEST_MAX_SIZE/2), internal::random<int>(1,EIGEN_TEST_MAX_SIZE/2))) );
+  }
+}
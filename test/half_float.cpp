@@ -0,0 +1,196 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+
+typedef DenseIndex Index;
+
+template<typename T> unsigned short bits(const T& x) { return x.x; }
+
+float from_bits(unsigned int u)
+{
+  float f;
+  std::memcpy(&f, &u, sizeof(float));
+  return f;
+}
+
+void half_conversion()
+{
+  VERIFY_IS_EQUAL(bits(half(0.f)), 0x0000);
+  VERIFY_IS_EQUAL(bits(half(-0.f)), 0x8000);
+  VERIFY_IS_EQUAL(bits(half(1.f)), 0x3c00);
+  VERIFY_IS_EQUAL(bits(half(-2.f)), 0xc000);
+  VERIFY_IS_EQUAL(bits(half(65504.f)), 0x7bff);
+  VERIFY_IS_EQUAL(bits(half(65520.f)), 0x7c00);
+  VERIFY_IS_EQUAL(bits(half(-1e6f)), 0xfc00);
+  VERIFY_IS_EQUAL(bits(half(std::numeric_limits<float>::infinity())), 0x7c00);
+  VERIFY((isnan)(half(std::numeric_limits<float>::quiet_NaN())));
+
+  // subnormals and rounding to nearest even
+  VERIFY_IS_EQUAL(bits(half(from_bits(0x33800000))), 0x0001);  // 2^-24
+  VERIFY_IS_EQUAL(bits(half(from_bits(0x33000000))), 0x0000);  // 2^-25, tie
+  VERIFY_IS_EQUAL(bits(half(from_bits(0x33c00000))), 0x0002);  // 3*2^-25, tie
+  VERIFY_IS_EQUAL(bits(half(1.f + from_bits(0x3a000000))), 0x3c00);    // 1+2^-11, tie
+  VERIFY_IS_EQUAL(bits(half(1.f + 3.f*from_bits(0x3a000000))), 0x3c02);
+  VERIFY_IS_EQUAL(float(internal::raw_uint16_to_half(0x0001)), from_bits(0x33800000));
+  VERIFY_IS_EQUAL(float(internal::raw_uint16_to_half(0x0400)), from_bits(0x38800000));
+
+  // all the half numbers convert exactly to float and back
+  for(unsigned int i=0; i<0x10000; ++i)
+  {
+    half h = internal::raw_uint16_to_half(static_cast<unsigned short>(i));
+    if((isnan)(h))
+      VERIFY((numext::isfinite)(float(h)) == false && float(h) != float(h));
+    else
+      VERIFY_IS_EQUAL(bits(half(float(h))), i);
+  }
+
+  VERIFY_IS_EQUAL(float((std::numeric_limits<half>::max)()), 65504.f);
+  VERIFY_IS_EQUAL(float(std::numeric_limits<half>::epsilon()), from_bits(0x3a800000));
+  VERIFY_IS_EQUAL(float(NumTraits<half>::highest()), 65504.f);
+  VERIFY_IS_EQUAL(float(NumTraits<half>::lowest()), -65504.f);
+  VERIFY(!NumTraits<half>::IsInteger && NumTraits<half>::IsSigned);
+}
+
+void bfloat16_conversion()
+{
+  VERIFY_IS_EQUAL(bits(bfloat16(0.f)), 0x0000);
+  VERIFY_IS_EQUAL(bits(bfloat16(-0.f)), 0x8000);
+  VERIFY_IS_EQUAL(bits(bfloat16(1.f)), 0x3f80);
+  VERIFY_IS_EQUAL(bits(bfloat16(-2.f)), 0xc000);
+  VERIFY_IS_EQUAL(bits(bfloat16(std::numeric_limits<float>::infinity())), 0x7f80);
+  VERIFY_IS_EQUAL(bits(bfloat16((std::numeric_limits<float>::max)())), 0x7f80);
+  VERIFY((isnan)(bfloat16(std::numeric_limits<float>::quiet_NaN())));
+  VERIFY((isnan)(bfloat16(from_bits(0x7fffffff))));
+
+  // rounding to nearest even
+  VERIFY_IS_EQUAL(bits(bfloat16(from_bits(0x3f808000))), 0x3f80);  // tie
+  VERIFY_IS_EQUAL(bits(bfloat16(from_bits(0x3f818000))), 0x3f82);  // tie
+  VERIFY_IS_EQUAL(bits(bfloat16(from_bits(0x3f808001))), 0x3f81);
+
+  for(unsigned int i=0; i<0x10000; ++i)
+  {
+    bfloat16 h = internal::raw_uint16_to_bfloat16(static_cast<unsigned short>(i));
+    if(!(isnan)(h))
+      VERIFY_IS_EQUAL(bits(bfloat16(float(h))), i);
+  }
+
+  VERIFY_IS_EQUAL(float(std::numeric_limits<bfloat16>::epsilon()), from_bits(0x3c000000));
+  VERIFY(!NumTraits<bfloat16>::IsInteger && NumTraits<bfloat16>::IsSigned);
+}
+
+template<typename T> void reduced_precision_cwise()
+{
+  typedef Array<T,Dynamic,1> ArrayX;
+  typedef Array<float,Dynamic,1> ArrayXf;
+  const Index size = internal::random<Index>(1,EIGEN_TEST_MAX_SIZE);
+
+  // values of various magnitudes, including the subnormals of half
+  ArrayXf f(size);
+  for(Index i=0; i<size; ++i)
+    f(i) = internal::random<float>(-1.f,1.f) * std::pow(2.f, float(internal::random<int>(-26,17)));
+  f(0) = std::numeric_limits<float>::infinity();
+  if(size>1) f(1) = std::numeric_limits<float>::quiet_NaN();
+
+  // the vectorized conversions match the scalar ones
+  ArrayX h = f.template cast<T>();
+  ArrayXf g = h.template cast<float>();
+  for(Index i=0; i<size; ++i)
+  {
+    VERIFY_IS_EQUAL(bits(h(i)), bits(T(f(i))));
+    VERIFY((numext::isfinite)(g(i))==false || g(i)==float(h(i)));
+  }
+
+  ArrayX a = ArrayX::Random(size), b = ArrayX::Random(size);
+  ArrayX c = a + b, d = a * b, e = a - b, q = a / b;
+  ArrayX m = (a.min)(b), n = a.abs(), o = -a;
+  for(Index i=0; i<size; ++i)
+  {
+    VERIFY_IS_EQUAL(bits(c(i)), bits(T(float(a(i)) + float(b(i)))));
+    VERIFY_IS_EQUAL(bits(d(i)), bits(T(float(a(i)) * float(b(i)))));
+    VERIFY_IS_EQUAL(bits(e(i)), bits(T(float(a(i)) - float(b(i)))));
+    VERIFY_IS_EQUAL(bits(q(i)), bits(T(float(a(i)) / float(b(i)))));
+    VERIFY_IS_EQUAL(bits(m(i)), bits((std::min)(a(i), b(i))));
+    VERIFY_IS_EQUAL(float(n(i)), std::abs(float(a(i))));
+    VERIFY_IS_EQUAL(float(o(i)), -float(a(i)));
+  }
+
+  const float eps = float(NumTraits<T>::epsilon());
+  ArrayXf af = a.template cast<float>();
+  // the partial sums are rounded
+  VERIFY(std::abs(float(a.sum()) - af.sum()) <= eps*size*af.abs().sum());
+  VERIFY_IS_EQUAL(float(a.maxCoeff()), af.maxCoeff());
+  VERIFY_IS_EQUAL(float(a.minCoeff()), af.minCoeff());
+  VERIFY(a.isApprox(a));
+}
+
+template<typename T> void reduced_precision_product(Index rows, Index depth, Index cols)
+{
+  typedef Matrix<T,Dynamic,Dynamic> MatrixX;
+  typedef Matrix<T,Dynamic,Dynamic,RowMajor> RowMatrixX;
+  typedef Matrix<T,Dynamic,1> VectorX;
+  typedef Matrix<float,Dynamic,Dynamic> MatrixXf;
+  typedef Matrix<float,Dynamic,1> VectorXf;
+
+  MatrixX A = MatrixX::Random(rows, depth), B = MatrixX::Random(depth, cols), C = MatrixX::Random(rows, cols);
+  RowMatrixX rA = A;
+  MatrixXf Af = A.template cast<float>(), Bf = B.template cast<float>(), Cf = C.template cast<float>();
+  const float eps = float(NumTraits<T>::epsilon());
+
+  // the products are accumulated in float and rounded once
+  MatrixXf ref = Af * Bf;
+  MatrixX res = A * B;
+  VERIFY(((res.template cast<float>() - ref).array().abs() <= eps * ref.array().abs() + 1e-5f * depth).all());
+  res.noalias() = rA * B;
+  VERIFY(((res.template cast<float>() - ref).array().abs() <= eps * ref.array().abs() + 1e-5f * depth).all());
+  RowMatrixX rres = A * B;
+  VERIFY(((rres.template cast<float>() - ref).array().abs() <= eps * ref.array().abs() + 1e-5f * depth).all());
+
+  ref = Cf - 2.f * Af * Bf;
+  res = C;
+  res.noalias() -= T(2.f) * A * B;
+  VERIFY(((res.template cast<float>() - ref).array().abs() <= eps * ref.array().abs() + 1e-5f * depth).all());
+
+  VectorX x = VectorX::Random(depth), y = VectorX::Random(rows);
+  VectorXf xf = x.template cast<float>(), yf = y.template cast<float>();
+  VectorXf vref = yf + Af * xf;
+  VectorX v = y;
+  v.noalias() += A * x;
+  VERIFY(((v.template cast<float>() - vref).array().abs() <= eps * vref.array().abs() + 1e-5f * depth).all());
+  v = y;
+  v.noalias() += rA * x;
+  VERIFY(((v.template cast<float>() - vref).array().abs() <= eps * vref.array().abs() + 1e-5f * depth).all());
+  v.noalias() = A.transpose().transpose() * x;
+  vref = Af * xf;
+  VERIFY(((v.template cast<float>() - vref).array().abs() <= eps * vref.array().abs() + 1e-5f * depth).all());
+
+  // the partial sums are not rounded to T, otherwise the additions of eps/4 to 1 would be lost
+  MatrixX small = MatrixX::Constant(rows, depth, T(eps/4));
+  small.col(0).setOnes();
+  const float expected = float(T(1.f + float(depth-1)*eps/4));
+  VERIFY(((small * VectorX::Ones(depth)).template cast<float>().array() == expected).all());
+  VERIFY(((small * MatrixX::Ones(depth, cols)).template cast<float>().array() == expected).all());
+  VERIFY(((RowMatrixX(small) * VectorX::Ones(depth)).template cast<float>().array() == expected).all());
+}
+
+void test_half_float()
+{
+  CALL_SUBTEST_1( half_conversion() );
+  CALL_SUBTEST_2( bfloat16_conversion() );
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( reduced_precision_cwise<half>() );
+    CALL_SUBTEST_2( reduced_precision_cwise<bfloat16>() );
+
+    Index rows = internal::random<Index>(1,EIGEN_TEST_MAX_SIZE); TEST_SET_BUT_UNUSED_VARIABLE(rows)
+    Index depth = internal::random<Index>(1,EIGEN_TEST_MAX_SIZE); TEST_SET_BUT_UNUSED_VARIABLE(depth)
+    Index cols = internal::random<Index>(1,EIGEN_TEST_MAX_SIZE); TEST_SET_BUT_UNUSED_VARIABLE(cols)
+    CALL_SUBTEST_3( reduced_precision_product<half>(rows, depth, cols) );
+    CALL_SUBTEST_4( reduced_precision_product<bfloat16>(rows, depth, cols) );
+  }
+  CALL_SUBTEST_3( reduced_precision_product<half>(300, 1500, 70) );
+  CALL_SUBTEST_4( reduced_precision_product<bfloat16>(70, 1500, 300) );
+}
@@ -49,6 +49,34 @@ template<typename Scalar> bool areApprox(const Scalar* a, const Scalar* b, int s
   return true;
 }
 
+// distance between a and b in units in the last place of b, the denormalized numbers having the smallest one,
+// and NaN if only one of them is infinite or NaN
+template<typename Scalar> Scalar ulpDistance(const Scalar& a, const Scalar& b)
+{
+  using std::abs;
+  if (a==b)
+    return Scalar(0);
+  if (!(abs(b)<=NumTraits<Scalar>::highest()))
+    return std::numeric_limits<Scalar>::quiet_NaN();
+  int e;
+  std::frexp(b, &e);
+  Scalar ulp = (std::max)(std::ldexp(Scalar(1), e-std::numeric_limits<Scalar>::digits), std::numeric_limits<Scalar>::denorm_min());
+  return abs(a-b)/ulp;
+}
+
+template<typename Scalar> bool areApproxUlp(const Scalar* a, const Scalar* b, int size, const Scalar& ulps)
+{
+  for (int i=0; i<size; ++i)
+  {
+    if (!(ulpDistance(a[i],b[i])<=ulps))
+    {
+      std::cout.precision(std::numeric_limits<Scalar>::digits10+2);
+      std::cout << "[" << Map<const Matrix<Scalar,1,Dynamic> >(a,size) << "]" << " != " << Map<const Matrix<Scalar,1,Dynamic> >(b,size) << "\n";
+      return false;
+    }
+  }
+  return true;
+}
 
 #define CHECK_CWISE2(REFOP, POP) { \
   for (int i=0; i<PacketSize; ++i) \
@@ -92,6 +120,38 @@ struct packet_helper<false,Packet>
   VERIFY(areApprox(ref, data2, PacketSize) && #POP); \
 }
 
+#define CHECK_CWISE2_IF(COND, REFOP, POP) if(COND) { \
+  packet_helper<COND,Packet> h; \
+  for (int i=0; i<PacketSize; ++i) \
+    ref[i] = REFOP(data1[i], data1[i+PacketSize]); \
+  h.store(data2, POP(h.load(data1),h.load(data1+PacketSize))); \
+  VERIFY(areApprox(ref, data2, PacketSize) && #POP); \
+}
+
+#define CHECK_CWISE1_ULP_IF(COND, REFOP, POP, ULPS) if(COND) { \
+  packet_helper<COND,Packet> h; \
+  for (int i=0; i<PacketSize; ++i) \
+    ref[i] = REFOP(data1[i]); \
+  h.store(data2, POP(h.load(data1))); \
+  VERIFY(areApproxUlp(data2, ref, PacketSize, Scalar(ULPS)) && #POP); \
+}
+
+#define CHECK_CWISE2_ULP_IF(COND, REFOP, POP, ULPS) if(COND) { \
+  packet_helper<COND,Packet> h; \
+  for (int i=0; i<PacketSize; ++i) \
+    ref[i] = REFOP(data1[i], data1[i+PacketSize]); \
+  h.store(data2, POP(h.load(data1),h.load(data1+PacketSize))); \
+  VERIFY(areApproxUlp(data2, ref, PacketSize, Scalar(ULPS)) && #POP); \
+}
+
+// references computed in double precision by the C library
+template<typename T> T ref_log1p(const T& x) { return T(::log1p(double(x))); }
+template<typename T> T ref_expm1(const T& x) { return T(::expm1(double(x))); }
+template<typename T> T ref_erf(const T& x) { return T(::erf(double(x))); }
+template<typename T> T ref_pow(const T& x, const T& y) { return T(std::pow(double(x), double(y))); }
+template<typename T> T ref_tanh(const T& x) { return T(std::tanh(double(x))); }
+template<typename T> T ref_log(const T& x) { return T(std::log(double(x))); }
+
 #define REF_ADD(a,b) ((a)+(b))
 #define REF_SUB(a,b) ((a)-(b))
 #define REF_MUL(a,b) ((a)*(b))
@@ -114,7 +174,7 @@ template<typename Scalar> void packetmath()
   {
     data1[i] = internal::random<Scalar>()/RealScalar(PacketSize);
     data2[i] = internal::random<Scalar>()/RealScalar(PacketSize);
-    refvalue = (std::max)(refvalue,abs(data1[i]));
+    refvalue = (std::max)(refvalue,RealScalar(abs(data1[i])));
   }
 
   internal::pstore(data2, internal::pload<Packet>(data1));
@@ -132,7 +192,8 @@ template<typename Scalar> void packetmath()
     VERIFY(areApprox(data1, data2+offset, PacketSize) && "internal::pstoreu");
   }
 
-  for (int offset=0; offset<PacketSize; ++offset)
+  // palign is only used with offsets up to 3
+  for (int offset=0; offset<(std::min)(PacketSize,4); ++offset)
   {
     packets[0] = internal::pload<Packet>(data1);
     packets[1] = internal::pload<Packet>(data1+PacketSize);
@@ -152,8 +213,8 @@ template<typename Scalar> void packetmath()
   CHECK_CWISE2(REF_SUB,  internal::psub);
   CHECK_CWISE2(REF_MUL,  internal::pmul);
   #ifndef EIGEN_VECTORIZE_ALTIVEC
-  if (!internal::is_same<Scalar,int>::value)
-    CHECK_CWISE2(REF_DIV,  internal::pdiv);
+  // the integer divisions are checked with non zero divisors in packetmath_integer
+  CHECK_CWISE2_IF(!NumTraits<Scalar>::IsInteger, REF_DIV,  internal::pdiv);
   #endif
   CHECK_CWISE1(internal::negate, internal::pnegate);
   CHECK_CWISE1(numext::conj, internal::pconj);
@@ -189,12 +250,14 @@ template<typename Scalar> void packetmath()
     ref[0] *= data1[i];
   VERIFY(internal::isApprox(ref[0], internal::predux_mul(internal::pload<Packet>(data1))) && "internal::predux_mul");
 
+  // the packets of more than 4 coefficients reuse the data
   for (int j=0; j<PacketSize; ++j)
   {
+    const int start = (j*PacketSize) % size;
     ref[j] = 0;
     for (int i=0; i<PacketSize; ++i)
-      ref[j] += data1[i+j*PacketSize];
-    packets[j] = internal::pload<Packet>(data1+j*PacketSize);
+      ref[j] += data1[i+start];
+    packets[j] = internal::pload<Packet>(data1+start);
   }
   internal::pstore(data2, internal::preduxp(packets));
   VERIFY(areApproxAbs(ref, data2, PacketSize, refvalue) && "internal::preduxp");
@@ -224,6 +287,8 @@ template<typename Scalar> void packetmath_real()
   CHECK_CWISE1_IF(internal::packet_traits<Scalar>::HasSin, std::sin, internal::psin);
   CHECK_CWISE1_IF(internal::packet_traits<Scalar>::HasCos, std::cos, internal::pcos);
   CHECK_CWISE1_IF(internal::packet_traits<Scalar>::HasTan, std::tan, internal::ptan);
+  CHECK_CWISE1_IF(internal::packet_traits<Scalar>::HasATan, std::atan, internal::patan);
+  CHECK_CWISE1_IF(internal::packet_traits<Scalar>::HasTanh, std::tanh, internal::ptanh);
   
   for (int i=0; i<size; ++i)
   {
@@ -232,6 +297,59 @@ template<typename Scalar> void packetmath_real()
   }
   CHECK_CWISE1_IF(internal::packet_traits<Scalar>::HasASin, std::asin, internal::pasin);
   CHECK_CWISE1_IF(internal::packet_traits<Scalar>::HasACos, std::acos, internal::pacos);
+  CHECK_CWISE1_IF(internal::packet_traits<Scalar>::HasATan, std::atan, internal::patan);
+
+  for (int i=0; i<size; ++i)
+  {
+    data1[i] = internal::random<Scalar>(-1,1) * std::pow(Scalar(10), internal::random<Scalar>(-6,1));
+    data2[i] = internal::random<Scalar>(-1,1) * std::pow(Scalar(10), internal::random<Scalar>(-6,1));
+  }
+  CHECK_CWISE1_IF(internal::packet_traits<Scalar>::HasTanh, std::tanh, internal::ptanh);
+  CHECK_CWISE1_IF(internal::packet_traits<Scalar>::HasErf, ref_erf, internal::perf);
+  CHECK_CWISE1_ULP_IF(internal::packet_traits<Scalar>::HasTanh, ref_tanh, internal::ptanh, 3);
+  CHECK_CWISE1_ULP_IF(internal::packet_traits<Scalar>::HasErf, ref_erf, internal::perf, 3);
+  // near the smallest normalized number, and the denormalized numbers
+  for (int i=0; i<PacketSize; ++i)
+    data1[i] = (std::numeric_limits<Scalar>::min)() * internal::random<Scalar>(Scalar(-2),Scalar(2));
+  data1[0] = std::numeric_limits<Scalar>::denorm_min();
+  CHECK_CWISE1_ULP_IF(internal::packet_traits<Scalar>::HasTanh, ref_tanh, internal::ptanh, 3);
+  CHECK_CWISE1_ULP_IF(internal::packet_traits<Scalar>::HasErf, ref_erf, internal::perf, 3);
+  CHECK_CWISE1_ULP_IF(internal::packet_traits<Scalar>::HasExpm1, ref_expm1, internal::pexpm1, 3);
+  CHECK_CWISE1_IF(internal::packet_traits<Scalar>::HasExpm1, ref_expm1, internal::pexpm1);
+  {
+    // near the overflow, and the infinities
+    const Scalar inf = std::numeric_limits<Scalar>::infinity();
+    const Scalar log_max = std::log(NumTraits<Scalar>::highest());
+    packet_helper<internal::packet_traits<Scalar>::HasExpm1,Packet> h;
+    data1[0] = log_max - Scalar(0.05);
+    h.store(data2, internal::pexpm1(h.load(data1)));
+    VERIFY(ulpDistance(data2[0], ref_expm1(data1[0])) <= Scalar(4));
+    data1[0] = log_max + Scalar(0.01);
+    h.store(data2, internal::pexpm1(h.load(data1)));
+    VERIFY_IS_EQUAL(data2[0], inf);
+    data1[0] = inf;
+    h.store(data2, internal::pexpm1(h.load(data1)));
+    VERIFY_IS_EQUAL(data2[0], inf);
+    data1[0] = -inf;
+    h.store(data2, internal::pexpm1(h.load(data1)));
+    VERIFY_IS_EQUAL(data2[0], Scalar(-1));
+  }
+  {
+    packet_helper<internal::packet_traits<Scalar>::HasTanh,Packet> h;
+    data1[0] = Scalar(-0.);
+    h.store(data2, internal::ptanh(h.load(data1)));
+    VERIFY_IS_EQUAL(data2[0], Scalar(0));
+    VERIFY(Scalar(1)/data2[0] < Scalar(0));
+  }
+  for (int i=0; i<size; ++i)
+    data1[i] = (std::max)(data1[i], Scalar(-0.99));
+  CHECK_CWISE1_IF(internal::packet_traits<Scalar>::HasLog1p, ref_log1p, internal::plog1p);
+  {
+    packet_helper<internal::packet_traits<Scalar>::HasLog1p,Packet> h;
+    data1[0] = std::numeric_limits<Scalar>::infinity();
+    h.store(data2, internal::plog1p(h.load(data1)));
+    VERIFY_IS_EQUAL(data2[0], std::numeric_limits<Scalar>::infinity());
+  }
 
   for (int i=0; i<size; ++i)
   {
@@ -263,12 +381,97 @@ template<typename Scalar> void packetmath_real()
     data1[0] = -1.0f;
     h.store(data2, internal::plog(h.load(data1)));
     VERIFY(isNaN(data2[0]));
+    // the denormalized numbers
+    data1[0] = std::numeric_limits<Scalar>::denorm_min();
+    data1[1] = (std::numeric_limits<Scalar>::min)() / Scalar(3);
+    h.store(data2, internal::plog(h.load(data1)));
+    VERIFY(ulpDistance(data2[0], ref_log(data1[0])) <= Scalar(2));
+    VERIFY(ulpDistance(data2[1], ref_log(data1[1])) <= Scalar(2));
 #if !EIGEN_FAST_MATH
     h.store(data2, internal::psqrt(h.load(data1)));
     VERIFY(isNaN(data2[0]));
     VERIFY(isNaN(data2[1]));
 #endif
   }
+
+  for (int i=0; i<PacketSize; ++i)
+  {
+    data1[i] = internal::random<Scalar>(0,1) * std::pow(Scalar(10), internal::random<Scalar>(-3,3));
+    data1[i+PacketSize] = internal::random<Scalar>(-4,4);
+  }
+  CHECK_CWISE2_IF(internal::packet_traits<Scalar>::HasPow, ref_pow, internal::ppow);
+  // negative numbers to integer powers
+  for (int i=0; i<PacketSize; ++i)
+  {
+    data1[i] = internal::random<Scalar>(-10,10);
+    data1[i+PacketSize] = Scalar(internal::random<int>(-5,5));
+  }
+  CHECK_CWISE2_IF(internal::packet_traits<Scalar>::HasPow, ref_pow, internal::ppow);
+  {
+    packet_helper<internal::packet_traits<Scalar>::HasPow,Packet> h;
+    data1[0] = Scalar(-2);
+    data1[PacketSize] = Scalar(0.5);
+    h.store(data2, internal::ppow(h.load(data1),h.load(data1+PacketSize)));
+    VERIFY(isNaN(data2[0]));
+    data1[0] = Scalar(0);
+    data1[PacketSize] = Scalar(0);
+    h.store(data2, internal::ppow(h.load(data1),h.load(data1+PacketSize)));
+    VERIFY_IS_EQUAL(data2[0], Scalar(1));
+    data1[PacketSize] = Scalar(-1);
+    h.store(data2, internal::ppow(h.load(data1),h.load(data1+PacketSize)));
+    VERIFY_IS_EQUAL(data2[0], std::numeric_limits<Scalar>::infinity());
+  }
+  // large exponents, up to the overflow and the denormalized numbers
+  const Scalar log_max = std::log(NumTraits<Scalar>::highest());
+  for (int i=0; i<PacketSize; ++i)
+  {
+    data1[i] = internal::random<Scalar>(Scalar(1.1),Scalar(2));
+    data1[i+PacketSize] = internal::random<Scalar>(Scalar(-1.03),Scalar(0.999)) * log_max / std::log(data1[i]);
+  }
+  CHECK_CWISE2_ULP_IF(internal::packet_traits<Scalar>::HasPow, ref_pow, internal::ppow, 2);
+  // integer exponents beyond 32
+  for (int i=0; i<PacketSize; ++i)
+  {
+    data1[i] = internal::random<Scalar>(Scalar(-1.5),Scalar(1.5));
+    data1[i+PacketSize] = Scalar(internal::random<int>(33,150) * (2*internal::random<int>(0,1)-1));
+  }
+  CHECK_CWISE2_ULP_IF(internal::packet_traits<Scalar>::HasPow, ref_pow, internal::ppow, 2);
+  for (int i=0; i<PacketSize; ++i)
+  {
+    data1[i] = internal::random<Scalar>(0,1) * std::pow(Scalar(10), internal::random<Scalar>(-3,3));
+    data1[i+PacketSize] = internal::random<Scalar>(-4,4);
+  }
+  CHECK_CWISE2_ULP_IF(internal::packet_traits<Scalar>::HasPow, ref_pow, internal::ppow, 2);
+  if(internal::packet_traits<Scalar>::HasPow)
+  {
+    // the packet path of Array::pow(), for integer exponents
+    for (int i=0; i<PacketSize; ++i)
+      data1[i] = internal::random<Scalar>(Scalar(0.5),Scalar(2)) * Scalar(2*internal::random<int>(0,1)-1);
+    const int exponents[] = { -7, -2, -1, 1, 2, 3, 31, 33 };
+    for (int k=0; k<8; ++k)
+    {
+      internal::scalar_pow_op<Scalar> op = internal::scalar_pow_op<Scalar>(Scalar(exponents[k]));
+      for (int i=0; i<PacketSize; ++i)
+        ref[i] = ref_pow(data1[i], Scalar(exponents[k]));
+      internal::pstore(data2, op.packetOp(internal::pload<Packet>(data1)));
+      VERIFY(areApproxUlp(data2, ref, PacketSize, Scalar(2)));
+    }
+  }
+  {
+    // exact powers, overflow, underflow, and the special cases of the C pow function
+    const Scalar inf = std::numeric_limits<Scalar>::infinity();
+    const Scalar denorm = Scalar(std::numeric_limits<Scalar>::min_exponent - std::numeric_limits<Scalar>::digits + 1);
+    const Scalar x[] = { -2, -2, 10,  10,      2, -inf, -inf, Scalar(-0.),  -1 };
+    const Scalar y[] = { 33, 35, 400, -400, denorm, 1.5,   3,          -3, inf };
+    packet_helper<internal::packet_traits<Scalar>::HasPow,Packet> h;
+    for (int k=0; k<9; ++k)
+    {
+      data1[0] = x[k];
+      data1[PacketSize] = y[k];
+      h.store(data2, internal::ppow(h.load(data1),h.load(data1+PacketSize)));
+      VERIFY_IS_EQUAL(data2[0], ref_pow(x[k], y[k]));
+    }
+  }
 }
 
 template<typename Scalar> void packetmath_notcomplex()
@@ -363,6 +566,89 @@ template<typename Scalar> void packetmath_complex()
   
 }
 
+#ifdef EIGEN_VECTORIZE_SSE
+// the integer specific packet functions of SSE
+void packetmath_integer()
+{
+  using namespace internal;
+  EIGEN_ALIGN16 unsigned char uc1[16], uc2[16], ucres[16];
+  EIGEN_ALIGN16 short s1[8], s2[8], sres[8];
+  EIGEN_ALIGN16 int i1[4], i2[4], ires[4];
+  EIGEN_ALIGN16 float f1[4], fres[4];
+  for(int k=0; k<16; ++k)
+  {
+    uc1[k] = internal::random<unsigned char>();
+    uc2[k] = internal::random<unsigned char>();
+  }
+  for(int k=0; k<8; ++k)
+  {
+    s1[k] = internal::random<short>();
+    s2[k] = internal::random<short>();
+  }
+  for(int k=0; k<4; ++k)
+  {
+    i1[k] = internal::random<int>();
+    i2[k] = internal::random<int>(1,1000) * (2*internal::random<int>(0,1)-1);
+    f1[k] = internal::random<float>(-1e6f,1e6f);
+  }
+  Packet16uc puc1 = pload<Packet16uc>(uc1), puc2 = pload<Packet16uc>(uc2);
+  Packet8s ps1 = pload<Packet8s>(s1), ps2 = pload<Packet8s>(s2);
+  Packet4i pi1 = pload<Packet4i>(i1), pi2 = pload<Packet4i>(i2);
+
+  pstore(ucres, padds(puc1, puc2));
+  for(int k=0; k<16; ++k) VERIFY_IS_EQUAL(int(ucres[k]), (std::min)(int(uc1[k])+int(uc2[k]), 255));
+  pstore(ucres, psubs(puc1, puc2));
+  for(int k=0; k<16; ++k) VERIFY_IS_EQUAL(int(ucres[k]), (std::max)(int(uc1[k])-int(uc2[k]), 0));
+  pstore(sres, padds(ps1, ps2));
+  for(int k=0; k<8; ++k) VERIFY_IS_EQUAL(int(sres[k]), (std::max)((std::min)(int(s1[k])+int(s2[k]), 32767), -32768));
+  pstore(sres, psubs(ps1, ps2));
+  for(int k=0; k<8; ++k) VERIFY_IS_EQUAL(int(sres[k]), (std::max)((std::min)(int(s1[k])-int(s2[k]), 32767), -32768));
+
+  pstore(ucres, plogical_shift_left<3>(puc1));
+  for(int k=0; k<16; ++k) VERIFY_IS_EQUAL(ucres[k], (unsigned char)(uc1[k] << 3));
+  pstore(ucres, plogical_shift_right<5>(puc1));
+  for(int k=0; k<16; ++k) VERIFY_IS_EQUAL(ucres[k], (unsigned char)(uc1[k] >> 5));
+  pstore(sres, plogical_shift_left<4>(ps1));
+  for(int k=0; k<8; ++k) VERIFY_IS_EQUAL(sres[k], short(s1[k] << 4));
+  pstore(sres, plogical_shift_right<4>(ps1));
+  for(int k=0; k<8; ++k) VERIFY_IS_EQUAL(sres[k], short((unsigned short)(s1[k]) >> 4));
+  pstore(sres, parithmetic_shift_right<4>(ps1));
+  for(int k=0; k<8; ++k) VERIFY_IS_EQUAL(sres[k], short(s1[k] >> 4));
+  pstore(ires, parithmetic_shift_right<7>(pi1));
+  for(int k=0; k<4; ++k) VERIFY_IS_EQUAL(ires[k], i1[k] >> 7);
+
+  // widening multiply-accumulate
+  int dot = 0;
+  for(int k=0; k<16; ++k) dot += int(uc1[k]) * int(uc2[k]);
+  VERIFY_IS_EQUAL(predux(pmaddw(puc1, puc2, pset1<Packet4i>(1))), dot + 4);
+  dot = 0;
+  for(int k=0; k<8; ++k) dot += int(s1[k]) * int(s2[k]);
+  VERIFY_IS_EQUAL(predux(pmaddw(ps1, ps2, pset1<Packet4i>(0))), dot);
+
+  // widening and saturating narrowing conversions
+  pstore(sres, pwiden_low<Packet8s>(puc1));
+  for(int k=0; k<8; ++k) VERIFY_IS_EQUAL(int(sres[k]), int(uc1[k]));
+  pstore(sres, pwiden_high<Packet8s>(puc1));
+  for(int k=0; k<8; ++k) VERIFY_IS_EQUAL(int(sres[k]), int(uc1[k+8]));
+  pstore(ires, pwiden_low<Packet4i>(ps1));
+  for(int k=0; k<4; ++k) VERIFY_IS_EQUAL(ires[k], int(s1[k]));
+  pstore(ires, pwiden_high<Packet4i>(ps1));
+  for(int k=0; k<4; ++k) VERIFY_IS_EQUAL(ires[k], int(s1[k+4]));
+  pstore(ucres, pnarrow<Packet16uc>(ps1, ps2));
+  for(int k=0; k<16; ++k) VERIFY_IS_EQUAL(int(ucres[k]), (std::max)((std::min)(int(k<8 ? s1[k] : s2[k-8]), 255), 0));
+  pstore(sres, pnarrow<Packet8s>(pi1, pi2));
+  for(int k=0; k<8; ++k) VERIFY_IS_EQUAL(int(sres[k]), (std::max)((std::min)(k<4 ? i1[k] : i2[k-4], 32767), -32768));
+
+  // conversions to and from float, and integer division
+  pstore(fres, pcast<Packet4i,Packet4f>(pi1));
+  for(int k=0; k<4; ++k) VERIFY_IS_EQUAL(fres[k], float(i1[k]));
+  pstore(ires, pcast<Packet4f,Packet4i>(pload<Packet4f>(f1)));
+  for(int k=0; k<4; ++k) VERIFY_IS_EQUAL(ires[k], int(f1[k]));
+  pstore(ires, pdiv(pi1, pi2));
+  for(int k=0; k<4; ++k) VERIFY_IS_EQUAL(ires[k], i1[k] / i2[k]);
+}
+#endif
+
 void test_packetmath()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -375,6 +661,16 @@ void test_packetmath()
     CALL_SUBTEST_1( packetmath_notcomplex<float>() );
     CALL_SUBTEST_2( packetmath_notcomplex<double>() );
     CALL_SUBTEST_3( packetmath_notcomplex<int>() );
+
+    CALL_SUBTEST_4( packetmath<unsigned char>() );
+    CALL_SUBTEST_4( packetmath<short>() );
+    CALL_SUBTEST_4( packetmath<std::ptrdiff_t>() );
+    CALL_SUBTEST_4( packetmath_notcomplex<unsigned char>() );
+    CALL_SUBTEST_4( packetmath_notcomplex<short>() );
+    CALL_SUBTEST_4( packetmath_notcomplex<std::ptrdiff_t>() );
+#ifdef EIGEN_VECTORIZE_SSE
+    CALL_SUBTEST_4( packetmath_integer() );
+#endif
     
     CALL_SUBTEST_1( packetmath_real<float>() );
     CALL_SUBTEST_2( packetmath_real<double>() );
@@ -0,0 +1,110 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// split even small assignments between threads; this test is built with OpenMP when it is supported
+#define EIGEN_PARALLEL_ASSIGN_THRESHOLD 16
+
+#include "main.h"
+
+template<typename MatrixType> void parallelAssign(const MatrixType& m)
+{
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  Index rows = m.rows();
+  Index cols = m.cols();
+
+  MatrixType m1 = MatrixType::Random(rows, cols),
+             m2 = MatrixType::Random(rows, cols),
+             m3(rows, cols),
+             ref(rows, cols);
+  Scalar s1 = internal::random<Scalar>();
+
+  ref = m1 + s1 * m2;
+  m3.parallel() = m1 + s1 * m2;
+  VERIFY_IS_EQUAL(m3, ref);
+
+  ref += m1.cwiseProduct(m2);
+  m3.parallel() += m1.cwiseProduct(m2);
+  VERIFY_IS_EQUAL(m3, ref);
+
+  ref -= m2;
+  m3.parallel() -= m2;
+  VERIFY_IS_EQUAL(m3, ref);
+
+  // the destination is resized
+  MatrixType m4;
+  m4.parallel() = m1.array().square().matrix();
+  VERIFY_IS_EQUAL(m4, MatrixType(m1.array().square().matrix()));
+
+  // blocks, and arrays
+  m3.setZero();
+  m3.block(0, 0, rows, cols/2).parallel() = m1.block(0, 0, rows, cols/2);
+  VERIFY_IS_EQUAL(m3.block(0, 0, rows, cols/2), m1.block(0, 0, rows, cols/2));
+  VERIFY(m3.block(0, cols/2, rows, cols-cols/2).isZero());
+  m3.array().parallel() = m1.array() * m2.array() + s1;
+  VERIFY_IS_EQUAL(m3, MatrixType(m1.cwiseProduct(m2).array() + s1));
+
+  // products are evaluated by their own kernels
+  ref = m1 * m2.transpose() * m1;
+  m3.parallel() = m1 * m2.transpose() * m1;
+  VERIFY_IS_APPROX(m3, ref);
+
+  // partial reductions
+  Matrix<Scalar,1,Dynamic> colSums;
+  colSums.parallel() = m1.colwise().sum();
+  VERIFY_IS_APPROX(colSums, m1.colwise().sum());
+  Matrix<RealScalar,Dynamic,1> rowNorms;
+  rowNorms.parallel() = m1.rowwise().squaredNorm();
+  VERIFY_IS_APPROX(rowNorms, m1.rowwise().squaredNorm());
+}
+
+template<typename VectorType> void parallelAssignVector(const VectorType& v)
+{
+  typedef typename VectorType::Scalar Scalar;
+  VectorType v1 = VectorType::Random(v.size()),
+             v2 = VectorType::Random(v.size()),
+             v3;
+  Scalar s1 = internal::random<Scalar>();
+
+  v3.parallel() = s1 * v1 - v2;
+  VERIFY_IS_EQUAL(v3, VectorType(s1 * v1 - v2));
+  v3.parallel() += v1.reverse();
+  VERIFY_IS_EQUAL(v3, VectorType(s1 * v1 - v2 + v1.reverse()));
+
+  // a destination which does not start a cache line
+  if(v.size() > 1)
+  {
+    VectorType ref = v3;
+    ref.tail(v.size()-1) = v1.tail(v.size()-1) + v2.head(v.size()-1);
+    v3.tail(v.size()-1).parallel() = v1.tail(v.size()-1) + v2.head(v.size()-1);
+    VERIFY_IS_EQUAL(v3, ref);
+  }
+}
+
+void test_parallel_assign()
+{
+#ifdef EIGEN_HAS_OPENMP
+  // several threads, whatever the number of cores
+  setNbThreads(4);
+  VERIFY_IS_EQUAL(nbThreads(), 4);
+#endif
+  for(int i = 0; i < g_repeat; i++) {
+    int rows = internal::random<int>(1,EIGEN_TEST_MAX_SIZE); TEST_SET_BUT_UNUSED_VARIABLE(rows)
+    int cols = internal::random<int>(2,EIGEN_TEST_MAX_SIZE); TEST_SET_BUT_UNUSED_VARIABLE(cols)
+    CALL_SUBTEST_1( parallelAssign(MatrixXf(rows, cols)) );
+    CALL_SUBTEST_2( parallelAssign(Matrix<double,Dynamic,Dynamic,RowMajor>(rows, cols)) );
+    // tall and skinny, and short and wide
+    CALL_SUBTEST_3( parallelAssign(MatrixXd(internal::random<int>(1000,5000), 2)) );
+    CALL_SUBTEST_3( parallelAssign(Matrix<float,Dynamic,Dynamic,RowMajor>(internal::random<int>(1,3), internal::random<int>(1000,5000))) );
+    CALL_SUBTEST_4( parallelAssign(MatrixXcd(rows, cols)) );
+    CALL_SUBTEST_5( parallelAssignVector(VectorXd(internal::random<int>(1,100000))) );
+    CALL_SUBTEST_5( parallelAssignVector(RowVectorXf(internal::random<int>(1,100000))) );
+    CALL_SUBTEST_6( parallelAssign(Matrix4f()) );
+  }
+}
@@ -0,0 +1,94 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+
+typedef DenseIndex Index;
+
+template<typename MatrixType> void random_bytes(MatrixType& m)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  for(Index j=0; j<m.cols(); ++j)
+    for(Index i=0; i<m.rows(); ++i)
+      m(i,j) = Scalar(internal::random<int>((std::numeric_limits<Scalar>::min)(), (std::numeric_limits<Scalar>::max)()));
+}
+
+template<typename LhsScalar, typename RhsScalar> void quantized_product(Index rows, Index depth, Index cols)
+{
+  typedef Matrix<LhsScalar,Dynamic,Dynamic> LhsMatrix;
+  typedef Matrix<RhsScalar,Dynamic,Dynamic> RhsMatrix;
+  typedef Matrix<LhsScalar,Dynamic,Dynamic,RowMajor> RowLhsMatrix;
+  typedef Matrix<RhsScalar,Dynamic,Dynamic,RowMajor> RowRhsMatrix;
+
+  LhsMatrix A(rows, depth);
+  RhsMatrix B(depth, cols);
+  random_bytes(A);
+  random_bytes(B);
+  // the extreme values
+  A(0,0) = (std::numeric_limits<LhsScalar>::min)();
+  B(0,0) = (std::numeric_limits<RhsScalar>::min)();
+  A(rows-1,depth-1) = (std::numeric_limits<LhsScalar>::max)();
+  B(depth-1,cols-1) = (std::numeric_limits<RhsScalar>::max)();
+
+  const MatrixXi Ai = A.template cast<int>(), Bi = B.template cast<int>();
+  const MatrixXi ref = Ai * Bi;
+
+  MatrixXi C = quantizedProduct(A, B);
+  VERIFY_IS_EQUAL(C, ref);
+  C = quantizedProduct(RowLhsMatrix(A), RowRhsMatrix(B));
+  VERIFY_IS_EQUAL(C, ref);
+  Matrix<int,Dynamic,Dynamic,RowMajor> rC = quantizedProduct(A, RowRhsMatrix(B));
+  VERIFY_IS_EQUAL(MatrixXi(rC), ref);
+
+  // transposed operands and blocks
+  const Matrix<RhsScalar,Dynamic,Dynamic> Bt = B.transpose();
+  C = quantizedProduct(A, Bt.transpose());
+  VERIFY_IS_EQUAL(C, ref);
+  if(rows>1 && depth>1)
+  {
+    Index r = internal::random<Index>(1,rows-1), d = internal::random<Index>(1,depth-1);
+    C = quantizedProduct(A.bottomRightCorner(r,d), B.bottomRows(d));
+    VERIFY_IS_EQUAL(C, (Ai.bottomRightCorner(r,d) * Bi.bottomRows(d)).eval());
+  }
+
+  // zero points and scales
+  VectorXi za(rows), zb(cols);
+  for(Index i=0; i<rows; ++i) za(i) = internal::random<int>(-20,150);
+  for(Index j=0; j<cols; ++j) zb(j) = internal::random<int>(-20,150);
+  const MatrixXi ref2 = (Ai - za.replicate(1,depth)) * (Bi - zb.transpose().replicate(depth,1));
+  C = quantizedProduct(A, B).setZeroPoints(za, zb);
+  VERIFY_IS_EQUAL(C, ref2);
+  C = quantizedProduct(A, B).setZeroPoints(za, VectorXi());
+  VERIFY_IS_EQUAL(C, ((Ai - za.replicate(1,depth)) * Bi).eval());
+  C = quantizedProduct(A, B).setZeroPoints(3, 128);
+  VERIFY_IS_EQUAL(C, ((Ai.array() - 3).matrix() * (Bi.array() - 128).matrix()).eval());
+
+  VectorXf sa = VectorXf::Random(rows), sb = VectorXf::Random(cols);
+  MatrixXf D = quantizedProduct(A, B).setZeroPoints(za, zb).setScales(sa, sb);
+  MatrixXf refD = sa.asDiagonal() * ref2.cast<float>() * sb.asDiagonal();
+  VERIFY_IS_APPROX(D, refD);
+  D = quantizedProduct(A, B).setScales(0.5f, 0.25f);
+  VERIFY_IS_APPROX(D, (0.125f * ref.cast<float>()).eval());
+  D = quantizedProduct(A, B);
+  VERIFY_IS_EQUAL(D, ref.cast<float>());
+}
+
+void test_quantized_product()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    Index rows = internal::random<Index>(1,EIGEN_TEST_MAX_SIZE);
+    Index depth = internal::random<Index>(1,EIGEN_TEST_MAX_SIZE);
+    Index cols = internal::random<Index>(1,EIGEN_TEST_MAX_SIZE);
+    CALL_SUBTEST_1(( quantized_product<signed char,signed char>(rows, depth, cols) ));
+    CALL_SUBTEST_2(( quantized_product<unsigned char,signed char>(rows, depth, cols) ));
+    CALL_SUBTEST_3(( quantized_product<signed char,unsigned char>(rows, depth, cols) ));
+    CALL_SUBTEST_4(( quantized_product<unsigned char,unsigned char>(rows, depth, cols) ));
+    CALL_SUBTEST_1(( quantized_product<signed char,signed char>(internal::random<Index>(1,9), internal::random<Index>(1,5), internal::random<Index>(1,5)) ));
+  }
+  CALL_SUBTEST_2(( quantized_product<unsigned char,signed char>(300, 2000, 70) ));
+  CALL_SUBTEST_3(( quantized_product<signed char,unsigned char>(70, 2000, 300) ));
+}
@@ -137,6 +137,36 @@ template<typename VectorType> void vectorRedux(const VectorType& w)
   VERIFY_RAISES_ASSERT(v.head(0).maxCoeff());
 }
 
+template<typename VectorType> void largeVectorRedux(const VectorType& w)
+{
+  using std::abs;
+  typedef typename VectorType::Index Index;
+  typedef typename VectorType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  Index size = w.size();
+
+  // long enough to use all the accumulators, and to be split between threads when OpenMP is enabled
+  VectorType v = VectorType::Random(size), v2 = VectorType::Random(size);
+  Index start = internal::random<Index>(0,3);
+  Index n = size - start - internal::random<Index>(0,3);
+  double s = 0, sabs = 0, dot = 0, dotabs = 0;
+  RealScalar minc = v(start), maxc = v(start);
+  for(Index i = start; i < start+n; ++i)
+  {
+    s += double(v(i));
+    sabs += abs(double(v(i)));
+    dot += double(v(i)) * double(v2(i));
+    dotabs += abs(double(v(i)) * double(v2(i)));
+    minc = (std::min)(minc, v(i));
+    maxc = (std::max)(maxc, v(i));
+  }
+  VERIFY(abs(double(v.segment(start,n).sum()) - s) <= double(test_precision<Scalar>()) * sabs);
+  VERIFY(abs(double(v.segment(start,n).dot(v2.segment(start,n))) - dot) <= double(test_precision<Scalar>()) * dotabs);
+  VERIFY_IS_APPROX(v.segment(start,n).squaredNorm(), v.segment(start,n).cwiseAbs2().sum());
+  VERIFY_IS_EQUAL(v.segment(start,n).minCoeff(), minc);
+  VERIFY_IS_EQUAL(v.segment(start,n).maxCoeff(), maxc);
+}
+
 void test_redux()
 {
   // the max size cannot be too large, otherwise reduxion operations obviously generate large errors.
@@ -164,4 +194,6 @@ void test_redux()
     CALL_SUBTEST_8( vectorRedux(VectorXf(internal::random<int>(1,maxsize))) );
     CALL_SUBTEST_8( vectorRedux(ArrayXf(internal::random<int>(1,maxsize))) );
   }
+  CALL_SUBTEST_9( largeVectorRedux(VectorXd(internal::random<int>(2,4) * EIGEN_PARALLEL_REDUX_THRESHOLD)) );
+  CALL_SUBTEST_9( largeVectorRedux(VectorXf(internal::random<int>(2,4) * EIGEN_PARALLEL_REDUX_THRESHOLD)) );
 }
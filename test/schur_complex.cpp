@@ -79,6 +79,35 @@ template<typename MatrixType> void schur(int size = MatrixType::ColsAtCompileTim
   }
 }
 
+template<typename MatrixType> void schur_large(int size)
+{
+  // Large matrices are reduced by multishift QR sweeps with aggressive early deflation
+  typedef typename ComplexSchur<MatrixType>::ComplexScalar ComplexScalar;
+  typedef typename ComplexSchur<MatrixType>::ComplexMatrixType ComplexMatrixType;
+  typedef typename MatrixType::Scalar Scalar;
+  MatrixType A = MatrixType::Random(size, size);
+  MatrixType selfadjoint = A + A.adjoint();
+  MatrixType clustered = MatrixType::Identity(size, size) + Scalar(1e-3) * A;
+  MatrixType cyclic = MatrixType::Zero(size, size);
+  cyclic.topRightCorner(size-1, size-1).setIdentity();
+  cyclic(size-1, 0) = Scalar(1);
+  MatrixType matrices[] = { A, selfadjoint, clustered, cyclic };
+  for(int k = 0; k < 4; ++k)
+  {
+    ComplexSchur<MatrixType> cs(matrices[k]);
+    VERIFY_IS_EQUAL(cs.info(), Success);
+    ComplexMatrixType U = cs.matrixU();
+    ComplexMatrixType T = cs.matrixT();
+    VERIFY(T.template triangularView<StrictlyLower>().toDenseMatrix().isZero(0));
+    VERIFY_IS_UNITARY(U);
+    VERIFY_IS_APPROX(matrices[k].template cast<ComplexScalar>(), U * T * U.adjoint());
+
+    ComplexSchur<MatrixType> csOnlyT(matrices[k], false);
+    VERIFY_IS_EQUAL(csOnlyT.info(), Success);
+    VERIFY_IS_EQUAL(csOnlyT.matrixT(), T);
+  }
+}
+
 void test_schur_complex()
 {
   CALL_SUBTEST_1(( schur<Matrix4cd>() ));
@@ -88,4 +117,7 @@ void test_schur_complex()
 
   // Test problem size constructors
   CALL_SUBTEST_5(ComplexSchur<MatrixXf>(10));
+
+  CALL_SUBTEST_6(( schur_large<MatrixXcd>(internal::random<int>(100,200)) ));
+  CALL_SUBTEST_7(( schur_large<MatrixXd>(internal::random<int>(75,150)) ));
 }
@@ -100,6 +100,35 @@ template<typename MatrixType> void schur(int size = MatrixType::ColsAtCompileTim
   }
 }
 
+template<typename MatrixType> void schur_large(int size)
+{
+  // Large matrices are reduced by multishift QR sweeps with aggressive early deflation
+  typedef typename MatrixType::Scalar Scalar;
+  MatrixType A = MatrixType::Random(size, size);
+  MatrixType symmetric = A + A.transpose();
+  MatrixType clustered = MatrixType::Identity(size, size) + Scalar(1e-3) * A; // tightly clustered eigenvalues
+  MatrixType cyclic = MatrixType::Zero(size, size);                             // eigenvalues on the unit circle
+  cyclic.topRightCorner(size-1, size-1).setIdentity();
+  cyclic(size-1, 0) = Scalar(1);
+  Matrix<Scalar,Dynamic,1> scaling = Matrix<Scalar,Dynamic,1>::LinSpaced(size, 0, 8).array().exp();
+  MatrixType graded = A * scaling.asDiagonal();                                 // graded columns
+  MatrixType matrices[] = { A, symmetric, clustered, cyclic, graded };
+  for(int k = 0; k < 5; ++k)
+  {
+    RealSchur<MatrixType> rs(matrices[k]);
+    VERIFY_IS_EQUAL(rs.info(), Success);
+    MatrixType U = rs.matrixU();
+    MatrixType T = rs.matrixT();
+    verifyIsQuasiTriangular(T);
+    VERIFY_IS_UNITARY(U);
+    VERIFY_IS_APPROX(matrices[k], U * T * U.transpose());
+
+    RealSchur<MatrixType> rsOnlyT(matrices[k], false);
+    VERIFY_IS_EQUAL(rsOnlyT.info(), Success);
+    VERIFY_IS_EQUAL(rsOnlyT.matrixT(), T);
+  }
+}
+
 void test_schur_real()
 {
   CALL_SUBTEST_1(( schur<Matrix4f>() ));
@@ -109,4 +138,7 @@ void test_schur_real()
 
   // Test problem size constructors
   CALL_SUBTEST_5(RealSchur<MatrixXf>(10));
+
+  CALL_SUBTEST_6(( schur_large<MatrixXd>(internal::random<int>(100,200)) ));
+  CALL_SUBTEST_7(( schur_large<Matrix<double,Dynamic,Dynamic,RowMajor> >(internal::random<int>(75,150)) ));
 }
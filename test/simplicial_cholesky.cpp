@@ -38,8 +38,93 @@ template<typename T> void test_simplicial_cholesky_T()
   check_sparse_spd_solving(ldlt_colmajor_upper_nat);
 }
 
+template<typename Solver> void check_simplicial_rank_update(Solver& solver, bool checkDefinite)
+{
+  typedef typename Solver::MatrixType Mat;
+  typedef typename Mat::Scalar Scalar;
+  typedef typename Mat::RealScalar RealScalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+
+  Mat A, halfA;
+  DenseMatrix dA;
+  int size = generate_sparse_spd_problem(solver, A, halfA, dA, 100);
+  DenseVector b = DenseVector::Random(size);
+
+  // a few new rows, of a couple of nonzeros each, coupling unrelated unknowns
+  int rank = internal::random<int>(1,4);
+  Mat W(size, rank);
+  for(int k = 0; k < rank; ++k)
+  {
+    W.insert(internal::random<int>(0,size-1), k) = internal::random<Scalar>();
+    int i = internal::random<int>(0,size-1);
+    if(W.coeff(i,k)==Scalar(0))
+      W.insert(i, k) = internal::random<Scalar>();
+  }
+  DenseMatrix dW = W;
+  RealScalar sigma = internal::random<RealScalar>(RealScalar(0.5), RealScalar(2));
+
+  solver.compute(halfA);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  solver.rankUpdate(W, sigma);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  DenseMatrix dA2 = dA + sigma * dW * dW.adjoint();
+  DenseVector x = solver.solve(b);
+  VERIFY(x.isApprox(dA2.llt().solve(b), test_precision<Scalar>()));
+  VERIFY_IS_APPROX(solver.determinant(), dA2.determinant());
+
+  // the downdate restores the initial matrix
+  solver.rankUpdate(W, -sigma);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  x = solver.solve(b);
+  VERIFY(x.isApprox(dA.llt().solve(b), test_precision<Scalar>()));
+
+  // the updated elimination tree and pattern remain valid for factorize()
+  Mat A2 = A + sigma * W * W.adjoint();
+  solver.rankUpdate(W, sigma);
+  solver.factorize(A2);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  x = solver.solve(b);
+  VERIFY(x.isApprox(dA2.llt().solve(b), test_precision<Scalar>()));
+
+  // a downdate to an indefinite matrix fails without square roots of negative numbers
+  if(checkDefinite)
+  {
+    solver.compute(halfA);
+    Mat E(size, 1);
+    E.insert(0, 0) = Scalar(2 * std::sqrt(numext::real(dA(0,0))));
+    solver.rankUpdate(E, -1);
+    VERIFY_IS_EQUAL(solver.info(), NumericalIssue);
+  }
+}
+
+template<typename T> void test_simplicial_rank_update_T()
+{
+  SimplicialLLT<SparseMatrix<T>, Lower> llt_colmajor_lower_amd;
+  SimplicialLLT<SparseMatrix<T>, Upper> llt_colmajor_upper_amd;
+  SimplicialLDLT<SparseMatrix<T>, Lower> ldlt_colmajor_lower_amd;
+  SimplicialLDLT<SparseMatrix<T>, Upper> ldlt_colmajor_upper_amd;
+  SimplicialLDLT<SparseMatrix<T>, Lower, NaturalOrdering<int> > ldlt_colmajor_lower_nat;
+  SimplicialLLT<SparseMatrix<T>, Upper, NaturalOrdering<int> > llt_colmajor_upper_nat;
+  SimplicialCholesky<SparseMatrix<T>, Lower> chol_colmajor_lower_amd;
+
+  CALL_SUBTEST( check_simplicial_rank_update(llt_colmajor_lower_amd, true) );
+  CALL_SUBTEST( check_simplicial_rank_update(llt_colmajor_upper_amd, true) );
+  CALL_SUBTEST( check_simplicial_rank_update(ldlt_colmajor_lower_amd, false) );
+  CALL_SUBTEST( check_simplicial_rank_update(ldlt_colmajor_upper_amd, false) );
+  CALL_SUBTEST( check_simplicial_rank_update(ldlt_colmajor_lower_nat, false) );
+  CALL_SUBTEST( check_simplicial_rank_update(llt_colmajor_upper_nat, true) );
+  CALL_SUBTEST( check_simplicial_rank_update(chol_colmajor_lower_amd, false) );
+  chol_colmajor_lower_amd.setMode(SimplicialCholeskyLLT);
+  CALL_SUBTEST( check_simplicial_rank_update(chol_colmajor_lower_amd, true) );
+}
+
 void test_simplicial_cholesky()
 {
   CALL_SUBTEST_1(test_simplicial_cholesky_T<double>());
   CALL_SUBTEST_2(test_simplicial_cholesky_T<std::complex<double> >());
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_3(test_simplicial_rank_update_T<double>());
+    CALL_SUBTEST_4(test_simplicial_rank_update_T<std::complex<double> >());
+  }
 }
@@ -89,12 +89,87 @@ template<typename Scalar> void test_sparseqr_scalar()
   idM.resize(Q.rows(), Q.rows()); idM.setIdentity();
   VERIFY(idM.isApprox(QtQ));
 }
+template<typename Scalar> void test_multifrontal_sparseqr_scalar()
+{
+  typedef SparseMatrix<Scalar,ColMajor> MatrixType; 
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMat;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+  MatrixType A;
+  DenseMat dA;
+  DenseVector refX,x,b; 
+  MultifrontalSparseQR<MatrixType, COLAMDOrdering<int> > solver; 
+
+  // full column rank problem
+  int rows = internal::random<int>(1,300);
+  int cols = internal::random<int>(1,rows);
+  double density = (std::max)(8./(rows*cols), 0.01);
+  A.resize(rows,cols);
+  dA.resize(rows,cols);
+  initSparse<Scalar>(density, dA, A, ForceNonZeroDiag);
+  A.makeCompressed();
+
+  b = DenseVector::Random(A.rows());
+  solver.compute(A);
+  if(internal::random<float>(0,1)>0.5)
+    solver.factorize(A);  // this checks that calling analyzePattern is not needed if the pattern do not change.
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  VERIFY_IS_EQUAL(solver.rank(), A.cols());
+  VERIFY(solver.nbFronts() <= A.cols());
+  x = solver.solve(b);
+
+  // compare with the least squares solution of a dense QR solver
+  refX = dA.householderQr().solve(b);
+  VERIFY_IS_APPROX(x, refX);
+
+  // A P = Q R, with Q unitary
+  DenseMat Q = solver.matrixQ();
+  VERIFY_IS_APPROX(Q.adjoint() * Q, DenseMat::Identity(A.rows(), A.rows()));
+  DenseMat R = solver.matrixR();
+  VERIFY_IS_APPROX(DenseMat(dA * solver.colsPermutation()), Q * R);
+  DenseVector Qtb = solver.matrixQ().transpose() * b;
+  VERIFY_IS_APPROX(Qtb, Q.adjoint() * b);
+
+  // a 2D grid Laplacian, with fronts of several columns on several levels
+  int n = internal::random<int>(5,20);
+  std::vector<Triplet<Scalar> > triplets;
+  for(int i=0; i<n; ++i)
+    for(int j=0; j<n; ++j)
+    {
+      int k = i*n+j;
+      triplets.push_back(Triplet<Scalar>(k, k, Scalar(4)));
+      if(i>0) triplets.push_back(Triplet<Scalar>(k, k-n, Scalar(-1)));
+      if(i<n-1) triplets.push_back(Triplet<Scalar>(k, k+n, Scalar(-1)));
+      if(j>0) triplets.push_back(Triplet<Scalar>(k, k-1, Scalar(-1)));
+      if(j<n-1) triplets.push_back(Triplet<Scalar>(k, k+1, Scalar(-1)));
+    }
+  A.resize(n*n, n*n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  A.makeCompressed();
+  b = DenseVector::Random(n*n);
+  solver.compute(A);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  VERIFY(solver.nbFronts() < A.cols());
+  x = solver.solve(b);
+  VERIFY_IS_APPROX(A * x, b);
+
+  // rank deficiency is reported
+  if(n > 1)
+  {
+    A.col(0) = A.col(1);
+    solver.compute(A);
+    VERIFY_IS_EQUAL(solver.info(), NumericalIssue);
+    VERIFY(solver.rank() < A.cols());
+  }
+}
+
 void test_sparseqr()
 {
   for(int i=0; i<g_repeat; ++i)
   {
     CALL_SUBTEST_1(test_sparseqr_scalar<double>());
     CALL_SUBTEST_2(test_sparseqr_scalar<std::complex<double> >());
+    CALL_SUBTEST_3(test_multifrontal_sparseqr_scalar<double>());
+    CALL_SUBTEST_4(test_multifrontal_sparseqr_scalar<std::complex<double> >());
   }
 }
 
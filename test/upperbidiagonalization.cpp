@@ -27,6 +27,15 @@ template<typename MatrixType> void upperbidiag(const MatrixType& m)
   VERIFY_IS_APPROX(a,c);
   TransposeMatrixType d = ubd.householderV() * b.adjoint() * ubd.householderU().adjoint();
   VERIFY_IS_APPROX(a.adjoint(),d);
+
+  // the blocked and unblocked reductions must agree
+  internal::UpperBidiagonalization<MatrixType> ubd_unblocked(rows, cols);
+  ubd_unblocked.computeUnblocked(a);
+  RealMatrixType b_unblocked(rows, cols);
+  b_unblocked.setZero();
+  b_unblocked.block(0,0,cols,cols) = ubd_unblocked.bidiagonal();
+  VERIFY_IS_APPROX(b, b_unblocked);
+  VERIFY_IS_APPROX(ubd.householder(), ubd_unblocked.householder());
 }
 
 void test_upperbidiagonalization()
@@ -40,4 +49,8 @@ void test_upperbidiagonalization()
    CALL_SUBTEST_6( upperbidiag(Matrix<float,5,5>()) );
    CALL_SUBTEST_7( upperbidiag(Matrix<double,4,3>()) );
   }
+
+  // large enough to exercise the blocked reduction
+  CALL_SUBTEST_8( upperbidiag(MatrixXd(internal::random<int>(100,140),internal::random<int>(60,100))) );
+  CALL_SUBTEST_9( upperbidiag(MatrixXcf(internal::random<int>(90,110),internal::random<int>(50,90))) );
 }
@@ -110,6 +110,82 @@ template<typename VectorType> void vectorVisitor(const VectorType& w)
   VERIFY(eigen_maxidx == (std::min)(idx0,idx2));
 }
 
+template<typename MatrixType> void checkCoeffVisitors(const MatrixType& m)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+
+  Scalar minc = m(0,0), maxc = m(0,0);
+  Index minrow = 0, mincol = 0, maxrow = 0, maxcol = 0;
+  for(Index j = 0; j < m.cols(); j++)
+  for(Index i = 0; i < m.rows(); i++)
+  {
+    if(m(i,j) < minc) { minc = m(i,j); minrow = i; mincol = j; }
+    if(m(i,j) > maxc) { maxc = m(i,j); maxrow = i; maxcol = j; }
+  }
+  Index row, col;
+  VERIFY_IS_EQUAL(m.minCoeff(&row,&col), minc);
+  VERIFY_IS_EQUAL(row, minrow);
+  VERIFY_IS_EQUAL(col, mincol);
+  VERIFY_IS_EQUAL(m.maxCoeff(&row,&col), maxc);
+  VERIFY_IS_EQUAL(row, maxrow);
+  VERIFY_IS_EQUAL(col, maxcol);
+}
+
+template<typename MatrixType> void largeVisitor(const MatrixType& p)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+
+  Index rows = p.rows();
+  Index cols = p.cols();
+
+  // many ties, so that the first occurrence has to be found
+  MatrixType m(rows, cols), m2(rows, cols);
+  for(Index i = 0; i < m.size(); i++)
+  {
+    m(i) = Scalar(internal::random<int>(-20,20));
+    m2(i) = Scalar(internal::random<int>(-20,20));
+  }
+  checkCoeffVisitors(m);
+  checkCoeffVisitors(m + m2);
+  checkCoeffVisitors(m.block(internal::random<Index>(0,rows-1), internal::random<Index>(0,cols-1), 1, 1));
+  Index r0 = internal::random<Index>(0,rows-1), c0 = internal::random<Index>(0,cols-1);
+  checkCoeffVisitors(m.block(r0, c0, internal::random<Index>(1,rows-r0), internal::random<Index>(1,cols-c0)));
+  checkCoeffVisitors(m.col(c0).segment(r0, internal::random<Index>(1,rows-r0)));
+  checkCoeffVisitors(m.row(r0));
+
+  // the extremum in the last coefficients
+  m(rows-1, cols-1) = Scalar(-21);
+  m2(rows-1, cols-1) = Scalar(21);
+  checkCoeffVisitors(m);
+  checkCoeffVisitors(m2);
+
+  Index index;
+  m.col(c0).minCoeff(&index);
+  VERIFY_IS_EQUAL(m.col(c0)(index), m.col(c0).minCoeff());
+}
+
+// NaN coefficients are skipped, unless the first one is NaN
+template<typename MatrixType> void nanVisitor(const MatrixType& p)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+
+  MatrixType m = MatrixType::Random(p.rows(), p.cols());
+  for(Index i = 1; i < m.size(); i++)
+    if(internal::random<int>(0,9)==0)
+      m(i) = std::numeric_limits<Scalar>::quiet_NaN();
+  checkCoeffVisitors(m);
+
+  m(0) = std::numeric_limits<Scalar>::quiet_NaN();
+  Index row, col;
+  VERIFY(isNaN(m.minCoeff(&row,&col)));
+  VERIFY(row == 0 && col == 0);
+  VERIFY(isNaN(m.maxCoeff(&row,&col)));
+  VERIFY(row == 0 && col == 0);
+}
+
 void test_visitor()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -127,4 +203,15 @@ void test_visitor()
     CALL_SUBTEST_9( vectorVisitor(RowVectorXd(10)) );
     CALL_SUBTEST_10( vectorVisitor(VectorXf(33)) );
   }
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_11( largeVisitor(MatrixXf(internal::random<int>(1,300), internal::random<int>(1,300))) );
+    CALL_SUBTEST_11( largeVisitor(VectorXf(internal::random<int>(1,5000))) );
+    CALL_SUBTEST_12( largeVisitor(MatrixXd(internal::random<int>(1,300), internal::random<int>(1,300))) );
+    CALL_SUBTEST_12( largeVisitor(Matrix<double,Dynamic,Dynamic,RowMajor>(internal::random<int>(1,300), internal::random<int>(1,300))) );
+    CALL_SUBTEST_13( largeVisitor(MatrixXi(internal::random<int>(1,300), internal::random<int>(1,300))) );
+    CALL_SUBTEST_13( largeVisitor(RowVectorXi(internal::random<int>(1,5000))) );
+    CALL_SUBTEST_11( nanVisitor(VectorXf(internal::random<int>(1,5000))) );
+    CALL_SUBTEST_12( nanVisitor(VectorXd(internal::random<int>(1,5000))) );
+    CALL_SUBTEST_12( nanVisitor(MatrixXd(internal::random<int>(1,300), internal::random<int>(1,300))) );
+  }
 }
@@ -0,0 +1,390 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// We used the "A Krylov-Schur algorithm for large eigenproblems" paper written
+// by G. W. Stewart, and the "On swapping diagonal blocks in real Schur form"
+// paper written by Z. Bai and J. W. Demmel.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_KRYLOVSCHUREIGENSOLVER_H
+#define EIGEN_KRYLOVSCHUREIGENSOLVER_H
+
+namespace Eigen {
+
+namespace internal {
+
+template<typename Scalar, bool IsComplex = NumTraits<Scalar>::IsComplex> struct krylov_schur_impl;
+
+// real operators: the projected matrix is reduced to the real Schur form, with 2x2 blocks for the complex conjugate pairs
+template<typename Scalar> struct krylov_schur_impl<Scalar,false>
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef EigenSolver<MatrixType> EigenSolverType;
+
+  static void schur(const MatrixType& H, MatrixType& T, MatrixType& Q)
+  {
+    RealSchur<MatrixType> schur(H);
+    T = schur.matrixT();
+    Q = schur.matrixU();
+  }
+
+  template<typename BasisType, typename CoeffsType, typename ResultType>
+  static void ritzVectors(const BasisType& V, const CoeffsType& Y, ResultType& X)
+  {
+    X.resize(V.rows(), Y.cols());
+    X.real() = V * Y.real();
+    X.imag() = V * Y.imag();
+  }
+};
+
+// complex operators: the projected matrix is reduced to the triangular Schur form
+template<typename Scalar> struct krylov_schur_impl<Scalar,true>
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef ComplexEigenSolver<MatrixType> EigenSolverType;
+
+  static void schur(const MatrixType& H, MatrixType& T, MatrixType& Q)
+  {
+    ComplexSchur<MatrixType> schur(H);
+    T = schur.matrixT();
+    Q = schur.matrixU();
+  }
+
+  template<typename BasisType, typename CoeffsType, typename ResultType>
+  static void ritzVectors(const BasisType& V, const CoeffsType& Y, ResultType& X)
+  {
+    X.noalias() = V * Y;
+  }
+};
+
+/** \internal
+  * Reorders the Schur decomposition T, Q such that the diagonal blocks for which \a select is true come first,
+  * and returns their total size. \a select is indexed by the initial position of the blocks.
+  */
+template<typename MatrixType, typename SelectType>
+typename MatrixType::Index krylov_schur_reorder(MatrixType& T, MatrixType& Q, const SelectType& select)
+{
+  typedef typename MatrixType::Index Index;
+  const Index size = T.rows();
+  Index ks = 0;
+  for(Index i=0; i<size;)
+  {
+    Index bs = schur_block_size(T, i);
+    if(select(i))
+    {
+      // all the blocks in [ks,i) are unselected: move the current block in front of them
+      for(Index pos=i; pos>ks;)
+      {
+        Index prev = (pos-2>=ks && schur_block_size(T, pos-2)==2) ? 2 : 1;
+        // a rejected swap leaves blocks with a common eigenvalue in place, their order being irrelevant
+        schur_swap_blocks(T, Q, pos-prev, prev, bs);
+        pos -= prev;
+      }
+      ks += bs;
+    }
+    i += bs;
+  }
+  return ks;
+}
+
+} // end namespace internal
+
+/** \ingroup KrylovEigenSolvers_Module
+  *
+  *
+  * \class KrylovSchurEigenSolver
+  *
+  * \brief Computes a few eigenvalues and eigenvectors of a large general operator
+  *
+  * \tparam _MatrixType the type of the operator, e.g., a SparseMatrix, a dense matrix, a ShiftInvertOperator
+  *                     or a user defined matrix-free operator
+  *
+  * This class computes the \a nev wanted eigenpairs \f$ A v = \lambda v \f$ of a square operator \a A using the
+  * Krylov-Schur method of Stewart. An Arnoldi basis of dimension \a ncv is built and the projected matrix is reduced to
+  * its Schur form. The Schur form is reordered such that the wanted Ritz values come first, and the basis is truncated
+  * to the corresponding invariant subspace before being extended again. This is mathematically equivalent to the
+  * implicitly restarted Arnoldi method of ARPACK, but the restart does not rely on the numerically delicate implicit
+  * shifts and allows to lock the converged Ritz vectors. The basis is fully reorthogonalized.
+  *
+  * For real operators the computations are performed in real arithmetic using the real Schur form, and the complex
+  * eigenvalues appear in conjugate pairs. The eigenvalues and eigenvectors are always returned as complex values.
+  * For selfadjoint operators, LanczosSelfAdjointEigenSolver is faster.
+  *
+  * The operator type has the same requirements as for LanczosSelfAdjointEigenSolver, and the eigenvalues
+  * closest to a shift \f$ \sigma \f$ are efficiently computed by passing a ShiftInvertOperator based on SparseLU with
+  * the #LargestMagnitude selection.
+  *
+  * Example:
+  * \code
+  * SparseMatrix<double> A = ...;
+  * KrylovSchurEigenSolver<SparseMatrix<double> > es(A, 6, LargestMagnitude);
+  * if(es.info()==Success)
+  *   std::cout << es.eigenvalues() << std::endl;
+  * \endcode
+  *
+  * \sa class LanczosSelfAdjointEigenSolver, class ShiftInvertOperator, class EigenSolver
+  */
+template<typename _MatrixType>
+class KrylovSchurEigenSolver
+{
+  public:
+
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef std::complex<RealScalar> ComplexScalar;
+    typedef typename MatrixType::Index Index;
+    typedef Matrix<ComplexScalar, Dynamic, Dynamic> EigenvectorsType;
+    typedef Matrix<ComplexScalar, Dynamic, 1> EigenvalueType;
+
+    /** \brief Default constructor.
+      *
+      * The default constructor is useful in cases in which the user intends to
+      * perform decompositions via compute().
+      */
+    KrylovSchurEigenSolver()
+      : m_subspaceSize(0), m_maxIterations(1000), m_tolerance(NumTraits<RealScalar>::epsilon()),
+        m_info(Success), m_isInitialized(false), m_eigenvectorsOk(false), m_nbrConverged(0), m_nbrIterations(0)
+    {}
+
+    /** \brief Constructor; computes a few eigenpairs of the given operator.
+      *
+      * \sa compute()
+      */
+    KrylovSchurEigenSolver(const MatrixType& op, Index nev, int selection = LargestMagnitude,
+                           int options = ComputeEigenvectors)
+      : m_subspaceSize(0), m_maxIterations(1000), m_tolerance(NumTraits<RealScalar>::epsilon()),
+        m_info(Success), m_isInitialized(false), m_eigenvectorsOk(false), m_nbrConverged(0), m_nbrIterations(0)
+    {
+      compute(op, nev, selection, options);
+    }
+
+    /** \brief Computes \a nev eigenvalues, and optionally the eigenvectors, of the operator \a op.
+      *
+      * \param[in] op the square operator
+      * \param[in] nev the number of wanted eigenpairs, which must be smaller than the size of \a op minus one
+      * \param[in] selection the part of the spectrum to compute, see #EigenvalueSelection
+      * \param[in] options can be #ComputeEigenvectors (default) or #EigenvaluesOnly
+      *
+      * The eigenvalues are sorted in the order of the selection, e.g., decreasing magnitudes for #LargestMagnitude.
+      * Check info() for the convergence of all the wanted eigenpairs within the maximal number of restarts.
+      */
+    KrylovSchurEigenSolver& compute(const MatrixType& op, Index nev, int selection = LargestMagnitude,
+                                    int options = ComputeEigenvectors);
+
+    /** Sets the dimension \a ncv of the Krylov subspace. The default is max(2*nev+1, 20), bounded by the size of the operator.
+      * Larger values reduce the number of restarts at the price of more memory and orthogonalization work.
+      */
+    KrylovSchurEigenSolver& setSubspaceSize(Index ncv)
+    {
+      m_subspaceSize = ncv;
+      return *this;
+    }
+
+    /** Sets the maximal number of restarts (default is 1000). */
+    KrylovSchurEigenSolver& setMaxIterations(Index maxIters)
+    {
+      m_maxIterations = maxIters;
+      return *this;
+    }
+
+    /** Sets the relative tolerance on the residual norms of the Ritz pairs. The default is the machine precision. */
+    KrylovSchurEigenSolver& setTolerance(const RealScalar& tolerance)
+    {
+      m_tolerance = tolerance;
+      return *this;
+    }
+
+    /** \returns the dimension of the Krylov subspace, 0 meaning the default */
+    Index subspaceSize() const { return m_subspaceSize; }
+
+    /** \returns the maximal number of restarts */
+    Index maxIterations() const { return m_maxIterations; }
+
+    /** \returns the relative tolerance */
+    RealScalar tolerance() const { return m_tolerance; }
+
+    /** \returns the \a nev computed eigenvalues */
+    const EigenvalueType& eigenvalues() const
+    {
+      eigen_assert(m_isInitialized && "KrylovSchurEigenSolver is not initialized.");
+      return m_eivalues;
+    }
+
+    /** \returns the n-by-nev matrix whose columns are the normalized eigenvectors, in the order of eigenvalues() */
+    const EigenvectorsType& eigenvectors() const
+    {
+      eigen_assert(m_isInitialized && "KrylovSchurEigenSolver is not initialized.");
+      eigen_assert(m_eigenvectorsOk && "The eigenvectors have not been computed together with the eigenvalues.");
+      return m_eivec;
+    }
+
+    /** \returns \c Success if all the wanted eigenpairs converged, \c NoConvergence otherwise */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "KrylovSchurEigenSolver is not initialized.");
+      return m_info;
+    }
+
+    /** \returns the number of converged eigenpairs */
+    Index getNbrConvergedEigenValues() const { return m_nbrConverged; }
+
+    /** \returns the number of restarts performed by the last call to compute() */
+    Index getNbrIterations() const { return m_nbrIterations; }
+
+  protected:
+    EigenvectorsType m_eivec;
+    EigenvalueType m_eivalues;
+    Index m_subspaceSize, m_maxIterations;
+    RealScalar m_tolerance;
+    ComputationInfo m_info;
+    bool m_isInitialized, m_eigenvectorsOk;
+    Index m_nbrConverged, m_nbrIterations;
+};
+
+template<typename MatrixType>
+KrylovSchurEigenSolver<MatrixType>&
+KrylovSchurEigenSolver<MatrixType>::compute(const MatrixType& op, Index nev, int selection, int options)
+{
+  using std::abs;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+  typedef internal::krylov_schur_impl<Scalar> Impl;
+
+  const Index n = op.rows();
+  eigen_assert(op.cols()==n && "KrylovSchurEigenSolver: the operator must be square");
+  eigen_assert(nev>0 && nev<n-1 && "KrylovSchurEigenSolver: the number of eigenvalues must be in [1,n-2]");
+  eigen_assert((options &~ EigVecMask)==0 && (options & EigVecMask)!=EigVecMask && "invalid option parameter");
+
+  const Index ncv = (std::min)(n, m_subspaceSize>0 ? m_subspaceSize : (std::max)(2*nev+1, Index(20)));
+  eigen_assert(ncv>nev+1 && "KrylovSchurEigenSolver: the subspace size must be larger than the number of eigenvalues plus one");
+  const RealScalar eps23 = std::pow(NumTraits<RealScalar>::epsilon(), RealScalar(2)/RealScalar(3));
+
+  // Krylov basis, the last column being the next direction, and projected matrix H = V^* op V
+  DenseType V(n, ncv+1);
+  DenseType H = DenseType::Zero(ncv, ncv);
+  DenseType T, Q;
+  VectorType w(n), h;
+  RealScalar beta = 0;
+
+  typename Impl::EigenSolverType eig;
+  Matrix<Index,Dynamic,1> perm, schurPerm;
+  EigenvalueType schurValues(ncv);
+  Matrix<bool,Dynamic,1> select(ncv);
+
+  V.col(0).setRandom();
+  V.col(0).normalize();
+  Index k = 0;   // size of the kept Krylov-Schur decomposition
+  m_nbrConverged = 0;
+  m_info = NoConvergence;
+
+  for(m_nbrIterations=0; m_nbrIterations<m_maxIterations; ++m_nbrIterations)
+  {
+    // extend the Krylov decomposition op V_ncv = V_ncv H + beta v_ncv e_ncv^*
+    for(Index j=k; j<ncv; ++j)
+    {
+      w.noalias() = op * V.col(j);
+      RealScalar wnorm = w.norm();
+      beta = internal::krylov_orthogonalize(V, j+1, w, h);
+      H.col(j).head(j+1) = h;
+      if(beta <= NumTraits<RealScalar>::epsilon() * wnorm)
+      {
+        // invariant subspace: continue with a new random direction decoupled from the previous ones
+        beta = 0;
+        internal::krylov_random_direction(V, j+1);
+      }
+      else
+        V.col(j+1) = w / beta;
+      if(j+1<ncv)
+        H(j+1,j) = beta;
+    }
+
+    // Ritz pairs sorted such that the wanted ones come first
+    eig.compute(H);
+    internal::krylov_sort_eigenvalues(eig.eigenvalues(), selection, perm);
+    m_nbrConverged = 0;
+    for(Index i=0; i<nev; ++i)
+    {
+      RealScalar residual = abs(beta * eig.eigenvectors()(ncv-1,perm(i)));
+      if(residual <= m_tolerance * (std::max)(eps23, abs(eig.eigenvalues()(perm(i)))))
+        ++m_nbrConverged;
+    }
+    if(m_nbrConverged>=nev)
+    {
+      m_info = Success;
+      break;
+    }
+    if(m_nbrIterations+1==m_maxIterations)
+      break;
+
+    // Schur form of the projected matrix and eigenvalues of its diagonal blocks
+    Impl::schur(H, T, Q);
+    for(Index i=0; i<ncv;)
+    {
+      if(internal::schur_block_size(T, i)==2)
+      {
+        ComplexScalar mean = ComplexScalar(numext::real(T(i,i)+T(i+1,i+1))) / RealScalar(2);
+        ComplexScalar delta = std::sqrt(ComplexScalar(numext::real((T(i,i)-T(i+1,i+1))*(T(i,i)-T(i+1,i+1))/Scalar(4)
+                                                                   + T(i,i+1)*T(i+1,i))));
+        schurValues(i) = mean + delta;
+        schurValues(i+1) = mean - delta;
+        i += 2;
+      }
+      else
+      {
+        schurValues(i) = ComplexScalar(T(i,i));
+        i += 1;
+      }
+    }
+
+    // select the wanted Ritz values, plus a few more to speed up the convergence, without splitting conjugate pairs
+    Index target = nev + (std::min)(m_nbrConverged, (ncv-nev)/2);
+    if(target==1 && ncv>=6)
+      target = ncv/2;
+    internal::krylov_sort_eigenvalues(schurValues, selection, schurPerm);
+    select.setConstant(false);
+    k = 0;
+    for(Index i=0; i<ncv && k<target; ++i)
+    {
+      Index pos = schurPerm(i);
+      if(select(pos))
+        continue;
+      Index start = (pos>0 && internal::schur_block_size(T, pos-1)==2) ? pos-1 : pos;
+      Index bs = internal::schur_block_size(T, start);
+      if(k+bs>ncv-1)
+        break;
+      select.segment(start, bs).setConstant(true);
+      k += bs;
+    }
+    k = internal::krylov_schur_reorder(T, Q, select);
+
+    // truncate the Krylov-Schur decomposition to the selected invariant subspace
+    DenseType Vk = V.leftCols(ncv) * Q.leftCols(k);
+    V.leftCols(k) = Vk;
+    V.col(k) = V.col(ncv);
+    H.setZero();
+    H.topLeftCorner(k,k) = T.topLeftCorner(k,k);
+    H.row(k).head(k) = beta * Q.row(ncv-1).head(k);
+  }
+
+  m_eivalues.resize(nev);
+  for(Index i=0; i<nev; ++i)
+    m_eivalues(i) = internal::krylov_spectral_transform<MatrixType>::run(op, ComplexScalar(eig.eigenvalues()(perm(i))));
+  m_eigenvectorsOk = (options & ComputeEigenvectors) == ComputeEigenvectors;
+  if(m_eigenvectorsOk)
+  {
+    EigenvectorsType Y(ncv, nev);
+    for(Index i=0; i<nev; ++i)
+      Y.col(i) = eig.eigenvectors().col(perm(i));
+    Impl::ritzVectors(V.leftCols(ncv), Y, m_eivec);
+  }
+  m_isInitialized = true;
+  return *this;
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_KRYLOVSCHUREIGENSOLVER_H
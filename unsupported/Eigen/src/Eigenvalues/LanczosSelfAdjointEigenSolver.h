@@ -0,0 +1,326 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// We used the "Thick-restart Lanczos method for large symmetric eigenvalue
+// problems" paper written by K. Wu and H. Simon.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_LANCZOSSELFADJOINTEIGENSOLVER_H
+#define EIGEN_LANCZOSSELFADJOINTEIGENSOLVER_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal
+  * Orthogonalizes \a w against the \a j first columns of \a V using classical Gram-Schmidt with one step of
+  * reorthogonalization, accumulates the projection coefficients into \a h, and returns the norm of the result.
+  */
+template<typename BasisType, typename VectorType, typename CoeffsType>
+typename NumTraits<typename BasisType::Scalar>::Real
+krylov_orthogonalize(const BasisType& V, typename BasisType::Index j, VectorType& w, CoeffsType& h)
+{
+  typedef typename BasisType::Scalar Scalar;
+  h.setZero(j);
+  Matrix<Scalar,Dynamic,1> c(j);
+  for(int pass=0; pass<2; ++pass)
+  {
+    c.noalias() = V.leftCols(j).adjoint() * w;
+    w.noalias() -= V.leftCols(j) * c;
+    h += c;
+  }
+  return w.norm();
+}
+
+/** \internal
+  * Sets column \a j of \a V to a random unit vector orthogonal to the \a j first columns.
+  * This is used after a breakdown of the Krylov recurrence, i.e., when an invariant subspace has been found.
+  */
+template<typename BasisType>
+void krylov_random_direction(BasisType& V, typename BasisType::Index j)
+{
+  typedef typename BasisType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  Matrix<Scalar,Dynamic,1> w(V.rows()), h;
+  for(int attempt=0; attempt<5; ++attempt)
+  {
+    w.setRandom();
+    RealScalar nrm = krylov_orthogonalize(V, j, w, h);
+    if(nrm > RealScalar(0.5))
+      break;
+  }
+  V.col(j) = w.normalized();
+}
+
+} // end namespace internal
+
+/** \ingroup KrylovEigenSolvers_Module
+  *
+  *
+  * \class LanczosSelfAdjointEigenSolver
+  *
+  * \brief Computes a few eigenvalues and eigenvectors of a large selfadjoint operator
+  *
+  * \tparam _MatrixType the type of the selfadjoint operator, e.g., a SparseMatrix, a dense matrix,
+  *                     a ShiftInvertOperator or a user defined matrix-free operator
+  *
+  * This class computes the \a nev wanted eigenpairs \f$ A v = \lambda v \f$ of a selfadjoint operator \a A using the
+  * thick-restart Lanczos method of Wu and Simon. A Lanczos basis of dimension \a ncv is built, the Ritz pairs of the
+  * projected matrix are computed by SelfAdjointEigenSolver, and the basis is restarted from the wanted Ritz vectors,
+  * which are kept explicitly instead of being implicitly filtered. The basis is fully reorthogonalized, such that
+  * the method is robust against the loss of orthogonality of the plain Lanczos recurrence.
+  *
+  * The operator type only needs to provide:
+  *  - the typedefs \c Scalar and \c Index,
+  *  - the \c rows() and \c cols() methods,
+  *  - the product with a dense vector via \c operator*.
+  *
+  * The eigenvalues closest to a shift \f$ \sigma \f$ are efficiently computed by passing a ShiftInvertOperator with
+  * the #LargestMagnitude selection. In this case the returned eigenvalues are the ones of the original matrix.
+  *
+  * Example:
+  * \code
+  * SparseMatrix<double> A = ...;
+  * LanczosSelfAdjointEigenSolver<SparseMatrix<double> > es;
+  * es.setSubspaceSize(40);
+  * es.compute(A, 10, LargestAlgebraic);
+  * if(es.info()==Success)
+  *   std::cout << es.eigenvalues() << std::endl;
+  * \endcode
+  *
+  * \sa class KrylovSchurEigenSolver, class ShiftInvertOperator, class SelfAdjointEigenSolver
+  */
+template<typename _MatrixType>
+class LanczosSelfAdjointEigenSolver
+{
+  public:
+
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef Matrix<Scalar, Dynamic, Dynamic> EigenvectorsType;
+    typedef Matrix<RealScalar, Dynamic, 1> RealVectorType;
+
+    /** \brief Default constructor.
+      *
+      * The default constructor is useful in cases in which the user intends to
+      * perform decompositions via compute().
+      */
+    LanczosSelfAdjointEigenSolver()
+      : m_subspaceSize(0), m_maxIterations(1000), m_tolerance(NumTraits<RealScalar>::epsilon()),
+        m_info(Success), m_isInitialized(false), m_eigenvectorsOk(false), m_nbrConverged(0), m_nbrIterations(0)
+    {}
+
+    /** \brief Constructor; computes a few eigenpairs of the given operator.
+      *
+      * \sa compute()
+      */
+    LanczosSelfAdjointEigenSolver(const MatrixType& op, Index nev, int selection = LargestMagnitude,
+                                  int options = ComputeEigenvectors)
+      : m_subspaceSize(0), m_maxIterations(1000), m_tolerance(NumTraits<RealScalar>::epsilon()),
+        m_info(Success), m_isInitialized(false), m_eigenvectorsOk(false), m_nbrConverged(0), m_nbrIterations(0)
+    {
+      compute(op, nev, selection, options);
+    }
+
+    /** \brief Computes \a nev eigenvalues, and optionally the eigenvectors, of the selfadjoint operator \a op.
+      *
+      * \param[in] op the selfadjoint operator
+      * \param[in] nev the number of wanted eigenpairs, which must be smaller than the size of \a op
+      * \param[in] selection the part of the spectrum to compute, see #EigenvalueSelection
+      * \param[in] options can be #ComputeEigenvectors (default) or #EigenvaluesOnly
+      *
+      * The eigenvalues are sorted in the order of the selection, e.g., decreasing magnitudes for #LargestMagnitude.
+      * Check info() for the convergence of all the wanted eigenpairs within the maximal number of restarts.
+      */
+    LanczosSelfAdjointEigenSolver& compute(const MatrixType& op, Index nev, int selection = LargestMagnitude,
+                                           int options = ComputeEigenvectors);
+
+    /** Sets the dimension \a ncv of the Krylov subspace. The default is max(2*nev+1, 20), bounded by the size of the operator.
+      * Larger values reduce the number of restarts at the price of more memory and orthogonalization work.
+      */
+    LanczosSelfAdjointEigenSolver& setSubspaceSize(Index ncv)
+    {
+      m_subspaceSize = ncv;
+      return *this;
+    }
+
+    /** Sets the maximal number of restarts (default is 1000). */
+    LanczosSelfAdjointEigenSolver& setMaxIterations(Index maxIters)
+    {
+      m_maxIterations = maxIters;
+      return *this;
+    }
+
+    /** Sets the relative tolerance on the residual norms of the Ritz pairs. The default is the machine precision. */
+    LanczosSelfAdjointEigenSolver& setTolerance(const RealScalar& tolerance)
+    {
+      m_tolerance = tolerance;
+      return *this;
+    }
+
+    /** \returns the dimension of the Krylov subspace, 0 meaning the default */
+    Index subspaceSize() const { return m_subspaceSize; }
+
+    /** \returns the maximal number of restarts */
+    Index maxIterations() const { return m_maxIterations; }
+
+    /** \returns the relative tolerance */
+    RealScalar tolerance() const { return m_tolerance; }
+
+    /** \returns the \a nev computed eigenvalues */
+    const RealVectorType& eigenvalues() const
+    {
+      eigen_assert(m_isInitialized && "LanczosSelfAdjointEigenSolver is not initialized.");
+      return m_eivalues;
+    }
+
+    /** \returns the n-by-nev matrix whose columns are the normalized eigenvectors, in the order of eigenvalues() */
+    const EigenvectorsType& eigenvectors() const
+    {
+      eigen_assert(m_isInitialized && "LanczosSelfAdjointEigenSolver is not initialized.");
+      eigen_assert(m_eigenvectorsOk && "The eigenvectors have not been computed together with the eigenvalues.");
+      return m_eivec;
+    }
+
+    /** \returns \c Success if all the wanted eigenpairs converged, \c NoConvergence otherwise */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "LanczosSelfAdjointEigenSolver is not initialized.");
+      return m_info;
+    }
+
+    /** \returns the number of converged eigenpairs */
+    Index getNbrConvergedEigenValues() const { return m_nbrConverged; }
+
+    /** \returns the number of restarts performed by the last call to compute() */
+    Index getNbrIterations() const { return m_nbrIterations; }
+
+  protected:
+    EigenvectorsType m_eivec;
+    RealVectorType m_eivalues;
+    Index m_subspaceSize, m_maxIterations;
+    RealScalar m_tolerance;
+    ComputationInfo m_info;
+    bool m_isInitialized, m_eigenvectorsOk;
+    Index m_nbrConverged, m_nbrIterations;
+};
+
+template<typename MatrixType>
+LanczosSelfAdjointEigenSolver<MatrixType>&
+LanczosSelfAdjointEigenSolver<MatrixType>::compute(const MatrixType& op, Index nev, int selection, int options)
+{
+  using std::abs;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<RealScalar,Dynamic,Dynamic> RealMatrixType;
+
+  const Index n = op.rows();
+  eigen_assert(op.cols()==n && "LanczosSelfAdjointEigenSolver: the operator must be square");
+  eigen_assert(nev>0 && nev<n && "LanczosSelfAdjointEigenSolver: the number of eigenvalues must be in [1,n-1]");
+  eigen_assert((options &~ EigVecMask)==0 && (options & EigVecMask)!=EigVecMask && "invalid option parameter");
+
+  const Index ncv = (std::min)(n, m_subspaceSize>0 ? m_subspaceSize : (std::max)(2*nev+1, Index(20)));
+  eigen_assert(ncv>nev && "LanczosSelfAdjointEigenSolver: the subspace size must be larger than the number of eigenvalues");
+  const RealScalar eps23 = std::pow(NumTraits<RealScalar>::epsilon(), RealScalar(2)/RealScalar(3));
+
+  // Lanczos basis, the last column being the next direction, and projected matrix H = V^* op V
+  EigenvectorsType V(n, ncv+1);
+  RealMatrixType H = RealMatrixType::Zero(ncv, ncv);
+  VectorType w(n), h;
+  RealScalar beta = 0;
+
+  SelfAdjointEigenSolver<RealMatrixType> eig;
+  Matrix<Index,Dynamic,1> perm;
+  RealVectorType residuals(ncv);
+
+  V.col(0).setRandom();
+  V.col(0).normalize();
+  Index k = 0;   // number of kept Ritz vectors
+  m_nbrConverged = 0;
+  m_info = NoConvergence;
+
+  for(m_nbrIterations=0; m_nbrIterations<m_maxIterations; ++m_nbrIterations)
+  {
+    // extend the Lanczos factorization op V_ncv = V_ncv H + beta v_ncv e_ncv^*
+    for(Index j=k; j<ncv; ++j)
+    {
+      w.noalias() = op * V.col(j);
+      RealScalar wnorm = w.norm();
+      beta = internal::krylov_orthogonalize(V, j+1, w, h);
+      H(j,j) = numext::real(h(j));
+      if(beta <= NumTraits<RealScalar>::epsilon() * wnorm)
+      {
+        // invariant subspace: continue with a new random direction decoupled from the previous ones
+        beta = 0;
+        internal::krylov_random_direction(V, j+1);
+      }
+      else
+        V.col(j+1) = w / beta;
+      if(j+1<ncv)
+        H(j,j+1) = H(j+1,j) = beta;
+    }
+
+    // Ritz pairs sorted such that the wanted ones come first
+    eig.compute(H);
+    internal::krylov_sort_eigenvalues(eig.eigenvalues(), selection, perm);
+    m_nbrConverged = 0;
+    for(Index i=0; i<ncv; ++i)
+    {
+      RealScalar theta = eig.eigenvalues()(perm(i));
+      residuals(i) = abs(beta * eig.eigenvectors()(ncv-1,perm(i)));
+      if(i<nev && residuals(i) <= m_tolerance * (std::max)(eps23, abs(theta)))
+        ++m_nbrConverged;
+    }
+    if(m_nbrConverged>=nev)
+    {
+      m_info = Success;
+      break;
+    }
+    if(m_nbrIterations+1==m_maxIterations)
+      break;
+
+    // thick restart: keep the wanted Ritz vectors, plus a few more to speed up the convergence
+    k = nev + (std::min)(m_nbrConverged, (ncv-nev)/2);
+    if(k==1 && ncv>=6)
+      k = ncv/2;
+    k = (std::min)(k, ncv-1);
+    RealMatrixType Y(ncv, k);
+    for(Index i=0; i<k; ++i)
+      Y.col(i) = eig.eigenvectors().col(perm(i));
+    EigenvectorsType Vk = V.leftCols(ncv) * Y.template cast<Scalar>();
+    V.leftCols(k) = Vk;
+    V.col(k) = V.col(ncv);
+    H.setZero();
+    for(Index i=0; i<k; ++i)
+    {
+      H(i,i) = eig.eigenvalues()(perm(i));
+      H(k,i) = H(i,k) = beta * Y(ncv-1,i);
+    }
+  }
+
+  m_eivalues.resize(nev);
+  for(Index i=0; i<nev; ++i)
+  {
+    // the transformation is performed in complex arithmetic since the shift may be complex with a zero imaginary part
+    std::complex<RealScalar> nu(eig.eigenvalues()(perm(i)));
+    m_eivalues(i) = numext::real(internal::krylov_spectral_transform<MatrixType>::run(op, nu));
+  }
+  m_eigenvectorsOk = (options & ComputeEigenvectors) == ComputeEigenvectors;
+  if(m_eigenvectorsOk)
+  {
+    RealMatrixType Y(ncv, nev);
+    for(Index i=0; i<nev; ++i)
+      Y.col(i) = eig.eigenvectors().col(perm(i));
+    m_eivec.noalias() = V.leftCols(ncv) * Y.template cast<Scalar>();
+  }
+  m_isInitialized = true;
+  return *this;
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_LANCZOSSELFADJOINTEIGENSOLVER_H
@@ -0,0 +1,161 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SHIFTINVERTOPERATOR_H
+#define EIGEN_SHIFTINVERTOPERATOR_H
+
+namespace Eigen {
+
+/** \ingroup KrylovEigenSolvers_Module
+  *
+  * Specifies which part of the spectrum is computed by the Krylov eigensolvers.
+  *
+  * For non selfadjoint operators, the algebraic order is the order of the real parts.
+  *
+  * \sa class LanczosSelfAdjointEigenSolver, class KrylovSchurEigenSolver
+  */
+enum EigenvalueSelection {
+  /** eigenvalues of largest magnitude */
+  LargestMagnitude,
+  /** eigenvalues of smallest magnitude, prefer a ShiftInvertOperator with a zero shift for faster convergence */
+  SmallestMagnitude,
+  /** largest eigenvalues (largest real parts) */
+  LargestAlgebraic,
+  /** smallest eigenvalues (smallest real parts) */
+  SmallestAlgebraic
+};
+
+/** \ingroup KrylovEigenSolvers_Module
+  *
+  * \class ShiftInvertOperator
+  *
+  * \brief Shift-and-invert spectral transformation of a matrix
+  *
+  * \tparam _MatrixType the type of the matrix \a A
+  * \tparam _Solver the type of the factorization of \f$ A - \sigma I \f$, e.g., SimplicialLDLT for selfadjoint
+  *                 sparse matrices, SparseLU for general sparse matrices, or LDLT and PartialPivLU for dense ones.
+  *
+  * This class factorizes \f$ A - \sigma I \f$ once and represents the operator \f$ (A - \sigma I)^{-1} \f$ through
+  * the solution of linear systems. Its eigenvalues \f$ \nu = 1/(\lambda - \sigma) \f$ are well separated around
+  * the shift \f$ \sigma \f$, such that computing the eigenvalues of largest magnitude of the operator yields the
+  * eigenvalues of \a A closest to \f$ \sigma \f$ in a few iterations.
+  *
+  * The Krylov eigensolvers recognize this operator and return the eigenvalues \f$ \lambda \f$ of \a A:
+  * \code
+  * SparseMatrix<double> A = ...;
+  * ShiftInvertOperator<SparseMatrix<double>, SimplicialLDLT<SparseMatrix<double> > > op(A, 0.5);
+  * LanczosSelfAdjointEigenSolver<ShiftInvertOperator<SparseMatrix<double>, SimplicialLDLT<SparseMatrix<double> > > > es(op, 10);
+  * // es.eigenvalues() are the 10 eigenvalues of A closest to 0.5
+  * \endcode
+  *
+  * \sa class LanczosSelfAdjointEigenSolver, class KrylovSchurEigenSolver
+  */
+template<typename _MatrixType, typename _Solver = SparseLU<_MatrixType> >
+class ShiftInvertOperator
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef _Solver Solver;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+
+    /** Factorizes \a mat - \a shift I */
+    ShiftInvertOperator(const MatrixType& mat, const Scalar& shift = Scalar(0))
+      : m_shift(shift), m_rows(mat.rows())
+    {
+      eigen_assert(mat.rows()==mat.cols() && "ShiftInvertOperator: the matrix must be square");
+      MatrixType identity(mat.rows(), mat.cols());
+      identity.setIdentity();
+      MatrixType shifted = mat - shift * identity;
+      m_solver.compute(shifted);
+    }
+
+    Index rows() const { return m_rows; }
+    Index cols() const { return m_rows; }
+
+    /** \returns the shift \f$ \sigma \f$ */
+    const Scalar& shift() const { return m_shift; }
+
+    /** \returns the factorization of \f$ A - \sigma I \f$ */
+    const Solver& solver() const { return m_solver; }
+
+    /** \returns \c Success if the factorization of \f$ A - \sigma I \f$ succeeded */
+    ComputationInfo info() const { return m_solver.info(); }
+
+    /** \returns \f$ (A - \sigma I)^{-1} x \f$ */
+    template<typename Rhs>
+    typename Rhs::PlainObject operator*(const MatrixBase<Rhs>& x) const
+    {
+      return m_solver.solve(x);
+    }
+
+  protected:
+    Solver m_solver;
+    Scalar m_shift;
+    Index m_rows;
+};
+
+namespace internal {
+
+/** \internal
+  * Maps an eigenvalue of the operator handed to the Krylov eigensolvers back to the eigenvalue of the
+  * underlying problem. This is the identity unless the operator is a spectral transformation.
+  */
+template<typename OperatorType> struct krylov_spectral_transform
+{
+  template<typename T>
+  static T run(const OperatorType&, const T& nu) { return nu; }
+};
+
+template<typename MatrixType, typename Solver>
+struct krylov_spectral_transform<ShiftInvertOperator<MatrixType,Solver> >
+{
+  template<typename T>
+  static T run(const ShiftInvertOperator<MatrixType,Solver>& op, const T& nu) { return T(op.shift()) + T(1)/nu; }
+};
+
+/** \internal
+  * Sorts the indices of \a values such that the wanted values (according to \a selection) come first.
+  */
+template<typename ValuesType, typename IndicesType>
+void krylov_sort_eigenvalues(const ValuesType& values, int selection, IndicesType& perm)
+{
+  using std::abs;
+  typedef typename IndicesType::Scalar Index;
+  typedef typename NumTraits<typename ValuesType::Scalar>::Real RealScalar;
+  const Index n = values.size();
+  Matrix<RealScalar,Dynamic,1> keys(n);
+  for(Index i=0; i<n; ++i)
+  {
+    switch(selection)
+    {
+      case LargestMagnitude:  keys(i) = -abs(values(i)); break;
+      case SmallestMagnitude: keys(i) =  abs(values(i)); break;
+      case LargestAlgebraic:  keys(i) = -numext::real(values(i)); break;
+      case SmallestAlgebraic: keys(i) =  numext::real(values(i)); break;
+      default: eigen_assert(false && "invalid eigenvalue selection");
+    }
+  }
+  perm.resize(n);
+  for(Index i=0; i<n; ++i)
+    perm(i) = i;
+  // insertion sort: the projected problems are small, and a stable order keeps conjugate pairs together
+  for(Index i=1; i<n; ++i)
+  {
+    Index p = perm(i);
+    Index j = i;
+    for(; j>0 && keys(perm(j-1))>keys(p); --j)
+      perm(j) = perm(j-1);
+    perm(j) = p;
+  }
+}
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_SHIFTINVERTOPERATOR_H
@@ -0,0 +1,278 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BLOCK_CONJUGATE_GRADIENT_H
+#define EIGEN_BLOCK_CONJUGATE_GRADIENT_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal Applies the preconditioner to each column of \a src */
+template<typename Preconditioner, typename Src, typename Dst>
+void block_krylov_precondition(const Preconditioner& precond, const Src& src, Dst& dst)
+{
+  typedef Matrix<typename Dst::Scalar,Dynamic,1> VectorType;
+  dst.resize(src.rows(), src.cols());
+  VectorType tmp;
+  for(typename Dst::Index j=0; j<src.cols(); ++j)
+  {
+    tmp = precond.solve(src.col(j));
+    dst.col(j) = tmp;
+  }
+}
+
+/** \internal \returns the largest ratio between the norm of a column of \a res and the one of the
+  * same column of \a rhs, columns of \a rhs with a zero norm being ignored */
+template<typename Res, typename RealVector>
+typename RealVector::Scalar block_krylov_relative_residual(const Res& res, const RealVector& rhsNorms)
+{
+  typedef typename RealVector::Scalar RealScalar;
+  RealScalar maxRatio(0);
+  for(typename Res::Index j=0; j<res.cols(); ++j)
+    if(rhsNorms(j)>RealScalar(0))
+      maxRatio = (std::max)(maxRatio, res.col(j).norm() / rhsNorms(j));
+  return maxRatio;
+}
+
+/** \internal Low-level block conjugate gradient algorithm
+  *
+  * All the columns of \a rhs are solved together: each iteration performs one product of the matrix by
+  * a block of search directions, and the search space is the sum of the Krylov spaces of all the residuals.
+  * The search directions are orthonormalized by a rank revealing QR decomposition, which drops the directions
+  * that became linearly dependent, as in the breakdown-free variant of Dubrulle. Their columns are scaled by
+  * the inverse norms of the right hand sides before, so that the threshold is relative to each right hand side.
+  *
+  * \param mat The matrix A
+  * \param rhs The right hand side vectors B
+  * \param x On input and initial solution, on output the computed solution.
+  * \param precond A preconditioner being able to efficiently solve for an
+  *                approximation of Ax=b (regardless of b)
+  * \param iters On input the max number of iteration, on output the number of performed iterations.
+  * \param tol_error On input the tolerance error, on output an estimation of the largest relative error of the columns.
+  */
+template<typename MatrixType, typename Rhs, typename Dest, typename Preconditioner>
+EIGEN_DONT_INLINE
+void block_conjugate_gradient(const MatrixType& mat, const Rhs& rhs, Dest& x,
+                              const Preconditioner& precond, int& iters,
+                              typename Dest::RealScalar& tol_error)
+{
+  using std::sqrt;
+  typedef typename Dest::RealScalar RealScalar;
+  typedef typename Dest::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<RealScalar,Dynamic,1> RealVector;
+
+  RealScalar tol = tol_error;
+  int maxIters = iters;
+
+  int n = mat.cols();
+  int k = rhs.cols();
+
+  RealVector rhsNorms = rhs.colwise().norm().transpose();
+  Matrix<Scalar,Dynamic,1> rhsScales(k);
+  DenseMatrix X = x;
+  for(int j=0; j<k; ++j)
+  {
+    rhsScales(j) = rhsNorms(j)>RealScalar(0) ? Scalar(RealScalar(1)/rhsNorms(j)) : Scalar(1);
+    if(rhsNorms(j)==RealScalar(0))
+      X.col(j).setZero();
+  }
+
+  DenseMatrix R = rhs - mat * X;
+  RealScalar residual = block_krylov_relative_residual(R, rhsNorms);
+  DenseMatrix Z, P, Q(n,k), alpha, beta;
+  ColPivHouseholderQR<DenseMatrix> qr;
+  qr.setThreshold(sqrt(NumTraits<RealScalar>::epsilon()));
+
+  int i = 0;
+  if(residual >= tol)
+  {
+    block_krylov_precondition(precond, R, Z);
+    qr.compute(Z * rhsScales.asDiagonal());
+    P = qr.householderQ() * DenseMatrix::Identity(n, qr.rank());
+  }
+  while(residual >= tol && i < maxIters && P.cols() > 0)
+  {
+    Q.noalias() = mat * P;                // the bottleneck of the algorithm, one product for all the right hand sides
+
+    LLT<DenseMatrix> pap(P.adjoint() * Q);
+    if(pap.info()!=Success)
+      break;
+    alpha = pap.solve(P.adjoint() * R);
+    X.noalias() += P * alpha;
+    R.noalias() -= Q * alpha;
+    ++i;
+
+    residual = block_krylov_relative_residual(R, rhsNorms);
+    if(residual < tol)
+      break;
+
+    // new search directions: the preconditioned residuals made A-conjugate to the previous ones
+    block_krylov_precondition(precond, R, Z);
+    beta = pap.solve(Q.adjoint() * Z);
+    Z.noalias() -= P * beta;
+    qr.compute(Z * rhsScales.asDiagonal());
+    P = qr.householderQ() * DenseMatrix::Identity(n, qr.rank());
+  }
+  x = X;
+  tol_error = residual;
+  iters = i;
+}
+
+}
+
+template< typename _MatrixType, int _UpLo=Lower,
+          typename _Preconditioner = DiagonalPreconditioner<typename _MatrixType::Scalar> >
+class BlockConjugateGradient;
+
+namespace internal {
+
+template< typename _MatrixType, int _UpLo, typename _Preconditioner>
+struct traits<BlockConjugateGradient<_MatrixType,_UpLo,_Preconditioner> >
+{
+  typedef _MatrixType MatrixType;
+  typedef _Preconditioner Preconditioner;
+};
+
+}
+
+/** \ingroup IterativeSolvers_Module
+  * \brief A block conjugate gradient solver for sparse self-adjoint problems with multiple right hand sides
+  *
+  * This class solves for A.X = B sparse linear problems, where B has several columns, like ConjugateGradient.
+  * Instead of solving each column independently, all the columns are advanced together by the block conjugate gradient
+  * algorithm of O'Leary: each iteration multiplies the matrix by a block of search directions, which streams the matrix
+  * once for all the right hand sides, and the search space combines the Krylov spaces of all the residuals, which
+  * reduces the number of iterations. The search directions are kept orthonormal and the directions becoming linearly
+  * dependent are dropped, so that the iterations do not break down when some columns converge before the others.
+  *
+  * \tparam _MatrixType the type of the matrix A, can be a dense or a sparse matrix.
+  * \tparam _UpLo the triangular part that will be used for the computations. It can be Lower,
+  *               Upper, or Lower|Upper in which the full matrix entries will be considered. Default is Lower.
+  * \tparam _Preconditioner the type of the preconditioner. Default is DiagonalPreconditioner
+  *
+  * The maximal number of iterations and tolerance value can be controlled via the setMaxIterations()
+  * and setTolerance() methods. An iteration updates all the columns, and error() is the largest relative
+  * residual of the columns. For a single right hand side, the algorithm reduces to ConjugateGradient.
+  * \code
+  * SparseMatrix<double> A(n,n);
+  * MatrixXd X(n,32), B(n,32);
+  * // fill A and B
+  * BlockConjugateGradient<SparseMatrix<double> > cg(A);
+  * X = cg.solve(B);
+  * std::cout << "#iterations:     " << cg.iterations() << std::endl;
+  * std::cout << "estimated error: " << cg.error()      << std::endl;
+  * \endcode
+  *
+  * \note Sparse right hand sides are solved column by column.
+  *
+  * \sa class ConjugateGradient, class BlockGMRES
+  */
+template< typename _MatrixType, int _UpLo, typename _Preconditioner>
+class BlockConjugateGradient : public IterativeSolverBase<BlockConjugateGradient<_MatrixType,_UpLo,_Preconditioner> >
+{
+  typedef IterativeSolverBase<BlockConjugateGradient> Base;
+  using Base::mp_matrix;
+  using Base::m_error;
+  using Base::m_iterations;
+  using Base::m_info;
+  using Base::m_isInitialized;
+public:
+  typedef _MatrixType MatrixType;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef _Preconditioner Preconditioner;
+
+  enum {
+    UpLo = _UpLo
+  };
+
+public:
+
+  /** Default constructor. */
+  BlockConjugateGradient() : Base() {}
+
+  /** Initialize the solver with matrix \a A for further \c AX=B solving.
+    *
+    * This constructor is a shortcut for the default constructor followed
+    * by a call to compute().
+    *
+    * \warning this class stores a reference to the matrix A as well as some
+    * precomputed values that depend on it. Therefore, if \a A is changed
+    * this class becomes invalid. Call compute() to update it with the new
+    * matrix A, or modify a copy of A.
+    */
+  template<typename MatrixDerived>
+  explicit BlockConjugateGradient(const EigenBase<MatrixDerived>& A) : Base(A.derived()) {}
+
+  ~BlockConjugateGradient() {}
+
+  /** \returns the solution X of \f$ A X = B \f$ using the current decomposition of A
+    * \a x0 as an initial solution.
+    *
+    * \sa compute()
+    */
+  template<typename Rhs,typename Guess>
+  inline const internal::solve_retval_with_guess<BlockConjugateGradient, Rhs, Guess>
+  solveWithGuess(const MatrixBase<Rhs>& b, const Guess& x0) const
+  {
+    eigen_assert(m_isInitialized && "BlockConjugateGradient is not initialized.");
+    eigen_assert(Base::rows()==b.rows()
+              && "BlockConjugateGradient::solve(): invalid number of rows of the right hand side matrix b");
+    return internal::solve_retval_with_guess
+            <BlockConjugateGradient, Rhs, Guess>(*this, b.derived(), x0);
+  }
+
+  /** \internal */
+  template<typename Rhs,typename Dest>
+  void _solveWithGuess(const Rhs& b, Dest& x) const
+  {
+    typedef typename internal::conditional<UpLo==(Lower|Upper) || internal::is_matrix_free<MatrixType>::value,
+                                           const MatrixType&,
+                                           SparseSelfAdjointView<const MatrixType, UpLo>
+                                          >::type MatrixWrapperType;
+    m_iterations = Base::maxIterations();
+    m_error = Base::m_tolerance;
+
+    internal::block_conjugate_gradient(MatrixWrapperType(*mp_matrix), b, x, Base::m_preconditioner, m_iterations, m_error);
+
+    m_isInitialized = true;
+    m_info = m_error <= Base::m_tolerance ? Success : NoConvergence;
+  }
+
+  /** \internal */
+  template<typename Rhs,typename Dest>
+  void _solve(const Rhs& b, Dest& x) const
+  {
+    x.setZero();
+    _solveWithGuess(b,x);
+  }
+};
+
+
+namespace internal {
+
+template<typename _MatrixType, int _UpLo, typename _Preconditioner, typename Rhs>
+struct solve_retval<BlockConjugateGradient<_MatrixType,_UpLo,_Preconditioner>, Rhs>
+  : solve_retval_base<BlockConjugateGradient<_MatrixType,_UpLo,_Preconditioner>, Rhs>
+{
+  typedef BlockConjugateGradient<_MatrixType,_UpLo,_Preconditioner> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_BLOCK_CONJUGATE_GRADIENT_H
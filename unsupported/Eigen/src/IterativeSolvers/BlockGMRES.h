@@ -0,0 +1,321 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BLOCK_GMRES_H
+#define EIGEN_BLOCK_GMRES_H
+
+namespace Eigen {
+
+namespace internal {
+
+/**
+ * Block Generalized Minimal Residual Algorithm, solving all the columns of the right hand side together.
+ *
+ * Each iteration extends the block Krylov space by the product of the matrix with a block of k basis vectors,
+ * orthogonalized with two passes of block Gram-Schmidt, such that the whole algorithm relies on matrix-matrix
+ * products. The block Hessenberg matrix is reduced to triangular form on the fly by Householder reflections of
+ * size k+1, which gives the residual norms of all the columns at each iteration. The cycle is restarted early when
+ * the Krylov space is exhausted.
+ *
+ * Parameters:
+ *  \param mat       matrix of linear system of equations
+ *  \param rhs       right hand side vectors of linear system of equations
+ *  \param x         on input: initial guess, on output: solution
+ *  \param precond   preconditioner used, applied on the left
+ *  \param iters     on input: maximum number of iterations to perform
+ *                   on output: number of iterations performed
+ *  \param restart   number of iterations for a restart
+ *  \param tol_error on input: relative residual tolerance
+ *                   on output: largest relative residual of the columns
+ *
+ * For references, please see:
+ *
+ * Saad, Y.
+ * Iterative Methods for Sparse Linear Systems, section 6.12.
+ * Society for Industrial and Applied Mathematics, Philadelphia, 2003.
+ *
+ */
+template<typename MatrixType, typename Rhs, typename Dest, typename Preconditioner>
+bool block_gmres(const MatrixType & mat, const Rhs & rhs, Dest & x, const Preconditioner & precond,
+                 int &iters, const int &restart, typename Dest::RealScalar & tol_error)
+{
+  using std::sqrt;
+
+  typedef typename Dest::RealScalar RealScalar;
+  typedef typename Dest::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<RealScalar,Dynamic,1> RealVector;
+
+  const RealScalar tol = tol_error;
+  const int maxIters = iters;
+  const int n = mat.rows();
+  const int k = rhs.cols();
+  const int m = (std::max)(1, restart);
+  const int s = (std::min)(n, k);           // the width of the blocks of the basis
+  const RealScalar eps = NumTraits<RealScalar>::epsilon();
+
+  DenseMatrix X = x, R, W, C;
+  block_krylov_precondition(precond, rhs, R);
+  RealVector rhsNorms = R.colwise().norm().transpose();
+  for(int j=0; j<k; ++j)
+    if(rhsNorms(j)==RealScalar(0))
+      X.col(j).setZero();
+
+  DenseMatrix V(n, (m+1)*s);                // the orthonormal basis of the block Krylov space
+  DenseMatrix H((m+1)*s, m*s);              // the block Hessenberg matrix, reduced to upper triangular form
+  DenseMatrix G((m+1)*s, k);                // the right hand sides of the least squares problems
+  DenseMatrix essential(s, m*s);            // the Householder reflectors reducing H
+  VectorType hCoeffs(m*s);
+  VectorType workspace(k), ess(s);
+  HouseholderQR<DenseMatrix> qr;
+
+  RealScalar residual(0);
+  int it = 0;
+  while(true)
+  {
+    // (re)start from the true residual
+    W = rhs - mat * X;
+    block_krylov_precondition(precond, W, R);
+    residual = block_krylov_relative_residual(R, rhsNorms);
+    if(!(residual >= tol) || it >= maxIters)   // also stops on NaN
+      break;
+
+    qr.compute(R);
+    V.leftCols(s) = qr.householderQ() * DenseMatrix::Identity(n, s);
+    G.setZero();
+    G.topRows(s) = qr.matrixQR().topRows(s).template triangularView<Upper>();
+    H.setZero();
+
+    int j = 0;
+    bool breakdown = false;
+    while(j < m && it < maxIters && !breakdown)
+    {
+      W.noalias() = mat * V.middleCols(j*s, s);
+      block_krylov_precondition(precond, W, R);
+      RealScalar normW = R.norm();
+
+      // block classical Gram-Schmidt with reorthogonalization
+      for(int pass=0; pass<2; ++pass)
+      {
+        C.noalias() = V.leftCols((j+1)*s).adjoint() * R;
+        R.noalias() -= V.leftCols((j+1)*s) * C;
+        H.block(0, j*s, (j+1)*s, s) += C;
+      }
+      qr.compute(R);
+      V.middleCols((j+1)*s, s) = qr.householderQ() * DenseMatrix::Identity(n, s);
+      H.block((j+1)*s, j*s, s, s) = qr.matrixQR().topRows(s).template triangularView<Upper>();
+      // the new block is not reliably orthogonal to the basis once the Krylov space is exhausted
+      if(qr.matrixQR().diagonal().cwiseAbs().minCoeff() <= sqrt(eps) * normW)
+        breakdown = true;
+
+      // reduce the new columns of H, and update G accordingly
+      for(int c=j*s; c<(j+1)*s; ++c)
+      {
+        for(int t=0; t<c; ++t)
+          H.col(c).segment(t, s+1).applyHouseholderOnTheLeft(essential.col(t), hCoeffs(t), workspace.data());
+        RealScalar beta;
+        H.col(c).segment(c, s+1).makeHouseholder(ess, hCoeffs.coeffRef(c), beta);
+        essential.col(c) = ess;
+        H(c,c) = beta;
+        H.col(c).segment(c+1, s).setZero();
+        G.middleRows(c, s+1).applyHouseholderOnTheLeft(essential.col(c), hCoeffs(c), workspace.data());
+      }
+      ++j;
+      ++it;
+
+      // the residual norms of the least squares problems are the norms of the trailing rows of G
+      RealScalar maxRatio(0);
+      for(int q=0; q<k; ++q)
+        if(rhsNorms(q)>RealScalar(0))
+          maxRatio = (std::max)(maxRatio, G.col(q).segment(j*s, s).norm() / rhsNorms(q));
+      if(maxRatio < tol)
+        break;
+    }
+
+    // solve the triangular system, ignoring the directions along which the Krylov space is exhausted
+    const int size = j*s;
+    DenseMatrix T = H.topLeftCorner(size, size).template triangularView<Upper>();
+    DenseMatrix Y = G.topRows(size);
+    const RealScalar threshold = eps * T.cwiseAbs().maxCoeff();
+    for(int c=0; c<size; ++c)
+      if(numext::abs2(T(c,c)) <= threshold*threshold)
+      {
+        T.row(c).setZero();
+        T(c,c) = Scalar(1);
+        Y.row(c).setZero();
+      }
+    T.template triangularView<Upper>().solveInPlace(Y);
+    X.noalias() += V.leftCols(size) * Y;
+  }
+
+  x = X;
+  tol_error = residual;
+  iters = it;
+  return (numext::isfinite)(residual);
+}
+
+}
+
+template< typename _MatrixType,
+          typename _Preconditioner = DiagonalPreconditioner<typename _MatrixType::Scalar> >
+class BlockGMRES;
+
+namespace internal {
+
+template< typename _MatrixType, typename _Preconditioner>
+struct traits<BlockGMRES<_MatrixType,_Preconditioner> >
+{
+  typedef _MatrixType MatrixType;
+  typedef _Preconditioner Preconditioner;
+};
+
+}
+
+/** \ingroup IterativeSolvers_Module
+  * \brief A block GMRES solver for sparse square problems with multiple right hand sides
+  *
+  * This class solves for A.X = B sparse linear problems, where B has several columns, like GMRES.
+  * Instead of solving each column independently, all the columns are advanced together in a common block Krylov
+  * space: each iteration multiplies the matrix by a block of basis vectors, which streams the matrix once for all the
+  * right hand sides, and each column is minimized over the Krylov spaces of all the residuals, which reduces the
+  * number of iterations. The basis is orthogonalized by matrix-matrix products as well.
+  *
+  * \tparam _MatrixType the type of the matrix A, can be a dense or a sparse matrix.
+  * \tparam _Preconditioner the type of the preconditioner. Default is DiagonalPreconditioner
+  *
+  * The maximal number of iterations and tolerance value can be controlled via the setMaxIterations()
+  * and setTolerance() methods. An iteration updates all the columns, and error() is the largest relative residual
+  * of the columns. The memory and orthogonalization costs grow with the number of columns times the number of
+  * iterations between two restarts, see set_restart().
+  * \code
+  * SparseMatrix<double> A(n,n);
+  * MatrixXd X(n,32), B(n,32);
+  * // fill A and B
+  * BlockGMRES<SparseMatrix<double>, IncompleteLUT<double> > solver(A);
+  * X = solver.solve(B);
+  * std::cout << "#iterations:     " << solver.iterations() << std::endl;
+  * std::cout << "estimated error: " << solver.error()      << std::endl;
+  * \endcode
+  *
+  * By default the iterations start with X=0 as an initial guess of the solution.
+  * One can control the start using the solveWithGuess() method.
+  *
+  * \note Sparse right hand sides are solved column by column.
+  *
+  * \sa class GMRES, class BlockConjugateGradient
+  */
+template< typename _MatrixType, typename _Preconditioner>
+class BlockGMRES : public IterativeSolverBase<BlockGMRES<_MatrixType,_Preconditioner> >
+{
+  typedef IterativeSolverBase<BlockGMRES> Base;
+  using Base::mp_matrix;
+  using Base::m_error;
+  using Base::m_iterations;
+  using Base::m_info;
+  using Base::m_isInitialized;
+
+private:
+  int m_restart;
+
+public:
+  typedef _MatrixType MatrixType;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef _Preconditioner Preconditioner;
+
+public:
+
+  /** Default constructor. */
+  BlockGMRES() : Base(), m_restart(30) {}
+
+  /** Initialize the solver with matrix \a A for further \c AX=B solving.
+    *
+    * This constructor is a shortcut for the default constructor followed
+    * by a call to compute().
+    *
+    * \warning this class stores a reference to the matrix A as well as some
+    * precomputed values that depend on it. Therefore, if \a A is changed
+    * this class becomes invalid. Call compute() to update it with the new
+    * matrix A, or modify a copy of A.
+    */
+  template<typename MatrixDerived>
+  explicit BlockGMRES(const EigenBase<MatrixDerived>& A) : Base(A.derived()), m_restart(30) {}
+
+  ~BlockGMRES() {}
+
+  /** Get the number of iterations after that a restart is performed.
+    */
+  int get_restart() { return m_restart; }
+
+  /** Set the number of iterations after that a restart is performed.
+    *  \param restart   number of iterations for a restart, default is 30.
+    */
+  void set_restart(const int restart) { m_restart=restart; }
+
+  /** \returns the solution X of \f$ A X = B \f$ using the current decomposition of A
+    * \a x0 as an initial solution.
+    *
+    * \sa compute()
+    */
+  template<typename Rhs,typename Guess>
+  inline const internal::solve_retval_with_guess<BlockGMRES, Rhs, Guess>
+  solveWithGuess(const MatrixBase<Rhs>& b, const Guess& x0) const
+  {
+    eigen_assert(m_isInitialized && "BlockGMRES is not initialized.");
+    eigen_assert(Base::rows()==b.rows()
+              && "BlockGMRES::solve(): invalid number of rows of the right hand side matrix b");
+    return internal::solve_retval_with_guess
+            <BlockGMRES, Rhs, Guess>(*this, b.derived(), x0);
+  }
+
+  /** \internal */
+  template<typename Rhs,typename Dest>
+  void _solveWithGuess(const Rhs& b, Dest& x) const
+  {
+    m_iterations = Base::maxIterations();
+    m_error = Base::m_tolerance;
+
+    bool ok = internal::block_gmres(*mp_matrix, b, x, Base::m_preconditioner, m_iterations, m_restart, m_error);
+
+    m_info = !ok ? NumericalIssue
+           : m_error <= Base::m_tolerance ? Success
+           : NoConvergence;
+    m_isInitialized = true;
+  }
+
+  /** \internal */
+  template<typename Rhs,typename Dest>
+  void _solve(const Rhs& b, Dest& x) const
+  {
+    x.setZero();
+    _solveWithGuess(b,x);
+  }
+};
+
+
+namespace internal {
+
+template<typename _MatrixType, typename _Preconditioner, typename Rhs>
+struct solve_retval<BlockGMRES<_MatrixType, _Preconditioner>, Rhs>
+  : solve_retval_base<BlockGMRES<_MatrixType, _Preconditioner>, Rhs>
+{
+  typedef BlockGMRES<_MatrixType, _Preconditioner> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_BLOCK_GMRES_H
@@ -0,0 +1,466 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_GCRODR_H
+#define EIGEN_GCRODR_H
+
+namespace Eigen {
+
+template< typename _MatrixType,
+          typename _Preconditioner = DiagonalPreconditioner<typename _MatrixType::Scalar> >
+class GCRODR;
+
+namespace internal {
+
+template< typename _MatrixType, typename _Preconditioner>
+struct traits<GCRODR<_MatrixType,_Preconditioner> >
+{
+  typedef _MatrixType MatrixType;
+  typedef _Preconditioner Preconditioner;
+};
+
+/** \internal Orthonormal basis of the span of the complex vectors \a Z, in the scalar type of \a P.
+  * For real scalars, the real and imaginary parts of complex conjugate eigenvectors span the same real subspace. */
+template<typename ComplexMatrix, typename RealScalar>
+void gcrodr_basis(const ComplexMatrix& Z, Matrix<RealScalar,Dynamic,Dynamic>& P)
+{
+  typedef Matrix<RealScalar,Dynamic,Dynamic> DenseMatrix;
+  DenseMatrix parts(Z.rows(), 2*Z.cols());
+  parts << Z.real(), Z.imag();
+  ColPivHouseholderQR<DenseMatrix> qr(parts);
+  typename DenseMatrix::Index k = (std::min)(qr.rank(), Z.cols());
+  P = qr.householderQ() * DenseMatrix::Identity(Z.rows(), k);
+}
+
+template<typename ComplexMatrix, typename RealScalar>
+void gcrodr_basis(const ComplexMatrix& Z, Matrix<std::complex<RealScalar>,Dynamic,Dynamic>& P)
+{
+  typedef Matrix<std::complex<RealScalar>,Dynamic,Dynamic> DenseMatrix;
+  ColPivHouseholderQR<DenseMatrix> qr(Z);
+  P = qr.householderQ() * DenseMatrix::Identity(Z.rows(), qr.rank());
+}
+
+/** \internal Computes an orthonormal basis \a P of the \a k harmonic Ritz vectors of smallest harmonic Ritz values,
+  * which are the solutions of the generalized eigenvalue problem \f$ G^* G p = \theta G^* W^* \hat V p \f$.
+  * \a P is empty when the problem is singular. */
+template<typename DenseMatrix>
+void gcrodr_harmonic_ritz(const DenseMatrix& G, const DenseMatrix& WhV, typename DenseMatrix::Index k,
+                          DenseMatrix& P)
+{
+  typedef typename DenseMatrix::Index Index;
+  typedef typename DenseMatrix::RealScalar RealScalar;
+  typedef Matrix<std::complex<RealScalar>,Dynamic,Dynamic> ComplexMatrix;
+
+  const Index m = G.cols();
+  P.resize(m, 0);
+  FullPivLU<DenseMatrix> lu(G.adjoint() * WhV);
+  if(!lu.isInvertible())
+    return;
+  ComplexEigenSolver<ComplexMatrix> eig(lu.solve(DenseMatrix(G.adjoint() * G)).template cast<std::complex<RealScalar> >());
+  if(eig.info()!=Success)
+    return;
+
+  // select the k harmonic Ritz values of smallest magnitudes
+  std::vector<std::pair<RealScalar,Index> > values(m);
+  for(Index i=0; i<m; ++i)
+    values[i] = std::make_pair(std::abs(eig.eigenvalues()(i)), i);
+  k = (std::min)(k, m);
+  std::partial_sort(values.begin(), values.begin()+k, values.end());
+  ComplexMatrix Z(m, k);
+  for(Index i=0; i<k; ++i)
+    Z.col(i) = eig.eigenvectors().col(values[i].second);
+  gcrodr_basis(Z, P);
+}
+
+} // end namespace internal
+
+/** \ingroup IterativeSolvers_Module
+  * \brief A GMRES solver recycling a deflation subspace across successive systems (GCRO-DR)
+  *
+  * This class solves for A.x = b sparse linear problems with the GCRO-DR algorithm of Parks et al., a restarted
+  * GMRES which keeps an approximate invariant subspace of the preconditioned matrix, spanned by the harmonic Ritz
+  * vectors of its smallest eigenvalues. Each cycle minimizes the residual over this subspace and a Krylov space
+  * made orthogonal to its image, which removes the small eigenvalues responsible for the stagnation of restarted
+  * GMRES.
+  *
+  * Unlike DGMRES, the subspace is kept from one solve to the next: solving for several right hand sides, or
+  * calling compute() with an updated matrix of a slowly changing sequence, reuses the subspace of the previous
+  * systems from the first iteration. On a new matrix, the image of the subspace is recomputed at the cost of
+  * recycleSize() products. Call clearRecycleSpace() when the next systems are unrelated.
+  *
+  * The preconditioner is applied on the left, and the tolerance is relative to the norm of the preconditioned
+  * right hand side. Each cycle performs set_restart() minus recycleSize() products by A.
+  *
+  * \tparam _MatrixType the type of the matrix A, can be a dense or a sparse matrix.
+  * \tparam _Preconditioner the type of the preconditioner. Default is DiagonalPreconditioner
+  *
+  * \code
+  * SparseMatrix<double> A;
+  * VectorXd x, b;
+  * GCRODR<SparseMatrix<double>, IncompleteLUT<double> > solver;
+  * solver.set_restart(40);
+  * solver.setRecycleSize(10);
+  * for(int step=0; step<nbSteps; ++step)
+  * {
+  *   // update A and b
+  *   solver.compute(A);
+  *   x = solver.solveWithGuess(b, x);
+  * }
+  * \endcode
+  *
+  * References :
+  * [1] M. L. Parks, E. de Sturler, G. Mackey, D. D. Johnson and S. Maiti, Recycling Krylov subspaces for
+  * sequences of linear systems, SIAM J. Sci. Comput. 28(5), 2006, 1651-1674.
+  *
+  * \sa class GMRES, class DGMRES
+  */
+template< typename _MatrixType, typename _Preconditioner>
+class GCRODR : public IterativeSolverBase<GCRODR<_MatrixType,_Preconditioner> >
+{
+    typedef IterativeSolverBase<GCRODR> Base;
+    using Base::mp_matrix;
+    using Base::m_error;
+    using Base::m_iterations;
+    using Base::m_info;
+    using Base::m_isInitialized;
+    using Base::m_tolerance;
+  public:
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef _Preconditioner Preconditioner;
+    typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+    typedef Matrix<Scalar,Dynamic,1> DenseVector;
+    typedef Matrix<RealScalar,Dynamic,1> RealVector;
+
+  /** Default constructor. */
+  GCRODR() : Base(), m_restart(30), m_recycleSize(10), m_isImageValid(false) {}
+
+  /** Initialize the solver with matrix \a A for further \c Ax=b solving.
+    *
+    * This constructor is a shortcut for the default constructor followed
+    * by a call to compute().
+    *
+    * \warning this class stores a reference to the matrix A as well as some
+    * precomputed values that depend on it. Therefore, if \a A is changed
+    * this class becomes invalid. Call compute() to update it with the new
+    * matrix A, or modify a copy of A.
+    */
+  template<typename MatrixDerived>
+  explicit GCRODR(const EigenBase<MatrixDerived>& A)
+    : Base(A.derived()), m_restart(30), m_recycleSize(10), m_isImageValid(false)
+  {}
+
+  ~GCRODR() {}
+
+  /** Initializes the preconditioner with the matrix \a A. The recycled subspace is kept, and its image
+    * by the new preconditioned matrix is recomputed by the next solve. */
+  template<typename MatrixDerived>
+  GCRODR& compute(const EigenBase<MatrixDerived>& A)
+  {
+    Base::compute(A.derived());
+    m_isImageValid = false;
+    return *this;
+  }
+
+  /** \sa compute() */
+  template<typename MatrixDerived>
+  GCRODR& factorize(const EigenBase<MatrixDerived>& A)
+  {
+    Base::factorize(A.derived());
+    m_isImageValid = false;
+    return *this;
+  }
+
+  /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A
+    * \a x0 as an initial solution.
+    *
+    * \sa compute()
+    */
+  template<typename Rhs,typename Guess>
+  inline const internal::solve_retval_with_guess<GCRODR, Rhs, Guess>
+  solveWithGuess(const MatrixBase<Rhs>& b, const Guess& x0) const
+  {
+    eigen_assert(m_isInitialized && "GCRODR is not initialized.");
+    eigen_assert(Base::rows()==b.rows()
+              && "GCRODR::solve(): invalid number of rows of the right hand side matrix b");
+    return internal::solve_retval_with_guess
+            <GCRODR, Rhs, Guess>(*this, b.derived(), x0);
+  }
+
+  /** \internal */
+  template<typename Rhs,typename Dest>
+  void _solveWithGuess(const Rhs& b, Dest& x) const
+  {
+    for(int j=0; j<b.cols(); ++j)
+    {
+      m_iterations = Base::maxIterations();
+      m_error = Base::m_tolerance;
+
+      typename Dest::ColXpr xj(x,j);
+      gcrodr(*mp_matrix, b.col(j), xj, Base::m_preconditioner);
+    }
+    m_info = m_error <= Base::m_tolerance ? Success : NoConvergence;
+    m_isInitialized = true;
+  }
+
+  /** \internal */
+  template<typename Rhs,typename Dest>
+  void _solve(const Rhs& b, Dest& x) const
+  {
+    x.setZero();
+    _solveWithGuess(b,x);
+  }
+
+  /** Get the maximal dimension of the search space of a cycle, recycled subspace included. */
+  int get_restart() { return m_restart; }
+
+  /** Set the maximal dimension of the search space of a cycle, recycled subspace included (default is 30). */
+  void set_restart(const int restart) { m_restart=restart; }
+
+  /** \returns the number of harmonic Ritz vectors kept across the cycles and the solves */
+  int recycleSize() const { return m_recycleSize; }
+
+  /** Sets the number of harmonic Ritz vectors kept across the cycles and the solves (default is 10).
+    * It must be lower than the restart value, and zero gives the restarted GMRES. */
+  GCRODR& setRecycleSize(int k)
+  {
+    eigen_assert(k>=0);
+    m_recycleSize = k;
+    return *this;
+  }
+
+  /** \returns the basis of the recycled subspace, in the unknown space */
+  const DenseMatrix& recycleSpace() const { return m_U; }
+
+  /** Discards the recycled subspace, which is rebuilt by the next solve. */
+  GCRODR& clearRecycleSpace()
+  {
+    resetRecycleSpace();
+    return *this;
+  }
+
+  protected:
+
+    void resetRecycleSpace() const
+    {
+      m_U.resize(0,0);
+      m_C.resize(0,0);
+      m_isImageValid = false;
+    }
+
+    /** \internal \returns the product of the preconditioned matrix by \a v */
+    template<typename Vec>
+    DenseVector apply(const MatrixType& mat, const Preconditioner& precond, const Vec& v) const
+    {
+      DenseVector w = mat * v;
+      return precond.solve(w);
+    }
+
+    /** \internal Computes C = M^-1 A U with orthonormal columns, and updates U accordingly. */
+    void updateImage(const MatrixType& mat, const Preconditioner& precond) const
+    {
+      if(m_isImageValid || m_U.cols()==0)
+        return;
+      if(m_U.rows()!=mat.cols())
+      {
+        resetRecycleSpace();
+        return;
+      }
+      const Index k = m_U.cols();
+      m_C.resize(mat.rows(), k);
+      for(Index i=0; i<k; ++i)
+        m_C.col(i) = apply(mat, precond, m_U.col(i));
+      HouseholderQR<DenseMatrix> qr(m_C);
+      const RealScalar threshold = NumTraits<RealScalar>::epsilon() * qr.matrixQR().diagonal().cwiseAbs().maxCoeff();
+      if(!(qr.matrixQR().diagonal().cwiseAbs().minCoeff() > threshold))
+      {
+        resetRecycleSpace();
+        return;
+      }
+      m_C = qr.householderQ() * DenseMatrix::Identity(mat.rows(), k);
+      qr.matrixQR().topRows(k).template triangularView<Upper>().template solveInPlace<OnTheRight>(m_U);
+      m_isImageValid = true;
+    }
+
+    template<typename Rhs, typename Dest>
+    void gcrodr(const MatrixType& mat, const Rhs& rhs, Dest& x, const Preconditioner& precond) const;
+
+    int m_restart;
+    int m_recycleSize;
+    mutable DenseMatrix m_U;      // basis of the recycled subspace
+    mutable DenseMatrix m_C;      // orthonormal basis of its image by the preconditioned matrix, C = M^-1 A U
+    mutable bool m_isImageValid;  // whether m_C matches the current matrix and preconditioner
+};
+
+/** \internal Performs cycles of GCRO-DR until convergence, updating the recycled subspace at the end of
+  * each cycle.
+  */
+template< typename _MatrixType, typename _Preconditioner>
+template<typename Rhs, typename Dest>
+void GCRODR<_MatrixType, _Preconditioner>::gcrodr(const MatrixType& mat, const Rhs& rhs, Dest& x,
+                                                 const Preconditioner& precond) const
+{
+  using std::abs;
+  const Index n = mat.rows();
+  const Index m = (std::max)(m_restart, 1);
+  const Index k = (std::min)(Index(m_recycleSize), m-1);
+  const int maxIters = m_iterations;
+  const RealScalar eps = NumTraits<RealScalar>::epsilon();
+
+  DenseVector c = precond.solve(rhs);
+  const RealScalar normRhs = c.norm();
+  if(normRhs==RealScalar(0))
+  {
+    x.setZero();
+    m_iterations = 0;
+    m_error = 0;
+    return;
+  }
+  const RealScalar tol = m_tolerance * normRhs;
+
+  if(m_U.cols() > k)
+    resetRecycleSpace();
+  updateImage(mat, precond);
+
+  DenseVector r(n), w(n), h;
+  int its = 0;
+  RealScalar beta(0);
+  while(true)
+  {
+    // (re)start from the true residual, projected onto the complement of the recycled image
+    r = c - apply(mat, precond, x);
+    if(m_U.cols()>0)
+    {
+      DenseVector t = m_C.adjoint() * r;
+      x += m_U * t;
+      r -= m_C * t;
+    }
+    beta = r.norm();
+    if(!(beta > tol) || its >= maxIters)   // also stops on NaN
+      break;
+
+    // Arnoldi process on (I - C C^*) M^-1 A. The search space is spanned by [U D, V_j] and its image by [C, V_{j+1}],
+    // with D = diag(1/|u_i|), so that the residual is minimized by the least squares problem min |beta e_kk - G y|
+    // with G = [D B_j; 0 H_j] upper Hessenberg, whose QR factorization is updated by Givens rotations.
+    const Index kk = m_U.cols();
+    const Index p = (std::min)(m - kk, Index(maxIters - its));
+    RealVector scale(kk);
+    for(Index i=0; i<kk; ++i)
+      scale(i) = RealScalar(1) / m_U.col(i).norm();
+    DenseMatrix V(n, p+1), H = DenseMatrix::Zero(p+1, p), B(kk, p);
+    DenseMatrix R = DenseMatrix::Zero(kk+p+1, kk+p);
+    R.topLeftCorner(kk,kk) = scale.template cast<Scalar>().asDiagonal();
+    DenseVector g = DenseVector::Zero(kk+p+1), col(kk+p+1);
+    g(kk) = beta;
+    std::vector<JacobiRotation<Scalar> > rotations(p);
+    V.col(0) = r / beta;
+    Index j = 0;
+    while(j < p)
+    {
+      w = apply(mat, precond, V.col(j));
+      ++its;
+      RealScalar normW = w.norm();
+      // classical Gram-Schmidt against [C V_j], with reorthogonalization
+      B.col(j).setZero();
+      for(int pass=0; pass<2; ++pass)
+      {
+        if(kk>0)
+        {
+          h = m_C.adjoint() * w;
+          w -= m_C * h;
+          B.col(j) += h;
+        }
+        h = V.leftCols(j+1).adjoint() * w;
+        w -= V.leftCols(j+1) * h;
+        H.col(j).head(j+1) += h;
+      }
+      RealScalar hNext = w.norm();
+      H(j+1,j) = hNext;
+
+      col.setZero();
+      col.head(kk) = B.col(j);
+      col.segment(kk, j+2) = H.col(j).head(j+2);
+      for(Index i=0; i<j; ++i)
+        col.applyOnTheLeft(kk+i, kk+i+1, rotations[i].adjoint());
+      rotations[j].makeGivens(col(kk+j), col(kk+j+1));
+      col.applyOnTheLeft(kk+j, kk+j+1, rotations[j].adjoint());
+      g.applyOnTheLeft(kk+j, kk+j+1, rotations[j].adjoint());
+      R.col(kk+j) = col;
+      ++j;
+
+      if(!(hNext > eps * normW))
+      {
+        // the Krylov space is invariant
+        V.col(j).setZero();
+        break;
+      }
+      V.col(j) = w / hNext;
+      if(!(abs(g(kk+j)) > tol))
+        break;
+    }
+    DenseVector y = R.topLeftCorner(kk+j, kk+j).template triangularView<Upper>().solve(g.head(kk+j));
+
+    DenseMatrix Vhat(n, kk+j), W(n, kk+j+1);
+    if(kk>0)
+    {
+      Vhat.leftCols(kk) = m_U * scale.template cast<Scalar>().asDiagonal();
+      W.leftCols(kk) = m_C;
+    }
+    Vhat.rightCols(j) = V.leftCols(j);
+    W.rightCols(j+1) = V.leftCols(j+1);
+    x += Vhat * y;
+
+    // new recycled subspace, from the harmonic Ritz vectors of the search space
+    if(k>0 && kk+j>=k)
+    {
+      DenseMatrix G = DenseMatrix::Zero(kk+j+1, kk+j);
+      G.topLeftCorner(kk,kk) = scale.template cast<Scalar>().asDiagonal();
+      G.block(0, kk, kk, j) = B.leftCols(j);
+      G.bottomRightCorner(j+1, j) = H.topLeftCorner(j+1, j);
+      DenseMatrix P;
+      internal::gcrodr_harmonic_ritz(G, DenseMatrix(W.adjoint() * Vhat), k, P);
+      if(P.cols()>0)
+      {
+        HouseholderQR<DenseMatrix> qr(G * P);
+        const Index kp = P.cols();
+        const RealScalar threshold = eps * qr.matrixQR().diagonal().cwiseAbs().maxCoeff();
+        if(qr.matrixQR().diagonal().cwiseAbs().minCoeff() > threshold)
+        {
+          m_C = W * (qr.householderQ() * DenseMatrix::Identity(G.rows(), kp));
+          m_U = Vhat * P;
+          qr.matrixQR().topRows(kp).template triangularView<Upper>().template solveInPlace<OnTheRight>(m_U);
+          m_isImageValid = true;
+        }
+      }
+    }
+  }
+  m_iterations = its;
+  m_error = beta / normRhs;
+}
+
+namespace internal {
+
+template<typename _MatrixType, typename _Preconditioner, typename Rhs>
+struct solve_retval<GCRODR<_MatrixType, _Preconditioner>, Rhs>
+  : solve_retval_base<GCRODR<_MatrixType, _Preconditioner>, Rhs>
+{
+  typedef GCRODR<_MatrixType, _Preconditioner> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_GCRODR_H
@@ -0,0 +1,307 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_MIXED_PRECISION_REFINEMENT_H
+#define EIGEN_MIXED_PRECISION_REFINEMENT_H
+
+namespace Eigen {
+
+/** \ingroup IterativeSolvers_Module
+  * The methods computing the corrections of MixedPrecisionRefinement */
+enum RefinementMethod {
+  /** Each correction is solved with the low precision factorization. */
+  ClassicalRefinement,
+  /** Each correction is solved by GMRES in the working precision, left preconditioned by the low precision
+    * factorization. */
+  GMRESRefinement
+};
+
+namespace internal {
+
+/** \internal Applies the low precision decomposition \a dec to the working precision vector or matrix \a b.
+  * The columns of \a b are scaled to a unit norm before being rounded, such that small residuals do not underflow. */
+template<typename Decomposition, typename Rhs, typename Dest>
+void mixed_precision_solve(const Decomposition& dec, const Rhs& b, Dest& x)
+{
+  typedef typename Dest::RealScalar RealScalar;
+  typedef typename Decomposition::MatrixType::Scalar LowScalar;
+  typedef Matrix<LowScalar,Dynamic,Dynamic> LowMatrix;
+
+  x.resize(b.rows(), b.cols());
+  LowMatrix lowB(b.rows(), b.cols()), lowX;
+  Matrix<RealScalar,Dynamic,1> scale(b.cols());
+  for(typename Dest::Index j=0; j<b.cols(); ++j)
+  {
+    scale(j) = b.col(j).template lpNorm<Infinity>();
+    if(scale(j)==RealScalar(0)) scale(j) = RealScalar(1);
+    lowB.col(j) = (b.col(j) / scale(j)).template cast<LowScalar>();
+  }
+  lowX = dec.solve(lowB);
+  x = lowX.template cast<typename Dest::Scalar>() * scale.asDiagonal();
+}
+
+/** \internal The low precision decomposition seen as a preconditioner of the working precision GMRES */
+template<typename Decomposition, typename Scalar>
+class mixed_precision_preconditioner
+{
+  public:
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+    explicit mixed_precision_preconditioner(const Decomposition& dec) : m_dec(dec) {}
+
+    template<typename Rhs>
+    VectorType solve(const MatrixBase<Rhs>& b) const
+    {
+      VectorType x;
+      mixed_precision_solve(m_dec, b.derived(), x);
+      return x;
+    }
+
+  protected:
+    const Decomposition& m_dec;
+};
+
+} // end namespace internal
+
+/** \ingroup IterativeSolvers_Module
+  * \brief Mixed precision iterative refinement of a low precision direct solver
+  *
+  * This class solves \f$ A x = b \f$ in the precision of \c _MatrixType, typically \c double, from a decomposition
+  * \c _Decomposition of \f$ A \f$ rounded to a lower precision, typically \c float. The factorization, which
+  * dominates the cost of a direct solve, runs about twice faster and needs half the memory, and the solution is
+  * recovered to the working precision by iterative refinement:
+  * \f[ r_i = b - A x_i, \quad A d_i = r_i, \quad x_{i+1} = x_i + d_i \f]
+  * where the residuals are computed in the working precision. The corrections \f$ d_i \f$ are computed according
+  * to setMethod():
+  *  - ClassicalRefinement solves them with the low precision factorization. This converges when the condition
+  *    number of \f$ A \f$ is well below the inverse of the low precision epsilon, about \c 1e7 for \c float.
+  *  - GMRESRefinement solves them with GMRES, left preconditioned by the low precision factorization. This costs
+  *    a few products by \f$ A \f$ per correction, but still converges for condition numbers of about \c 1e8 to
+  *    \c 1e10 with \c float factors and \c double residuals (Carson and Higham, SIAM J. Sci. Comput. 40(2), 2018).
+  *
+  * \tparam _MatrixType the type of the matrix A in the working precision, dense or sparse
+  * \tparam _Decomposition the type of the low precision decomposition, like PartialPivLU<MatrixXf>, LLT<MatrixXf>,
+  *         SimplicialLDLT<SparseMatrix<float> > or SparseLU<SparseMatrix<float>, COLAMDOrdering<int> >
+  *
+  * The iterations stop when the normwise backward error
+  * \f$ \|b - A x\|_\infty / (\|A\|_\infty \|x\|_\infty + \|b\|_\infty) \f$ of all the columns is below
+  * the tolerance, NumTraits<Scalar>::epsilon() by default, or when it stops decreasing.
+  * \code
+  * MatrixXd A(n,n);
+  * VectorXd b(n);
+  * // fill A and b
+  * MixedPrecisionRefinement<MatrixXd, PartialPivLU<MatrixXf> > solver(A);
+  * VectorXd x = solver.solve(b);
+  * std::cout << "#iterations:    " << solver.iterations() << std::endl;
+  * std::cout << "backward error: " << solver.error()      << std::endl;
+  * \endcode
+  *
+  * \warning this class stores a reference to the matrix A to compute the residuals. Therefore, if \a A is changed
+  * this class becomes invalid. Call compute() to update it with the new matrix A, or modify a copy of A.
+  *
+  * \note The entries of \a A must be representable in the low precision: scale the matrix beforehand if needed.
+  *
+  * \sa class GMRES, class PartialPivLU, class SimplicialLDLT
+  */
+template<typename _MatrixType, typename _Decomposition>
+class MixedPrecisionRefinement : internal::noncopyable
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef _Decomposition Decomposition;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef typename Decomposition::MatrixType::Scalar LowScalar;
+    typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+    typedef Matrix<RealScalar,Dynamic,1> RealVector;
+
+    /** Default constructor. */
+    MixedPrecisionRefinement()
+      : mp_matrix(0), m_matrixNorm(0), m_tolerance(NumTraits<Scalar>::epsilon()), m_maxIterations(10),
+        m_method(ClassicalRefinement), m_isInitialized(false)
+    {}
+
+    /** Initialize the solver with matrix \a A for further \c Ax=b solving.
+      * This constructor is a shortcut for the default constructor followed by a call to compute(). */
+    explicit MixedPrecisionRefinement(const MatrixType& A)
+      : mp_matrix(0), m_matrixNorm(0), m_tolerance(NumTraits<Scalar>::epsilon()), m_maxIterations(10),
+        m_method(ClassicalRefinement), m_isInitialized(false)
+    {
+      compute(A);
+    }
+
+    /** Computes the low precision decomposition of \a A, and keeps a reference to \a A. */
+    MixedPrecisionRefinement& compute(const MatrixType& A)
+    {
+      mp_matrix = &A;
+      m_decomposition.compute(A.template cast<LowScalar>());
+      m_matrixNorm = (A.cwiseAbs() * RealVector::Ones(A.cols())).maxCoeff();
+      m_iterations = 0;
+      m_error = 0;
+      m_info = Success;
+      m_isInitialized = true;
+      return *this;
+    }
+
+    Index rows() const { return mp_matrix ? mp_matrix->rows() : 0; }
+    Index cols() const { return mp_matrix ? mp_matrix->cols() : 0; }
+
+    /** \returns a read-only reference to the low precision decomposition. */
+    const Decomposition& decomposition() const { return m_decomposition; }
+
+    /** \returns the tolerance on the normwise backward error */
+    RealScalar tolerance() const { return m_tolerance; }
+
+    /** Sets the tolerance on the normwise backward error, the epsilon of the working precision by default. */
+    MixedPrecisionRefinement& setTolerance(const RealScalar& tolerance)
+    {
+      m_tolerance = tolerance;
+      return *this;
+    }
+
+    /** \returns the max number of refinement steps */
+    int maxIterations() const { return m_maxIterations; }
+
+    /** Sets the max number of refinement steps, 10 by default. */
+    MixedPrecisionRefinement& setMaxIterations(int maxIters)
+    {
+      m_maxIterations = maxIters;
+      return *this;
+    }
+
+    /** \returns the method computing the corrections */
+    RefinementMethod method() const { return m_method; }
+
+    /** Sets the method computing the corrections, ClassicalRefinement by default. */
+    MixedPrecisionRefinement& setMethod(RefinementMethod method)
+    {
+      m_method = method;
+      return *this;
+    }
+
+    /** \returns the number of refinement steps performed during the last solve */
+    int iterations() const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionRefinement is not initialized.");
+      return m_iterations;
+    }
+
+    /** \returns the normwise backward error reached during the last solve */
+    RealScalar error() const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionRefinement is not initialized.");
+      return m_error;
+    }
+
+    /** \returns Success if the backward error of the last solve meets the tolerance, NoConvergence otherwise. */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionRefinement is not initialized.");
+      return m_info;
+    }
+
+    /** \returns the solution x of \f$ A x = b \f$ in the working precision. */
+    template<typename Rhs> inline const internal::solve_retval<MixedPrecisionRefinement, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionRefinement is not initialized.");
+      eigen_assert(rows()==b.rows()
+                && "MixedPrecisionRefinement::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<MixedPrecisionRefinement, Rhs>(*this, b.derived());
+    }
+
+    /** \internal */
+    template<typename Rhs, typename Dest>
+    void _solve(const Rhs& b, Dest& dest) const
+    {
+      using std::sqrt;
+      const MatrixType& A = *mp_matrix;
+      DenseMatrix B = b, X, R, D, lastX;
+      RealVector rhsNorms(B.cols());
+      for(Index j=0; j<B.cols(); ++j)
+        rhsNorms(j) = B.col(j).template lpNorm<Infinity>();
+
+      internal::mixed_precision_solve(m_decomposition, B, X);
+      internal::mixed_precision_preconditioner<Decomposition,Scalar> precond(m_decomposition);
+      RealScalar lastError = NumTraits<RealScalar>::highest();
+      m_iterations = 0;
+      while(true)
+      {
+        R = B - A * X;
+        m_error = 0;
+        for(Index j=0; j<B.cols(); ++j)
+        {
+          RealScalar denom = m_matrixNorm * X.col(j).template lpNorm<Infinity>() + rhsNorms(j);
+          RealScalar res = R.col(j).template lpNorm<Infinity>();
+          if(denom>RealScalar(0))
+            m_error = (std::max)(m_error, res / denom);
+        }
+        // stop on convergence, and on stagnation or non finite values, keeping the best iterate
+        if(m_iterations>0 && !(m_error < lastError))
+        {
+          X.swap(lastX);
+          m_error = lastError;
+          break;
+        }
+        if(!(m_error > m_tolerance) || m_iterations>=m_maxIterations)
+          break;
+        lastError = m_error;
+        lastX = X;
+
+        if(m_method==ClassicalRefinement)
+          internal::mixed_precision_solve(m_decomposition, R, D);
+        else
+        {
+          // the preconditioned operator is only well conditioned up to the low precision: when A is ill
+          // conditioned, the corrections need a tighter inner tolerance and a larger Krylov space
+          D.setZero(R.rows(), R.cols());
+          int restart = int((std::min<Index>)(2 * A.rows(), 100));
+          int iters = restart;
+          RealScalar tol = sqrt(NumTraits<RealScalar>::epsilon());
+          internal::block_gmres(A, R, D, precond, iters, restart, tol);
+        }
+        X += D;
+        ++m_iterations;
+      }
+      m_info = m_error <= m_tolerance ? Success : NoConvergence;
+      dest = X;
+    }
+
+  protected:
+    const MatrixType* mp_matrix;
+    Decomposition m_decomposition;
+    RealScalar m_matrixNorm;
+    RealScalar m_tolerance;
+    int m_maxIterations;
+    RefinementMethod m_method;
+    mutable int m_iterations;
+    mutable RealScalar m_error;
+    mutable ComputationInfo m_info;
+    bool m_isInitialized;
+};
+
+namespace internal {
+
+template<typename _MatrixType, typename _Decomposition, typename Rhs>
+struct solve_retval<MixedPrecisionRefinement<_MatrixType,_Decomposition>, Rhs>
+  : solve_retval_base<MixedPrecisionRefinement<_MatrixType,_Decomposition>, Rhs>
+{
+  typedef MixedPrecisionRefinement<_MatrixType,_Decomposition> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_MIXED_PRECISION_REFINEMENT_H
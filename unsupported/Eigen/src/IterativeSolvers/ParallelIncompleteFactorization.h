@@ -0,0 +1,654 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_PARALLEL_INCOMPLETE_FACTORIZATION_H
+#define EIGEN_PARALLEL_INCOMPLETE_FACTORIZATION_H
+
+namespace Eigen {
+
+/** \ingroup IterativeSolvers_Module
+  * The reorderings exposing the parallelism of ParallelIncompleteLU and ParallelIncompleteCholesky */
+enum IncompleteFactorizationOrdering {
+  /** Keep the order of the matrix, and process the rows by level sets of the triangular factors. The factors
+    * are the ones of the sequential factorization, but the number of levels grows with the size of the problem. */
+  LevelSetOrdering,
+  /** Permute the matrix such that the rows of a same color of a greedy coloring of its graph are contiguous.
+    * Each color is a level, usually a handful of them, at the price of a weaker preconditioner. */
+  MulticolorOrdering
+};
+
+namespace internal {
+
+/** \internal Computes a greedy coloring of the symmetric graph \a graph, and returns in \a perm the permutation
+  * grouping the vertices of a same color, in increasing order within each color. */
+template<typename GraphType, typename PermutationType>
+void incomplete_multicolor_ordering(const GraphType& graph, PermutationType& perm)
+{
+  typedef typename GraphType::Index Index;
+  typedef Matrix<Index,Dynamic,1> IndexVector;
+  const Index n = graph.outerSize();
+
+  IndexVector color = IndexVector::Constant(n, -1);
+  IndexVector mark = IndexVector::Constant(n+1, -1);
+  Index nbColors = 0;
+  for(Index i=0; i<n; ++i)
+  {
+    for(typename GraphType::InnerIterator it(graph,i); it; ++it)
+      if(color(it.index())>=0)
+        mark(color(it.index())) = i;
+    Index c = 0;
+    while(mark(c)==i) ++c;
+    color(i) = c;
+    nbColors = (std::max)(nbColors, c+1);
+  }
+
+  // counting sort of the vertices by color
+  IndexVector start = IndexVector::Zero(nbColors+1);
+  for(Index i=0; i<n; ++i)
+    ++start(color(i)+1);
+  for(Index c=0; c<nbColors; ++c)
+    start(c+1) += start(c);
+  perm.resize(n);
+  for(Index i=0; i<n; ++i)
+    perm.indices()(i) = start(color(i))++;
+}
+
+/** \internal Groups the rows of the row major matrix \a mat into level sets of its lower (\a lower is true) or
+  * upper triangular part: the rows of a level only depend on rows of the previous levels. The rows of level \c l
+  * are <tt>rows[ptr[l]:ptr[l+1]]</tt>, in increasing order. */
+template<typename MatrixType, typename IndexVector>
+void incomplete_level_sets(const MatrixType& mat, bool lower, IndexVector& ptr, IndexVector& rows)
+{
+  typedef typename MatrixType::Index Index;
+  const Index n = mat.rows();
+  IndexVector level(n);
+  Index nbLevels = 0;
+  for(Index k=0; k<n; ++k)
+  {
+    Index i = lower ? k : n-1-k;
+    Index l = 0;
+    for(typename MatrixType::InnerIterator it(mat,i); it; ++it)
+      if(lower ? it.index()<i : it.index()>i)
+        l = (std::max)(l, level(it.index())+1);
+    level(i) = l;
+    nbLevels = (std::max)(nbLevels, l+1);
+  }
+
+  ptr.setZero(nbLevels+1);
+  for(Index i=0; i<n; ++i)
+    ++ptr(level(i)+1);
+  for(Index l=0; l<nbLevels; ++l)
+    ptr(l+1) += ptr(l);
+  rows.resize(n);
+  IndexVector next = ptr.head(nbLevels);
+  for(Index i=0; i<n; ++i)
+    rows(next(level(i))++) = i;
+}
+
+/** \internal Calls \a kernel on every row, level after level. The rows of a level are distributed among the
+  * threads, which synchronize between two levels. Sequentially, the rows are processed in increasing
+  * (\a forward is true) or decreasing order, which respects the dependencies and is more cache friendly. */
+template<typename IndexVector, typename Kernel>
+void incomplete_level_sweep(const IndexVector& ptr, const IndexVector& rows, bool forward, const Kernel& kernel)
+{
+  typedef typename IndexVector::Scalar Index;
+  const Index n = rows.size();
+  #ifdef EIGEN_HAS_OPENMP
+  const Index nbLevels = ptr.size()-1;
+  // a level needs enough rows to amortize the synchronization
+  if(nbThreads()>1 && n>=4096 && n>=256*nbLevels)
+  {
+    #pragma omp parallel num_threads(nbThreads())
+    for(Index l=0; l<nbLevels; ++l)
+    {
+      #pragma omp for schedule(static)
+      for(Index q=ptr(l); q<ptr(l+1); ++q)
+        kernel(rows(q));
+    }
+    return;
+  }
+  #else
+  EIGEN_UNUSED_VARIABLE(ptr);
+  #endif
+  if(forward)
+    for(Index i=0; i<n; ++i)
+      kernel(i);
+  else
+    for(Index i=n-1; i>=0; --i)
+      kernel(i);
+}
+
+/** \internal Builds the row major matrix \c P A P^T, adding explicit zeros on the diagonal. When \a lowerOnly is
+  * true, \a mat is self-adjoint and only its \a UpLo triangular part is referenced, and only the lower triangular
+  * part of the result is built. */
+template<int UpLo, typename MatrixType, typename PermutationType, typename FactorType>
+void incomplete_permuted_copy(const MatrixType& mat, const PermutationType& perm, bool lowerOnly, FactorType& dst)
+{
+  typedef typename FactorType::Scalar Scalar;
+  typedef typename FactorType::Index Index;
+  const Index n = mat.rows();
+  std::vector<Triplet<Scalar,Index> > triplets;
+  triplets.reserve(mat.nonZeros()+n);
+  for(Index j=0; j<mat.outerSize(); ++j)
+    for(typename MatrixType::InnerIterator it(mat,j); it; ++it)
+    {
+      Index r = it.row(), c = it.col();
+      if(lowerOnly && ((UpLo==Lower && r<c) || (UpLo==Upper && r>c)))
+        continue;
+      Index pr = perm.size()==n ? perm.indices()(r) : r;
+      Index pc = perm.size()==n ? perm.indices()(c) : c;
+      if(lowerOnly && pr<pc)
+        triplets.push_back(Triplet<Scalar,Index>(pc, pr, numext::conj(Scalar(it.value()))));
+      else
+        triplets.push_back(Triplet<Scalar,Index>(pr, pc, Scalar(it.value())));
+    }
+  for(Index i=0; i<n; ++i)
+    triplets.push_back(Triplet<Scalar,Index>(i, i, Scalar(0)));
+  dst.resize(n, n);
+  dst.setFromTriplets(triplets.begin(), triplets.end());
+  dst.makeCompressed();
+}
+
+/** \internal Positions of the diagonal entries in the compressed row major matrix \a mat */
+template<typename FactorType, typename IndexVector>
+void incomplete_diagonal_positions(const FactorType& mat, IndexVector& diag)
+{
+  typedef typename FactorType::Index Index;
+  diag.resize(mat.rows());
+  for(Index i=0; i<mat.rows(); ++i)
+  {
+    Index p = mat.outerIndexPtr()[i];
+    while(mat.innerIndexPtr()[p]<i) ++p;
+    diag(i) = p;
+  }
+}
+
+/** \internal Computes the row \a i of the ILU(0) factorization, in place: the rows it depends on must be done. */
+template<typename Scalar, typename Index>
+struct ilu0_row_kernel
+{
+  const Index* outer; const Index* inner; const Index* diag;
+  Scalar* values; unsigned char* zeroPivot;
+
+  void operator()(Index i) const
+  {
+    const Index end = outer[i+1];
+    for(Index p=outer[i]; p<diag[i]; ++p)
+    {
+      const Index k = inner[p];
+      values[p] /= values[diag[k]];
+      // row_i -= l_ik * U(k,:), restricted to the pattern of row i
+      Index q = p+1, r = diag[k]+1;
+      const Index rEnd = outer[k+1];
+      while(q<end && r<rEnd)
+      {
+        if(inner[q]==inner[r])   values[q++] -= values[p] * values[r++];
+        else if(inner[q]<inner[r]) ++q;
+        else                       ++r;
+      }
+    }
+    zeroPivot[i] = values[diag[i]]==Scalar(0);
+    if(zeroPivot[i])
+      values[diag[i]] = Scalar(1);
+  }
+};
+
+/** \internal Computes the row \a i of the IC(0) factorization, in place: the rows it depends on must be done.
+  * The rows only hold the lower triangular part, so the diagonal entry is the last one. */
+template<typename Scalar, typename Index>
+struct ic0_row_kernel
+{
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  const Index* outer; const Index* inner;
+  Scalar* values; unsigned char* zeroPivot;
+
+  void operator()(Index i) const
+  {
+    using std::sqrt;
+    const Index d = outer[i+1]-1;
+    for(Index p=outer[i]; p<d; ++p)
+    {
+      const Index j = inner[p];
+      // l_ij = (a_ij - sum_{k<j} l_ik conj(l_jk)) / l_jj
+      Scalar s = values[p];
+      Index q = outer[i], r = outer[j];
+      const Index rEnd = outer[j+1]-1;
+      while(q<p && r<rEnd)
+      {
+        if(inner[q]==inner[r])     s -= values[q++] * numext::conj(values[r++]);
+        else if(inner[q]<inner[r]) ++q;
+        else                       ++r;
+      }
+      values[p] = s / values[rEnd];
+    }
+    RealScalar pivot = numext::real(values[d]);
+    for(Index p=outer[i]; p<d; ++p)
+      pivot -= numext::abs2(values[p]);
+    zeroPivot[i] = !(pivot > RealScalar(0));
+    values[d] = zeroPivot[i] ? Scalar(1) : Scalar(sqrt(pivot));
+  }
+};
+
+/** \internal Computes the row \a i of the solution of a triangular system by substitution, using the entries
+  * of the row \a i of \a values on one side of its diagonal: <tt>x_i = (x_i - sum_j a_ij x_j) / a_ii</tt>. */
+template<typename Scalar, typename Index, bool Lower, bool UnitDiag>
+struct triangular_row_kernel
+{
+  const Index* outer; const Index* inner; const Index* diag;
+  const Scalar* values; Scalar* x;
+
+  void operator()(Index i) const
+  {
+    Scalar s = x[i];
+    const Index begin = Lower ? outer[i] : diag[i]+1;
+    const Index end = Lower ? diag[i] : outer[i+1];
+    for(Index p=begin; p<end; ++p)
+      s -= values[p] * x[inner[p]];
+    x[i] = UnitDiag ? s : s / values[diag[i]];
+  }
+};
+
+} // end namespace internal
+
+/** \ingroup IterativeSolvers_Module
+  * \brief Zero fill-in incomplete LU factorization ILU(0), computed and applied in parallel
+  *
+  * This preconditioner computes the incomplete factorization \f$ P A P^T \approx L U \f$ restricted to the
+  * sparsity pattern of \f$ A \f$, like IncompleteLU. The rows of the factors are grouped into levels whose rows
+  * only depend on the previous levels, so that the factorization and the two triangular solves of the
+  * preconditioner process the rows of each level in parallel with OpenMP. The permutation \f$ P \f$ is chosen
+  * by setOrdering():
+  *  - LevelSetOrdering keeps the order of the matrix, and gives the same factors as the sequential algorithm.
+  *    The number of levels is problem dependent: about \c 2n for a 5-point stencil on a \c n x \c n grid.
+  *  - MulticolorOrdering (red-black for a 5-point stencil) gives a few large levels, hence a much better parallel
+  *    efficiency, but the factors usually approximate the matrix less well and the number of iterations grows.
+  *
+  * Without OpenMP, or for small problems, the levels are processed sequentially.
+  *
+  * \tparam _Scalar the scalar type of the matrix
+  *
+  * \sa class ParallelIncompleteCholesky, class IncompleteLU, class IncompleteLUT
+  */
+template <typename _Scalar>
+class ParallelIncompleteLU : internal::noncopyable
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+    typedef SparseMatrix<Scalar,RowMajor> FactorType;
+    typedef typename FactorType::Index Index;
+    typedef Matrix<Index,Dynamic,1> IndexVector;
+    typedef PermutationMatrix<Dynamic,Dynamic,Index> PermutationType;
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+    ParallelIncompleteLU()
+      : m_ordering(LevelSetOrdering), m_analysisIsOk(false), m_factorizationIsOk(false), m_isInitialized(false)
+    {}
+
+    template<typename MatrixType>
+    explicit ParallelIncompleteLU(const MatrixType& mat)
+      : m_ordering(LevelSetOrdering), m_analysisIsOk(false), m_factorizationIsOk(false), m_isInitialized(false)
+    {
+      compute(mat);
+    }
+
+    Index rows() const { return m_lu.rows(); }
+    Index cols() const { return m_lu.cols(); }
+
+    /** Sets the reordering exposing the parallelism, LevelSetOrdering by default.
+      * It is used by the next call to analyzePattern() or compute(). */
+    ParallelIncompleteLU& setOrdering(IncompleteFactorizationOrdering ordering)
+    {
+      m_ordering = ordering;
+      return *this;
+    }
+
+    /** \returns the number of levels of the forward substitution, the number of synchronizations of the threads
+      * during the factorization. */
+    Index levels() const
+    {
+      eigen_assert(m_analysisIsOk && "ParallelIncompleteLU is not initialized.");
+      return m_lowerPtr.size()-1;
+    }
+
+    /** \brief Reports whether previous computation was successful.
+      *
+      * \returns \c Success if computation was succesful,
+      *          \c NumericalIssue if a zero pivot was met, in which case it was replaced by one.
+      */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "ParallelIncompleteLU is not initialized.");
+      return m_info;
+    }
+
+    /** Computes the reordering and the level sets of the factors, from the sparsity pattern of \a mat. */
+    template<typename MatrixType>
+    ParallelIncompleteLU& analyzePattern(const MatrixType& mat)
+    {
+      eigen_assert(mat.rows()==mat.cols() && "ParallelIncompleteLU needs a square matrix");
+      m_perm.resize(0);
+      if(m_ordering==MulticolorOrdering)
+      {
+        SparseMatrix<Scalar,ColMajor,Index> graph = mat;
+        graph = graph + SparseMatrix<Scalar,ColMajor,Index>(graph.adjoint());
+        internal::incomplete_multicolor_ordering(graph, m_perm);
+      }
+      internal::incomplete_permuted_copy<Lower>(mat, m_perm, false, m_lu);
+      internal::incomplete_diagonal_positions(m_lu, m_diag);
+      internal::incomplete_level_sets(m_lu, true, m_lowerPtr, m_lowerRows);
+      internal::incomplete_level_sets(m_lu, false, m_upperPtr, m_upperRows);
+      m_zeroPivot.resize(m_lu.rows());
+      m_analysisIsOk = true;
+      m_factorizationIsOk = false;
+      m_isInitialized = true;
+      m_info = Success;
+      return *this;
+    }
+
+    /** Computes the ILU(0) factorization of \a mat, which must have the sparsity pattern given to analyzePattern(). */
+    template<typename MatrixType>
+    ParallelIncompleteLU& factorize(const MatrixType& mat)
+    {
+      eigen_assert(m_analysisIsOk && "You must first call analyzePattern()");
+      Index nnz = m_lu.nonZeros();
+      internal::incomplete_permuted_copy<Lower>(mat, m_perm, false, m_lu);
+      eigen_assert(m_lu.nonZeros()==nnz && "the sparsity pattern changed since analyzePattern()");
+      EIGEN_UNUSED_VARIABLE(nnz);
+
+      internal::ilu0_row_kernel<Scalar,Index> kernel;
+      kernel.outer = m_lu.outerIndexPtr();
+      kernel.inner = m_lu.innerIndexPtr();
+      kernel.diag = m_diag.data();
+      kernel.values = m_lu.valuePtr();
+      kernel.zeroPivot = m_zeroPivot.data();
+      internal::incomplete_level_sweep(m_lowerPtr, m_lowerRows, true, kernel);
+
+      m_info = (m_zeroPivot.array()!=0).any() ? NumericalIssue : Success;
+      m_factorizationIsOk = true;
+      return *this;
+    }
+
+    template<typename MatrixType>
+    ParallelIncompleteLU& compute(const MatrixType& mat)
+    {
+      analyzePattern(mat);
+      factorize(mat);
+      return *this;
+    }
+
+    template<typename Rhs, typename Dest>
+    void _solve(const Rhs& b, Dest& x) const
+    {
+      VectorType y;
+      if(m_perm.size()>0) y = m_perm * b;
+      else                y = b;
+
+      internal::triangular_row_kernel<Scalar,Index,true,true> lower;
+      lower.outer = m_lu.outerIndexPtr(); lower.inner = m_lu.innerIndexPtr(); lower.diag = m_diag.data();
+      lower.values = m_lu.valuePtr(); lower.x = y.data();
+      internal::incomplete_level_sweep(m_lowerPtr, m_lowerRows, true, lower);
+
+      internal::triangular_row_kernel<Scalar,Index,false,false> upper;
+      upper.outer = m_lu.outerIndexPtr(); upper.inner = m_lu.innerIndexPtr(); upper.diag = m_diag.data();
+      upper.values = m_lu.valuePtr(); upper.x = y.data();
+      internal::incomplete_level_sweep(m_upperPtr, m_upperRows, false, upper);
+
+      if(m_perm.size()>0) x = m_perm.inverse() * y;
+      else                x = y;
+    }
+
+    template<typename Rhs> inline const internal::solve_retval<ParallelIncompleteLU, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_factorizationIsOk && "ParallelIncompleteLU is not initialized.");
+      eigen_assert(cols()==b.rows()
+                && "ParallelIncompleteLU::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<ParallelIncompleteLU, Rhs>(*this, b.derived());
+    }
+
+  protected:
+    FactorType m_lu;              // L and U in the pattern of P A P^T, with the unit diagonal of L implicit
+    IndexVector m_diag;           // positions of the diagonal entries in m_lu
+    IndexVector m_lowerPtr, m_lowerRows, m_upperPtr, m_upperRows;
+    PermutationType m_perm;       // empty for LevelSetOrdering
+    Matrix<unsigned char,Dynamic,1> m_zeroPivot;  // flags of the rows with a zero pivot
+    IncompleteFactorizationOrdering m_ordering;
+    ComputationInfo m_info;
+    bool m_analysisIsOk;
+    bool m_factorizationIsOk;
+    bool m_isInitialized;
+};
+
+/** \ingroup IterativeSolvers_Module
+  * \brief Zero fill-in incomplete Cholesky factorization IC(0), computed and applied in parallel
+  *
+  * This preconditioner computes the incomplete factorization \f$ P A P^T \approx L L^* \f$ of a self-adjoint
+  * positive definite matrix, restricted to the sparsity pattern of the lower triangular part of \f$ P A P^T \f$.
+  * As for ParallelIncompleteLU, the rows of the factors are grouped into levels which are processed in parallel
+  * with OpenMP by the factorization and the two triangular solves, with the same choice of orderings.
+  *
+  * When a non positive pivot is met, the factorization is restarted with a diagonal shift
+  * \f$ A + \alpha \, \mathrm{diag}(A) \f$, doubling \f$ \alpha \f$ until it succeeds; see shift().
+  *
+  * \tparam _Scalar the scalar type of the matrix
+  * \tparam _UpLo the triangular part of the matrix which is referenced, Lower (default) or Upper
+  *
+  * \sa class ParallelIncompleteLU, class IncompleteCholesky
+  */
+template <typename _Scalar, int _UpLo = Lower>
+class ParallelIncompleteCholesky : internal::noncopyable
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+    typedef SparseMatrix<Scalar,RowMajor> FactorType;
+    typedef typename FactorType::Index Index;
+    typedef Matrix<Index,Dynamic,1> IndexVector;
+    typedef PermutationMatrix<Dynamic,Dynamic,Index> PermutationType;
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+    enum { UpLo = _UpLo };
+
+    ParallelIncompleteCholesky()
+      : m_shift(0), m_ordering(LevelSetOrdering), m_analysisIsOk(false), m_factorizationIsOk(false), m_isInitialized(false)
+    {}
+
+    template<typename MatrixType>
+    explicit ParallelIncompleteCholesky(const MatrixType& mat)
+      : m_shift(0), m_ordering(LevelSetOrdering), m_analysisIsOk(false), m_factorizationIsOk(false), m_isInitialized(false)
+    {
+      compute(mat);
+    }
+
+    Index rows() const { return m_L.rows(); }
+    Index cols() const { return m_L.cols(); }
+
+    /** Sets the reordering exposing the parallelism, LevelSetOrdering by default.
+      * It is used by the next call to analyzePattern() or compute(). */
+    ParallelIncompleteCholesky& setOrdering(IncompleteFactorizationOrdering ordering)
+    {
+      m_ordering = ordering;
+      return *this;
+    }
+
+    /** \returns the number of levels of the forward substitution, the number of synchronizations of the threads
+      * during the factorization. */
+    Index levels() const
+    {
+      eigen_assert(m_analysisIsOk && "ParallelIncompleteCholesky is not initialized.");
+      return m_lowerPtr.size()-1;
+    }
+
+    /** \returns the relative diagonal shift \f$ \alpha \f$ used by the last factorization, zero if none was needed. */
+    RealScalar shift() const { return m_shift; }
+
+    /** \brief Reports whether previous computation was successful.
+      *
+      * \returns \c Success if computation was succesful,
+      *          \c NumericalIssue if the diagonal of the matrix is not positive.
+      */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "ParallelIncompleteCholesky is not initialized.");
+      return m_info;
+    }
+
+    /** Computes the reordering and the level sets of the factors, from the sparsity pattern of \a mat. */
+    template<typename MatrixType>
+    ParallelIncompleteCholesky& analyzePattern(const MatrixType& mat)
+    {
+      eigen_assert(mat.rows()==mat.cols() && "ParallelIncompleteCholesky needs a square matrix");
+      m_perm.resize(0);
+      if(m_ordering==MulticolorOrdering)
+      {
+        SparseMatrix<Scalar,ColMajor,Index> graph;
+        internal::incomplete_permuted_copy<UpLo>(mat, m_perm, true, graph);
+        graph = graph + SparseMatrix<Scalar,ColMajor,Index>(graph.adjoint());
+        internal::incomplete_multicolor_ordering(graph, m_perm);
+      }
+      internal::incomplete_permuted_copy<UpLo>(mat, m_perm, true, m_L);
+      m_Lt = m_L.adjoint();
+      internal::incomplete_diagonal_positions(m_L, m_diag);
+      internal::incomplete_level_sets(m_L, true, m_lowerPtr, m_lowerRows);
+      internal::incomplete_level_sets(m_Lt, false, m_upperPtr, m_upperRows);
+      m_zeroPivot.resize(m_L.rows());
+      m_analysisIsOk = true;
+      m_factorizationIsOk = false;
+      m_isInitialized = true;
+      m_info = Success;
+      return *this;
+    }
+
+    /** Computes the IC(0) factorization of \a mat, which must have the sparsity pattern given to analyzePattern(). */
+    template<typename MatrixType>
+    ParallelIncompleteCholesky& factorize(const MatrixType& mat)
+    {
+      eigen_assert(m_analysisIsOk && "You must first call analyzePattern()");
+      Index nnz = m_L.nonZeros();
+      internal::incomplete_permuted_copy<UpLo>(mat, m_perm, true, m_L);
+      eigen_assert(m_L.nonZeros()==nnz && "the sparsity pattern changed since analyzePattern()");
+      EIGEN_UNUSED_VARIABLE(nnz);
+
+      const Index n = m_L.rows();
+      VectorType values = Map<const VectorType>(m_L.valuePtr(), m_L.nonZeros());
+      m_info = Success;
+      for(Index i=0; i<n; ++i)
+        if(!(numext::real(values(m_L.outerIndexPtr()[i+1]-1)) > RealScalar(0)))
+          m_info = NumericalIssue;
+
+      internal::ic0_row_kernel<Scalar,Index> kernel;
+      kernel.outer = m_L.outerIndexPtr();
+      kernel.inner = m_L.innerIndexPtr();
+      kernel.values = m_L.valuePtr();
+      kernel.zeroPivot = m_zeroPivot.data();
+      m_shift = 0;
+      while(m_info==Success)
+      {
+        Map<VectorType>(m_L.valuePtr(), m_L.nonZeros()) = values;
+        if(m_shift>RealScalar(0))
+          for(Index i=0; i<n; ++i)
+            m_L.valuePtr()[m_L.outerIndexPtr()[i+1]-1] *= RealScalar(1) + m_shift;
+        internal::incomplete_level_sweep(m_lowerPtr, m_lowerRows, true, kernel);
+        if(!(m_zeroPivot.array()!=0).any())
+          break;
+        m_shift = m_shift==RealScalar(0) ? RealScalar(1e-3) : RealScalar(2)*m_shift;
+        if(m_shift>RealScalar(1e3))   // only reached with non finite entries
+          m_info = NumericalIssue;
+      }
+      m_Lt = m_L.adjoint();
+      m_factorizationIsOk = true;
+      return *this;
+    }
+
+    template<typename MatrixType>
+    ParallelIncompleteCholesky& compute(const MatrixType& mat)
+    {
+      analyzePattern(mat);
+      factorize(mat);
+      return *this;
+    }
+
+    template<typename Rhs, typename Dest>
+    void _solve(const Rhs& b, Dest& x) const
+    {
+      VectorType y;
+      if(m_perm.size()>0) y = m_perm * b;
+      else                y = b;
+
+      // the diagonal entry is the last one of each row of L, and the first one of each row of L^*
+      internal::triangular_row_kernel<Scalar,Index,true,false> lower;
+      lower.outer = m_L.outerIndexPtr(); lower.inner = m_L.innerIndexPtr(); lower.diag = m_diag.data();
+      lower.values = m_L.valuePtr(); lower.x = y.data();
+      internal::incomplete_level_sweep(m_lowerPtr, m_lowerRows, true, lower);
+
+      internal::triangular_row_kernel<Scalar,Index,false,false> upper;
+      upper.outer = m_Lt.outerIndexPtr(); upper.inner = m_Lt.innerIndexPtr(); upper.diag = m_Lt.outerIndexPtr();
+      upper.values = m_Lt.valuePtr(); upper.x = y.data();
+      internal::incomplete_level_sweep(m_upperPtr, m_upperRows, false, upper);
+
+      if(m_perm.size()>0) x = m_perm.inverse() * y;
+      else                x = y;
+    }
+
+    template<typename Rhs> inline const internal::solve_retval<ParallelIncompleteCholesky, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_factorizationIsOk && "ParallelIncompleteCholesky is not initialized.");
+      eigen_assert(cols()==b.rows()
+                && "ParallelIncompleteCholesky::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<ParallelIncompleteCholesky, Rhs>(*this, b.derived());
+    }
+
+  protected:
+    FactorType m_L;               // lower triangular part of P A P^T, then the factor L
+    FactorType m_Lt;              // L^*, for the parallel backward substitution
+    IndexVector m_diag;           // positions of the diagonal entries in m_L
+    IndexVector m_lowerPtr, m_lowerRows, m_upperPtr, m_upperRows;
+    PermutationType m_perm;       // empty for LevelSetOrdering
+    Matrix<unsigned char,Dynamic,1> m_zeroPivot;  // flags of the rows with a non positive pivot
+    RealScalar m_shift;
+    IncompleteFactorizationOrdering m_ordering;
+    ComputationInfo m_info;
+    bool m_analysisIsOk;
+    bool m_factorizationIsOk;
+    bool m_isInitialized;
+};
+
+namespace internal {
+
+template<typename _Scalar, typename Rhs>
+struct solve_retval<ParallelIncompleteLU<_Scalar>, Rhs>
+  : solve_retval_base<ParallelIncompleteLU<_Scalar>, Rhs>
+{
+  typedef ParallelIncompleteLU<_Scalar> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+template<typename _Scalar, int _UpLo, typename Rhs>
+struct solve_retval<ParallelIncompleteCholesky<_Scalar,_UpLo>, Rhs>
+  : solve_retval_base<ParallelIncompleteCholesky<_Scalar,_UpLo>, Rhs>
+{
+  typedef ParallelIncompleteCholesky<_Scalar,_UpLo> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_PARALLEL_INCOMPLETE_FACTORIZATION_H
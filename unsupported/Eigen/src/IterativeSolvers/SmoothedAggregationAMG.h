@@ -0,0 +1,434 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SMOOTHED_AGGREGATION_AMG_H
+#define EIGEN_SMOOTHED_AGGREGATION_AMG_H
+
+#include <vector>
+
+namespace Eigen {
+
+/** \ingroup IterativeSolvers_Module
+  * Smoothers available to SmoothedAggregationAMG.
+  */
+enum AMGSmootherType {
+  /** Damped Jacobi iterations, with a damping factor of \f$ 4/(3\rho) \f$ where \f$ \rho \f$ bounds the spectral radius of \f$ D^{-1}A \f$. */
+  JacobiSmoother,
+  /** Gauss-Seidel iterations: forward sweeps before the coarse grid correction and backward sweeps after it, such that the V-cycle remains symmetric. */
+  GaussSeidelSmoother
+};
+
+namespace internal {
+
+/** \internal Builds the strength of connection graph of \a A:
+  * j is a strong neighbor of i if \f$ |a_{ij}| \geq \theta \sqrt{|a_{ii} a_{jj}|} \f$.
+  * The neighbors of i are stored in \a adj[ptr[i]] ... \a adj[ptr[i+1]-1].
+  */
+template<typename MatrixType, typename RealVector, typename IndexVector>
+void amg_strength_graph(const MatrixType& A, const RealVector& absDiag, typename RealVector::Scalar theta,
+                        IndexVector& ptr, IndexVector& adj)
+{
+  using std::abs;
+  using std::sqrt;
+  typedef typename MatrixType::Index Index;
+  Index n = A.rows();
+  ptr.assign(n+1, 0);
+  adj.clear();
+  adj.reserve(A.nonZeros());
+  for(Index i=0; i<n; ++i)
+  {
+    for(typename MatrixType::InnerIterator it(A,i); it; ++it)
+    {
+      Index j = it.index();
+      if(j!=i && abs(it.value()) >= theta * sqrt(absDiag(i)*absDiag(j)))
+        adj.push_back(j);
+    }
+    ptr[i+1] = Index(adj.size());
+  }
+}
+
+/** \internal Greedy aggregation of the strength graph (\a ptr, \a adj) following Vaněk, Mandel and Brezina:
+  *  1. every node whose strong neighbors are all free is aggregated together with its neighborhood,
+  *  2. the remaining nodes join the aggregate of one of their strong neighbors built at step 1,
+  *  3. the nodes left are aggregated with their free strong neighbors.
+  * \returns the number of aggregates, \a agg[i] being the aggregate of the node i.
+  */
+template<typename IndexVector>
+typename IndexVector::value_type amg_aggregate(const IndexVector& ptr, const IndexVector& adj, IndexVector& agg)
+{
+  typedef typename IndexVector::value_type Index;
+  Index n = Index(ptr.size()) - 1;
+  Index nc = 0;
+  agg.assign(n, -1);
+
+  for(Index i=0; i<n; ++i)
+  {
+    if(agg[i]!=-1) continue;
+    bool allFree = true;
+    for(Index k=ptr[i]; k<ptr[i+1] && allFree; ++k)
+      allFree = agg[adj[k]]==-1;
+    if(!allFree) continue;
+    agg[i] = nc;
+    for(Index k=ptr[i]; k<ptr[i+1]; ++k)
+      agg[adj[k]] = nc;
+    ++nc;
+  }
+
+  IndexVector rootAgg(agg);
+  for(Index i=0; i<n; ++i)
+  {
+    if(agg[i]!=-1) continue;
+    for(Index k=ptr[i]; k<ptr[i+1]; ++k)
+      if(rootAgg[adj[k]]!=-1)
+      {
+        agg[i] = rootAgg[adj[k]];
+        break;
+      }
+  }
+
+  for(Index i=0; i<n; ++i)
+  {
+    if(agg[i]!=-1) continue;
+    agg[i] = nc;
+    for(Index k=ptr[i]; k<ptr[i+1]; ++k)
+      if(agg[adj[k]]==-1)
+        agg[adj[k]] = nc;
+    ++nc;
+  }
+  return nc;
+}
+
+} // end namespace internal
+
+/** \ingroup IterativeSolvers_Module
+  * \brief A smoothed aggregation algebraic multigrid preconditioner
+  *
+  * This class implements a preconditioner for sparse problems arising from the discretization of
+  * elliptic partial differential equations, for which the number of iterations of a Krylov method
+  * preconditioned by one V-cycle is nearly independent of the mesh size.
+  *
+  * The setup builds a hierarchy of coarser and coarser operators. On each level:
+  *  - a strength of connection graph is extracted from the matrix (see setStrengthThreshold()),
+  *  - the nodes are grouped into aggregates of strongly connected neighbors,
+  *  - the piecewise constant tentative prolongator \f$ T \f$ is smoothed by one damped Jacobi step, \f$ P = (I - \omega D^{-1} A) T \f$,
+  *  - the coarse operator is the Galerkin product \f$ P^* A P \f$.
+  *
+  * The coarsening stops when the operator has less than maxCoarseSize() rows, and the coarsest
+  * level is solved by a dense LU factorization with full pivoting. If the coarsening stops earlier,
+  * because the aggregation does not reduce the size of the problem or setMaxLevels() is reached,
+  * the coarsest level is only smoothed, by forward then backward sweeps.
+  *
+  * The solve() function applies one V-cycle with the smoother selected by setSmoother().
+  *
+  * \tparam _Scalar the type of the scalar.
+  *
+  * This class follows the sparse preconditioner concept, and can be used as the \c Preconditioner
+  * template argument of ConjugateGradient, BiCGSTAB, GMRES, etc.:
+  * \code
+  * ConjugateGradient<SparseMatrix<double>, Lower|Upper, SmoothedAggregationAMG<double> > cg;
+  * cg.preconditioner().setSmoother(GaussSeidelSmoother);
+  * cg.compute(A);
+  * x = cg.solve(b);
+  * \endcode
+  *
+  * \warning The preconditioner is built from all the entries stored in the matrix, so a selfadjoint
+  * problem must be given with both its lower and upper triangular parts.
+  *
+  * \note The near null space of the operator is assumed to be spanned by the constant vector, as for
+  * scalar diffusion problems. Systems such as linear elasticity will converge, though not optimally.
+  */
+template <typename _Scalar>
+class SmoothedAggregationAMG
+{
+    typedef _Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef Matrix<Scalar,Dynamic,1> Vector;
+    typedef Matrix<RealScalar,Dynamic,1> RealVector;
+    typedef SparseMatrix<Scalar,RowMajor> LevelMatrix;
+    typedef typename LevelMatrix::Index Index;
+
+    struct Level
+    {
+      LevelMatrix A;          // the operator of this level
+      LevelMatrix P;          // the prolongator to this level from the next coarser one
+      LevelMatrix R;          // the restriction P^* from this level to the next coarser one
+      Vector invDiag;         // the inverse of the diagonal of A
+      RealScalar omega;       // the Jacobi damping factor
+    };
+
+  public:
+    // this typedef is only to export the scalar type and compile-time dimensions to solve_retval
+    typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+
+    SmoothedAggregationAMG()
+      : m_theta(0.08), m_maxLevels(10), m_maxCoarseSize(100), m_smoother(JacobiSmoother), m_sweeps(1),
+        m_directCoarse(false), m_isInitialized(false), m_info(Success)
+    {}
+
+    template<typename MatType>
+    SmoothedAggregationAMG(const MatType& mat)
+      : m_theta(0.08), m_maxLevels(10), m_maxCoarseSize(100), m_smoother(JacobiSmoother), m_sweeps(1),
+        m_directCoarse(false), m_isInitialized(false), m_info(Success)
+    {
+      compute(mat);
+    }
+
+    Index rows() const { return m_levels.empty() ? 0 : m_levels.front().A.rows(); }
+    Index cols() const { return rows(); }
+
+    /** Sets the threshold \f$ \theta \f$ of the strength of connection test \f$ |a_{ij}| \geq \theta \sqrt{|a_{ii} a_{jj}|} \f$ (default is 0.08).
+      * Larger values lead to smaller aggregates, hence to more levels and more expensive but more efficient V-cycles. */
+    SmoothedAggregationAMG& setStrengthThreshold(const RealScalar& theta) { m_theta = theta; return *this; }
+
+    /** Sets the maximal number of levels of the hierarchy, the fine level included (default is 10). */
+    SmoothedAggregationAMG& setMaxLevels(Index maxLevels) { eigen_assert(maxLevels>0); m_maxLevels = maxLevels; return *this; }
+
+    /** Sets the size below which an operator is solved directly instead of being coarsened further (default is 100).
+      * Larger operators are never factorized. */
+    SmoothedAggregationAMG& setMaxCoarseSize(Index maxCoarseSize) { m_maxCoarseSize = maxCoarseSize; return *this; }
+
+    /** Selects the smoother applied on each level of the V-cycle (default is JacobiSmoother). */
+    SmoothedAggregationAMG& setSmoother(AMGSmootherType smoother) { m_smoother = smoother; return *this; }
+
+    /** Sets the number of pre- and post-smoothing sweeps (default is 1). */
+    SmoothedAggregationAMG& setSmootherSweeps(Index sweeps) { m_sweeps = sweeps; return *this; }
+
+    /** \returns the maximal size of the coarsest operator */
+    Index maxCoarseSize() const { return m_maxCoarseSize; }
+
+    /** \returns the number of levels of the hierarchy built by the last call to compute(), the fine level included */
+    Index levels() const { return Index(m_levels.size()); }
+
+    /** \returns the sum of the number of nonzeros of the operators of all levels divided by the one of the input matrix */
+    RealScalar operatorComplexity() const
+    {
+      eigen_assert(m_isInitialized && "SmoothedAggregationAMG is not initialized.");
+      RealScalar nnz(0);
+      for(std::size_t l=0; l<m_levels.size(); ++l)
+        nnz += RealScalar(m_levels[l].A.nonZeros());
+      return nnz / RealScalar(m_levels.front().A.nonZeros());
+    }
+
+    template<typename MatType>
+    SmoothedAggregationAMG& analyzePattern(const MatType& )
+    {
+      return *this;
+    }
+
+    template<typename MatType>
+    SmoothedAggregationAMG& factorize(const MatType& mat)
+    {
+      m_levels.clear();
+      m_levels.push_back(Level());
+      m_levels.back().A = mat;
+      m_levels.back().A.makeCompressed();
+
+      while(true)
+      {
+        Level& fine = m_levels.back();
+        setupSmoother(fine);
+        if(fine.A.rows()<=m_maxCoarseSize || levels()>=m_maxLevels)
+          break;
+        LevelMatrix coarse;
+        if(!coarsen(fine, coarse))
+          break;
+        m_levels.push_back(Level());
+        m_levels.back().A.swap(coarse);
+      }
+
+      const LevelMatrix& coarsest = m_levels.back().A;
+      m_directCoarse = coarsest.rows()<=m_maxCoarseSize;
+      if(m_directCoarse)
+        m_coarseSolver.compute(coarsest.toDense());
+      else
+        m_coarseSolver = FullPivLU<MatrixType>();
+      m_info = Map<const Vector>(coarsest.valuePtr(), coarsest.nonZeros()).allFinite() ? Success : NumericalIssue;
+      m_isInitialized = true;
+      return *this;
+    }
+
+    template<typename MatType>
+    SmoothedAggregationAMG& compute(const MatType& mat)
+    {
+      analyzePattern(mat);
+      return factorize(mat);
+    }
+
+    /** \returns \c Success if the hierarchy has been built, and \c NumericalIssue if the operators contain non finite values. */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "SmoothedAggregationAMG is not initialized.");
+      return m_info;
+    }
+
+    template<typename Rhs, typename Dest>
+    void _solve(const Rhs& b, Dest& x) const
+    {
+      Vector bj, xj;
+      for(Index j=0; j<b.cols(); ++j)
+      {
+        bj = b.col(j);
+        vcycle(0, bj, xj);
+        x.col(j) = xj;
+      }
+    }
+
+    template<typename Rhs> inline const internal::solve_retval<SmoothedAggregationAMG, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "SmoothedAggregationAMG is not initialized.");
+      eigen_assert(rows()==b.rows()
+                && "SmoothedAggregationAMG::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<SmoothedAggregationAMG, Rhs>(*this, b.derived());
+    }
+
+  protected:
+
+    /** \internal Computes the inverted diagonal of \a level.A and the Jacobi damping factor \f$ 4/(3\rho) \f$,
+      * where \f$ \rho = \| D^{-1} A \|_\infty \f$ is a cheap upper bound of the spectral radius of \f$ D^{-1} A \f$. */
+    void setupSmoother(Level& level) const
+    {
+      using std::abs;
+      const LevelMatrix& A = level.A;
+      Index n = A.rows();
+      level.invDiag.setOnes(n);
+      RealVector rowSums = RealVector::Zero(n);
+      for(Index i=0; i<n; ++i)
+        for(typename LevelMatrix::InnerIterator it(A,i); it; ++it)
+        {
+          rowSums(i) += abs(it.value());
+          if(it.index()==i && it.value()!=Scalar(0))
+            level.invDiag(i) = Scalar(1)/it.value();
+        }
+      RealScalar rho(0);
+      for(Index i=0; i<n; ++i)
+        rho = (std::max)(rho, rowSums(i) * abs(level.invDiag(i)));
+      level.omega = rho>RealScalar(0) ? RealScalar(4)/(RealScalar(3)*rho) : RealScalar(1);
+    }
+
+    /** \internal Builds the prolongator and restriction of \a fine, and the Galerkin operator \a coarse.
+      * \returns false if the aggregation does not reduce the size of the problem */
+    bool coarsen(Level& fine, LevelMatrix& coarse) const
+    {
+      using std::abs;
+      using std::sqrt;
+      const LevelMatrix& A = fine.A;
+      Index n = A.rows();
+
+      RealVector absDiag(n);
+      for(Index i=0; i<n; ++i)
+        absDiag(i) = abs(Scalar(1)/fine.invDiag(i));
+
+      std::vector<Index> ptr, adj, agg;
+      internal::amg_strength_graph(A, absDiag, m_theta, ptr, adj);
+      Index nc = internal::amg_aggregate(ptr, adj, agg);
+      if(nc==0 || nc>=n)
+        return false;
+
+      // tentative prolongator: the normalized indicator functions of the aggregates
+      std::vector<Index> aggSizes(nc, 0);
+      for(Index i=0; i<n; ++i)
+        ++aggSizes[agg[i]];
+      LevelMatrix T(n, nc);
+      T.reserve(Matrix<Index,Dynamic,1>::Ones(n));
+      for(Index i=0; i<n; ++i)
+        T.insert(i, agg[i]) = Scalar(RealScalar(1)/sqrt(RealScalar(aggSizes[agg[i]])));
+      T.makeCompressed();
+
+      // prolongator smoothing and Galerkin product
+      LevelMatrix AT = A * T;
+      AT = fine.invDiag.asDiagonal() * AT;
+      fine.P = T - Scalar(fine.omega) * AT;
+      fine.R = fine.P.adjoint();
+      LevelMatrix AP = A * fine.P;
+      coarse = fine.R * AP;
+      coarse.makeCompressed();
+      return true;
+    }
+
+    /** \internal Applies \a m_sweeps smoothing iterations to A x = b, forward or \a backward for Gauss-Seidel. */
+    void smooth(const Level& level, const Vector& b, Vector& x, bool backward) const
+    {
+      const LevelMatrix& A = level.A;
+      Index n = A.rows();
+      for(Index s=0; s<m_sweeps; ++s)
+      {
+        if(m_smoother==GaussSeidelSmoother)
+        {
+          for(Index k=0; k<n; ++k)
+          {
+            Index i = backward ? n-1-k : k;
+            Scalar r = b(i);
+            for(typename LevelMatrix::InnerIterator it(A,i); it; ++it)
+              r -= it.value() * x(it.index());
+            x(i) += r * level.invDiag(i);
+          }
+        }
+        else
+        {
+          Vector r = b - A * x;
+          x += Scalar(level.omega) * level.invDiag.cwiseProduct(r);
+        }
+      }
+    }
+
+    /** \internal Approximately solves A_l x = b by one V-cycle starting from the level \a l. */
+    void vcycle(std::size_t l, const Vector& b, Vector& x) const
+    {
+      const Level& level = m_levels[l];
+      x.setZero(b.size());
+      if(l+1==m_levels.size() && m_directCoarse)
+      {
+        x = m_coarseSolver.solve(b);
+        return;
+      }
+      smooth(level, b, x, false);
+      if(l+1==m_levels.size())
+      {
+        smooth(level, b, x, true);
+        return;
+      }
+      Vector r = b - level.A * x;
+      Vector bc = level.R * r;
+      Vector xc;
+      vcycle(l+1, bc, xc);
+      x += level.P * xc;
+      smooth(level, b, x, true);
+    }
+
+    std::vector<Level> m_levels;
+    FullPivLU<MatrixType> m_coarseSolver;
+    bool m_directCoarse;
+    RealScalar m_theta;
+    Index m_maxLevels;
+    Index m_maxCoarseSize;
+    AMGSmootherType m_smoother;
+    Index m_sweeps;
+    bool m_isInitialized;
+    ComputationInfo m_info;
+};
+
+namespace internal {
+
+template<typename _Scalar, typename Rhs>
+struct solve_retval<SmoothedAggregationAMG<_Scalar>, Rhs>
+  : solve_retval_base<SmoothedAggregationAMG<_Scalar>, Rhs>
+{
+  typedef SmoothedAggregationAMG<_Scalar> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_SMOOTHED_AGGREGATION_AMG_H
@@ -0,0 +1,415 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// We used the "New fast and accurate Jacobi SVD algorithm" I and II papers
+// written by Z. Drmac and K. Veselic, and the "Parallel one-sided block
+// Jacobi SVD algorithm" papers written by M. Becka, G. Oksa and M. Vajtersic.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BLOCKJACOBISVD_H
+#define EIGEN_BLOCKJACOBISVD_H
+
+namespace Eigen {
+
+/** \ingroup SVD_Module
+ *
+ *
+ * \class BlockJacobiSVD
+ *
+ * \brief One-sided block Jacobi SVD with parallel sweeps
+ *
+ * \param MatrixType the type of the matrix of which we are computing the SVD decomposition
+ *
+ * This class computes the SVD by the one-sided Jacobi method of Hestenes, preconditioned as proposed by Drmac and
+ * Veselic: the matrix is first reduced by a QR decomposition with column pivoting \f$ A P = Q R \f$, and the columns of
+ * \f$ R^* \f$ are orthogonalized by plane rotations. Like JacobiSVD, it computes the small singular values with a high
+ * relative accuracy, in particular for matrices whose columns are badly scaled.
+ *
+ * The columns are split into blocks of setBlockSize() columns, and the pairs of blocks are processed in a round-robin
+ * ordering such that each round consists of disjoint pairs. The pairs of a round are processed in parallel when
+ * OpenMP is enabled. For each pair, the rotations are computed on the small triangular factor of the block columns and
+ * accumulated into a small orthogonal matrix, which is applied to the columns and to the singular vectors by a matrix
+ * product. Compared to JacobiSVD, which sequentially applies each rotation to full rows and columns, this makes the
+ * decomposition of large matrices cache friendly and scalable.
+ *
+ * \sa class JacobiSVD, class BDCSVD
+ */
+template<typename _MatrixType>
+class BlockJacobiSVD : public SVDBase<_MatrixType>
+{
+  typedef SVDBase<_MatrixType> Base;
+
+public:
+  using Base::rows;
+  using Base::cols;
+
+  typedef _MatrixType MatrixType;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename NumTraits<typename MatrixType::Scalar>::Real RealScalar;
+  typedef typename MatrixType::Index Index;
+  typedef typename Base::MatrixUType MatrixUType;
+  typedef typename Base::MatrixVType MatrixVType;
+  typedef typename Base::SingularValuesType SingularValuesType;
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixX;
+  typedef Matrix<RealScalar, Dynamic, 1> VectorXr;
+
+  /** \brief Default Constructor.
+   *
+   * The default constructor is useful in cases in which the user intends to
+   * perform decompositions via BlockJacobiSVD::compute(const MatrixType&).
+   */
+  BlockJacobiSVD()
+    : SVDBase<_MatrixType>::SVDBase(), m_blockSize(64), m_maxSweeps(30), m_sweeps(0)
+  {}
+
+  /** \brief Default Constructor with memory preallocation
+   *
+   * Like the default constructor but with preallocation of the internal data
+   * according to the specified problem size.
+   * \sa BlockJacobiSVD()
+   */
+  BlockJacobiSVD(Index rows, Index cols, unsigned int computationOptions = 0)
+    : SVDBase<_MatrixType>::SVDBase(), m_blockSize(64), m_maxSweeps(30), m_sweeps(0)
+  {
+    Base::allocate(rows, cols, computationOptions);
+  }
+
+  /** \brief Constructor performing the decomposition of given matrix.
+   *
+   * \param matrix the matrix to decompose
+   * \param computationOptions optional parameter allowing to specify if you want full or thin U or V unitaries to be computed.
+   *                           By default, none is computed. This is a bit-field, the possible bits are #ComputeFullU, #ComputeThinU,
+   *                           #ComputeFullV, #ComputeThinV.
+   *
+   * Thin unitaries are only available if your matrix type has a Dynamic number of columns (for example MatrixXf).
+   */
+  BlockJacobiSVD(const MatrixType& matrix, unsigned int computationOptions = 0)
+    : SVDBase<_MatrixType>::SVDBase(), m_blockSize(64), m_maxSweeps(30), m_sweeps(0)
+  {
+    compute(matrix, computationOptions);
+  }
+
+  /** \brief Method performing the decomposition of given matrix using custom options.
+   *
+   * \param matrix the matrix to decompose
+   * \param computationOptions optional parameter allowing to specify if you want full or thin U or V unitaries to be computed.
+   *                           By default, none is computed. This is a bit-field, the possible bits are #ComputeFullU, #ComputeThinU,
+   *                           #ComputeFullV, #ComputeThinV.
+   *
+   * Thin unitaries are only available if your matrix type has a Dynamic number of columns (for example MatrixXf).
+   */
+  SVDBase<MatrixType>& compute(const MatrixType& matrix, unsigned int computationOptions);
+
+  /** \brief Method performing the decomposition of given matrix using current options.
+   *
+   * \param matrix the matrix to decompose
+   *
+   * This method uses the current \a computationOptions, as already passed to the constructor or to compute(const MatrixType&, unsigned int).
+   */
+  SVDBase<MatrixType>& compute(const MatrixType& matrix)
+  {
+    return compute(matrix, this->m_computationOptions);
+  }
+
+  /** \brief Sets the number of columns of the blocks, the default is 64.
+   *
+   * Matrices with at most this number of columns are decomposed as a single block.
+   */
+  BlockJacobiSVD& setBlockSize(Index blockSize)
+  {
+    eigen_assert(blockSize>0 && "BlockJacobiSVD: the block size must be positive");
+    m_blockSize = blockSize;
+    return *this;
+  }
+
+  /** \returns the number of columns of the blocks */
+  Index blockSize() const { return m_blockSize; }
+
+  /** \brief Sets the maximal number of sweeps over all the pairs of blocks, the default is 30. */
+  BlockJacobiSVD& setMaxSweeps(Index maxSweeps)
+  {
+    m_maxSweeps = maxSweeps;
+    return *this;
+  }
+
+  /** \returns the number of sweeps performed by the last decomposition, the last one being the one without any rotation */
+  Index sweeps() const
+  {
+    eigen_assert(this->m_isInitialized && "BlockJacobiSVD is not initialized.");
+    return m_sweeps;
+  }
+
+  /** \returns a (least squares) solution of \f$ A x = b \f$ using the current SVD decomposition of A.
+   *
+   * \param b the right-hand-side of the equation to solve.
+   *
+   * \note Solving requires both U and V to be computed. Thin U and V are enough, there is no need for full U or V.
+   *
+   * \note SVD solving is implicitly least-squares. Thus, this method serves both purposes of exact solving and least-squares solving.
+   * In other words, the returned solution is guaranteed to minimize the Euclidean norm \f$ \Vert A x - b \Vert \f$.
+   */
+  template<typename Rhs>
+  inline const internal::solve_retval<BlockJacobiSVD, Rhs>
+  solve(const MatrixBase<Rhs>& b) const
+  {
+    eigen_assert(this->m_isInitialized && "BlockJacobiSVD is not initialized.");
+    eigen_assert(Base::computeU() && Base::computeV() &&
+                 "BlockJacobiSVD::solve() requires both unitaries U and V to be computed (thin unitaries suffice).");
+    return internal::solve_retval<BlockJacobiSVD, Rhs>(*this, b.derived());
+  }
+
+protected:
+  bool orthogonalizeBlocks(MatrixX& W, MatrixX* J, Index c0, Index s0, Index c1, Index s1, RealScalar tol,
+                           Index innerSweeps) const;
+
+  Index m_blockSize;
+  Index m_maxSweeps;
+  Index m_sweeps;
+};
+
+/** \internal
+  * Orthogonalizes the columns c0..c0+s0-1 and c1..c1+s1-1 of \a W, and applies the same transformation to the columns
+  * of \a J if not null. The rotations are computed on the triangular factor of the block columns by at most
+  * \a innerSweeps cyclic sweeps, and applied at once.
+  * \returns true if any rotation has been applied
+  */
+template<typename MatrixType>
+bool BlockJacobiSVD<MatrixType>::orthogonalizeBlocks(MatrixX& W, MatrixX* J, Index c0, Index s0, Index c1, Index s1,
+                                                     RealScalar tol, Index innerSweeps) const
+{
+  using std::abs;
+  using std::sqrt;
+  const RealScalar considerAsZero = (std::numeric_limits<RealScalar>::min)();
+  const Index s = s0+s1;
+  MatrixX Wb(W.rows(), s);
+  Wb.leftCols(s0) = W.middleCols(c0, s0);
+  Wb.rightCols(s1) = W.middleCols(c1, s1);
+
+  // cheap convergence test on the Gram matrix, which is the common case in the last sweeps
+  MatrixX G(s, s);
+  G.noalias() = Wb.adjoint() * Wb;
+  bool orthogonal = true;
+  for(Index q=1; q<s && orthogonal; ++q)
+    for(Index p=0; p<q; ++p)
+    {
+      RealScalar a = numext::real(G.coeff(p,p)), b = numext::real(G.coeff(q,q));
+      if(a>considerAsZero && b>considerAsZero && abs(G.coeff(p,q)) > tol * sqrt(a) * sqrt(b))
+      {
+        orthogonal = false;
+        break;
+      }
+    }
+  if(orthogonal)
+    return false;
+
+  // cyclic one-sided Jacobi on the columns of the triangular factor, which have the same Gram matrix as Wb
+  HouseholderQR<MatrixX> qr(Wb);
+  const Index r = (std::min)(W.rows(), s);
+  MatrixX R = qr.matrixQR().topRows(r).template triangularView<Upper>();
+  MatrixX Vb = MatrixX::Identity(s, s);
+  bool rotated = false;
+  for(Index sweep=0; sweep<innerSweeps; ++sweep)
+  {
+    bool finished = true;
+    for(Index p=0; p<s; ++p)
+      for(Index q=p+1; q<s; ++q)
+      {
+        RealScalar a = R.col(p).squaredNorm(), b = R.col(q).squaredNorm();
+        Scalar c = R.col(p).dot(R.col(q));
+        if(a>considerAsZero && b>considerAsZero && abs(c) > tol * sqrt(a) * sqrt(b))
+        {
+          JacobiRotation<Scalar> rot;
+          rot.makeJacobi(a, c, b);
+          R.applyOnTheRight(p, q, rot);
+          Vb.applyOnTheRight(p, q, rot);
+          finished = false;
+          rotated = true;
+        }
+      }
+    if(finished)
+      break;
+  }
+  if(!rotated)
+    return false;
+
+  // the rotated block columns are Q R Vb: applying the orthogonal factor Q = I - V T V^* to the rotated triangular
+  // factor, rather than Vb to the block columns, preserves the relative accuracy of the columns of small norm
+  MatrixX V = qr.matrixQR().leftCols(r);
+  MatrixX T(r, r);
+  internal::make_block_householder_triangular_factor(T, V, qr.hCoeffs().head(r).conjugate());
+  Wb.setZero();
+  Wb.topRows(r) = R;
+  MatrixX tmp = V.template triangularView<UnitLower>().adjoint() * Wb;
+  tmp = T.template triangularView<Upper>() * tmp;
+  Wb.noalias() -= V.template triangularView<UnitLower>() * tmp;
+  W.middleCols(c0, s0) = Wb.leftCols(s0);
+  W.middleCols(c1, s1) = Wb.rightCols(s1);
+  if(J)
+  {
+    MatrixX Jb(J->rows(), s);
+    Jb.leftCols(s0) = J->middleCols(c0, s0);
+    Jb.rightCols(s1) = J->middleCols(c1, s1);
+    Jb = Jb * Vb;
+    J->middleCols(c0, s0) = Jb.leftCols(s0);
+    J->middleCols(c1, s1) = Jb.rightCols(s1);
+  }
+  return true;
+}
+
+template<typename MatrixType>
+SVDBase<MatrixType>&
+BlockJacobiSVD<MatrixType>::compute(const MatrixType& matrix, unsigned int computationOptions)
+{
+  using std::abs;
+  using std::sqrt;
+  Base::allocate(matrix.rows(), matrix.cols(), computationOptions);
+  m_sweeps = 0;
+
+  // work on the adjoint of wide matrices, such that A is m x n with m >= n
+  const bool transposed = matrix.cols() > matrix.rows();
+  MatrixX A = transposed ? MatrixX(matrix.adjoint()) : MatrixX(matrix);
+  const Index m = A.rows();
+  const Index n = A.cols();
+  // the left singular vectors of A are obtained by accumulating the rotations, the right ones from the columns
+  const bool computeLeft = transposed ? this->computeV() : this->computeU();
+  const bool computeRight = transposed ? this->computeU() : this->computeV();
+  const bool fullLeft = transposed ? this->m_computeFullV : this->m_computeFullU;
+
+  // scale the matrix to avoid overflows in the squared norms
+  RealScalar scale = A.cwiseAbs().maxCoeff();
+  if(scale==RealScalar(0) || !(numext::isfinite)(scale))
+    scale = RealScalar(1);
+  A /= scale;
+
+  // step 1: QR decomposition with column pivoting A P = Q R, and W = R^*
+  ColPivHouseholderQR<MatrixX> qr(A);
+  MatrixX W = qr.matrixQR().topRows(n).template triangularView<Upper>().adjoint();
+  MatrixX J;
+  if(computeLeft)
+    J.setIdentity(n, n);
+
+  // step 2: one-sided Jacobi sweeps over the pairs of column blocks, W J = X with orthogonal columns
+  const RealScalar tol = NumTraits<RealScalar>::epsilon() * RealScalar(m);
+  const Index bs = (std::max)(Index(1), (std::min)(m_blockSize, n));
+  const Index nbBlocks = n>0 ? (n + bs - 1) / bs : 0;
+  const Index nbPlayers = nbBlocks + (nbBlocks % 2);  // a dummy block is added to get an even number of blocks
+  MatrixX* Jptr = computeLeft ? &J : 0;
+  // a single inner sweep per pair of blocks is enough to get the same number of outer sweeps than a full
+  // diagonalization of the pair, except when all the columns fit in a single block
+  const Index innerSweeps = nbBlocks>1 ? 1 : m_maxSweeps;
+  for(m_sweeps=0; m_sweeps<m_maxSweeps && nbPlayers>0;)
+  {
+    ++m_sweeps;
+    int rotatedPairs = 0;
+    // round-robin ordering: in each round the pairs of blocks are disjoint and processed in parallel
+    for(Index round=0; round<nbPlayers-1; ++round)
+    {
+      const int nbPairs = int(nbPlayers/2);
+      #ifdef EIGEN_HAS_OPENMP
+      #pragma omp parallel for reduction(+:rotatedPairs) schedule(dynamic,1) num_threads(nbThreads()) if(nbPairs>1 && n>=4*bs)
+      #endif
+      for(int k=0; k<nbPairs; ++k)
+      {
+        Index b0 = k==0 ? 0 : 1 + (round + k) % (nbPlayers-1);
+        Index b1 = k==0 ? 1 + round : 1 + (round - k + nbPlayers - 1) % (nbPlayers-1);
+        if(b0>=nbBlocks) std::swap(b0, b1);
+        const Index c0 = b0*bs, s0 = (std::min)(bs, n-c0);
+        const Index c1 = b1<nbBlocks ? b1*bs : 0, s1 = b1<nbBlocks ? (std::min)(bs, n-c1) : 0;
+        if(orthogonalizeBlocks(W, Jptr, c0, s0, c1, s1, tol, innerSweeps))
+          ++rotatedPairs;
+      }
+    }
+    if(rotatedPairs==0)
+      break;
+  }
+
+  // step 3: the singular values are the norms of the columns, sorted in decreasing order
+  VectorXr norms(n);
+  for(Index i=0; i<n; ++i)
+    norms.coeffRef(i) = W.col(i).norm();
+  Matrix<Index, Dynamic, 1> order(n);
+  for(Index i=0; i<n; ++i)
+    order.coeffRef(i) = i;
+  for(Index i=1; i<n; ++i)
+  {
+    Index p = order.coeff(i), j = i;
+    for(; j>0 && norms.coeff(order.coeff(j-1)) < norms.coeff(p); --j)
+      order.coeffRef(j) = order.coeff(j-1);
+    order.coeffRef(j) = p;
+  }
+  this->m_nonzeroSingularValues = 0;
+  for(Index i=0; i<n; ++i)
+  {
+    RealScalar sv = norms.coeff(order.coeff(i));
+    this->m_singularValues.coeffRef(i) = scale * sv;
+    if(sv>RealScalar(0))
+      ++this->m_nonzeroSingularValues;
+  }
+
+  if(computeLeft)
+  {
+    // Q [J; 0] or Q diag(J, I)
+    MatrixX L = MatrixX::Identity(m, fullLeft ? m : n);
+    for(Index i=0; i<n; ++i)
+      L.col(i).head(n) = J.col(order.coeff(i));
+    L.applyOnTheLeft(qr.householderQ());
+    if(transposed) this->m_matrixV = L;
+    else           this->m_matrixU = L;
+  }
+  if(computeRight)
+  {
+    // P X Sigma^-1, completed to an orthonormal basis for the zero singular values
+    const Index nz = this->m_nonzeroSingularValues;
+    MatrixX X(n, n);
+    for(Index i=0; i<nz; ++i)
+      X.col(i) = W.col(order.coeff(i)) / norms.coeff(order.coeff(i));
+    if(nz<n)
+    {
+      HouseholderQR<MatrixX> complement(X.leftCols(nz));
+      MatrixX Qc = complement.householderQ();
+      X.rightCols(n-nz) = Qc.rightCols(n-nz);
+    }
+    X.applyOnTheLeft(qr.colsPermutation());
+    if(transposed) this->m_matrixU = X;
+    else           this->m_matrixV = X;
+  }
+
+  this->m_isInitialized = true;
+  return *this;
+}
+
+namespace internal {
+
+template<typename _MatrixType, typename Rhs>
+struct solve_retval<BlockJacobiSVD<_MatrixType>, Rhs>
+  : solve_retval_base<BlockJacobiSVD<_MatrixType>, Rhs>
+{
+  typedef BlockJacobiSVD<_MatrixType> SVDType;
+  EIGEN_MAKE_SOLVE_HELPERS(SVDType, Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    eigen_assert(rhs().rows() == dec().rows());
+    // A = U S V^*
+    // So A^{-1} = V S^{-1} U^*
+    Index diagSize = (std::min)(dec().rows(), dec().cols());
+    typename SVDType::SingularValuesType invertedSingVals(diagSize);
+    Index nonzeroSingVals = dec().nonzeroSingularValues();
+    invertedSingVals.head(nonzeroSingVals) = dec().singularValues().head(nonzeroSingVals).array().inverse();
+    invertedSingVals.tail(diagSize - nonzeroSingVals).setZero();
+
+    dst = dec().matrixV().leftCols(diagSize)
+      * invertedSingVals.asDiagonal()
+      * dec().matrixU().leftCols(diagSize).adjoint()
+      * rhs();
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_BLOCKJACOBISVD_H
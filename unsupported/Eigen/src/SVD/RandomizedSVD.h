@@ -0,0 +1,248 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// We used the "Finding structure with randomness: Probabilistic algorithms
+// for constructing approximate matrix decompositions" paper written by
+// N. Halko, P. G. Martinsson and J. A. Tropp.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_RANDOMIZEDSVD_H
+#define EIGEN_RANDOMIZEDSVD_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal
+  * Overwrites the n x l matrix \a Y with an orthonormal basis of its range, using a thin Householder QR.
+  */
+template<typename MatrixType>
+void randomized_svd_orthonormalize(MatrixType& Y)
+{
+  typedef typename MatrixType::Index Index;
+  const Index rows = Y.rows();
+  const Index cols = Y.cols();
+  HouseholderQR<MatrixType> qr(Y);
+  Y.setIdentity(rows, cols);
+  qr.householderQ().applyThisOnTheLeft(Y);
+}
+
+} // end namespace internal
+
+/** \ingroup SVD_Module
+  *
+  *
+  * \class RandomizedSVD
+  *
+  * \brief Randomized truncated SVD of a large matrix or linear operator
+  *
+  * \param _MatrixType the type of the operator of which we are computing the truncated SVD decomposition
+  *
+  * This class computes an approximation of the \a k dominant singular triplets of a n-by-p operator \a A:
+  *   \f[ A \approx U_k S_k V_k^* \f]
+  * where \a U_k is n-by-k and \a V_k is p-by-k, both with orthonormal columns, and \a S_k holds the \a k largest singular values
+  * sorted in decreasing order.
+  *
+  * The algorithm is the randomized range finder of Halko, Martinsson and Tropp:
+  *  -# a n-by-(k+p) orthonormal basis \a Q of the range of \a A is found from the product of \a A with a random matrix,
+  *     where \a p is the oversampling parameter (see setOversampling()),
+  *  -# the basis is optionally refined by a few power iterations, i.e., by repeated products with \a A and \a A^*
+  *     (see setPowerIterations()), which is recommended when the singular values decay slowly,
+  *  -# the small matrix \f$ B = Q^* A \f$ is decomposed using JacobiSVD, and the singular vectors of \a A are
+  *     recovered from the ones of \a B.
+  *
+  * All the products involve a block of k+p vectors at once, such that for dense operators the cost is dominated by
+  * matrix-matrix products. The orthonormalizations are performed by HouseholderQR.
+  *
+  * The type \a _MatrixType does not need to be a dense matrix. It only has to provide:
+  *  - the typedefs \c Scalar and \c Index,
+  *  - the \c rows() and \c cols() methods,
+  *  - the product with a dense matrix via \c operator*,
+  *  - an \c adjoint() method returning an expression supporting the same product.
+  *
+  * This is the case of dense matrices, SparseMatrix and their expressions, and matrix-free operators can be used
+  * the same way by implementing this small interface.
+  *
+  * Example:
+  * \code
+  * SparseMatrix<double> A = ...;
+  * RandomizedSVD<SparseMatrix<double> > rsvd;
+  * rsvd.setOversampling(10).setPowerIterations(2);
+  * rsvd.compute(A, 20, ComputeThinU | ComputeThinV);
+  * MatrixXd U = rsvd.matrixU();
+  * \endcode
+  *
+  * \sa class JacobiSVD, class BDCSVD
+  */
+template<typename _MatrixType>
+class RandomizedSVD
+{
+  public:
+
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrixType;
+    typedef DenseMatrixType MatrixUType;
+    typedef DenseMatrixType MatrixVType;
+    typedef Matrix<RealScalar, Dynamic, 1> SingularValuesType;
+
+    /** \brief Default Constructor.
+      *
+      * The default constructor is useful in cases in which the user intends to
+      * perform decompositions via RandomizedSVD::compute(const MatrixType&, Index, unsigned int).
+      */
+    RandomizedSVD()
+      : m_oversampling(10), m_powerIterations(1), m_rank(0),
+        m_isInitialized(false), m_computeU(false), m_computeV(false)
+    {}
+
+    /** \brief Constructor performing the decomposition of given operator.
+      *
+      * \param mat the operator to decompose
+      * \param rank the number \a k of singular triplets to compute
+      * \param computationOptions optional parameter allowing to specify if you want the \a U and \a V singular vectors to be computed.
+      *                           By default, none is computed. This is a bit-field, the possible bits are #ComputeThinU and #ComputeThinV.
+      */
+    RandomizedSVD(const MatrixType& mat, Index rank, unsigned int computationOptions = 0)
+      : m_oversampling(10), m_powerIterations(1), m_rank(0),
+        m_isInitialized(false), m_computeU(false), m_computeV(false)
+    {
+      compute(mat, rank, computationOptions);
+    }
+
+    /** \brief Method performing the decomposition of given operator.
+      *
+      * \param mat the operator to decompose
+      * \param rank the number \a k of singular triplets to compute
+      * \param computationOptions optional parameter allowing to specify if you want the \a U and \a V singular vectors to be computed.
+      *                           By default, none is computed. This is a bit-field, the possible bits are #ComputeThinU and #ComputeThinV.
+      */
+    RandomizedSVD& compute(const MatrixType& mat, Index rank, unsigned int computationOptions = 0);
+
+    /** Sets the number \a p of extra random samples used to find the range of the operator (default is 10).
+      *
+      * The search space has dimension \a k + \a p. Larger values improve the accuracy at the price of larger products.
+      */
+    RandomizedSVD& setOversampling(Index p)
+    {
+      eigen_assert(p>=0 && "RandomizedSVD: the oversampling must be non negative");
+      m_oversampling = p;
+      return *this;
+    }
+
+    /** Sets the number \a q of power iterations (default is 1).
+      *
+      * Each power iteration costs one product with the operator and one with its adjoint, and makes the
+      * approximation error decay as the ratio of the singular values to the power 2q+1.
+      */
+    RandomizedSVD& setPowerIterations(Index q)
+    {
+      eigen_assert(q>=0 && "RandomizedSVD: the number of power iterations must be non negative");
+      m_powerIterations = q;
+      return *this;
+    }
+
+    /** \returns the number of extra random samples */
+    Index oversampling() const { return m_oversampling; }
+
+    /** \returns the number of power iterations */
+    Index powerIterations() const { return m_powerIterations; }
+
+    /** \returns the number of computed singular triplets */
+    Index rank() const
+    {
+      eigen_assert(m_isInitialized && "RandomizedSVD is not initialized.");
+      return m_rank;
+    }
+
+    /** \returns the n-by-k matrix of the left singular vectors.
+      *
+      * This method asserts that you asked for \a U to be computed.
+      */
+    const MatrixUType& matrixU() const
+    {
+      eigen_assert(m_isInitialized && "RandomizedSVD is not initialized.");
+      eigen_assert(m_computeU && "This RandomizedSVD decomposition didn't compute U. Did you ask for it?");
+      return m_matrixU;
+    }
+
+    /** \returns the p-by-k matrix of the right singular vectors.
+      *
+      * This method asserts that you asked for \a V to be computed.
+      */
+    const MatrixVType& matrixV() const
+    {
+      eigen_assert(m_isInitialized && "RandomizedSVD is not initialized.");
+      eigen_assert(m_computeV && "This RandomizedSVD decomposition didn't compute V. Did you ask for it?");
+      return m_matrixV;
+    }
+
+    /** \returns the vector of the \a k largest singular values, sorted in decreasing order. */
+    const SingularValuesType& singularValues() const
+    {
+      eigen_assert(m_isInitialized && "RandomizedSVD is not initialized.");
+      return m_singularValues;
+    }
+
+  protected:
+    MatrixUType m_matrixU;
+    MatrixVType m_matrixV;
+    SingularValuesType m_singularValues;
+    Index m_oversampling, m_powerIterations, m_rank;
+    bool m_isInitialized, m_computeU, m_computeV;
+};
+
+template<typename MatrixType>
+RandomizedSVD<MatrixType>&
+RandomizedSVD<MatrixType>::compute(const MatrixType& mat, Index rank, unsigned int computationOptions)
+{
+  eigen_assert(rank>=0 && "RandomizedSVD: the rank must be non negative");
+  eigen_assert(!(computationOptions & (ComputeFullU|ComputeFullV)) &&
+               "RandomizedSVD: only thin U and V are available");
+
+  const Index rows = mat.rows();
+  const Index cols = mat.cols();
+  const Index diagSize = (std::min)(rows, cols);
+
+  m_computeU = (computationOptions & ComputeThinU) != 0;
+  m_computeV = (computationOptions & ComputeThinV) != 0;
+  m_rank = (std::min)(rank, diagSize);
+  // dimension of the search space
+  const Index l = (std::min)(m_rank + m_oversampling, diagSize);
+
+  // Stage A: find an orthonormal basis Q of the range of mat
+  DenseMatrixType Q(rows, l), Z(cols, l);
+  Z.setRandom();
+  Q.noalias() = mat * Z;
+  internal::randomized_svd_orthonormalize(Q);
+  for(Index i=0; i<m_powerIterations; ++i)
+  {
+    // orthonormalize after each product to avoid the loss of the smallest singular values
+    Z.noalias() = mat.adjoint() * Q;
+    internal::randomized_svd_orthonormalize(Z);
+    Q.noalias() = mat * Z;
+    internal::randomized_svd_orthonormalize(Q);
+  }
+
+  // Stage B: SVD of the small matrix B = Q^* mat, that is B^* = mat^* Q
+  Z.noalias() = mat.adjoint() * Q;
+  JacobiSVD<DenseMatrixType> svd(Z, (m_computeU ? ComputeThinV : 0) | (m_computeV ? ComputeThinU : 0));
+
+  m_singularValues = svd.singularValues().head(m_rank);
+  if(m_computeU)
+    m_matrixU.noalias() = Q * svd.matrixV().leftCols(m_rank);
+  if(m_computeV)
+    m_matrixV = svd.matrixU().leftCols(m_rank);
+
+  m_isInitialized = true;
+  return *this;
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_RANDOMIZEDSVD_H
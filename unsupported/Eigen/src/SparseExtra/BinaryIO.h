@@ -0,0 +1,509 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BINARY_IO_H
+#define EIGEN_BINARY_IO_H
+
+namespace Eigen {
+
+namespace internal {
+
+/* The binary format starts with a 64 bytes header, followed by the coefficients of a dense matrix
+ * in its storage order, or by the outer indices, the inner indices and the values of a compressed
+ * sparse matrix. Each array starts on a 64 bytes boundary, such that a mapped file gives aligned pointers.
+ * The numbers are stored in the byte order of the writer, which is checked when reading.
+ */
+struct binary_matrix_header
+{
+  char magic[8];          // "EIGENBIN"
+  unsigned int byteOrder; // binary_byte_order in the byte order of the writer
+  unsigned int version;
+  unsigned int scalarCode;
+  unsigned int scalarSize;
+  unsigned int indexSize; // size of the indices of a sparse matrix, 0 for a dense matrix
+  unsigned int flags;     // RowMajorBit for a row major storage
+  unsigned int rows[2];   // 64 bits sizes, low word first
+  unsigned int cols[2];
+  unsigned int nnz[2];
+  unsigned int reserved[2];
+};
+
+enum {
+  binary_byte_order = 0x01020304,
+  binary_version = 1,
+  binary_alignment = 64
+};
+
+// The code identifying the scalar type in the header, together with its size.
+template<typename Scalar> struct binary_scalar_code;
+
+#define EIGEN_BINARY_SCALAR_CODE(TYPE,CODE) \
+  template<> struct binary_scalar_code<TYPE> { enum { value = CODE }; };
+
+EIGEN_BINARY_SCALAR_CODE(float, 1)
+EIGEN_BINARY_SCALAR_CODE(double, 2)
+EIGEN_BINARY_SCALAR_CODE(long double, 3)
+EIGEN_BINARY_SCALAR_CODE(std::complex<float>, 4)
+EIGEN_BINARY_SCALAR_CODE(std::complex<double>, 5)
+EIGEN_BINARY_SCALAR_CODE(std::complex<long double>, 6)
+EIGEN_BINARY_SCALAR_CODE(signed char, 7)
+EIGEN_BINARY_SCALAR_CODE(unsigned char, 8)
+EIGEN_BINARY_SCALAR_CODE(short, 9)
+EIGEN_BINARY_SCALAR_CODE(unsigned short, 10)
+EIGEN_BINARY_SCALAR_CODE(int, 11)
+EIGEN_BINARY_SCALAR_CODE(unsigned int, 12)
+EIGEN_BINARY_SCALAR_CODE(long, 13)
+EIGEN_BINARY_SCALAR_CODE(unsigned long, 14)
+EIGEN_BINARY_SCALAR_CODE(half, 15)
+EIGEN_BINARY_SCALAR_CODE(bfloat16, 16)
+
+#undef EIGEN_BINARY_SCALAR_CODE
+
+inline void binary_set_size(unsigned int* words, std::size_t size)
+{
+  words[0] = static_cast<unsigned int>(size & 0xffffffffu);
+  // two shifts, since a single shift by 32 is undefined for 32 bits size_t
+  words[1] = static_cast<unsigned int>(((size >> 16) >> 16) & 0xffffffffu);
+}
+
+inline std::size_t binary_get_size(const unsigned int* words)
+{
+  return std::size_t(words[0]) | ((std::size_t(words[1]) << 16) << 16);
+}
+
+inline std::size_t binary_align(std::size_t offset)
+{
+  return (offset + binary_alignment - 1) / binary_alignment * binary_alignment;
+}
+
+template<typename Scalar>
+binary_matrix_header binary_make_header(std::size_t rows, std::size_t cols, std::size_t nnz, unsigned int indexSize, bool rowMajor)
+{
+  EIGEN_STATIC_ASSERT(int(sizeof(binary_matrix_header))==int(binary_alignment) && sizeof(unsigned int)==4,
+                      EIGEN_INTERNAL_ERROR_PLEASE_FILE_A_BUG_REPORT)
+  binary_matrix_header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, "EIGENBIN", 8);
+  header.byteOrder = binary_byte_order;
+  header.version = binary_version;
+  header.scalarCode = binary_scalar_code<Scalar>::value;
+  header.scalarSize = sizeof(Scalar);
+  header.indexSize = indexSize;
+  header.flags = rowMajor ? RowMajorBit : 0;
+  binary_set_size(header.rows, rows);
+  binary_set_size(header.cols, cols);
+  binary_set_size(header.nnz, nnz);
+  return header;
+}
+
+// moves \a end past an array of \a count elements of \a elementSize bytes, if it ends before \a size
+inline bool binary_skip_array(std::size_t& end, std::size_t count, std::size_t elementSize, std::size_t size)
+{
+  // the divisions avoid the overflows of the products
+  if(end > size || (elementSize!=0 && count > (size - end) / elementSize))
+    return false;
+  end += count * elementSize;
+  return true;
+}
+
+// \returns whether the first \a size bytes of a file hold a valid header, and the arrays it announces
+inline bool binary_check_header(const binary_matrix_header& header, std::size_t size)
+{
+  if(size < sizeof(binary_matrix_header) || std::memcmp(header.magic, "EIGENBIN", 8)!=0
+     || header.byteOrder!=binary_byte_order || header.version!=binary_version || header.scalarSize==0)
+    return false;
+  // the sizes above 2^32 cannot be represented by a 32 bits size_t
+  const std::size_t highWord = (std::size_t(-1) >> 16) >> 16;
+  if(highWord==0 && (header.rows[1]!=0 || header.cols[1]!=0 || header.nnz[1]!=0))
+    return false;
+  const std::size_t rows = binary_get_size(header.rows), cols = binary_get_size(header.cols), nnz = binary_get_size(header.nnz);
+  std::size_t end = sizeof(binary_matrix_header);
+  if(header.indexSize==0)
+    return (cols==0 || rows <= std::size_t(-1) / cols) && binary_skip_array(end, rows * cols, header.scalarSize, size);
+  const std::size_t outerSize = (header.flags & RowMajorBit) ? rows : cols;
+  if(outerSize==std::size_t(-1) || !binary_skip_array(end, outerSize+1, header.indexSize, size))
+    return false;
+  end = binary_align(end);
+  if(!binary_skip_array(end, nnz, header.indexSize, size))
+    return false;
+  end = binary_align(end);
+  return binary_skip_array(end, nnz, header.scalarSize, size);
+}
+
+// \returns whether the sizes of the header can be represented by \a Index
+template<typename Index>
+inline bool binary_fits_index(const binary_matrix_header& header)
+{
+  const std::size_t highest = std::size_t(NumTraits<Index>::highest());
+  return binary_get_size(header.rows) <= highest && binary_get_size(header.cols) <= highest
+      && binary_get_size(header.nnz) <= highest;
+}
+
+// \returns whether the outer indices increase from 0 to \a nnz, and the inner indices are in [0,innerSize)
+template<typename Index>
+bool binary_check_indices(const Index* outer, const Index* inner, std::size_t outerSize, std::size_t innerSize, std::size_t nnz)
+{
+  if(outer[0]!=0 || std::size_t(outer[outerSize])!=nnz)
+    return false;
+  for(std::size_t j=0; j<outerSize; ++j)
+    if(outer[j+1] < outer[j])
+      return false;
+  for(std::size_t k=0; k<nnz; ++k)
+    if(inner[k] < 0 || std::size_t(inner[k]) >= innerSize)
+      return false;
+  return true;
+}
+
+// checks the index arrays of the file mapped at \a data, whose indices are of type \a Index
+template<typename Index>
+bool binary_check_mapped_indices(const char* data)
+{
+  const binary_matrix_header& header = *reinterpret_cast<const binary_matrix_header*>(data);
+  if(!binary_fits_index<Index>(header))
+    return false;
+  const bool rowMajor = (header.flags & RowMajorBit)!=0;
+  const std::size_t rows = binary_get_size(header.rows), cols = binary_get_size(header.cols), nnz = binary_get_size(header.nnz);
+  const std::size_t outerSize = rowMajor ? rows : cols;
+  const std::size_t offset = binary_align(sizeof(binary_matrix_header) + (outerSize+1) * sizeof(Index));
+  return binary_check_indices(reinterpret_cast<const Index*>(data + sizeof(binary_matrix_header)),
+                              reinterpret_cast<const Index*>(data + offset), outerSize, rowMajor ? cols : rows, nnz);
+}
+
+// checks the index arrays of the sparse matrix of a mapped file, of any supported index type
+inline bool binary_check_mapped_sparse(const char* data)
+{
+  const unsigned int indexSize = reinterpret_cast<const binary_matrix_header*>(data)->indexSize;
+  if(indexSize==sizeof(short))
+    return binary_check_mapped_indices<short>(data);
+  if(indexSize==sizeof(int))
+    return binary_check_mapped_indices<int>(data);
+  if(indexSize==sizeof(std::ptrdiff_t))
+    return binary_check_mapped_indices<std::ptrdiff_t>(data);
+  return false;
+}
+
+inline void binary_write_padding(std::ofstream& out, std::size_t& offset)
+{
+  static const char zeros[binary_alignment] = {0};
+  const std::size_t aligned = binary_align(offset);
+  out.write(zeros, aligned - offset);
+  offset = aligned;
+}
+
+template<typename T>
+inline void binary_write_array(std::ofstream& out, std::size_t& offset, const T* data, std::size_t size)
+{
+  binary_write_padding(out, offset);
+  out.write(reinterpret_cast<const char*>(data), size * sizeof(T));
+  offset += size * sizeof(T);
+}
+
+inline bool binary_read_header(std::ifstream& in, binary_matrix_header& header)
+{
+  in.seekg(0, std::ios::end);
+  const std::size_t size = static_cast<std::size_t>(in.tellg());
+  in.seekg(0, std::ios::beg);
+  if(size < sizeof(binary_matrix_header))
+    return false;
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+  return in.good() && binary_check_header(header, size);
+}
+
+// reads the arrays of a compressed sparse matrix of the storage order of the file
+template<typename SparseMatrixType>
+bool binary_read_sparse(std::ifstream& in, SparseMatrixType& mat, typename SparseMatrixType::Index rows,
+                        typename SparseMatrixType::Index cols, typename SparseMatrixType::Index nnz)
+{
+  typedef typename SparseMatrixType::Index Index;
+  typedef typename SparseMatrixType::Scalar Scalar;
+  mat.resize(rows, cols);
+  mat.resizeNonZeros(nnz);
+  std::size_t offset = sizeof(binary_matrix_header) + (mat.outerSize()+1) * sizeof(Index);
+  in.read(reinterpret_cast<char*>(mat.outerIndexPtr()), (mat.outerSize()+1) * sizeof(Index));
+  in.seekg(binary_align(offset), std::ios::beg);
+  offset = binary_align(offset) + nnz * sizeof(Index);
+  in.read(reinterpret_cast<char*>(mat.innerIndexPtr()), nnz * sizeof(Index));
+  in.seekg(binary_align(offset), std::ios::beg);
+  in.read(reinterpret_cast<char*>(mat.valuePtr()), nnz * sizeof(Scalar));
+  return in.good() && binary_check_indices(mat.outerIndexPtr(), mat.innerIndexPtr(), mat.outerSize(), mat.innerSize(), nnz);
+}
+
+template<typename Scalar>
+inline bool binary_has_scalar_type(const binary_matrix_header& header)
+{
+  return header.scalarCode==unsigned(binary_scalar_code<Scalar>::value) && header.scalarSize==sizeof(Scalar);
+}
+
+} // end namespace internal
+
+/** \ingroup SparseExtra_Module
+  * Saves the dense matrix \a mat into the binary file \a filename, in its storage order.
+  * \returns false if the file could not be written.
+  * \sa loadBinary(), class MappedMatrixFile
+  */
+template<typename Derived>
+bool saveBinary(const DenseBase<Derived>& mat, const std::string& filename)
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename internal::eval<Derived>::type EvalType;
+  typedef typename internal::remove_all<EvalType>::type PlainType;
+  EvalType m(mat.derived());
+
+  std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+  if(!out)
+    return false;
+  const internal::binary_matrix_header header = internal::binary_make_header<Scalar>(m.rows(), m.cols(), m.size(), 0, PlainType::IsRowMajor);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(m.data()), m.size() * sizeof(Scalar));
+  return out.good();
+}
+
+/** \ingroup SparseExtra_Module
+  * Saves the sparse matrix \a mat into the binary file \a filename, in its storage order
+  * and in compressed form.
+  * \returns false if the file could not be written.
+  * \sa loadBinary(), class MappedMatrixFile
+  */
+template<typename Scalar, int Options, typename Index>
+bool saveBinary(const SparseMatrix<Scalar,Options,Index>& mat, const std::string& filename)
+{
+  if(!mat.isCompressed())
+  {
+    SparseMatrix<Scalar,Options,Index> compressed(mat);
+    compressed.makeCompressed();
+    return saveBinary(compressed, filename);
+  }
+
+  std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+  if(!out)
+    return false;
+  const internal::binary_matrix_header header
+    = internal::binary_make_header<Scalar>(mat.rows(), mat.cols(), mat.nonZeros(), sizeof(Index), mat.IsRowMajor);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  std::size_t offset = sizeof(header);
+  internal::binary_write_array(out, offset, mat.outerIndexPtr(), mat.outerSize()+1);
+  internal::binary_write_array(out, offset, mat.innerIndexPtr(), mat.nonZeros());
+  internal::binary_write_array(out, offset, mat.valuePtr(), mat.nonZeros());
+  return out.good();
+}
+
+/** \ingroup SparseExtra_Module
+  * Loads into \a mat the dense matrix saved by saveBinary() in \a filename. The coefficients are read
+  * in one pass, and are transposed if the file has the other storage order.
+  * \returns false if the file could not be read, or if it does not hold a dense matrix of the scalar
+  * type and of a size compatible with \a mat.
+  */
+template<typename Derived>
+bool loadBinary(PlainObjectBase<Derived>& mat, const std::string& filename)
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+  std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+  internal::binary_matrix_header header;
+  if(!in || !internal::binary_read_header(in, header) || header.indexSize!=0 || !internal::binary_has_scalar_type<Scalar>(header)
+     || !internal::binary_fits_index<Index>(header))
+    return false;
+  const Index rows = Index(internal::binary_get_size(header.rows));
+  const Index cols = Index(internal::binary_get_size(header.cols));
+  if((Derived::RowsAtCompileTime!=Dynamic && rows!=Derived::RowsAtCompileTime)
+     || (Derived::ColsAtCompileTime!=Dynamic && cols!=Derived::ColsAtCompileTime))
+    return false;
+
+  const bool rowMajor = (header.flags & RowMajorBit)!=0;
+  mat.resize(rows, cols);
+  if(rowMajor==bool(Derived::IsRowMajor) || rows==1 || cols==1)
+    in.read(reinterpret_cast<char*>(mat.data()), mat.size() * sizeof(Scalar));
+  else
+  {
+    Matrix<Scalar,Dynamic,Dynamic,Derived::IsRowMajor ? ColMajor : RowMajor> tmp(rows, cols);
+    in.read(reinterpret_cast<char*>(tmp.data()), tmp.size() * sizeof(Scalar));
+    mat = tmp;
+  }
+  return in.good();
+}
+
+/** \ingroup SparseExtra_Module
+  * Loads into \a mat the sparse matrix saved by saveBinary() in \a filename.
+  * \returns false if the file could not be read, or if it does not hold a valid sparse matrix
+  * of the scalar type and of the index type of \a mat.
+  */
+template<typename Scalar, int Options, typename Index>
+bool loadBinary(SparseMatrix<Scalar,Options,Index>& mat, const std::string& filename)
+{
+  typedef SparseMatrix<Scalar,Options,Index> SparseMatrixType;
+  std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+  internal::binary_matrix_header header;
+  if(!in || !internal::binary_read_header(in, header) || header.indexSize!=sizeof(Index) || !internal::binary_has_scalar_type<Scalar>(header)
+     || !internal::binary_fits_index<Index>(header))
+    return false;
+  const Index rows = Index(internal::binary_get_size(header.rows));
+  const Index cols = Index(internal::binary_get_size(header.cols));
+  const Index nnz = Index(internal::binary_get_size(header.nnz));
+  if((header.flags & RowMajorBit)==(SparseMatrixType::Flags & RowMajorBit))
+    return internal::binary_read_sparse(in, mat, rows, cols, nnz);
+  // the arrays are read into a matrix of the storage order of the file
+  SparseMatrix<Scalar,Options^RowMajorBit,Index> tmp;
+  if(!internal::binary_read_sparse(in, tmp, rows, cols, nnz))
+    return false;
+  mat = tmp;
+  return true;
+}
+
+/** \ingroup SparseExtra_Module
+  * \class MappedMatrixFile
+  *
+  * \brief Zero-copy access to a dense or sparse matrix saved by saveBinary()
+  *
+  * The file is mapped in memory with mmap, and map() and mapSparse() return a Map and a
+  * MappedSparseMatrix pointing to the mapped arrays. Hence opening the file does not read
+  * the coefficients, which are paged in when they are first accessed, but the indices of a sparse
+  * matrix are checked once, in a linear pass over them. The mapping is private:
+  * writing to the coefficients modifies the mapped copy only, not the file.
+  * On systems without mmap, the whole file is read into memory instead.
+  *
+  * The Map objects are valid as long as the MappedMatrixFile is open.
+  *
+  * \code
+  * MappedMatrixFile file("weights.bin");
+  * if(file.isOpen() && !file.isSparse() && file.hasScalarType<float>())
+  *   y = file.map<MatrixXf>() * x;
+  * \endcode
+  *
+  * \sa saveBinary(), loadBinary()
+  */
+class MappedMatrixFile
+{
+  public:
+    typedef DenseIndex Index;
+
+    MappedMatrixFile() : m_data(0), m_size(0) {}
+
+    /** Opens \a filename, see open() */
+    explicit MappedMatrixFile(const std::string& filename) : m_data(0), m_size(0)
+    {
+      open(filename);
+    }
+
+    ~MappedMatrixFile() { close(); }
+
+    /** Maps the file \a filename in memory.
+      * \returns false if the file could not be mapped, or if it is not a valid binary matrix file. */
+    bool open(const std::string& filename)
+    {
+      close();
+#if !defined(_WIN32)
+      int fd = ::open(filename.c_str(), O_RDONLY);
+      if(fd<0)
+        return false;
+      struct stat st;
+      if(::fstat(fd, &st)==0 && st.st_size>=off_t(sizeof(internal::binary_matrix_header)))
+      {
+        void* data = ::mmap(0, std::size_t(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if(data!=MAP_FAILED)
+        {
+          m_data = static_cast<char*>(data);
+          m_size = std::size_t(st.st_size);
+        }
+      }
+      ::close(fd);
+#else
+      std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+      if(!in)
+        return false;
+      in.seekg(0, std::ios::end);
+      m_size = static_cast<std::size_t>(in.tellg());
+      in.seekg(0, std::ios::beg);
+      m_data = static_cast<char*>(internal::aligned_malloc(m_size));
+      in.read(m_data, m_size);
+      if(!in.good())
+        close();
+#endif
+      if(m_data && (!internal::binary_check_header(header(), m_size) || !internal::binary_fits_index<Index>(header())
+                    || (isSparse() && !internal::binary_check_mapped_sparse(m_data))))
+        close();
+      return isOpen();
+    }
+
+    /** Unmaps the file. */
+    void close()
+    {
+      if(m_data)
+      {
+#if !defined(_WIN32)
+        ::munmap(m_data, m_size);
+#else
+        internal::aligned_free(m_data);
+#endif
+      }
+      m_data = 0;
+      m_size = 0;
+    }
+
+    bool isOpen() const { return m_data!=0; }
+
+    Index rows() const { eigen_assert(isOpen()); return Index(internal::binary_get_size(header().rows)); }
+    Index cols() const { eigen_assert(isOpen()); return Index(internal::binary_get_size(header().cols)); }
+    /** \returns the number of stored coefficients */
+    Index nonZeros() const { eigen_assert(isOpen()); return Index(internal::binary_get_size(header().nnz)); }
+    bool isSparse() const { eigen_assert(isOpen()); return header().indexSize!=0; }
+    bool isRowMajor() const { eigen_assert(isOpen()); return (header().flags & RowMajorBit)!=0; }
+
+    /** \returns whether the coefficients of the file are of type \a Scalar */
+    template<typename Scalar> bool hasScalarType() const
+    {
+      eigen_assert(isOpen());
+      return internal::binary_has_scalar_type<Scalar>(header());
+    }
+
+    /** \returns a Map of the dense matrix of the file, which must have the scalar type
+      * and the storage order of \a MatrixType. */
+    template<typename MatrixType>
+    Map<MatrixType, Aligned> map() const
+    {
+      typedef typename MatrixType::Scalar Scalar;
+      eigen_assert(isOpen() && !isSparse() && hasScalarType<Scalar>()
+                   && (isRowMajor()==bool(MatrixType::IsRowMajor) || rows()==1 || cols()==1)
+                   && "the file does not hold a dense matrix of this type");
+      return Map<MatrixType, Aligned>(reinterpret_cast<Scalar*>(m_data + sizeof(internal::binary_matrix_header)), rows(), cols());
+    }
+
+    /** \returns a MappedSparseMatrix of the sparse matrix of the file, which must have the scalar type,
+      * the storage order and the index type given by the template parameters. */
+    template<typename Scalar, int Options, typename SparseIndex>
+    MappedSparseMatrix<Scalar,Options,SparseIndex> mapSparse() const
+    {
+      eigen_assert(isOpen() && isSparse() && hasScalarType<Scalar>() && header().indexSize==sizeof(SparseIndex)
+                   && isRowMajor()==bool(Options&RowMajorBit)
+                   && "the file does not hold a sparse matrix of this type");
+      std::size_t offset = sizeof(internal::binary_matrix_header);
+      SparseIndex* outerIndex = reinterpret_cast<SparseIndex*>(m_data + offset);
+      offset += ((isRowMajor() ? rows() : cols()) + 1) * sizeof(SparseIndex);
+      offset = internal::binary_align(offset);
+      SparseIndex* innerIndices = reinterpret_cast<SparseIndex*>(m_data + offset);
+      offset = internal::binary_align(offset + nonZeros() * sizeof(SparseIndex));
+      Scalar* values = reinterpret_cast<Scalar*>(m_data + offset);
+      return MappedSparseMatrix<Scalar,Options,SparseIndex>(SparseIndex(rows()), SparseIndex(cols()), SparseIndex(nonZeros()),
+                                                            outerIndex, innerIndices, values);
+    }
+
+  protected:
+    const internal::binary_matrix_header& header() const
+    {
+      return *reinterpret_cast<const internal::binary_matrix_header*>(m_data);
+    }
+
+    char* m_data;
+    std::size_t m_size;
+
+  private:
+    MappedMatrixFile(const MappedMatrixFile&);
+    MappedMatrixFile& operator=(const MappedMatrixFile&);
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_BINARY_IO_H
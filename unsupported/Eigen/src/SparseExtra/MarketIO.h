@@ -17,34 +17,119 @@ namespace Eigen {
 
 namespace internal 
 {
-  template <typename Scalar>
-  inline bool GetMarketLine (std::stringstream& line, int& M, int& N, int& i, int& j, Scalar& value)
+  /* The entries of a Matrix Market file are parsed by hand from large chunks of the file: the
+   * indices by a simple loop over their digits, and the real values by strtod, which rounds them
+   * correctly. The parsers below read the field starting at p, and return a pointer past it, or 0
+   * if it is missing or invalid, indices overflowing Index included. The text they read always ends
+   * with a '\n', at which they stop.
+   */
+  inline const char* market_skip_blanks(const char* p)
   {
-    line >> i >> j >> value;
-    i--;
-    j--;
-    if(i>=0 && j>=0 && i<M && j<N)
+    while(*p==' ' || *p=='\t' || *p=='\r')
+      ++p;
+    return p;
+  }
+
+  template<typename Index>
+  inline const char* market_parse_index(const char* p, Index& value)
+  {
+    p = market_skip_blanks(p);
+    if(*p<'0' || *p>'9')
+      return 0;
+    Index v = 0;
+    while(*p>='0' && *p<='9')
     {
-      return true; 
+      const Index digit = Index(*p++ - '0');
+      if(v > (NumTraits<Index>::highest() - digit) / 10)
+        return 0;
+      v = 10*v + digit;
     }
-    else
-      return false;
+    value = v;
+    return p;
   }
-  template <typename Scalar>
-  inline bool GetMarketLine (std::stringstream& line, int& M, int& N, int& i, int& j, std::complex<Scalar>& value)
+
+  inline const char* market_parse_real(const char* p, double& value)
+  {
+    p = market_skip_blanks(p);
+    // strtod would skip the end of the line
+    if(*p=='\n')
+      return 0;
+    char* end;
+    value = std::strtod(p, &end);
+    return end==p ? 0 : end;
+  }
+
+  inline const char* market_parse_real(const char* p, float& value)
+  {
+    double v;
+    p = market_parse_real(p, v);
+    value = float(v);
+    return p;
+  }
+
+  // other scalar types, e.g., long double or integers, are read by a stream
+  template<typename RealScalar>
+  inline const char* market_parse_real(const char* p, RealScalar& value)
+  {
+    p = market_skip_blanks(p);
+    const char* end = p;
+    while(*end!=' ' && *end!='\t' && *end!='\r' && *end!='\n')
+      ++end;
+    std::istringstream field(std::string(p, end));
+    return end!=p && (field >> value) ? end : 0;
+  }
+
+  template<typename Scalar>
+  inline const char* market_parse_value(const char* p, Scalar& value)
+  {
+    return market_parse_real(p, value);
+  }
+
+  template<typename RealScalar>
+  inline const char* market_parse_value(const char* p, std::complex<RealScalar>& value)
+  {
+    RealScalar valR, valI;
+    if((p = market_parse_real(p, valR)) && (p = market_parse_real(p, valI)))
+      value = std::complex<RealScalar>(valR, valI);
+    return p;
+  }
+
+  /* Parses the entries of a range of whole lines of a Matrix Market file into triplets.
+   * Each thread has its own parser, and hence its own triplets.
+   */
+  template<typename Scalar, typename Index>
+  struct market_parser
   {
-    Scalar valR, valI;
-    line >> i >> j >> valR >> valI;
-    i--;
-    j--;
-    if(i>=0 && j>=0 && i<M && j<N)
+    typedef Triplet<Scalar,Index> T;
+
+    market_parser() : rows(0), cols(0), pattern(false), invalid(0) {}
+
+    void parse(const char* p, const char* end)
     {
-      value = std::complex<Scalar>(valR, valI);
-      return true; 
+      while(p<end)
+      {
+        const char* q = market_skip_blanks(p);
+        // comments and empty lines are skipped
+        if(*q!='%' && *q!='\n')
+        {
+          Index i(0), j(0);
+          Scalar value(1);
+          if((q = market_parse_index(q, i)) && (q = market_parse_index(q, j))
+             && (pattern || (q = market_parse_value(q, value)))
+             && i>=1 && j>=1 && i<=rows && j<=cols)
+            triplets.push_back(T(i-1, j-1, value));
+          else
+            ++invalid;
+        }
+        p = static_cast<const char*>(std::memchr(p, '\n', end-p)) + 1;
+      }
     }
-    else
-      return false;
-  }
+
+    std::vector<T> triplets;
+    Index rows, cols;
+    bool pattern;
+    Index invalid;
+  };
 
   template <typename RealScalar>
   inline void  GetVectorElt (const std::string& line, RealScalar& val)
@@ -81,17 +166,74 @@ namespace internal
     }
   }
 
-  template<typename Scalar>
-  inline void PutMatrixElt(Scalar value, int row, int col, std::ofstream& out)
+  /* The entries written by saveMarket are formatted by hand into strings, with enough digits
+   * for the real values to be read back exactly.
+   */
+  template<typename Index>
+  inline void market_put_index(std::string& out, Index i)
+  {
+    char digits[32];
+    int n = 0;
+    do {
+      digits[n++] = char('0' + i%10);
+      i /= 10;
+    } while(i>0);
+    while(n>0)
+      out += digits[--n];
+  }
+
+  inline void market_put_real(std::string& out, double value)
   {
-    out << row << " "<< col << " " << value << "\n";
+    char buffer[64];
+    std::sprintf(buffer, "%.17g", value);
+    out += buffer;
   }
+
+  inline void market_put_real(std::string& out, float value)
+  {
+    char buffer[64];
+    std::sprintf(buffer, "%.9g", double(value));
+    out += buffer;
+  }
+
+  template<typename RealScalar>
+  inline void market_put_real(std::string& out, const RealScalar& value)
+  {
+    std::ostringstream field;
+    field.precision(std::numeric_limits<RealScalar>::digits10 + 3);
+    field << value;
+    out += field.str();
+  }
+
   template<typename Scalar>
-  inline void PutMatrixElt(std::complex<Scalar> value, int row, int col, std::ofstream& out)
+  inline void market_put_value(std::string& out, const Scalar& value)
+  {
+    market_put_real(out, value);
+  }
+
+  template<typename RealScalar>
+  inline void market_put_value(std::string& out, const std::complex<RealScalar>& value)
   {
-    out << row << " " << col << " " << value.real() << " " << value.imag() << "\n";
+    market_put_real(out, value.real());
+    out += ' ';
+    market_put_real(out, value.imag());
   }
 
+  template<typename SparseMatrixType>
+  inline void market_put_entries(std::string& out, const SparseMatrixType& mat,
+                                 typename SparseMatrixType::Index start, typename SparseMatrixType::Index end)
+  {
+    for(typename SparseMatrixType::Index j=start; j<end; ++j)
+      for(typename SparseMatrixType::InnerIterator it(mat,j); it; ++it)
+      {
+        market_put_index(out, it.row()+1);
+        out += ' ';
+        market_put_index(out, it.col()+1);
+        out += ' ';
+        market_put_value(out, it.value());
+        out += '\n';
+      }
+  }
 
   template<typename Scalar>
   inline void putVectorElt(Scalar value, std::ofstream& out)
@@ -129,61 +271,142 @@ inline bool getMarketHeader(const std::string& filename, int& sym, bool& iscompl
   return true;
 }
   
+#ifndef EIGEN_MARKET_IO_CHUNK_SIZE
+#define EIGEN_MARKET_IO_CHUNK_SIZE (1<<24)
+#endif
+
+/** Loads the sparse matrix \a mat from the Matrix Market file \a filename.
+  *
+  * The entries are read by chunks of EIGEN_MARKET_IO_CHUNK_SIZE bytes per thread, or of the size of
+  * the remaining file if smaller, which are split into ranges of lines parsed in parallel when OpenMP
+  * is enabled, each thread gathering its own triplets. Pattern matrices are loaded with unit
+  * coefficients. Only the stored entries of symmetric matrices are loaded.
+  *
+  * \returns false if the file cannot be opened or has no valid size line
+  */
 template<typename SparseMatrixType>
 bool loadMarket(SparseMatrixType& mat, const std::string& filename)
 {
   typedef typename SparseMatrixType::Scalar Scalar;
-  std::ifstream input(filename.c_str(),std::ios::in);
+  typedef typename SparseMatrixType::Index Index;
+  typedef internal::market_parser<Scalar,Index> Parser;
+  std::ifstream input(filename.c_str(),std::ios::in | std::ios::binary);
   if(!input)
     return false;
-  
-  const int maxBuffersize = 2048;
-  char buffer[maxBuffersize];
-  
-  bool readsizes = false;
 
-  typedef Triplet<Scalar,int> T;
-  std::vector<T> elements;
-  
-  int M(-1), N(-1), NNZ(-1);
-  int count = 0;
-  while(input.getline(buffer, maxBuffersize))
+  // the header, the comments, and the sizes, on the first other line
+  std::string line;
+  bool pattern = false;
+  bool readsizes = false;
+  Index M(-1), N(-1), NNZ(-1);
+  while(std::getline(input, line))
   {
-    // skip comments   
-    //NOTE An appropriate test should be done on the header to get the  symmetry
-    if(buffer[0]=='%')
+    if(line.compare(0, 14, "%%MatrixMarket")==0)
+      pattern = line.find("pattern")!=std::string::npos;
+    if(line.empty() || line[0]=='%')
       continue;
-    
-    std::stringstream line(buffer);
-    
-    if(!readsizes)
+    const char* p = line.c_str();
+    readsizes = (p = internal::market_parse_index(p, M)) && (p = internal::market_parse_index(p, N))
+             && internal::market_parse_index(p, NNZ) && M>0 && N>0;
+    break;
+  }
+  if(!readsizes)
+    return false;
+
+  const int threads = nbThreads();
+  std::vector<Parser> parsers(threads);
+  for(int t=0; t<threads; ++t)
+  {
+    parsers[t].rows = M;
+    parsers[t].cols = N;
+    parsers[t].pattern = pattern;
+    parsers[t].triplets.reserve(NNZ/threads + 1);
+  }
+
+  // the chunks are not larger than the remaining entries
+  std::size_t chunk = std::size_t(EIGEN_MARKET_IO_CHUNK_SIZE) * threads;
+  const std::streamoff start = input.eof() ? std::streamoff(-1) : std::streamoff(input.tellg());
+  if(start<0)
+    chunk = 0;
+  else if(input.seekg(0, std::ios::end))
+  {
+    const std::streamoff remaining = std::streamoff(input.tellg()) - start;
+    if(remaining>=0 && std::size_t(remaining)<chunk)
+      chunk = std::size_t(remaining);
+    input.seekg(start);
+  }
+  else
+    input.clear();
+
+  // the entries, by chunks ending at the end of a line
+  std::vector<char> buffer(chunk + 1);
+  std::size_t filled = 0;
+  bool eof = false;
+  while(!eof)
+  {
+    input.read(&buffer[filled], buffer.size()-1-filled);
+    filled += std::size_t(input.gcount());
+    eof = !input;
+    std::size_t size = filled;
+    if(eof)
     {
-      line >> M >> N >> NNZ;
-      if(M > 0 && N > 0 && NNZ > 0) 
-      {
-        readsizes = true;
-        std::cout << "sizes: " << M << "," << N << "," << NNZ << "\n";
-        mat.resize(M,N);
-        mat.reserve(NNZ);
-      }
+      if(size>0 && buffer[size-1]!='\n')
+        buffer[size++] = '\n';
     }
     else
-    { 
-      int i(-1), j(-1);
-      Scalar value; 
-      if( internal::GetMarketLine(line, M, N, i, j, value) ) 
+    {
+      while(size>0 && buffer[size-1]!='\n')
+        --size;
+      if(size==0)
       {
-        ++ count;
-        elements.push_back(T(i,j,value));
+        // a line longer than the buffer
+        buffer.resize(2*buffer.size());
+        continue;
       }
-      else 
-        std::cerr << "Invalid read: " << i << "," << j << "\n";        
+    }
+
+    // each thread parses whole lines
+    const int pieces = (std::min)(threads, int(size>>12) + 1);
+    const char* data = &buffer[0];
+    std::vector<const char*> bounds(pieces+1);
+    bounds[0] = data;
+    bounds[pieces] = data + size;
+    for(int t=1; t<pieces; ++t)
+    {
+      const char* b = (std::max)(bounds[t-1], data + (size*t)/pieces);
+      bounds[t] = b==bounds[pieces] ? b : static_cast<const char*>(std::memchr(b, '\n', bounds[pieces]-b)) + 1;
+    }
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for num_threads(pieces) schedule(static,1) if(pieces>1)
+#endif
+    for(int t=0; t<pieces; ++t)
+      parsers[t].parse(bounds[t], bounds[t+1]);
+
+    // the beginning of the next line is kept for the next chunk
+    if(!eof)
+    {
+      std::memmove(&buffer[0], &buffer[size], filled-size);
+      filled -= size;
     }
   }
+  buffer.clear();
+
+  std::vector<typename Parser::T>& elements = parsers[0].triplets;
+  Index invalid = parsers[0].invalid;
+  for(int t=1; t<threads; ++t)
+  {
+    elements.insert(elements.end(), parsers[t].triplets.begin(), parsers[t].triplets.end());
+    std::vector<typename Parser::T>().swap(parsers[t].triplets);
+    invalid += parsers[t].invalid;
+  }
+
+  mat.resize(M,N);
   mat.setFromTriplets(elements.begin(), elements.end());
-  if(count!=NNZ)
-    std::cerr << count << "!=" << NNZ << "\n";
-  
+  if(invalid>0)
+    std::cerr << "Invalid read: " << invalid << " entries\n";
+  if(Index(elements.size())!=NNZ)
+    std::cerr << elements.size() << "!=" << NNZ << "\n";
+
   input.close();
   return true;
 }
@@ -220,30 +443,50 @@ bool loadMarketVector(VectorType& vec, const std::string& filename)
   return true;
 }
 
+/** Saves the sparse matrix \a mat to the Matrix Market file \a filename.
+  *
+  * The entries are formatted by blocks of outer vectors, several of them in parallel when OpenMP is
+  * enabled, and are written in the order of the storage. The real values are written with enough
+  * digits to be read back exactly by loadMarket.
+  *
+  * \param sym the symmetry written in the header, 0, Symmetric or SelfAdjoint
+  */
 template<typename SparseMatrixType>
 bool saveMarket(const SparseMatrixType& mat, const std::string& filename, int sym = 0)
 {
   typedef typename SparseMatrixType::Scalar Scalar;
-  std::ofstream out(filename.c_str(),std::ios::out);
+  typedef typename SparseMatrixType::Index Index;
+  std::ofstream out(filename.c_str(),std::ios::out | std::ios::binary);
   if(!out)
     return false;
   
-  out.flags(std::ios_base::scientific);
-  out.precision(64);
   std::string header; 
   internal::putMarketHeader<Scalar>(header, sym); 
-  out << header << std::endl; 
+  out << header << "\n";
   out << mat.rows() << " " << mat.cols() << " " << mat.nonZeros() << "\n";
-  int count = 0;
-  for(int j=0; j<mat.outerSize(); ++j)
-    for(typename SparseMatrixType::InnerIterator it(mat,j); it; ++it)
+
+  // blocks of about 64K entries
+  const Index outerSize = mat.outerSize();
+  const Index blockSize = (std::max)(Index(1), Index(65536. * double(outerSize) / double((std::max)(Index(1), Index(mat.nonZeros())))));
+  const int threads = nbThreads();
+  std::vector<std::string> blocks(threads);
+  for(Index start=0; start<outerSize; start+=threads*blockSize)
+  {
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for num_threads(threads) schedule(static,1) if(threads>1 && outerSize-start>blockSize)
+#endif
+    for(int t=0; t<threads; ++t)
     {
-	++ count;
-	internal::PutMatrixElt(it.value(), it.row()+1, it.col()+1, out);
-	// out << it.row()+1 << " " << it.col()+1 << " " << it.value() << "\n";
+      const Index begin = (std::min)(start + t*blockSize, outerSize);
+      const Index end = (std::min)(begin + blockSize, outerSize);
+      blocks[t].clear();
+      internal::market_put_entries(blocks[t], mat, begin, end);
     }
+    for(int t=0; t<threads; ++t)
+      out.write(blocks[t].data(), blocks[t].size());
+  }
   out.close();
-  return true;
+  return !out.fail();
 }
 
 template<typename VectorType>
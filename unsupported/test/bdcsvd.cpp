@@ -101,6 +101,36 @@ void compare_bdc_jacobi(const MatrixType& a = MatrixType(), unsigned int computa
 } // end template compare_bdc_jacobi
 
 
+// exercise the divide and conquer steps (deflation, secular equation, merge)
+// by lowering the size below which JacobiSVD is used
+template<typename MatrixType>
+void bdcsvd_small_switch(const MatrixType& a, int switchSize)
+{
+  typedef typename MatrixType::Index Index;
+  Index rows = a.rows(), cols = a.cols();
+  MatrixType m = MatrixType::Random(rows, cols);
+  // make it rank deficient half of the time to trigger deflation
+  if(internal::random<bool>() && cols>2)
+    m.col(cols-1) = m.col(0);
+
+  BDCSVD<MatrixType> svd;
+  svd.setSwitchSize(switchSize);
+  svd.compute(m, ComputeFullU|ComputeFullV);
+  bdcsvd_check_full(m, svd);
+
+  JacobiSVD<MatrixType> jacobi_svd(m);
+  VERIFY_IS_APPROX(svd.singularValues(), jacobi_svd.singularValues());
+
+  svd.compute(m, ComputeThinU|ComputeThinV);
+  Index diagSize = (std::min)(rows, cols);
+  VERIFY_IS_APPROX(m, svd.matrixU() * svd.singularValues().template cast<typename MatrixType::Scalar>().asDiagonal() * svd.matrixV().adjoint());
+  VERIFY_IS_APPROX(svd.matrixU().adjoint() * svd.matrixU(), MatrixType::Identity(diagSize, diagSize));
+  VERIFY_IS_APPROX(svd.matrixV().adjoint() * svd.matrixV(), MatrixType::Identity(diagSize, diagSize));
+
+  svd.compute(m, 0);
+  VERIFY_IS_APPROX(svd.singularValues(), jacobi_svd.singularValues());
+}
+
 // call the tests
 void test_bdcsvd()
 {
@@ -210,4 +240,13 @@ void test_bdcsvd()
   // Test problem size constructors
   CALL_SUBTEST_7( BDCSVD<MatrixXf>(10,10) );
 
+  for(int i = 0; i < g_repeat; i++) {
+    int r = internal::random<int>(10, EIGEN_TEST_MAX_SIZE/2),
+      c = internal::random<int>(10, EIGEN_TEST_MAX_SIZE/2);
+    CALL_SUBTEST_9(( bdcsvd_small_switch(MatrixXd(r,c), internal::random<int>(4,8)) ));
+    CALL_SUBTEST_10(( bdcsvd_small_switch(MatrixXcf(r,c), internal::random<int>(4,8)) ));
+    (void) r;
+    (void) c;
+  }
+
 } // end test_bdcsvd
@@ -0,0 +1,253 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "sparse.h"
+#include <Eigen/SparseExtra>
+#include <cstdio>
+
+template<typename MatrixType> void binary_io_dense(const MatrixType& m)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+  typedef Matrix<Scalar,Dynamic,Dynamic,ColMajor> ColMatrix;
+  typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> RowMatrix;
+  const std::string filename = "binary_io_dense.bin";
+
+  VERIFY(saveBinary(m, filename));
+
+  MatrixType m1;
+  VERIFY(loadBinary(m1, filename));
+  VERIFY_IS_EQUAL(m1, m);
+  ColMatrix m2;
+  VERIFY(loadBinary(m2, filename));
+  VERIFY_IS_EQUAL(m2, ColMatrix(m));
+  RowMatrix m3;
+  VERIFY(loadBinary(m3, filename));
+  VERIFY_IS_EQUAL(m3, RowMatrix(m));
+
+  {
+    MappedMatrixFile file(filename);
+    VERIFY(file.isOpen());
+    VERIFY(!file.isSparse());
+    VERIFY(file.template hasScalarType<Scalar>());
+    VERIFY(!file.template hasScalarType<std::complex<long double> >());
+    VERIFY_IS_EQUAL(file.rows(), m.rows());
+    VERIFY_IS_EQUAL(file.cols(), m.cols());
+    VERIFY_IS_EQUAL(file.isRowMajor(), bool(MatrixType::IsRowMajor));
+    VERIFY_IS_EQUAL(file.template map<const MatrixType>(), m);
+    VERIFY(reinterpret_cast<std::size_t>(file.template map<MatrixType>().data()) % 16 == 0);
+  }
+
+  // expressions are evaluated
+  if(m.rows()>1 && m.cols()>1)
+  {
+    Index r = internal::random<Index>(1,m.rows()-1), c = internal::random<Index>(1,m.cols()-1);
+    VERIFY(saveBinary(m.bottomRightCorner(r,c), filename));
+    VERIFY(loadBinary(m2, filename));
+    VERIFY_IS_EQUAL(m2, ColMatrix(m.bottomRightCorner(r,c)));
+    VERIFY(saveBinary(m.transpose(), filename));
+    VERIFY(loadBinary(m3, filename));
+    VERIFY_IS_EQUAL(m3, RowMatrix(m.transpose()));
+  }
+
+  // mismatches are reported
+  Matrix<std::complex<long double>,Dynamic,Dynamic> other;
+  VERIFY(!loadBinary(other, filename));
+  Matrix<Scalar,Dynamic,Dynamic> tall(m.rows()+1, m.cols());
+  VERIFY(saveBinary(tall, filename));
+  Matrix<Scalar,Dynamic,1> vec;
+  VERIFY(!loadBinary(vec, filename) || m.cols()==1);
+
+  std::remove(filename.c_str());
+}
+
+template<typename SparseMatrixType> void binary_io_sparse(const SparseMatrixType& ref)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef typename SparseMatrixType::Index Index;
+  enum { Options = SparseMatrixType::Flags & RowMajorBit };
+  typedef SparseMatrix<Scalar,ColMajor,Index> ColSparseMatrix;
+  typedef SparseMatrix<Scalar,RowMajor,Index> RowSparseMatrix;
+  const std::string filename = "binary_io_sparse.bin";
+
+  Matrix<Scalar,Dynamic,Dynamic> refMat(ref.rows(), ref.cols());
+  SparseMatrixType m(ref.rows(), ref.cols());
+  initSparse<Scalar>(0.1, refMat, m);
+
+  VERIFY(saveBinary(m, filename));
+
+  SparseMatrixType m1;
+  VERIFY(loadBinary(m1, filename));
+  VERIFY(m1.isCompressed());
+  VERIFY_IS_EQUAL(m1.nonZeros(), m.nonZeros());
+  VERIFY_IS_APPROX(m1.toDense(), refMat);
+  ColSparseMatrix m2;
+  VERIFY(loadBinary(m2, filename));
+  VERIFY_IS_APPROX(m2.toDense(), refMat);
+  RowSparseMatrix m3;
+  VERIFY(loadBinary(m3, filename));
+  VERIFY_IS_APPROX(m3.toDense(), refMat);
+
+  {
+    MappedMatrixFile file(filename);
+    VERIFY(file.isOpen());
+    VERIFY(file.isSparse());
+    VERIFY_IS_EQUAL(file.nonZeros(), m.nonZeros());
+    MappedSparseMatrix<Scalar,Options,Index> mapped = file.template mapSparse<Scalar,Options,Index>();
+    VERIFY_IS_EQUAL(mapped.rows(), m.rows());
+    VERIFY_IS_EQUAL(mapped.cols(), m.cols());
+    VERIFY_IS_APPROX(mapped.toDense(), refMat);
+    VERIFY_IS_APPROX(mapped * refMat.transpose(), refMat * refMat.transpose());
+  }
+
+  // uncompressed matrices are compressed before being saved
+  m.coeffRef(0,0) += Scalar(1);
+  refMat(0,0) += Scalar(1);
+  m.reserve(Matrix<Index,Dynamic,1>::Constant(m.outerSize(), 2));
+  VERIFY(!m.isCompressed());
+  VERIFY(saveBinary(m, filename));
+  VERIFY(loadBinary(m1, filename));
+  VERIFY_IS_APPROX(m1.toDense(), refMat);
+
+  // mismatches are reported
+  SparseMatrix<Scalar,ColMajor,short> shortIndices;
+  VERIFY(!loadBinary(shortIndices, filename));
+  Matrix<Scalar,Dynamic,Dynamic> dense;
+  VERIFY(!loadBinary(dense, filename));
+
+  std::remove(filename.c_str());
+}
+
+// reads the whole file into \a buffer, which is written back by write_file
+void read_file(const std::string& filename, std::vector<char>& buffer)
+{
+  std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+  in.seekg(0, std::ios::end);
+  buffer.resize(std::size_t(in.tellg()));
+  in.seekg(0, std::ios::beg);
+  in.read(&buffer[0], buffer.size());
+}
+
+void write_file(const std::string& filename, const std::vector<char>& buffer)
+{
+  std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+  out.write(&buffer[0], buffer.size());
+}
+
+template<typename T> void set_array_element(std::vector<char>& buffer, std::size_t offset, std::size_t i, T value)
+{
+  std::memcpy(&buffer[offset + i*sizeof(T)], &value, sizeof(T));
+}
+
+void binary_io_invalid()
+{
+  const std::string filename = "binary_io_invalid.bin";
+  MatrixXd m;
+  VERIFY(!loadBinary(m, "binary_io_missing.bin"));
+  MappedMatrixFile file("binary_io_missing.bin");
+  VERIFY(!file.isOpen());
+
+  // a truncated file
+  VERIFY(saveBinary(MatrixXd::Random(10,10), filename));
+  {
+    std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+    std::vector<char> buffer(64+799);
+    in.read(&buffer[0], buffer.size());
+    in.close();
+    std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+    out.write(&buffer[0], buffer.size());
+  }
+  VERIFY(!loadBinary(m, filename));
+  VERIFY(!file.open(filename));
+
+  // a text file
+  {
+    std::ofstream out(filename.c_str(), std::ios::out);
+    out << "%%MatrixMarket matrix coordinate real general\n1 1 1\n1 1 1.0\n";
+  }
+  VERIFY(!loadBinary(m, filename));
+  VERIFY(!file.open(filename));
+
+  // sizes whose products overflow
+  VERIFY(saveBinary(MatrixXd::Random(10,10), filename));
+  std::vector<char> buffer;
+  read_file(filename, buffer);
+  internal::binary_matrix_header header;
+  std::memcpy(&header, &buffer[0], sizeof(header));
+  header.rows[0] = 0; header.rows[1] = 2;
+  header.cols[0] = 0x80000000u; header.cols[1] = 0;
+  std::memcpy(&buffer[0], &header, sizeof(header));
+  write_file(filename, buffer);
+  VERIFY(!loadBinary(m, filename));
+  VERIFY(!file.open(filename));
+
+  // the sparse matrices, whose indices are checked
+  SparseMatrix<double,ColMajor,short> sm(20,30);
+  for(int j=0; j<30; ++j)
+    sm.insert(j%20, j) = j+1;
+  sm.insert(5, 3) = 1;
+  sm.makeCompressed();
+  VERIFY(saveBinary(sm, filename));
+  std::vector<char> valid;
+  read_file(filename, valid);
+  const std::size_t outerOffset = 64, innerOffset = 128;
+  SparseMatrix<double,ColMajor,short> sm1;
+  VERIFY(loadBinary(sm1, filename));
+  VERIFY(file.open(filename));
+
+  // a number of rows which does not fit the index type
+  buffer = valid;
+  std::memcpy(&header, &buffer[0], sizeof(header));
+  header.rows[0] = 70000;
+  std::memcpy(&buffer[0], &header, sizeof(header));
+  write_file(filename, buffer);
+  VERIFY(!loadBinary(sm1, filename));
+  VERIFY(!file.open(filename));
+
+  // an inner index out of range
+  buffer = valid;
+  set_array_element<short>(buffer, innerOffset, 7, 20);
+  write_file(filename, buffer);
+  VERIFY(!loadBinary(sm1, filename));
+  VERIFY(!file.open(filename));
+  set_array_element<short>(buffer, innerOffset, 7, -1);
+  write_file(filename, buffer);
+  VERIFY(!loadBinary(sm1, filename));
+  VERIFY(!file.open(filename));
+
+  // decreasing outer indices
+  buffer = valid;
+  set_array_element<short>(buffer, outerOffset, 10, 30);
+  write_file(filename, buffer);
+  VERIFY(!loadBinary(sm1, filename));
+  VERIFY(!file.open(filename));
+
+  // a last outer index which is not the number of nonzeros
+  buffer = valid;
+  set_array_element<short>(buffer, outerOffset, 30, 30);
+  write_file(filename, buffer);
+  VERIFY(!loadBinary(sm1, filename));
+  VERIFY(!file.open(filename));
+
+  std::remove(filename.c_str());
+}
+
+void test_binary_io()
+{
+  CALL_SUBTEST_1( binary_io_invalid() );
+  for(int i = 0; i < g_repeat; i++) {
+    int r = internal::random<int>(1,200), c = internal::random<int>(1,200);
+    CALL_SUBTEST_1( binary_io_dense(MatrixXd(MatrixXd::Random(r,c))) );
+    CALL_SUBTEST_1( binary_io_dense(Matrix4f(Matrix4f::Random())) );
+    CALL_SUBTEST_2( binary_io_dense(Matrix<std::complex<float>,Dynamic,Dynamic,RowMajor>(MatrixXcf::Random(r,c))) );
+    CALL_SUBTEST_2( binary_io_dense(VectorXi(VectorXi::Random(r))) );
+    CALL_SUBTEST_2( binary_io_dense(RowVectorXf(RowVectorXf::Random(c))) );
+    CALL_SUBTEST_3( binary_io_sparse(SparseMatrix<double>(r,c)) );
+    CALL_SUBTEST_3( binary_io_sparse(SparseMatrix<double,RowMajor>(r,c)) );
+    CALL_SUBTEST_4( binary_io_sparse(SparseMatrix<std::complex<float>,ColMajor,long>(r,c)) );
+  }
+}
@@ -0,0 +1,104 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/
+
+#include "svd_common.h"
+
+template<typename MatrixType>
+void block_jacobi_svd(const MatrixType& a = MatrixType(), bool pickrandom = true)
+{
+  MatrixType m = pickrandom ? MatrixType::Random(a.rows(), a.cols()) : a;
+  BlockJacobiSVD<MatrixType> fullSvd(m, ComputeFullU|ComputeFullV);
+  svd_test_computation_options_1< MatrixType, BlockJacobiSVD< MatrixType > >(m, fullSvd);
+  svd_test_computation_options_2< MatrixType, BlockJacobiSVD< MatrixType > >(m, fullSvd);
+
+  JacobiSVD<MatrixType> jacobiSvd(m);
+  VERIFY_IS_APPROX(fullSvd.singularValues(), jacobiSvd.singularValues());
+}
+
+// exercise the round-robin sweeps over several blocks of columns
+template<typename MatrixType>
+void block_jacobi_svd_blocks(int rows, int cols, int blockSize)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+  MatrixType m = MatrixType::Random(rows, cols);
+  // make it rank deficient half of the time
+  if(internal::random<bool>() && cols>2)
+    m.col(cols-1) = m.col(0);
+
+  BlockJacobiSVD<MatrixType> svd;
+  svd.setBlockSize(blockSize).compute(m, ComputeFullU|ComputeFullV);
+  svd_check_full(m, svd);
+  VERIFY(svd.sweeps() > 1);
+
+  JacobiSVD<MatrixType> jacobiSvd(m);
+  VERIFY_IS_APPROX(svd.singularValues(), jacobiSvd.singularValues());
+
+  svd.compute(m, ComputeThinU|ComputeThinV);
+  Index diagSize = (std::min)(rows, cols);
+  VERIFY_IS_APPROX(m, svd.matrixU() * svd.singularValues().template cast<Scalar>().asDiagonal() * svd.matrixV().adjoint());
+  VERIFY_IS_UNITARY(svd.matrixU());
+  VERIFY_IS_UNITARY(svd.matrixV());
+  VERIFY_IS_EQUAL(svd.matrixU().cols(), diagSize);
+
+  svd.compute(m, 0);
+  VERIFY_IS_APPROX(svd.singularValues(), jacobiSvd.singularValues());
+}
+
+// the small singular values of a matrix with badly scaled columns are computed with a high relative accuracy
+template<typename MatrixType>
+void block_jacobi_svd_graded(int size)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef Matrix<RealScalar, Dynamic, 1> RealVectorType;
+
+  // B = Q diag(d) with orthogonal Q: its singular values are exactly |d|, which span 24 orders of magnitude
+  MatrixType q = HouseholderQR<MatrixType>(MatrixType::Random(size, size)).householderQ();
+  RealVectorType d(size);
+  for(int i=0; i<size; ++i)
+    d(i) = std::pow(RealScalar(10), -RealScalar(24*i)/RealScalar(size-1));
+  MatrixType m = q * d.template cast<Scalar>().asDiagonal();
+
+  BlockJacobiSVD<MatrixType> svd;
+  svd.setBlockSize(4).compute(m);
+  RealVectorType relativeErrors = (svd.singularValues() - d).cwiseQuotient(d).cwiseAbs();
+  VERIFY(relativeErrors.maxCoeff() < RealScalar(100*size) * NumTraits<RealScalar>::epsilon());
+}
+
+void test_block_jacobi_svd()
+{
+  CALL_SUBTEST_1(( svd_verify_assert<Matrix3f, BlockJacobiSVD<Matrix3f> >(Matrix3f()) ));
+  CALL_SUBTEST_1(( svd_verify_assert<MatrixXd, BlockJacobiSVD<MatrixXd> >(MatrixXd(10,12)) ));
+  CALL_SUBTEST_2(( svd_inf_nan<MatrixXf, BlockJacobiSVD<MatrixXf> >() ));
+  CALL_SUBTEST_2(( svd_inf_nan<MatrixXd, BlockJacobiSVD<MatrixXd> >() ));
+
+  for(int i = 0; i < g_repeat; i++) {
+    Matrix2cd m;
+    m << 0, 1,
+         0, 1;
+    CALL_SUBTEST_3(( block_jacobi_svd(m, false) ));
+    Matrix2d n;
+    n << 0, 0,
+         0, 1;
+    CALL_SUBTEST_3(( block_jacobi_svd(n, false) ));
+    n.setZero();
+    CALL_SUBTEST_3(( block_jacobi_svd(n, false) ));
+
+    CALL_SUBTEST_4(( block_jacobi_svd<Matrix3f>() ));
+    CALL_SUBTEST_4(( block_jacobi_svd<Matrix<double,5,7> >() ));
+    CALL_SUBTEST_5(( block_jacobi_svd(MatrixXf(internal::random<int>(1,50), internal::random<int>(1,50))) ));
+    CALL_SUBTEST_5(( block_jacobi_svd(MatrixXd(internal::random<int>(1,50), internal::random<int>(1,50))) ));
+    CALL_SUBTEST_6(( block_jacobi_svd(MatrixXcd(internal::random<int>(1,30), internal::random<int>(1,30))) ));
+
+    int rows = internal::random<int>(20,120); TEST_SET_BUT_UNUSED_VARIABLE(rows)
+    int cols = internal::random<int>(20,120); TEST_SET_BUT_UNUSED_VARIABLE(cols)
+    CALL_SUBTEST_7(( block_jacobi_svd_blocks<MatrixXd>(rows, cols, internal::random<int>(2,12)) ));
+    CALL_SUBTEST_8(( block_jacobi_svd_blocks<MatrixXcf>(rows, cols, internal::random<int>(2,12)) ));
+    CALL_SUBTEST_9(( block_jacobi_svd_graded<MatrixXd>(internal::random<int>(10,60)) ));
+  }
+}
@@ -0,0 +1,133 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "../../test/sparse_solver.h"
+#include <Eigen/IterativeSolvers>
+
+template<typename T> void test_block_krylov_T()
+{
+  BlockConjugateGradient<SparseMatrix<T>, Lower      > bcg_colmajor_lower_diag;
+  BlockConjugateGradient<SparseMatrix<T>, Upper      > bcg_colmajor_upper_diag;
+  BlockConjugateGradient<SparseMatrix<T>, Lower|Upper> bcg_colmajor_loup_diag;
+  BlockConjugateGradient<SparseMatrix<T>, Lower, IdentityPreconditioner> bcg_colmajor_lower_I;
+  BlockGMRES<SparseMatrix<T>, DiagonalPreconditioner<T> > bgmres_colmajor_diag;
+  BlockGMRES<SparseMatrix<T>, IncompleteLUT<T> >          bgmres_colmajor_ilut;
+
+  CALL_SUBTEST( check_sparse_spd_solving(bcg_colmajor_lower_diag)  );
+  CALL_SUBTEST( check_sparse_spd_solving(bcg_colmajor_upper_diag)  );
+  CALL_SUBTEST( check_sparse_spd_solving(bcg_colmajor_loup_diag)   );
+  CALL_SUBTEST( check_sparse_spd_solving(bcg_colmajor_lower_I)     );
+  CALL_SUBTEST( check_sparse_square_solving(bgmres_colmajor_diag)  );
+  CALL_SUBTEST( check_sparse_square_solving(bgmres_colmajor_ilut)  );
+}
+
+// 5-point finite difference discretization of -div(grad u) + c.grad u on a n x n grid
+template<typename Scalar>
+SparseMatrix<Scalar> block_krylov_problem(int n, double c)
+{
+  std::vector<Triplet<Scalar> > triplets;
+  for(int i=0; i<n; ++i)
+    for(int j=0; j<n; ++j)
+    {
+      int k = i*n+j;
+      triplets.push_back(Triplet<Scalar>(k, k, Scalar(4+2*c)));
+      if(i>0)   triplets.push_back(Triplet<Scalar>(k, k-n, Scalar(-1-c)));
+      if(i<n-1) triplets.push_back(Triplet<Scalar>(k, k+n, Scalar(-1)));
+      if(j>0)   triplets.push_back(Triplet<Scalar>(k, k-1, Scalar(-1-c)));
+      if(j<n-1) triplets.push_back(Triplet<Scalar>(k, k+1, Scalar(-1)));
+    }
+  SparseMatrix<Scalar> A(n*n, n*n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  return A;
+}
+
+// all the columns converge, and the block solvers need fewer iterations than the single right hand side ones
+template<typename T> void test_block_krylov_multiple_rhs()
+{
+  typedef Matrix<T,Dynamic,Dynamic> DenseMatrix;
+  typedef typename NumTraits<T>::Real RealScalar;
+  const RealScalar tol(1e-8);
+
+  int n = internal::random<int>(10,30);
+  int k = internal::random<int>(2,12);
+  DenseMatrix B = DenseMatrix::Random(n*n, k);
+  // a zero column, and a column that is a combination of the others
+  B.col(0).setZero();
+  B.col(k-1) = B.col(1) * T(2);
+
+  SparseMatrix<T> A = block_krylov_problem<T>(n, 0);
+  BlockConjugateGradient<SparseMatrix<T>, Lower> bcg(A);
+  ConjugateGradient<SparseMatrix<T>, Lower> cg(A);
+  bcg.setTolerance(tol);
+  cg.setTolerance(tol);
+  DenseMatrix X = bcg.solve(B);
+  VERIFY_IS_EQUAL(bcg.info(), Success);
+  VERIFY(bcg.error() <= tol);
+  VERIFY(X.col(0).isZero());
+  for(int j=1; j<k; ++j)
+  {
+    VERIFY((A*X.col(j) - B.col(j)).norm() <= RealScalar(10) * tol * B.col(j).norm());
+    Matrix<T,Dynamic,1> x = cg.solve(B.col(j));
+    VERIFY(bcg.iterations() <= cg.iterations() + 1);  // ConjugateGradient does not count its last iteration
+  }
+
+  // a right hand side much smaller than the others is still solved to the relative tolerance,
+  // and does not change the search directions
+  int iterations = bcg.iterations();
+  DenseMatrix B2 = B;
+  B2.col(1) *= T(1e-9);
+  B2.col(k-1) *= T(1e-9);
+  DenseMatrix X2 = bcg.solve(B2);
+  VERIFY_IS_EQUAL(bcg.info(), Success);
+  VERIFY((A*X2.col(1) - B2.col(1)).norm() <= RealScalar(10) * tol * B2.col(1).norm());
+  VERIFY(bcg.iterations() <= iterations + 1);
+
+  // starting from the solution
+  X = bcg.solveWithGuess(B, X);
+  VERIFY(bcg.iterations() <= 1);
+
+  // without restarts, the block Krylov space contains the ones of the individual columns
+  n = internal::random<int>(15,20);
+  k = internal::random<int>(2,4);
+  B = DenseMatrix::Random(n*n, k);
+  B.col(0).setZero();
+  B.col(k-1) = B.col(1) * T(2);
+  A = block_krylov_problem<T>(n, 1);
+  BlockGMRES<SparseMatrix<T> > bgmres(A);
+  GMRES<SparseMatrix<T> > gmres(A);
+  bgmres.setTolerance(tol);
+  bgmres.set_restart(n*n);
+  gmres.setTolerance(tol);
+  gmres.set_restart(n*n);
+  X = bgmres.solve(B);
+  VERIFY_IS_EQUAL(bgmres.info(), Success);
+  VERIFY(bgmres.error() <= tol);
+  VERIFY(X.col(0).isZero());
+  for(int j=1; j<k; ++j)
+  {
+    VERIFY((A*X.col(j) - B.col(j)).norm() <= RealScalar(100) * tol * B.col(j).norm());
+    Matrix<T,Dynamic,1> x = gmres.solve(B.col(j));
+    VERIFY(bgmres.iterations() <= gmres.iterations());
+  }
+
+  // with restarts
+  bgmres.set_restart(internal::random<int>(5,10));
+  bgmres.setMaxIterations(10*n*n);
+  X = bgmres.solve(B);
+  VERIFY_IS_EQUAL(bgmres.info(), Success);
+  VERIFY((A*X - B).norm() <= RealScalar(100) * tol * B.norm());
+}
+
+void test_block_krylov()
+{
+  CALL_SUBTEST_1(test_block_krylov_T<double>());
+  CALL_SUBTEST_2(test_block_krylov_T<std::complex<double> >());
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_3(test_block_krylov_multiple_rhs<double>());
+    CALL_SUBTEST_4(test_block_krylov_multiple_rhs<std::complex<double> >());
+  }
+}
@@ -0,0 +1,102 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "../../test/sparse_solver.h"
+#include <Eigen/IterativeSolvers>
+
+template<typename T> void test_gcrodr_T()
+{
+  GCRODR<SparseMatrix<T>, DiagonalPreconditioner<T> > gcrodr_colmajor_diag;
+  GCRODR<SparseMatrix<T>, IncompleteLUT<T> >          gcrodr_colmajor_ilut;
+
+  CALL_SUBTEST( check_sparse_square_solving(gcrodr_colmajor_diag) );
+  CALL_SUBTEST( check_sparse_square_solving(gcrodr_colmajor_ilut) );
+}
+
+// upwind finite difference discretization of -laplacian(u) + a.grad(u) + s*u on a n x n grid
+template<typename Scalar>
+SparseMatrix<Scalar> gcrodr_convection_diffusion(int n, double a, double s)
+{
+  std::vector<Triplet<Scalar> > triplets;
+  for(int i=0; i<n; ++i)
+    for(int j=0; j<n; ++j)
+    {
+      int k = i*n+j;
+      triplets.push_back(Triplet<Scalar>(k, k, Scalar(4 + a + s)));
+      if(i>0)   triplets.push_back(Triplet<Scalar>(k, k-n, Scalar(-1 - a)));
+      if(i<n-1) triplets.push_back(Triplet<Scalar>(k, k+n, Scalar(-1)));
+      if(j>0)   triplets.push_back(Triplet<Scalar>(k, k-1, Scalar(-1)));
+      if(j<n-1) triplets.push_back(Triplet<Scalar>(k, k+1, Scalar(-1)));
+    }
+  SparseMatrix<Scalar> A(n*n, n*n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  return A;
+}
+
+template<typename T> void test_gcrodr_sequence()
+{
+  typedef Matrix<T,Dynamic,1> VectorType;
+  typedef typename NumTraits<T>::Real RealScalar;
+  const RealScalar tol(1e-8);
+  const int n = internal::random<int>(20,30);
+  const int steps = 6;
+
+  GCRODR<SparseMatrix<T> > recycled, restarted;
+  recycled.setTolerance(tol);
+  restarted.setTolerance(tol);
+  recycled.setMaxIterations(20*n*n);
+  restarted.setMaxIterations(20*n*n);
+  restarted.setRecycleSize(0);
+  VERIFY_IS_EQUAL(recycled.recycleSize(), 10);
+
+  int recycledIterations = 0, restartedIterations = 0;
+  VectorType b = VectorType::Random(n*n);
+  for(int step=0; step<steps; ++step)
+  {
+    // slowly changing matrices and right hand sides
+    SparseMatrix<T> A = gcrodr_convection_diffusion<T>(n, 0.1 + 0.02*step, 1e-3*step);
+    b += RealScalar(0.1) * VectorType::Random(n*n);
+
+    recycled.compute(A);
+    VectorType x = recycled.solve(b);
+    VERIFY_IS_EQUAL(recycled.info(), Success);
+    VERIFY((A*x - b).norm() <= RealScalar(10) * tol * b.norm());
+    VERIFY_IS_EQUAL(recycled.recycleSpace().cols(), 10);
+    // the first system builds the recycled subspace
+    if(step>0) recycledIterations += recycled.iterations();
+
+    restarted.compute(A);
+    x = restarted.solve(b);
+    VERIFY_IS_EQUAL(restarted.info(), Success);
+    VERIFY((A*x - b).norm() <= RealScalar(10) * tol * b.norm());
+    VERIFY_IS_EQUAL(restarted.recycleSpace().cols(), 0);
+    if(step>0) restartedIterations += restarted.iterations();
+  }
+  VERIFY(2 * recycledIterations < restartedIterations);
+
+  // starting from the solution
+  SparseMatrix<T> A = gcrodr_convection_diffusion<T>(n, 0.7, 0.0);
+  recycled.compute(A);
+  VectorType x = recycled.solve(b);
+  x = recycled.solveWithGuess(b, x);
+  VERIFY(recycled.iterations() == 0);
+
+  recycled.clearRecycleSpace();
+  VERIFY_IS_EQUAL(recycled.recycleSpace().cols(), 0);
+  x = recycled.solve(b);
+  VERIFY_IS_EQUAL(recycled.info(), Success);
+}
+
+void test_gcrodr()
+{
+  CALL_SUBTEST_1(test_gcrodr_T<double>());
+  CALL_SUBTEST_2(test_gcrodr_T<std::complex<double> >());
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_3(test_gcrodr_sequence<double>());
+    CALL_SUBTEST_4(test_gcrodr_sequence<std::complex<double> >());
+  }
+}
@@ -0,0 +1,213 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <unsupported/Eigen/KrylovEigenSolvers>
+
+// A matrix-free operator wrapping a matrix through its products only
+template<typename _MatrixType>
+class KrylovTestOperator
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+
+    KrylovTestOperator(const MatrixType& mat) : m_mat(mat) {}
+    Index rows() const { return m_mat.rows(); }
+    Index cols() const { return m_mat.cols(); }
+    template<typename Rhs>
+    Matrix<Scalar,Dynamic,1> operator*(const MatrixBase<Rhs>& x) const { return m_mat * x; }
+
+  protected:
+    const MatrixType& m_mat;
+};
+
+// sorts the reference eigenvalues according to the selection
+template<typename ValuesType>
+ValuesType krylov_sorted_reference(const ValuesType& values, int selection)
+{
+  Matrix<typename ValuesType::Index,Dynamic,1> perm;
+  internal::krylov_sort_eigenvalues(values, selection, perm);
+  ValuesType sorted(values.size());
+  for(typename ValuesType::Index i=0; i<values.size(); ++i)
+    sorted(i) = values(perm(i));
+  return sorted;
+}
+
+// symmetric matrix with the spectrum 1..n slightly perturbed
+template<typename Scalar>
+SparseMatrix<Scalar> krylov_selfadjoint_matrix(int n)
+{
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  SparseMatrix<Scalar> A(n,n), B(n,n);
+  std::vector<Triplet<Scalar> > triplets;
+  for(int i=0; i<n; ++i)
+  {
+    triplets.push_back(Triplet<Scalar>(i, i, Scalar(RealScalar(i+1))));
+    for(int k=0; k<3; ++k)
+      triplets.push_back(Triplet<Scalar>(internal::random<int>(0,n-1), i, internal::random<Scalar>() * RealScalar(0.1)));
+  }
+  B.setFromTriplets(triplets.begin(), triplets.end());
+  A = SparseMatrix<Scalar>(B.adjoint()) + B;
+  return A;
+}
+
+// general matrix with the spectrum 1..n slightly perturbed, and a few complex conjugate pairs
+template<typename Scalar>
+SparseMatrix<Scalar> krylov_general_matrix(int n)
+{
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  SparseMatrix<Scalar> A(n,n);
+  std::vector<Triplet<Scalar> > triplets;
+  for(int i=0; i<n; ++i)
+  {
+    triplets.push_back(Triplet<Scalar>(i, i, Scalar(RealScalar(i+1))));
+    for(int k=0; k<3; ++k)
+      triplets.push_back(Triplet<Scalar>(internal::random<int>(0,n-1), i, internal::random<Scalar>() * RealScalar(0.1)));
+  }
+  for(int i=0; i+1<n; i+=7)
+  {
+    triplets.push_back(Triplet<Scalar>(i, i+1, Scalar(RealScalar(2))));
+    triplets.push_back(Triplet<Scalar>(i+1, i, Scalar(RealScalar(-2))));
+  }
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  return A;
+}
+
+template<typename OperatorType, typename Scalar>
+void lanczos_check(const OperatorType& op, const SparseMatrix<Scalar>& A, int nev, int selection)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  LanczosSelfAdjointEigenSolver<OperatorType> es(op, nev, selection);
+  VERIFY_IS_EQUAL(es.info(), Success);
+  VERIFY_IS_EQUAL(es.eigenvalues().size(), nev);
+
+  SelfAdjointEigenSolver<DenseType> ref(DenseType(A), EigenvaluesOnly);
+  Matrix<RealScalar,Dynamic,1> refValues = ref.eigenvalues();
+  VERIFY_IS_APPROX(es.eigenvalues(), krylov_sorted_reference(refValues, selection).head(nev));
+  VERIFY_IS_UNITARY(es.eigenvectors());
+  VERIFY_IS_APPROX(DenseType(A * es.eigenvectors()), DenseType(es.eigenvectors() * es.eigenvalues().template cast<Scalar>().asDiagonal()));
+}
+
+template<typename Scalar> void lanczos(int n)
+{
+  using std::abs;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef SparseMatrix<Scalar> SparseType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+  int nev = internal::random<int>(1,6);
+  SparseType A = krylov_selfadjoint_matrix<Scalar>(n);
+
+  lanczos_check(A, A, nev, LargestMagnitude);
+  lanczos_check(A, A, nev, LargestAlgebraic);
+  lanczos_check(A, A, nev, SmallestAlgebraic);
+
+  // dense and matrix-free operators
+  DenseType dA(A);
+  lanczos_check(dA, A, nev, LargestAlgebraic);
+  KrylovTestOperator<SparseType> op(A);
+  lanczos_check(op, A, nev, LargestMagnitude);
+
+  // eigenvalues closest to a shift in the middle of the spectrum
+  typedef ShiftInvertOperator<SparseType, SimplicialLDLT<SparseType> > ShiftInvertType;
+  ShiftInvertType shiftInvert(A, Scalar(n/2 + 0.5));
+  VERIFY_IS_EQUAL(shiftInvert.info(), Success);
+  LanczosSelfAdjointEigenSolver<ShiftInvertType> es(shiftInvert, nev);
+  VERIFY_IS_EQUAL(es.info(), Success);
+  VERIFY_IS_APPROX(DenseType(A * es.eigenvectors()), DenseType(es.eigenvectors() * es.eigenvalues().template cast<Scalar>().asDiagonal()));
+  SelfAdjointEigenSolver<DenseType> ref(dA, EigenvaluesOnly);
+  for(int i=0; i<nev; ++i)
+  {
+    // the eigenvalues are sorted by increasing distance to the shift
+    typename DenseType::Index closest;
+    (ref.eigenvalues().array() - es.eigenvalues()(i)).abs().minCoeff(&closest);
+    VERIFY_IS_APPROX(es.eigenvalues()(i), ref.eigenvalues()(closest));
+    VERIFY(abs(es.eigenvalues()(i) - (n/2 + 0.5)) < RealScalar(nev)+1);
+  }
+
+  // eigenvalues only
+  LanczosSelfAdjointEigenSolver<SparseType> esValues;
+  esValues.setSubspaceSize(2*nev+2).compute(A, nev, LargestAlgebraic, EigenvaluesOnly);
+  VERIFY_IS_EQUAL(esValues.info(), Success);
+  VERIFY_IS_APPROX(esValues.eigenvalues(), krylov_sorted_reference(ref.eigenvalues(), LargestAlgebraic).head(nev));
+}
+
+template<typename OperatorType, typename Scalar>
+void krylov_schur_check(const OperatorType& op, const SparseMatrix<Scalar>& A, int nev, int selection)
+{
+  using std::abs;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef std::complex<RealScalar> ComplexScalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+  typedef Matrix<ComplexScalar,Dynamic,Dynamic> ComplexDenseType;
+
+  KrylovSchurEigenSolver<OperatorType> es(op, nev, selection);
+  VERIFY_IS_EQUAL(es.info(), Success);
+  VERIFY_IS_EQUAL(es.eigenvalues().size(), nev);
+
+  // compare the selection keys, the order within conjugate pairs being arbitrary
+  Matrix<ComplexScalar,Dynamic,1> refValues = ComplexEigenSolver<ComplexDenseType>(DenseType(A).template cast<ComplexScalar>(), false).eigenvalues();
+  Matrix<ComplexScalar,Dynamic,1> sorted = krylov_sorted_reference(refValues, selection);
+  for(int i=0; i<nev; ++i)
+  {
+    if(selection==LargestMagnitude || selection==SmallestMagnitude)
+      VERIFY_IS_APPROX(abs(es.eigenvalues()(i)), abs(sorted(i)));
+    else
+      VERIFY_IS_APPROX(numext::real(es.eigenvalues()(i)), numext::real(sorted(i)));
+  }
+  ComplexDenseType X = es.eigenvectors();
+  VERIFY_IS_APPROX(X.colwise().norm(), (Matrix<RealScalar,1,Dynamic>::Ones(nev)));
+  VERIFY_IS_APPROX(ComplexDenseType(DenseType(A).template cast<ComplexScalar>() * X), ComplexDenseType(X * es.eigenvalues().asDiagonal()));
+}
+
+template<typename Scalar> void krylov_schur(int n)
+{
+  using std::abs;
+  typedef SparseMatrix<Scalar> SparseType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+  int nev = internal::random<int>(1,6);
+  SparseType A = krylov_general_matrix<Scalar>(n);
+
+  krylov_schur_check(A, A, nev, LargestMagnitude);
+  krylov_schur_check(A, A, nev, LargestAlgebraic);
+
+  // dense and matrix-free operators
+  DenseType dA(A);
+  krylov_schur_check(dA, A, nev, LargestMagnitude);
+  KrylovTestOperator<SparseType> op(A);
+  krylov_schur_check(op, A, nev, LargestAlgebraic);
+
+  // smallest eigenvalues using a shift-and-invert transformation
+  typedef ShiftInvertOperator<SparseType, SparseLU<SparseType> > ShiftInvertType;
+  ShiftInvertType shiftInvert(A, Scalar(0));
+  VERIFY_IS_EQUAL(shiftInvert.info(), Success);
+  KrylovSchurEigenSolver<ShiftInvertType> es(shiftInvert, nev);
+  VERIFY_IS_EQUAL(es.info(), Success);
+  typedef typename KrylovSchurEigenSolver<ShiftInvertType>::EigenvectorsType ComplexDenseType;
+  typedef typename ComplexDenseType::Scalar ComplexScalar;
+  ComplexDenseType X = es.eigenvectors();
+  VERIFY_IS_APPROX(ComplexDenseType(dA.template cast<ComplexScalar>() * X), ComplexDenseType(X * es.eigenvalues().asDiagonal()));
+  Matrix<ComplexScalar,Dynamic,1> refValues = ComplexEigenSolver<ComplexDenseType>(dA.template cast<ComplexScalar>(), false).eigenvalues();
+  Matrix<ComplexScalar,Dynamic,1> sorted = krylov_sorted_reference(refValues, SmallestMagnitude);
+  for(int i=0; i<nev; ++i)
+    VERIFY_IS_APPROX(abs(es.eigenvalues()(i)), abs(sorted(i)));
+}
+
+void test_krylov_eigensolvers()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(( lanczos<double>(internal::random<int>(50,300)) ));
+    CALL_SUBTEST_2(( lanczos<std::complex<double> >(internal::random<int>(50,200)) ));
+    CALL_SUBTEST_3(( krylov_schur<double>(internal::random<int>(50,300)) ));
+    CALL_SUBTEST_4(( krylov_schur<std::complex<double> >(internal::random<int>(50,200)) ));
+    CALL_SUBTEST_5(( lanczos<double>(20) ));
+    CALL_SUBTEST_5(( krylov_schur<double>(20) ));
+  }
+}
@@ -0,0 +1,172 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// small chunks such that the files are read in several of them
+#define EIGEN_MARKET_IO_CHUNK_SIZE 4096
+
+#include "sparse.h"
+#include <Eigen/SparseExtra>
+#include <cstdio>
+
+template<typename SparseMatrixType> void market_io_roundtrip(const SparseMatrixType& ref, double density)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  const std::string filename = "market_io_roundtrip.mtx";
+
+  Matrix<Scalar,Dynamic,Dynamic> refMat(ref.rows(), ref.cols());
+  SparseMatrixType m(ref.rows(), ref.cols());
+  initSparse<Scalar>(density, refMat, m);
+
+  VERIFY(saveMarket(m, filename));
+  SparseMatrixType m1;
+  VERIFY(loadMarket(m1, filename));
+  VERIFY_IS_EQUAL(m1.rows(), m.rows());
+  VERIFY_IS_EQUAL(m1.cols(), m.cols());
+  VERIFY_IS_EQUAL(m1.nonZeros(), m.nonZeros());
+  // the values are read back exactly
+  VERIFY(m1.toDense() == refMat);
+
+  // the other storage order
+  SparseMatrix<Scalar,(SparseMatrixType::Flags&RowMajorBit) ? ColMajor : RowMajor> m2;
+  VERIFY(loadMarket(m2, filename));
+  VERIFY(m2.toDense() == refMat);
+
+  std::remove(filename.c_str());
+}
+
+void market_io_text()
+{
+  const std::string filename = "market_io_text.mtx";
+
+  // comments, blank lines, spaces, carriage returns, and no final end of line
+  {
+    std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+    out << "%%MatrixMarket matrix coordinate real general\n"
+        << "% a comment\n"
+        << "%\n"
+        << "3 4 5\n"
+        << "1 1 1.5\n"
+        << "\n"
+        << "  2\t3   -2e-3\r\n"
+        << "% another comment\n"
+        << "3 4 .25\n"
+        << "1 2 7\n"
+        << "3 1 1E2";
+  }
+  MatrixXd ref = MatrixXd::Zero(3,4);
+  ref(0,0) = 1.5; ref(1,2) = -2e-3; ref(2,3) = .25; ref(0,1) = 7; ref(2,0) = 1e2;
+  SparseMatrix<double> m;
+  VERIFY(loadMarket(m, filename));
+  VERIFY_IS_EQUAL(m.nonZeros(), 5);
+  VERIFY(m.toDense() == ref);
+  SparseMatrix<float,RowMajor> mf;
+  VERIFY(loadMarket(mf, filename));
+  VERIFY(mf.toDense() == ref.cast<float>());
+
+  // pattern matrices
+  {
+    std::ofstream out(filename.c_str(), std::ios::out);
+    out << "%%MatrixMarket matrix coordinate pattern general\n"
+        << "2 3 3\n"
+        << "1 1\n"
+        << "2 3\n"
+        << "1 3\n";
+  }
+  VERIFY(loadMarket(m, filename));
+  ref = MatrixXd::Zero(2,3);
+  ref(0,0) = ref(1,2) = ref(0,2) = 1;
+  VERIFY(m.toDense() == ref);
+
+  // complex matrices, and duplicated entries which are summed
+  {
+    std::ofstream out(filename.c_str(), std::ios::out);
+    out << "%%MatrixMarket matrix coordinate complex general\n"
+        << "2 2 3\n"
+        << "1 1 1 -1\n"
+        << "2 1 0.5 2\n"
+        << "1 1 1 1\n";
+  }
+  SparseMatrix<std::complex<double> > mc;
+  VERIFY(loadMarket(mc, filename));
+  VERIFY_IS_EQUAL(mc.nonZeros(), 2);
+  VERIFY(mc.coeff(0,0) == std::complex<double>(2,0));
+  VERIFY(mc.coeff(1,0) == std::complex<double>(0.5,2));
+
+  // entries out of range or incomplete are skipped
+  {
+    std::ofstream out(filename.c_str(), std::ios::out);
+    out << "%%MatrixMarket matrix coordinate real general\n"
+        << "2 2 4\n"
+        << "1 1 1\n"
+        << "3 1 1\n"
+        << "2 2\n"
+        << "2 1 4\n";
+  }
+  std::streambuf* cerrBuf = std::cerr.rdbuf(0);
+  VERIFY(loadMarket(m, filename));
+  std::cerr.rdbuf(cerrBuf);
+  VERIFY_IS_EQUAL(m.nonZeros(), 2);
+  VERIFY_IS_EQUAL(m.coeff(0,0), 1.);
+  VERIFY_IS_EQUAL(m.coeff(1,0), 4.);
+
+  // no entries, and no final end of line
+  {
+    std::ofstream out(filename.c_str(), std::ios::out);
+    out << "%%MatrixMarket matrix coordinate real general\n"
+        << "3 2 0";
+  }
+  VERIFY(loadMarket(m, filename));
+  VERIFY_IS_EQUAL(m.rows(), 3);
+  VERIFY_IS_EQUAL(m.cols(), 2);
+  VERIFY_IS_EQUAL(m.nonZeros(), 0);
+
+  // indices overflowing Index are invalid, instead of wrapping around into the range
+  {
+    std::ofstream out(filename.c_str(), std::ios::out);
+    out << "%%MatrixMarket matrix coordinate real general\n"
+        << "2 2 2\n"
+        << "1 1 1\n"
+        << "18446744073709551617 1 2\n";
+  }
+  cerrBuf = std::cerr.rdbuf(0);
+  VERIFY(loadMarket(m, filename));
+  std::cerr.rdbuf(cerrBuf);
+  VERIFY_IS_EQUAL(m.nonZeros(), 1);
+  VERIFY_IS_EQUAL(m.coeff(0,0), 1.);
+  {
+    std::ofstream out(filename.c_str(), std::ios::out);
+    out << "%%MatrixMarket matrix coordinate real general\n"
+        << "4294967297 2 1\n"
+        << "1 1 1\n";
+  }
+  // 2^32+1 rows do not fit the int indices of m
+  VERIFY(!loadMarket(m, filename));
+
+  // no size line
+  {
+    std::ofstream out(filename.c_str(), std::ios::out);
+    out << "%%MatrixMarket matrix coordinate real general\n";
+  }
+  VERIFY(!loadMarket(m, filename));
+  VERIFY(!loadMarket(m, "market_io_missing.mtx"));
+
+  std::remove(filename.c_str());
+}
+
+void test_market_io()
+{
+  CALL_SUBTEST_1( market_io_text() );
+  for(int i = 0; i < g_repeat; i++) {
+    int r = internal::random<int>(1,200), c = internal::random<int>(1,200);
+    CALL_SUBTEST_1( market_io_roundtrip(SparseMatrix<double>(r,c), 0.1) );
+    CALL_SUBTEST_2( market_io_roundtrip(SparseMatrix<float,RowMajor>(r,c), 0.1) );
+    CALL_SUBTEST_3( market_io_roundtrip(SparseMatrix<std::complex<double>,ColMajor,long>(r,c), 0.1) );
+    CALL_SUBTEST_4( market_io_roundtrip(SparseMatrix<long double>(r,c), 0.1) );
+  }
+  // several blocks of entries
+  CALL_SUBTEST_1( market_io_roundtrip(SparseMatrix<double>(1000,800), 0.2) );
+}
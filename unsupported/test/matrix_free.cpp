@@ -0,0 +1,150 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/IterativeSolvers>
+#include <Eigen/src/IterativeSolvers/DGMRES.h>
+
+// 5-point finite difference discretization of -div(grad u) + c.grad u on a n x n grid,
+// applied without assembling the matrix
+template<typename Scalar>
+struct convection_diffusion_stencil
+{
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  convection_diffusion_stencil() : n(0), c(0) {}
+
+  void operator()(const Ref<const VectorType>& x, Ref<VectorType> y) const
+  {
+    const Scalar diag(4+2*c), west(-1-c), east(-1);
+    for(int i=0; i<n; ++i)
+      for(int j=0; j<n; ++j)
+      {
+        int k = i*n+j;
+        Scalar v = diag * x(k);
+        if(i>0)   v += west * x(k-n);
+        if(i<n-1) v += east * x(k+n);
+        if(j>0)   v += west * x(k-1);
+        if(j<n-1) v += east * x(k+1);
+        y(k) = v;
+      }
+  }
+
+  int n;
+  double c;
+};
+
+template<typename Scalar>
+SparseMatrix<Scalar> convection_diffusion_matrix(int n, double c)
+{
+  std::vector<Triplet<Scalar> > triplets;
+  for(int i=0; i<n; ++i)
+    for(int j=0; j<n; ++j)
+    {
+      int k = i*n+j;
+      triplets.push_back(Triplet<Scalar>(k, k, Scalar(4+2*c)));
+      if(i>0)   triplets.push_back(Triplet<Scalar>(k, k-n, Scalar(-1-c)));
+      if(i<n-1) triplets.push_back(Triplet<Scalar>(k, k+n, Scalar(-1)));
+      if(j>0)   triplets.push_back(Triplet<Scalar>(k, k-1, Scalar(-1-c)));
+      if(j<n-1) triplets.push_back(Triplet<Scalar>(k, k+1, Scalar(-1)));
+    }
+  SparseMatrix<Scalar> A(n*n, n*n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  return A;
+}
+
+template<typename Solver, typename Operator, typename Scalar>
+void check_matrix_free_solving(Solver& solver, const Operator& op, const SparseMatrix<Scalar>& A)
+{
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  VectorType b = VectorType::Random(A.rows());
+  solver.setTolerance(RealScalar(1e-10));
+  solver.compute(op);
+  VectorType x = solver.solve(b);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  VERIFY((A*x - b).norm() <= RealScalar(1e-8) * b.norm());
+
+  // starting from the solution
+  VectorType x0 = solver.solveWithGuess(b, x);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  VERIFY((A*x0 - b).norm() <= RealScalar(1e-8) * b.norm());
+
+  // several right hand sides
+  DenseMatrix B = DenseMatrix::Random(A.rows(), 2);
+  DenseMatrix X = solver.solve(B);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  VERIFY((A*X - B).norm() <= RealScalar(1e-8) * B.norm());
+}
+
+template<typename Scalar> void test_matrix_free_T()
+{
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef convection_diffusion_stencil<Scalar> Stencil;
+  typedef MatrixFreeOperator<Scalar,Stencil> Operator;
+
+  int n = internal::random<int>(4,16);
+  Stencil stencil;
+  stencil.n = n;
+  Operator sym(n*n, n*n, stencil);
+  stencil.c = 1;
+  Operator nonsym(n*n, n*n, stencil);
+  SparseMatrix<Scalar> A_sym = convection_diffusion_matrix<Scalar>(n, 0);
+  SparseMatrix<Scalar> A_nonsym = convection_diffusion_matrix<Scalar>(n, 1);
+
+  // products, in expressions, by matrices, and in place
+  VectorType x = VectorType::Random(n*n), y;
+  y = nonsym * x;
+  VERIFY_IS_APPROX(y, A_nonsym * x);
+  y.noalias() = nonsym * x;
+  VERIFY_IS_APPROX(y, A_nonsym * x);
+  VERIFY_IS_APPROX(x - nonsym * x, x - A_nonsym * x);
+  DenseMatrix X = DenseMatrix::Random(n*n, 3), Y;
+  Y.noalias() = nonsym * X;
+  VERIFY_IS_APPROX(Y, A_nonsym * X);
+  VERIFY_IS_APPROX(Y.col(1), nonsym * X.col(1));
+  y = A_nonsym * x;
+  x = nonsym * x;
+  VERIFY_IS_APPROX(x, y);
+
+  ConjugateGradient<Operator, Lower, IdentityPreconditioner> cg;
+  BiCGSTAB<Operator, IdentityPreconditioner> bicgstab;
+  GMRES<Operator, IdentityPreconditioner> gmres;
+
+  CALL_SUBTEST( check_matrix_free_solving(cg, sym, A_sym) );
+  CALL_SUBTEST( check_matrix_free_solving(bicgstab, nonsym, A_nonsym) );
+  CALL_SUBTEST( check_matrix_free_solving(gmres, nonsym, A_nonsym) );
+}
+
+// MINRES only supports real scalars, and DGMRES stagnates on complex problems with tight tolerances
+template<typename Scalar> void test_matrix_free_real()
+{
+  typedef convection_diffusion_stencil<Scalar> Stencil;
+  typedef MatrixFreeOperator<Scalar,Stencil> Operator;
+
+  int n = internal::random<int>(4,16);
+  Stencil stencil;
+  stencil.n = n;
+  Operator sym(n*n, n*n, stencil);
+  stencil.c = 1;
+  Operator nonsym(n*n, n*n, stencil);
+  MINRES<Operator, Lower|Upper, IdentityPreconditioner> minres;
+  DGMRES<Operator, IdentityPreconditioner> dgmres;
+  CALL_SUBTEST( check_matrix_free_solving(minres, sym, convection_diffusion_matrix<Scalar>(n, 0)) );
+  CALL_SUBTEST( check_matrix_free_solving(dgmres, nonsym, convection_diffusion_matrix<Scalar>(n, 1)) );
+}
+
+void test_matrix_free()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(test_matrix_free_T<double>());
+    CALL_SUBTEST_1(test_matrix_free_real<double>());
+    CALL_SUBTEST_2(test_matrix_free_T<std::complex<double> >());
+  }
+}
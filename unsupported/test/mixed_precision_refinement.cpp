@@ -0,0 +1,121 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "sparse.h"
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseLU>
+#include <unsupported/Eigen/IterativeSolvers>
+
+template<typename Solver, typename MatrixType, typename Rhs>
+void check_mixed_precision_solving(Solver& solver, const MatrixType& A, const Rhs& b, const Rhs& ref)
+{
+  typedef typename Solver::RealScalar RealScalar;
+  typedef typename Rhs::PlainObject PlainObject;
+
+  solver.compute(A);
+  PlainObject x = solver.solve(b);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  VERIFY(solver.error() <= NumTraits<RealScalar>::epsilon());
+  VERIFY(solver.iterations() <= solver.maxIterations());
+  VERIFY_IS_APPROX(x, ref);
+
+  // the low precision solution alone does not reach the working precision
+  solver.setMaxIterations(0);
+  x = solver.solve(b);
+  VERIFY(!internal::isApprox(solver.error(), RealScalar(0), RealScalar(1e-12)) || x.isApprox(ref));
+  solver.setMaxIterations(10);
+}
+
+template<typename Scalar> void test_mixed_precision_dense()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef typename internal::conditional<NumTraits<Scalar>::IsComplex, std::complex<float>, float>::type LowScalar;
+  typedef Matrix<LowScalar,Dynamic,Dynamic> LowMatrixType;
+
+  int n = internal::random<int>(10,200);
+  int k = internal::random<int>(1,4);
+  MatrixType A = MatrixType::Random(n,n);
+  A.diagonal().array() += Scalar(RealScalar(n));
+  MatrixType spd = A * A.adjoint();
+  MatrixType b = MatrixType::Random(n,k);
+
+  MixedPrecisionRefinement<MatrixType, PartialPivLU<LowMatrixType> > lu;
+  MatrixType ref = A.partialPivLu().solve(b);
+  CALL_SUBTEST( check_mixed_precision_solving(lu, A, b, ref) );
+  lu.setMethod(GMRESRefinement);
+  CALL_SUBTEST( check_mixed_precision_solving(lu, A, b, ref) );
+
+  MixedPrecisionRefinement<MatrixType, LLT<LowMatrixType> > llt;
+  ref = spd.llt().solve(b);
+  CALL_SUBTEST( check_mixed_precision_solving(llt, spd, b, ref) );
+}
+
+// a matrix whose condition number 1e8 is beyond the reach of the classical refinement with float factors
+template<typename Scalar> void test_mixed_precision_ill_conditioned()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  int n = internal::random<int>(20,100);
+  MatrixType U = MatrixType::Random(n,n).householderQr().householderQ();
+  MatrixType V = MatrixType::Random(n,n).householderQr().householderQ();
+  VectorType s(n);
+  for(int i=0; i<n; ++i)
+    s(i) = Scalar(std::pow(RealScalar(10), -RealScalar(8)*RealScalar(i)/RealScalar(n-1)));
+  MatrixType A = U * s.asDiagonal() * V.adjoint();
+  VectorType b = VectorType::Random(n);
+
+  MixedPrecisionRefinement<MatrixType, PartialPivLU<MatrixXf> > solver(A);
+  solver.setMethod(GMRESRefinement);
+  VectorType x = solver.solve(b);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  VERIFY(solver.error() <= NumTraits<RealScalar>::epsilon());
+  int gmresIterations = solver.iterations();
+
+  solver.setMethod(ClassicalRefinement);
+  x = solver.solve(b);
+  VERIFY(solver.info()!=Success || solver.iterations() > gmresIterations);
+}
+
+template<typename Scalar> void test_mixed_precision_sparse()
+{
+  typedef SparseMatrix<Scalar> MatrixType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+  int n = internal::random<int>(10,300);
+  MatrixType A(n,n);
+  DenseMatrix dA(n,n);
+  initSparse<Scalar>(0.05, dA, A, ForceNonZeroDiag);
+  MatrixType I(n,n);
+  I.setIdentity();
+  A = A + Scalar(10) * I;
+  MatrixType spd = A * MatrixType(A.adjoint());
+  VectorType b = VectorType::Random(n);
+
+  MixedPrecisionRefinement<MatrixType, SparseLU<SparseMatrix<float>, COLAMDOrdering<int> > > lu;
+  VectorType ref = DenseMatrix(A).partialPivLu().solve(b);
+  CALL_SUBTEST( check_mixed_precision_solving(lu, A, b, ref) );
+
+  MixedPrecisionRefinement<MatrixType, SimplicialLDLT<SparseMatrix<float> > > ldlt;
+  ref = DenseMatrix(spd).llt().solve(b);
+  CALL_SUBTEST( check_mixed_precision_solving(ldlt, spd, b, ref) );
+  ldlt.setMethod(GMRESRefinement);
+  CALL_SUBTEST( check_mixed_precision_solving(ldlt, spd, b, ref) );
+}
+
+void test_mixed_precision_refinement()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(test_mixed_precision_dense<double>());
+    CALL_SUBTEST_2(test_mixed_precision_dense<std::complex<double> >());
+    CALL_SUBTEST_3(test_mixed_precision_ill_conditioned<double>());
+    CALL_SUBTEST_4(test_mixed_precision_sparse<double>());
+  }
+}
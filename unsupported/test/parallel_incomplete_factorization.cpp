@@ -0,0 +1,137 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "../../test/sparse_solver.h"
+#include <Eigen/IterativeSolvers>
+
+template<typename T> void test_parallel_incomplete_factorization_T()
+{
+  ConjugateGradient<SparseMatrix<T>, Lower, ParallelIncompleteCholesky<T, Lower> > cg_ic0_lower;
+  ConjugateGradient<SparseMatrix<T>, Upper, ParallelIncompleteCholesky<T, Upper> > cg_ic0_upper;
+  ConjugateGradient<SparseMatrix<T>, Lower, ParallelIncompleteCholesky<T, Lower> > cg_ic0_color;
+  BiCGSTAB<SparseMatrix<T>, ParallelIncompleteLU<T> > bicgstab_ilu0;
+  BiCGSTAB<SparseMatrix<T>, ParallelIncompleteLU<T> > bicgstab_ilu0_color;
+  cg_ic0_color.preconditioner().setOrdering(MulticolorOrdering);
+  bicgstab_ilu0_color.preconditioner().setOrdering(MulticolorOrdering);
+
+  CALL_SUBTEST( check_sparse_spd_solving(cg_ic0_lower) );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_ic0_upper) );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_ic0_color) );
+  CALL_SUBTEST( check_sparse_square_solving(bicgstab_ilu0) );
+  CALL_SUBTEST( check_sparse_square_solving(bicgstab_ilu0_color) );
+}
+
+// 5-point finite difference discretization of -div(grad u) + c.grad u on a n x n grid
+template<typename Scalar>
+SparseMatrix<Scalar> incomplete_factorization_problem(int n, double c)
+{
+  std::vector<Triplet<Scalar> > triplets;
+  for(int i=0; i<n; ++i)
+    for(int j=0; j<n; ++j)
+    {
+      int k = i*n+j;
+      triplets.push_back(Triplet<Scalar>(k, k, Scalar(4+2*c)));
+      if(i>0)   triplets.push_back(Triplet<Scalar>(k, k-n, Scalar(-1-c)));
+      if(i<n-1) triplets.push_back(Triplet<Scalar>(k, k+n, Scalar(-1)));
+      if(j>0)   triplets.push_back(Triplet<Scalar>(k, k-1, Scalar(-1-c)));
+      if(j<n-1) triplets.push_back(Triplet<Scalar>(k, k+1, Scalar(-1)));
+    }
+  SparseMatrix<Scalar> A(n*n, n*n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  return A;
+}
+
+// sequential dense ILU(0), in the IKJ order
+template<typename T>
+Matrix<T,Dynamic,1> dense_ilu0_solve(const SparseMatrix<T>& A, const Matrix<T,Dynamic,1>& b)
+{
+  typedef Matrix<T,Dynamic,Dynamic> DenseMatrix;
+  const int n = A.rows();
+  DenseMatrix pattern = DenseMatrix(A).cwiseAbs().template cast<T>();
+  DenseMatrix lu = A;
+  for(int i=1; i<n; ++i)
+    for(int k=0; k<i; ++k)
+      if(pattern(i,k)!=T(0))
+      {
+        lu(i,k) /= lu(k,k);
+        for(int j=k+1; j<n; ++j)
+          if(pattern(i,j)!=T(0))
+            lu(i,j) -= lu(i,k) * lu(k,j);
+      }
+  Matrix<T,Dynamic,1> x = lu.template triangularView<UnitLower>().solve(b);
+  return lu.template triangularView<Upper>().solve(x);
+}
+
+// the level set ordering gives the sequential factors, the multicolor one few levels
+template<typename T> void test_parallel_incomplete_factorization_levels()
+{
+  typedef Matrix<T,Dynamic,1> VectorType;
+  typedef typename NumTraits<T>::Real RealScalar;
+
+  int n = internal::random<int>(8,30);
+  SparseMatrix<T> A = incomplete_factorization_problem<T>(n, 1);
+  VectorType b = VectorType::Random(n*n);
+
+  ParallelIncompleteLU<T> pilu(A);
+  VERIFY_IS_EQUAL(pilu.info(), Success);
+  VERIFY_IS_EQUAL(pilu.levels(), 2*n-1);
+  VectorType x = pilu.solve(b), ref = dense_ilu0_solve(A, b);
+  VERIFY_IS_APPROX(x, ref);
+
+  // red-black ordering of the grid
+  pilu.setOrdering(MulticolorOrdering).compute(A);
+  VERIFY_IS_EQUAL(pilu.info(), Success);
+  VERIFY_IS_EQUAL(pilu.levels(), 2);
+
+  BiCGSTAB<SparseMatrix<T>, ParallelIncompleteLU<T> > bicgstab;
+  bicgstab.setTolerance(RealScalar(1e-10));
+  bicgstab.preconditioner().setOrdering(MulticolorOrdering);
+  bicgstab.compute(A);
+  x = bicgstab.solve(b);
+  VERIFY_IS_EQUAL(bicgstab.info(), Success);
+  VERIFY((A*x - b).norm() <= RealScalar(1e-8) * b.norm());
+
+  // on a self-adjoint matrix, IC(0) and ILU(0) give the same preconditioner
+  A = incomplete_factorization_problem<T>(n, 0);
+  pilu.setOrdering(LevelSetOrdering).compute(A);
+  ParallelIncompleteCholesky<T> pic(A);
+  VERIFY_IS_EQUAL(pic.info(), Success);
+  VERIFY_IS_EQUAL(pic.shift(), RealScalar(0));
+  VERIFY_IS_EQUAL(pic.levels(), 2*n-1);
+  x = pic.solve(b);
+  ref = pilu.solve(b);
+  VERIFY_IS_APPROX(x, ref);
+
+  pic.setOrdering(MulticolorOrdering).compute(A);
+  pilu.setOrdering(MulticolorOrdering).compute(A);
+  VERIFY_IS_EQUAL(pic.levels(), 2);
+  x = pic.solve(b);
+  ref = pilu.solve(b);
+  VERIFY_IS_APPROX(x, ref);
+
+  ConjugateGradient<SparseMatrix<T>, Lower, ParallelIncompleteCholesky<T> > cg;
+  ConjugateGradient<SparseMatrix<T>, Lower> cg_diag;
+  cg.setTolerance(RealScalar(1e-10));
+  cg_diag.setTolerance(RealScalar(1e-10));
+  cg.compute(A);
+  cg_diag.compute(A);
+  x = cg.solve(b);
+  VERIFY_IS_EQUAL(cg.info(), Success);
+  VERIFY((A*x - b).norm() <= RealScalar(1e-8) * b.norm());
+  x = cg_diag.solve(b);
+  VERIFY(cg.iterations() < cg_diag.iterations());
+}
+
+void test_parallel_incomplete_factorization()
+{
+  CALL_SUBTEST_1(test_parallel_incomplete_factorization_T<double>());
+  CALL_SUBTEST_2(test_parallel_incomplete_factorization_T<std::complex<double> >());
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_3(test_parallel_incomplete_factorization_levels<double>());
+    CALL_SUBTEST_4(test_parallel_incomplete_factorization_levels<std::complex<double> >());
+  }
+}
@@ -0,0 +1,69 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "../../test/sparse_solver.h"
+#include <Eigen/IterativeSolvers>
+
+template<typename T> void test_pipelined_conjugate_gradient_T()
+{
+  PipelinedConjugateGradient<SparseMatrix<T>, Lower      > cg_colmajor_lower_diag;
+  PipelinedConjugateGradient<SparseMatrix<T>, Upper      > cg_colmajor_upper_diag;
+  PipelinedConjugateGradient<SparseMatrix<T>, Lower|Upper> cg_colmajor_loup_diag;
+  PipelinedConjugateGradient<SparseMatrix<T>, Lower, IdentityPreconditioner> cg_colmajor_lower_I;
+  PipelinedConjugateGradient<SparseMatrix<T>, Upper, IdentityPreconditioner> cg_colmajor_upper_I;
+
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_lower_diag)  );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_upper_diag)  );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_loup_diag)   );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_lower_I)     );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_upper_I)     );
+}
+
+// in exact arithmetic, the pipelined iterates are the ones of the classic algorithm
+template<typename T> void test_pipelined_conjugate_gradient_iterates()
+{
+  typedef typename NumTraits<T>::Real RealScalar;
+  typedef Matrix<T,Dynamic,1> VectorType;
+  int n = internal::random<int>(20,200);
+  SparseMatrix<T> M(n,n);
+  Matrix<T,Dynamic,Dynamic> dM(n,n);
+  initSparse<T>((std::max)(8./(n*n), 0.01), dM, M, ForceNonZeroDiag);
+  SparseMatrix<T> A = M * M.adjoint();
+  for(int i=0; i<n; ++i)
+    A.coeffRef(i,i) += T(n);
+  VectorType b = VectorType::Random(n);
+
+  ConjugateGradient<SparseMatrix<T>, Lower> cg(A);
+  PipelinedConjugateGradient<SparseMatrix<T>, Lower> pcg(A);
+  for(int iters=1; iters<=5; ++iters)
+  {
+    cg.setMaxIterations(iters);
+    pcg.setMaxIterations(iters);
+    VectorType x = cg.solve(b), y = pcg.solve(b);
+    VERIFY_IS_EQUAL(cg.iterations(), pcg.iterations());
+    VERIFY_IS_APPROX(x, y);
+  }
+
+  cg.setMaxIterations(n);
+  pcg.setMaxIterations(n);
+  cg.setTolerance(RealScalar(1e-10));
+  pcg.setTolerance(RealScalar(1e-10));
+  VectorType x = cg.solve(b), y = pcg.solve(b);
+  VERIFY_IS_EQUAL(pcg.info(), Success);
+  VERIFY((A*y - b).norm() <= RealScalar(1e-10) * b.norm());
+  VERIFY(pcg.iterations() <= cg.iterations() + 2);
+}
+
+void test_pipelined_conjugate_gradient()
+{
+  CALL_SUBTEST_1(test_pipelined_conjugate_gradient_T<double>());
+  CALL_SUBTEST_2(test_pipelined_conjugate_gradient_T<std::complex<double> >());
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_3(test_pipelined_conjugate_gradient_iterates<double>());
+    CALL_SUBTEST_3(test_pipelined_conjugate_gradient_iterates<std::complex<double> >());
+  }
+}
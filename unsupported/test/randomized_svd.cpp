@@ -0,0 +1,131 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <unsupported/Eigen/SVD>
+#include <Eigen/SparseCore>
+
+// A matrix-free operator wrapping a dense matrix through its products only
+template<typename _Scalar>
+class MatrixFreeOperator
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+    typedef typename DenseType::Index Index;
+
+    struct AdjointOperator
+    {
+      AdjointOperator(const DenseType& mat) : m_mat(mat) {}
+      template<typename Rhs>
+      DenseType operator*(const MatrixBase<Rhs>& x) const { return m_mat.adjoint() * x; }
+      const DenseType& m_mat;
+    };
+
+    MatrixFreeOperator(const DenseType& mat) : m_mat(mat) {}
+    Index rows() const { return m_mat.rows(); }
+    Index cols() const { return m_mat.cols(); }
+    template<typename Rhs>
+    DenseType operator*(const MatrixBase<Rhs>& x) const { return m_mat * x; }
+    AdjointOperator adjoint() const { return AdjointOperator(m_mat); }
+
+  protected:
+    const DenseType& m_mat;
+};
+
+// check the truncated decomposition against JacobiSVD on an exactly low rank operator
+template<typename OperatorType, typename DenseType>
+void randomized_svd_check(const OperatorType& op, const DenseType& ref, typename DenseType::Index rank)
+{
+  typedef typename DenseType::Index Index;
+  typedef typename DenseType::Scalar Scalar;
+
+  RandomizedSVD<OperatorType> rsvd;
+  rsvd.setOversampling(internal::random<Index>(2,8)).setPowerIterations(internal::random<Index>(0,2));
+  rsvd.compute(op, rank, ComputeThinU|ComputeThinV);
+
+  JacobiSVD<DenseType> svd(ref);
+  VERIFY_IS_EQUAL(rsvd.rank(), rank);
+  VERIFY_IS_EQUAL(rsvd.singularValues().size(), rank);
+  VERIFY_IS_APPROX(rsvd.singularValues(), svd.singularValues().head(rank));
+  VERIFY_IS_UNITARY(rsvd.matrixU());
+  VERIFY_IS_UNITARY(rsvd.matrixV());
+  VERIFY_IS_APPROX(ref, DenseType(rsvd.matrixU() * rsvd.singularValues().template cast<Scalar>().asDiagonal() * rsvd.matrixV().adjoint()));
+
+  // singular values only
+  RandomizedSVD<OperatorType> rsvd_values(op, rank);
+  VERIFY_IS_APPROX(rsvd_values.singularValues(), svd.singularValues().head(rank));
+}
+
+template<typename Scalar> void randomized_svd_dense()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+  typedef typename DenseType::Index Index;
+  Index rows = internal::random<Index>(20,EIGEN_TEST_MAX_SIZE);
+  Index cols = internal::random<Index>(20,EIGEN_TEST_MAX_SIZE);
+  Index rank = internal::random<Index>(1,10);
+
+  DenseType m = DenseType::Random(rows, rank) * DenseType::Random(rank, cols);
+  randomized_svd_check(m, m, rank);
+
+  MatrixFreeOperator<Scalar> op(m);
+  randomized_svd_check(op, m, rank);
+}
+
+template<typename Scalar> void randomized_svd_sparse()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+  typedef typename DenseType::Index Index;
+  Index rows = internal::random<Index>(20,EIGEN_TEST_MAX_SIZE);
+  Index cols = internal::random<Index>(20,EIGEN_TEST_MAX_SIZE);
+  Index rank = internal::random<Index>(1,10);
+
+  // a sparse matrix of low rank: a few dense rows
+  DenseType m = DenseType::Zero(rows, cols);
+  for(Index k=0; k<rank; ++k)
+    m.row(k * (rows/rank)) = DenseType::Random(1,cols);
+  SparseMatrix<Scalar> sm = m.sparseView();
+  randomized_svd_check(sm, m, rank);
+}
+
+template<typename Scalar> void randomized_svd_decay()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef typename DenseType::Index Index;
+  Index rows = internal::random<Index>(40,EIGEN_TEST_MAX_SIZE);
+  Index cols = internal::random<Index>(40,EIGEN_TEST_MAX_SIZE);
+  Index size = (std::min)(rows,cols);
+
+  // full rank matrix with fast decaying singular values
+  DenseType u = HouseholderQR<DenseType>(DenseType::Random(rows,rows)).householderQ();
+  DenseType v = HouseholderQR<DenseType>(DenseType::Random(cols,cols)).householderQ();
+  Matrix<RealScalar,Dynamic,1> s(size);
+  for(Index i=0; i<size; ++i)
+    s(i) = std::pow(RealScalar(0.5), RealScalar(i));
+  DenseType m = u.leftCols(size) * s.template cast<Scalar>().asDiagonal() * v.leftCols(size).adjoint();
+
+  Index rank = 5;
+  RandomizedSVD<DenseType> rsvd;
+  rsvd.setOversampling(10).setPowerIterations(2);
+  rsvd.compute(m, rank, ComputeThinU|ComputeThinV);
+  VERIFY_IS_APPROX(rsvd.singularValues(), s.head(rank));
+  // the error of the best rank k approximation is s(k)
+  DenseType err = m - rsvd.matrixU() * rsvd.singularValues().template cast<Scalar>().asDiagonal() * rsvd.matrixV().adjoint();
+  VERIFY( JacobiSVD<DenseType>(err).singularValues()(0) < RealScalar(2) * s(rank) );
+}
+
+void test_randomized_svd()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(( randomized_svd_dense<double>() ));
+    CALL_SUBTEST_2(( randomized_svd_dense<std::complex<float> >() ));
+    CALL_SUBTEST_3(( randomized_svd_sparse<double>() ));
+    CALL_SUBTEST_4(( randomized_svd_decay<double>() ));
+    CALL_SUBTEST_5(( randomized_svd_decay<std::complex<double> >() ));
+  }
+}
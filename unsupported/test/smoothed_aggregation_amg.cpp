@@ -0,0 +1,123 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "../../test/sparse_solver.h"
+#include <Eigen/IterativeSolvers>
+
+// 5-point finite difference discretization of -div(grad u) + c.grad u on a n x n grid,
+// using an upwind scheme for the convection term
+template<typename Scalar>
+SparseMatrix<Scalar> convection_diffusion_2d(int n, double c)
+{
+  std::vector<Triplet<Scalar> > triplets;
+  for(int i=0; i<n; ++i)
+    for(int j=0; j<n; ++j)
+    {
+      int k = i*n+j;
+      triplets.push_back(Triplet<Scalar>(k, k, Scalar(4+2*c)));
+      if(i>0)   triplets.push_back(Triplet<Scalar>(k, k-n, Scalar(-1-c)));
+      if(i<n-1) triplets.push_back(Triplet<Scalar>(k, k+n, Scalar(-1)));
+      if(j>0)   triplets.push_back(Triplet<Scalar>(k, k-1, Scalar(-1-c)));
+      if(j<n-1) triplets.push_back(Triplet<Scalar>(k, k+1, Scalar(-1)));
+    }
+  SparseMatrix<Scalar> A(n*n, n*n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  return A;
+}
+
+template<typename T> void test_smoothed_aggregation_amg_T()
+{
+  ConjugateGradient<SparseMatrix<T>, Lower|Upper, SmoothedAggregationAMG<T> > cg_jacobi, cg_gs;
+  cg_jacobi.preconditioner().setMaxCoarseSize(10);
+  cg_gs.preconditioner().setMaxCoarseSize(10).setSmoother(GaussSeidelSmoother);
+
+  CALL_SUBTEST( check_sparse_spd_solving(cg_jacobi) );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_gs) );
+}
+
+// the number of iterations of the preconditioned solvers does not grow with the size of the mesh
+template<typename T> void test_smoothed_aggregation_amg_poisson(AMGSmootherType smoother)
+{
+  typedef Matrix<T,Dynamic,1> VectorType;
+  typedef typename NumTraits<T>::Real RealScalar;
+
+  int iterations[2];
+  for(int l=0; l<2; ++l)
+  {
+    int n = l==0 ? 32 : 96;
+    SparseMatrix<T> A = convection_diffusion_2d<T>(n, 0);
+    VectorType b = VectorType::Random(n*n);
+
+    ConjugateGradient<SparseMatrix<T>, Lower|Upper, SmoothedAggregationAMG<T> > cg;
+    cg.setTolerance(RealScalar(1e-8));
+    cg.preconditioner().setSmoother(smoother);
+    cg.compute(A);
+    VERIFY_IS_EQUAL(cg.info(), Success);
+    VERIFY(cg.preconditioner().levels() > 1);
+    VERIFY(cg.preconditioner().operatorComplexity() < RealScalar(2));
+
+    VectorType x = cg.solve(b);
+    VERIFY_IS_EQUAL(cg.info(), Success);
+    VERIFY((A*x - b).norm() <= RealScalar(1e-6) * b.norm());
+    iterations[l] = cg.iterations();
+    VERIFY(iterations[l] < 30);
+
+    ConjugateGradient<SparseMatrix<T>, Lower|Upper> cg_diag(A);
+    cg_diag.setTolerance(RealScalar(1e-8));
+    x = cg_diag.solve(b);
+    VERIFY(3*iterations[l] < cg_diag.iterations());
+  }
+  VERIFY(iterations[1] <= 2*iterations[0]);
+
+  // a non symmetric problem
+  SparseMatrix<T> A = convection_diffusion_2d<T>(48, 1);
+  VectorType b = VectorType::Random(A.rows());
+  BiCGSTAB<SparseMatrix<T>, SmoothedAggregationAMG<T> > bicg;
+  bicg.setTolerance(RealScalar(1e-8));
+  bicg.preconditioner().setSmoother(smoother);
+  bicg.compute(A);
+  VectorType x = bicg.solve(b);
+  VERIFY_IS_EQUAL(bicg.info(), Success);
+  VERIFY((A*x - b).norm() <= RealScalar(1e-6) * b.norm());
+  VERIFY(bicg.iterations() < 30);
+}
+
+// without any strong connection, the fine level cannot be coarsened, and is smoothed instead of factorized
+template<typename T> void test_smoothed_aggregation_amg_weak(AMGSmootherType smoother)
+{
+  typedef Matrix<T,Dynamic,1> VectorType;
+  typedef typename NumTraits<T>::Real RealScalar;
+
+  int n = 60;
+  SparseMatrix<T> I(n*n, n*n);
+  I.setIdentity();
+  SparseMatrix<T> A = I + T(0.01) * convection_diffusion_2d<T>(n, 0);
+  VectorType b = VectorType::Random(n*n);
+
+  ConjugateGradient<SparseMatrix<T>, Lower|Upper, SmoothedAggregationAMG<T> > cg;
+  cg.setTolerance(RealScalar(1e-8));
+  cg.preconditioner().setSmoother(smoother);
+  cg.compute(A);
+  VERIFY_IS_EQUAL(cg.info(), Success);
+  VERIFY_IS_EQUAL(cg.preconditioner().levels(), 1);
+
+  VectorType x = cg.solve(b);
+  VERIFY_IS_EQUAL(cg.info(), Success);
+  VERIFY((A*x - b).norm() <= RealScalar(1e-6) * b.norm());
+  VERIFY(cg.iterations() < 10);
+}
+
+void test_smoothed_aggregation_amg()
+{
+  CALL_SUBTEST_1(test_smoothed_aggregation_amg_T<double>());
+  CALL_SUBTEST_2(test_smoothed_aggregation_amg_T<std::complex<double> >());
+  CALL_SUBTEST_3(test_smoothed_aggregation_amg_poisson<double>(JacobiSmoother));
+  CALL_SUBTEST_3(test_smoothed_aggregation_amg_poisson<double>(GaussSeidelSmoother));
+  CALL_SUBTEST_4(test_smoothed_aggregation_amg_poisson<std::complex<double> >(GaussSeidelSmoother));
+  CALL_SUBTEST_5(test_smoothed_aggregation_amg_weak<double>(JacobiSmoother));
+  CALL_SUBTEST_5(test_smoothed_aggregation_amg_weak<double>(GaussSeidelSmoother));
+}